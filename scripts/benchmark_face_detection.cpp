@@ -0,0 +1,202 @@
+// Face detection benchmark: latency and recall of the face detection
+// service backends (Haar, LBP, YuNet), each run on the full-resolution
+// frame, on the downscaled pyramid level, and tracked (full search every N
+// frames, region re-detection around tracked faces in between)
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ai/face_detection_service.h"
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+
+namespace {
+// Backends frame boxes differently (Haar boxes include more forehead than
+// YuNet's), so agreement is counted at a looser IoU than usual
+const float kMatchIoU = 0.3f;
+
+using Boxes = std::vector<cv::Rect>;
+
+float IoU(const cv::Rect& a, const cv::Rect& b)
+{
+    int intersection = (a & b).area();
+    int unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0 ? static_cast<float>(intersection) / unionArea : 0.0f;
+}
+
+// Greedy one-to-one matching; returns matches and accumulates matched IoU
+int CountMatches(const Boxes& boxes, const Boxes& reference, double& iouSum)
+{
+    std::vector<bool> used(reference.size(), false);
+    int matches = 0;
+    for (const cv::Rect& box : boxes) {
+        float best = kMatchIoU;
+        int bestIndex = -1;
+        for (size_t r = 0; r < reference.size(); ++r) {
+            float iou = used[r] ? 0.0f : IoU(box, reference[r]);
+            if (iou >= best) {
+                best = iou;
+                bestIndex = static_cast<int>(r);
+            }
+        }
+        if (bestIndex >= 0) {
+            used[bestIndex] = true;
+            iouSum += best;
+            matches++;
+        }
+    }
+    return matches;
+}
+
+struct RunResult {
+    std::vector<Boxes> faces;       // Per frame
+    double meanMs = 0.0;
+    double maxMs = 0.0;
+};
+
+// Mode: 0 = full resolution, 1 = pyramid level, 2 = tracked
+RunResult Run(FaceDetectionService& service, const std::vector<cv::Mat>& frames, int mode)
+{
+    RunResult result;
+    service.SetDetectionScale(mode == 0 ? 1.0f : 0.5f);
+    service.ResetTracking();
+
+    double totalMs = 0.0;
+    int timed = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        Boxes faces;
+        if (mode == 2) {
+            service.Track(frames[i], faces);
+        } else {
+            service.Detect(frames[i], faces);
+        }
+        // First frames warm up caches and the network
+        if (i >= 3) {
+            totalMs += service.GetLastDetectMs();
+            result.maxMs = std::max(result.maxMs, service.GetLastDetectMs());
+            timed++;
+        }
+        result.faces.push_back(faces);
+    }
+    result.meanMs = timed ? totalMs / timed : 0.0;
+    return result;
+}
+}
+#endif
+
+int main(int argc, char** argv) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Face Detection Benchmark" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+#ifdef HAVE_OPENCV
+    std::string source = argc > 1 ? argv[1] : "0";
+    int frameCount = argc > 2 ? std::stoi(argv[2]) : 150;
+    std::string yunetPath = argc > 3 ? argv[3] : "";
+    int interval = argc > 4 ? std::stoi(argv[4]) : 5;
+
+    cv::VideoCapture capture;
+    if (source.size() == 1 && std::isdigit(static_cast<unsigned char>(source[0]))) {
+        capture.open(source[0] - '0');
+    } else {
+        capture.open(source);
+    }
+    if (!capture.isOpened()) {
+        std::cerr << "\n❌ Could not open " << source << std::endl;
+        std::cerr << "   Usage: benchmark_face_detection [video|camera index] [frames] [yunet model] [interval]" << std::endl;
+        return 1;
+    }
+
+    // Every backend sees the same frames
+    std::vector<cv::Mat> frames;
+    cv::Mat frame;
+    while (static_cast<int>(frames.size()) < frameCount && capture.read(frame)) {
+        frames.push_back(frame.clone());
+    }
+    if (frames.empty()) {
+        std::cerr << "\n❌ No frames read from " << source << std::endl;
+        return 1;
+    }
+
+    struct Backend {
+        FaceDetectionService::Backend backend;
+        std::string path;
+    };
+    std::vector<Backend> backends = {
+        {FaceDetectionService::YUNET, yunetPath},
+        {FaceDetectionService::HAAR, ""},
+        {FaceDetectionService::LBP, ""}
+    };
+
+    // Reference: the first backend that loads, on full-resolution frames
+    // (YuNet when its model is available)
+    std::vector<Boxes> reference;
+    std::string referenceName;
+    int referenceFaces = 0;
+
+    std::cout << "\nSource: " << source << " | " << frames[0].cols << "x" << frames[0].rows
+              << " | Frames: " << frames.size() << " | Tracked: full search every " << interval << " frames" << std::endl;
+
+    bool headerPrinted = false;
+    for (const Backend& entry : backends) {
+        FaceDetectionService service;
+        if (!service.Load(entry.backend, entry.path)) {
+            std::cout << "  (" << FaceDetectionService::GetBackendName(entry.backend) << " not available - skipped)" << std::endl;
+            continue;
+        }
+        service.SetDetectInterval(interval);
+        const std::string name = FaceDetectionService::GetBackendName(entry.backend);
+
+        const char* modeNames[] = {"full-res", "pyramid", "tracked"};
+        for (int mode = 0; mode < 3; ++mode) {
+            RunResult result = Run(service, frames, mode);
+
+            if (reference.empty()) {
+                reference = result.faces;
+                referenceName = name + " " + modeNames[mode];
+                for (const Boxes& faces : reference) referenceFaces += static_cast<int>(faces.size());
+                std::cout << "Reference: " << referenceName << " (" << referenceFaces << " faces, "
+                          << std::fixed << std::setprecision(2) << static_cast<double>(referenceFaces) / frames.size()
+                          << " per frame)" << std::endl;
+            }
+            if (!headerPrinted) {
+                std::cout << "\n  backend | mode     | ms/frame |  max ms | faces | recall | precision | mean IoU" << std::endl;
+                std::cout << "----------+----------+----------+---------+-------+--------+-----------+---------" << std::endl;
+                headerPrinted = true;
+            }
+
+            int faces = 0, matches = 0;
+            double iouSum = 0.0;
+            for (size_t i = 0; i < frames.size(); ++i) {
+                faces += static_cast<int>(result.faces[i].size());
+                matches += CountMatches(result.faces[i], reference[i], iouSum);
+            }
+
+            std::cout << "  " << std::left << std::setw(7) << name << " | " << std::setw(8) << modeNames[mode] << std::right
+                      << " | " << std::setw(8) << std::setprecision(2) << result.meanMs
+                      << " | " << std::setw(7) << result.maxMs
+                      << " | " << std::setw(5) << faces
+                      << " | " << std::setw(5) << std::setprecision(1) << 100.0 * matches / std::max(1, referenceFaces) << "%"
+                      << " | " << std::setw(8) << 100.0 * matches / std::max(1, faces) << "%"
+                      << " | " << std::setw(7) << std::setprecision(2) << (matches ? iouSum / matches : 0.0) << std::endl;
+        }
+    }
+
+    if (reference.empty()) {
+        std::cerr << "\n❌ No face detector could be loaded (cascade XMLs / YuNet ONNX not found)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nRecall and precision are against " << referenceName << " at IoU >= " << kMatchIoU << "." << std::endl;
+    std::cout << "Tracked max ms is a full-search frame; the other frames only re-detect around tracked faces." << std::endl;
+
+#else
+    std::cerr << "❌ OpenCV not available - cannot run benchmark" << std::endl;
+    return 1;
+#endif
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+// Multi-object tracker benchmark: update time and identity stability of
+// MultiObjectTracker (Kalman + Hungarian) vs. greedy frame-to-frame IoU matching
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "ai/multi_object_tracker.h"
+
+namespace {
+using Detection = MultiObjectTracker::Detection;
+
+struct Scene {
+    std::vector<float> x, y, vx, vy, width, height;
+};
+
+float IoU(const Detection& a, const Detection& b)
+{
+    float ix = std::max(0.0f, std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x));
+    float iy = std::max(0.0f, std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y));
+    float intersection = ix * iy;
+    return intersection / (a.width * a.height + b.width * b.height - intersection);
+}
+
+// Greedy matching against the previous frame's boxes (the tracker's predecessor)
+class GreedyTracker {
+public:
+    void Update(const std::vector<Detection>& detections, std::vector<int>& ids)
+    {
+        ids.assign(detections.size(), -1);
+        std::vector<bool> used(m_boxes.size(), false);
+        for (size_t d = 0; d < detections.size(); ++d) {
+            float best = 0.1f;
+            int bestIndex = -1;
+            for (size_t p = 0; p < m_boxes.size(); ++p) {
+                float iou = used[p] ? 0.0f : IoU(detections[d], m_boxes[p]);
+                if (iou > best) {
+                    best = iou;
+                    bestIndex = static_cast<int>(p);
+                }
+            }
+            if (bestIndex >= 0) {
+                used[bestIndex] = true;
+                ids[d] = m_ids[bestIndex];
+            } else {
+                ids[d] = m_nextId++;
+            }
+        }
+        m_boxes = detections;
+        m_ids = ids;
+    }
+    int GetIdCount() const { return m_nextId - 1; }
+
+private:
+    std::vector<Detection> m_boxes;
+    std::vector<int> m_ids;
+    int m_nextId = 1;
+};
+
+// Counts identity changes of each ground-truth target between frames it is reported
+class SwitchCounter {
+public:
+    explicit SwitchCounter(int targets) : m_last(targets, -1) {}
+    void Record(const std::vector<int>& truth, const std::vector<int>& ids)
+    {
+        for (size_t d = 0; d < truth.size(); ++d) {
+            if (truth[d] < 0 || ids[d] < 0) continue;
+            int& last = m_last[truth[d]];
+            if (last >= 0 && last != ids[d]) m_switches++;
+            last = ids[d];
+        }
+    }
+    int GetSwitches() const { return m_switches; }
+
+private:
+    std::vector<int> m_last;
+    int m_switches = 0;
+};
+}
+
+int main(int argc, char** argv) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Multi-Object Tracker Benchmark" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    int frameCount = argc > 1 ? std::stoi(argv[1]) : 600;
+    std::vector<int> targetCounts;
+    for (int i = 2; i < argc; ++i) {
+        targetCounts.push_back(std::stoi(argv[i]));
+    }
+    if (targetCounts.empty()) {
+        targetCounts = {5, 20, 50, 100};
+    }
+
+    const float frameWidth = 1920.0f;
+    const float frameHeight = 1080.0f;
+    const float missRate = 0.05f;           // Detections dropped per frame
+    const float clutterRate = 0.02f;        // False positives per target per frame
+
+    std::cout << "\nScene: " << frameWidth << "x" << frameHeight << ", " << frameCount << " frames, "
+              << missRate * 100 << "% missed detections, box noise 2 px" << std::endl;
+    std::cout << "\n  targets | mean ms |  max ms | tracks | ids | switches | greedy ids | greedy switches" << std::endl;
+    std::cout << "----------+---------+---------+--------+-----+----------+------------+----------------" << std::endl;
+
+    for (int targets : targetCounts) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+        std::normal_distribution<float> noise(0.0f, 2.0f);
+
+        Scene scene;
+        for (int i = 0; i < targets; ++i) {
+            scene.width.push_back(40.0f + uniform(rng) * 40.0f);
+            scene.height.push_back(scene.width.back() * 2.0f);
+            scene.x.push_back(uniform(rng) * (frameWidth - scene.width.back()));
+            scene.y.push_back(uniform(rng) * (frameHeight - scene.height.back()));
+            scene.vx.push_back((uniform(rng) - 0.5f) * 16.0f);
+            scene.vy.push_back((uniform(rng) - 0.5f) * 8.0f);
+        }
+
+        MultiObjectTracker tracker;
+        GreedyTracker greedy;
+        SwitchCounter trackerSwitches(targets);
+        SwitchCounter greedySwitches(targets);
+        std::vector<Detection> detections;
+        std::vector<int> truth;
+        std::vector<int> greedyIds;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+
+        for (int frame = 0; frame < frameCount; ++frame) {
+            detections.clear();
+            truth.clear();
+            for (int i = 0; i < targets; ++i) {
+                scene.x[i] += scene.vx[i];
+                scene.y[i] += scene.vy[i];
+                if (scene.x[i] < 0.0f || scene.x[i] + scene.width[i] > frameWidth) scene.vx[i] = -scene.vx[i];
+                if (scene.y[i] < 0.0f || scene.y[i] + scene.height[i] > frameHeight) scene.vy[i] = -scene.vy[i];
+                if (uniform(rng) < missRate) continue;
+
+                detections.push_back({scene.x[i] + noise(rng), scene.y[i] + noise(rng),
+                                      scene.width[i] + noise(rng), scene.height[i] + noise(rng), 0.9f});
+                truth.push_back(i);
+            }
+            for (int i = 0; i < targets; ++i) {
+                if (uniform(rng) < clutterRate) {
+                    detections.push_back({uniform(rng) * (frameWidth - 60.0f), uniform(rng) * (frameHeight - 120.0f),
+                                          60.0f, 120.0f, 0.3f});
+                    truth.push_back(-1);
+                }
+            }
+
+            tracker.Update(detections);
+            if (frame >= 10) {
+                totalMs += tracker.GetLastUpdateMs();
+                maxMs = std::max(maxMs, tracker.GetLastUpdateMs());
+            }
+            trackerSwitches.Record(truth, tracker.GetDetectionTrackIds());
+
+            greedy.Update(detections, greedyIds);
+            greedySwitches.Record(truth, greedyIds);
+        }
+
+        std::cout << "  " << std::setw(7) << targets << " | "
+                  << std::setw(7) << std::fixed << std::setprecision(3) << totalMs / std::max(1, frameCount - 10) << " | "
+                  << std::setw(7) << maxMs << " | "
+                  << std::setw(6) << tracker.GetTrackCount() << " | "
+                  << std::setw(3) << tracker.GetIdCount() << " | "
+                  << std::setw(8) << trackerSwitches.GetSwitches() << " | "
+                  << std::setw(10) << greedy.GetIdCount() << " | "
+                  << greedySwitches.GetSwitches() << std::endl;
+    }
+
+    std::cout << "\n'ids' counts tracks ever created (tentative clutter tracks included);" << std::endl;
+    std::cout << "'switches' counts frames where a target is reported under a new id." << std::endl;
+
+    return 0;
+}
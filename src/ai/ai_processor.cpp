@@ -1,6 +1,7 @@
 #include "ai_processor.h"
 #include "passthrough_processor.h"
-#include <iostream>
+#include "logger.h"
+#include <algorithm>
 
 // AIProcessorFactory implementation
 std::unique_ptr<AIProcessor> AIProcessorFactory::CreateProcessor(const std::string& type) {
@@ -59,8 +60,8 @@ Frame AIProcessingPipeline::ProcessFrame(const Frame& input) {
         if (processor) {
             current = processor->ProcessFrame(current);
             if (!current.IsValid()) {
-                std::cerr << "Processor " << processor->GetName() 
-                         << " returned invalid frame" << std::endl;
+                MS_LOG_ERROR("Processor " << processor->GetName() 
+                         << " returned invalid frame");
                 return input; // Return original frame on error
             }
         }
@@ -78,8 +79,8 @@ bool AIProcessingPipeline::Initialize() {
     
     for (auto& processor : m_processors) {
         if (processor && !processor->Initialize()) {
-            std::cerr << "Failed to initialize processor: " 
-                     << processor->GetName() << std::endl;
+            MS_LOG_ERROR("Failed to initialize processor: " 
+                     << processor->GetName());
             allSuccess = false;
         }
     }
@@ -1,6 +1,8 @@
 #include "anime_gan_processor.h"
-#include <iostream>
+#include "virtual_background_processor.h"
+#include "logger.h"
 #include <chrono>
+#include <cmath>
 #include <filesystem>
 
 #ifdef HAVE_OPENCV
@@ -21,9 +23,37 @@ AnimeGANProcessor::AnimeGANProcessor()
       m_target(cv::dnn::DNN_TARGET_CPU),
       m_temporalBlendWeight(0.7f),
       m_processingTime(0.0),
-      m_frameCounter(0)
+      m_frameCounter(0),
+      m_useFusedPipeline(true),
+      m_personOnly(false),
+      m_stylizeBackground(false),
+      m_backgroundInterval(5),
+      m_backgroundScale(0.25f),
+      m_segmenterReady(false),
+      m_backgroundAge(0),
+      m_segmentationTime(0.0),
+      m_computeSaving(0.0),
+      m_keyframeMode(false),
+      m_keyframeQuality(0.5f),
+      m_targetFPS(30.0),
+      m_flowScale(1.0f),
+      m_framesSinceKeyframe(0),
+      m_keyframeLatency(0.0),
+      m_warpTime(0.0),
+      m_lastMotion(0.0),
+      m_keyframeCount(0),
+      m_netInstances(1),
+      m_threadsPerInstance(0),
+      m_backendChoice(InferenceBackend::AUTO),
+      m_backendType(InferenceBackend::OPENCV_TORCH),
+      m_modelCacheBudgetMB(512),
+      m_adaptiveRequested(false)
 {
-    std::cout << "[AnimeGANProcessor] Initializing with Fast Neural Style..." << std::endl;
+    m_resolutionController.SetLadder({256, 320, 384, 448, 512, 640, 768});
+    m_resolutionController.SetCurrentSize(m_inputWidth);
+    m_resolutionController.SetBudget(1000.0 / m_targetFPS);
+
+    MS_LOG_INFO("[AnimeGANProcessor] Initializing with Fast Neural Style...");
 }
 
 AnimeGANProcessor::~AnimeGANProcessor()
@@ -33,15 +63,15 @@ AnimeGANProcessor::~AnimeGANProcessor()
 
 bool AnimeGANProcessor::Initialize()
 {
-    std::cout << "[AnimeGANProcessor] Initialize called" << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] Initialize called");
     
 #ifdef HAVE_OPENCV
     // Check if model file exists
     if (!std::filesystem::exists(m_modelPath)) {
-        std::cerr << "[AnimeGANProcessor] ERROR: Model file not found: " << m_modelPath << std::endl;
-        std::cerr << "[AnimeGANProcessor] Please download Fast Neural Style .t7 model and place it in models/ folder" << std::endl;
-        std::cerr << "[AnimeGANProcessor] Available models: candy.t7, mosaic.t7, starry_night.t7, etc." << std::endl;
-        std::cerr << "[AnimeGANProcessor] Download from: https://cs.stanford.edu/people/jcjohns/fast-neural-style/" << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] ERROR: Model file not found: " << m_modelPath);
+        MS_LOG_ERROR("[AnimeGANProcessor] Please download Fast Neural Style .t7 model and place it in models/ folder");
+        MS_LOG_ERROR("[AnimeGANProcessor] Available models: candy.t7, mosaic.t7, starry_night.t7, etc.");
+        MS_LOG_ERROR("[AnimeGANProcessor] Download from: https://cs.stanford.edu/people/jcjohns/fast-neural-style/");
         return false;
     }
     
@@ -49,87 +79,161 @@ bool AnimeGANProcessor::Initialize()
     m_gpuAvailable = DetectGPUSupport();
     
     try {
-        // Load the Torch model (.t7 format)
-        std::cout << "[AnimeGANProcessor] Loading Fast Neural Style model from: " << m_modelPath << std::endl;
-        m_net = cv::dnn::readNetFromTorch(m_modelPath);  // Changed from readNetFromONNX
+        // Engine from the parameter, or from the model file type
+        m_backendType = m_backendChoice == InferenceBackend::AUTO ? InferenceBackend::DetectType(m_modelPath)
+                                                                   : m_backendChoice;
+        if (m_backendType == InferenceBackend::ORT_CPU) {
+#ifdef HAVE_ONNX
+            return InitializeOrtBackend();
+#else
+            MS_LOG_INFO("[AnimeGANProcessor] ONNX Runtime not available, loading ONNX model with OpenCV DNN");
+            m_backendType = InferenceBackend::OPENCV_ONNX;
+#endif
+        }
+
+        // Load the model with OpenCV DNN (.t7 Torch or .onnx)
+        MS_LOG_INFO("[AnimeGANProcessor] Loading style model from: " << m_modelPath
+                  << " (" << InferenceBackend::GetTypeName(m_backendType) << ")");
+        m_net = OpenCVDnnBackend::ReadNet(m_modelPath, m_backendType);
         
         if (m_net.empty()) {
-            std::cerr << "[AnimeGANProcessor] ERROR: Failed to load model" << std::endl;
+            MS_LOG_ERROR("[AnimeGANProcessor] ERROR: Failed to load model");
             return false;
         }
         
         // Configure GPU backend if available and requested
         if (m_useGPU && m_gpuAvailable) {
-            std::cout << "[AnimeGANProcessor] Configuring GPU acceleration..." << std::endl;
+            MS_LOG_INFO("[AnimeGANProcessor] Configuring GPU acceleration...");
             
             // Try FP16 first for best performance
             if (m_useFP16) {
                 try {
-                    std::cout << "[AnimeGANProcessor] Attempting CUDA with FP16 (half-precision)..." << std::endl;
+                    MS_LOG_INFO("[AnimeGANProcessor] Attempting CUDA with FP16 (half-precision)...");
                     m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
                     m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA_FP16);
                     m_backend = cv::dnn::DNN_BACKEND_CUDA;
                     m_target = cv::dnn::DNN_TARGET_CUDA_FP16;
-                    std::cout << "[AnimeGANProcessor] ✅ Using CUDA with FP16 - MAXIMUM PERFORMANCE" << std::endl;
+                    MS_LOG_INFO("[AnimeGANProcessor] ✅ Using CUDA with FP16 - MAXIMUM PERFORMANCE");
                 } catch (const cv::Exception& e) {
-                    std::cout << "[AnimeGANProcessor] FP16 not available, falling back to FP32..." << std::endl;
+                    MS_LOG_INFO("[AnimeGANProcessor] FP16 not available, falling back to FP32...");
                     m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
                     m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
                     m_backend = cv::dnn::DNN_BACKEND_CUDA;
                     m_target = cv::dnn::DNN_TARGET_CUDA;
-                    std::cout << "[AnimeGANProcessor] ✅ Using CUDA with FP32" << std::endl;
+                    MS_LOG_INFO("[AnimeGANProcessor] ✅ Using CUDA with FP32");
                 }
             } else {
                 m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
                 m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
                 m_backend = cv::dnn::DNN_BACKEND_CUDA;
                 m_target = cv::dnn::DNN_TARGET_CUDA;
-                std::cout << "[AnimeGANProcessor] ✅ Using CUDA with FP32" << std::endl;
+                MS_LOG_INFO("[AnimeGANProcessor] ✅ Using CUDA with FP32");
             }
         } else {
-            std::cout << "[AnimeGANProcessor] Using CPU backend" << std::endl;
+            MS_LOG_INFO("[AnimeGANProcessor] Using CPU backend");
             m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
             m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
             m_backend = cv::dnn::DNN_BACKEND_OPENCV;
             m_target = cv::dnn::DNN_TARGET_CPU;
         }
         
+        m_inference = std::make_unique<OpenCVDnnBackend>(m_net, m_backendType);
+        UpdateAdaptiveForModel();
         m_modelLoaded = true;
-        std::cout << "[AnimeGANProcessor] Fast Neural Style model loaded successfully" << std::endl;
-        std::cout << "[AnimeGANProcessor] Configuration:" << std::endl;
-        std::cout << "[AnimeGANProcessor]   Input size: " << m_inputWidth << "x" << m_inputHeight << std::endl;
-        std::cout << "[AnimeGANProcessor]   Blend weight: " << m_blendWeight << std::endl;
-        std::cout << "[AnimeGANProcessor]   Temporal blend: " << m_temporalBlendWeight << std::endl;
-        std::cout << "[AnimeGANProcessor]   GPU enabled: " << (m_useGPU && m_gpuAvailable ? "YES" : "NO") << std::endl;
-        std::cout << "[AnimeGANProcessor]   FP16 mode: " << (m_useFP16 && m_target == cv::dnn::DNN_TARGET_CUDA_FP16 ? "YES" : "NO") << std::endl;
-        std::cout << "[AnimeGANProcessor]   Expected speedup: " << (m_target == cv::dnn::DNN_TARGET_CUDA_FP16 ? "5-10x" : m_target == cv::dnn::DNN_TARGET_CUDA ? "3-5x" : "1x (CPU)") << std::endl;
+        MS_LOG_INFO("[AnimeGANProcessor] Fast Neural Style model loaded successfully");
+
+        StartModelCache();
+        if (m_netInstances > 1) {
+            StartNetPool();
+        }
+        MS_LOG_INFO("[AnimeGANProcessor] Configuration:");
+        MS_LOG_INFO("[AnimeGANProcessor]   Input size: " << m_inputWidth << "x" << m_inputHeight);
+        MS_LOG_INFO("[AnimeGANProcessor]   Blend weight: " << m_blendWeight);
+        MS_LOG_INFO("[AnimeGANProcessor]   Temporal blend: " << m_temporalBlendWeight);
+        MS_LOG_INFO("[AnimeGANProcessor]   GPU enabled: " << (m_useGPU && m_gpuAvailable ? "YES" : "NO"));
+        MS_LOG_INFO("[AnimeGANProcessor]   FP16 mode: " << (m_useFP16 && m_target == cv::dnn::DNN_TARGET_CUDA_FP16 ? "YES" : "NO"));
+        MS_LOG_INFO("[AnimeGANProcessor]   Expected speedup: " << (m_target == cv::dnn::DNN_TARGET_CUDA_FP16 ? "5-10x" : m_target == cv::dnn::DNN_TARGET_CUDA ? "3-5x" : "1x (CPU)"));
         
         return true;
         
     } catch (const cv::Exception& e) {
-        std::cerr << "[AnimeGANProcessor] OpenCV exception during initialization: " << e.what() << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] OpenCV exception during initialization: " << e.what());
         return false;
     } catch (const std::exception& e) {
-        std::cerr << "[AnimeGANProcessor] Exception during initialization: " << e.what() << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] Exception during initialization: " << e.what());
         return false;
     }
 #else
-    std::cerr << "[AnimeGANProcessor] ERROR: OpenCV not available" << std::endl;
+    MS_LOG_ERROR("[AnimeGANProcessor] ERROR: OpenCV not available");
     return false;
 #endif
 }
 
+#ifdef HAVE_ONNX
+bool AnimeGANProcessor::InitializeOrtBackend()
+{
+    // CPU-only engine; GPU settings apply to the OpenCV DNN engines
+    MS_LOG_INFO("[AnimeGANProcessor] Loading style model with ONNX Runtime (CPU): " << m_modelPath);
+
+    auto backend = std::make_unique<OrtCpuBackend>(m_threadsPerInstance);
+    if (!backend->Load(m_modelPath)) {
+        MS_LOG_ERROR("[AnimeGANProcessor] ERROR: Failed to load model");
+        return false;
+    }
+
+    // Static-shape exports dictate the network input size
+    cv::Size fixedSize = backend->GetFixedInputSize();
+    if (fixedSize.area() > 0) {
+        m_inputWidth = fixedSize.width;
+        m_inputHeight = fixedSize.height;
+    }
+
+    m_inference = std::move(backend);
+    m_backend = cv::dnn::DNN_BACKEND_OPENCV;
+    m_target = cv::dnn::DNN_TARGET_CPU;
+    m_modelLoaded = true;
+    UpdateAdaptiveForModel();
+
+    MS_LOG_INFO("[AnimeGANProcessor] Configuration:");
+    MS_LOG_INFO("[AnimeGANProcessor]   Engine: ONNX Runtime CPU");
+    MS_LOG_INFO("[AnimeGANProcessor]   Input size: " << m_inputWidth << "x" << m_inputHeight
+              << (fixedSize.area() > 0 ? " (fixed by model)" : ""));
+    MS_LOG_INFO("[AnimeGANProcessor]   Blend weight: " << m_blendWeight);
+    MS_LOG_INFO("[AnimeGANProcessor]   Temporal blend: " << m_temporalBlendWeight);
+
+    StartModelCache();
+    return true;
+}
+#endif
+
 void AnimeGANProcessor::Cleanup()
 {
-    std::cout << "[AnimeGANProcessor] Cleanup called" << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] Cleanup called");
     
 #ifdef HAVE_OPENCV
+    m_netPool.Stop();
+    m_modelCache.Stop();
+    m_modelCache.Clear();
+    m_pendingModelPath.clear();
+    m_inference.reset();
     m_previousOutput.release();
+    m_personStyled.release();
+    m_backgroundStyled.release();
+    m_personBox = cv::Rect2f();
+    m_keyframeStyled.release();
+    m_keyframeGray.release();
+    m_flow.release();
     m_modelLoaded = false;
+
+    if (m_segmenter) {
+        m_segmenter->Cleanup();
+        m_segmenter.reset();
+        m_segmenterReady = false;
+    }
     
     if (!m_net.empty()) {
         // Note: cv::dnn::Net doesn't have explicit cleanup, handled by destructor
-        std::cout << "[AnimeGANProcessor] Model released" << std::endl;
+        MS_LOG_INFO("[AnimeGANProcessor] Model released");
     }
 #endif
 }
@@ -142,39 +246,46 @@ Frame AnimeGANProcessor::ProcessFrame(const Frame& input)
     
 #ifdef HAVE_OPENCV
     if (!m_modelLoaded) {
-        std::cerr << "[AnimeGANProcessor] Model not loaded, returning original frame" << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] Model not loaded, returning original frame");
         return output;
     }
+
+    if (!m_pendingModelPath.empty()) {
+        // Style switch completes on the first frame after its background load
+        CheckPendingModel();
+    }
     
     if (input.data.empty()) {
         return output;
     }
     
     try {
-        // Run inference
-        cv::Mat animeResult = RunInference(input.data);
-        
+        cv::Mat animeResult;
+
+        if (m_keyframeMode) {
+            // Network on keyframes only, flow-warped output in between
+            animeResult = RunKeyframeTemporal(input.data);
+        } else if (m_netPool.IsRunning() && !m_personOnly) {
+            // Frame-parallel instances: the output is an earlier frame, so it
+            // carries that frame's timestamp
+            animeResult = RunInferencePooled(input.data, output.timestamp);
+        } else {
+            animeResult = StylizeFrame(input.data);
+        }
+
         if (animeResult.empty()) {
-            std::cerr << "[AnimeGANProcessor] Inference failed, returning original frame" << std::endl;
+            MS_LOG_ERROR("[AnimeGANProcessor] Inference failed, returning original frame");
             return output;
         }
         
-        // Blend with original if blend weight < 1.0
-        if (m_blendWeight < 1.0f) {
-            animeResult = BlendWithOriginal(input.data, animeResult);
-        }
-        
-        // Apply temporal stabilization
-        animeResult = StabilizeOutput(animeResult);
-        
         // Copy to output
         animeResult.copyTo(output.data);
         
     } catch (const cv::Exception& e) {
-        std::cerr << "[AnimeGANProcessor] OpenCV exception: " << e.what() << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] OpenCV exception: " << e.what());
         return input;  // Return original on error
     } catch (const std::exception& e) {
-        std::cerr << "[AnimeGANProcessor] Exception: " << e.what() << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] Exception: " << e.what());
         return input;
     }
 #endif
@@ -183,6 +294,13 @@ Frame AnimeGANProcessor::ProcessFrame(const Frame& input)
     m_processingTime = std::chrono::duration<double, std::milli>(endTime - startTime).count();
     
     m_frameCounter++;
+
+#ifdef HAVE_OPENCV
+    // Closed loop on the frame deadline: step the network input size along the ladder
+    if (m_resolutionController.Update(m_processingTime)) {
+        ApplyAdaptiveInputSize(m_resolutionController.GetCurrentSize());
+    }
+#endif
     
     // Log performance periodically with detailed GPU stats
     if (m_frameCounter % 100 == 0) {
@@ -190,16 +308,30 @@ Frame AnimeGANProcessor::ProcessFrame(const Frame& input)
                              m_target == cv::dnn::DNN_TARGET_CUDA ? "GPU-FP32" : "CPU";
         float fps = (m_processingTime > 0) ? (1000.0f / m_processingTime) : 0.0f;
         
-        std::cout << "[AnimeGANProcessor] Frame " << m_frameCounter 
+        MS_LOG_INFO("[AnimeGANProcessor] Frame " << m_frameCounter 
                   << " | Backend: " << backend
                   << " | Time: " << m_processingTime << "ms"
-                  << " | FPS: " << fps << std::endl;
+                  << " | FPS: " << fps);
+
+        if (m_keyframeMode) {
+            MS_LOG_INFO("[AnimeGANProcessor]   Keyframes: " << m_keyframeCount << "/100 frames"
+                      << " | Net: " << m_keyframeLatency << "ms"
+                      << " | Warp: " << m_warpTime << "ms"
+                      << " | Motion: " << m_lastMotion << "px");
+            m_keyframeCount = 0;
+        }
+
+        if (m_personOnly && m_segmenterReady) {
+            MS_LOG_INFO("[AnimeGANProcessor]   Person-only: segmentation " << m_segmentationTime << "ms"
+                      << " | Compute saved vs full frame: " << static_cast<int>(std::lround(m_computeSaving * 100.0)) << "%"
+                      << " | Background: " << (m_stylizeBackground ? "stylized every " + std::to_string(m_backgroundInterval) + " frames" : "passthrough"));
+        }
         
         // Show performance comparison
         if (m_target != cv::dnn::DNN_TARGET_CPU) {
             float estimatedCPUTime = m_processingTime * (m_target == cv::dnn::DNN_TARGET_CUDA_FP16 ? 7.5f : 4.0f);
-            std::cout << "[AnimeGANProcessor]   Estimated CPU time: " << estimatedCPUTime << "ms"
-                      << " | Speedup: " << (estimatedCPUTime / m_processingTime) << "x" << std::endl;
+            MS_LOG_INFO("[AnimeGANProcessor]   Estimated CPU time: " << estimatedCPUTime << "ms"
+                      << " | Speedup: " << (estimatedCPUTime / m_processingTime) << "x");
         }
     }
     
@@ -210,7 +342,7 @@ Frame AnimeGANProcessor::ProcessFrame(const Frame& input)
 
 bool AnimeGANProcessor::DetectGPUSupport()
 {
-    std::cout << "[AnimeGANProcessor] Detecting GPU support..." << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] Detecting GPU support...");
     
     try {
         // Check CUDA support
@@ -222,24 +354,24 @@ bool AnimeGANProcessor::DetectGPUSupport()
         for (const auto& target : cudaTargets) {
             if (target == cv::dnn::DNN_TARGET_CUDA) {
                 cudaAvailable = true;
-                std::cout << "[AnimeGANProcessor]   ✅ CUDA (FP32) available" << std::endl;
+                MS_LOG_INFO("[AnimeGANProcessor]   ✅ CUDA (FP32) available");
             }
             if (target == cv::dnn::DNN_TARGET_CUDA_FP16) {
                 fp16Available = true;
-                std::cout << "[AnimeGANProcessor]   ✅ CUDA FP16 (half-precision) available" << std::endl;
+                MS_LOG_INFO("[AnimeGANProcessor]   ✅ CUDA FP16 (half-precision) available");
             }
         }
         
         if (cudaAvailable || fp16Available) {
             // Get CUDA device count
             int cudaDeviceCount = cv::cuda::getCudaEnabledDeviceCount();
-            std::cout << "[AnimeGANProcessor]   CUDA devices: " << cudaDeviceCount << std::endl;
+            MS_LOG_INFO("[AnimeGANProcessor]   CUDA devices: " << cudaDeviceCount);
             
             if (cudaDeviceCount > 0) {
                 cv::cuda::DeviceInfo deviceInfo(0);
-                std::cout << "[AnimeGANProcessor]   Device 0: " << deviceInfo.name() << std::endl;
-                std::cout << "[AnimeGANProcessor]   Compute capability: " << deviceInfo.majorVersion() << "." << deviceInfo.minorVersion() << std::endl;
-                std::cout << "[AnimeGANProcessor]   Total memory: " << (deviceInfo.totalMemory() / (1024 * 1024)) << " MB" << std::endl;
+                MS_LOG_INFO("[AnimeGANProcessor]   Device 0: " << deviceInfo.name());
+                MS_LOG_INFO("[AnimeGANProcessor]   Compute capability: " << deviceInfo.majorVersion() << "." << deviceInfo.minorVersion());
+                MS_LOG_INFO("[AnimeGANProcessor]   Total memory: " << (deviceInfo.totalMemory() / (1024 * 1024)) << " MB");
             }
             
             return true;
@@ -249,27 +381,27 @@ bool AnimeGANProcessor::DetectGPUSupport()
         std::vector<cv::dnn::Target> openclTargets = cv::dnn::getAvailableTargets(cv::dnn::DNN_BACKEND_OPENCV);
         for (const auto& target : openclTargets) {
             if (target == cv::dnn::DNN_TARGET_OPENCL || target == cv::dnn::DNN_TARGET_OPENCL_FP16) {
-                std::cout << "[AnimeGANProcessor]   ⚠️  OpenCL available (slower than CUDA)" << std::endl;
+                MS_LOG_INFO("[AnimeGANProcessor]   ⚠️  OpenCL available (slower than CUDA)");
                 // Don't use OpenCL for now, prefer CUDA or CPU
                 break;
             }
         }
         
-        std::cout << "[AnimeGANProcessor]   ❌ No GPU support detected - using CPU" << std::endl;
-        std::cout << "[AnimeGANProcessor]   💡 To enable GPU:" << std::endl;
-        std::cout << "[AnimeGANProcessor]      1. Install NVIDIA GPU with CUDA support" << std::endl;
-        std::cout << "[AnimeGANProcessor]      2. Install CUDA Toolkit (11.0 or later)" << std::endl;
-        std::cout << "[AnimeGANProcessor]      3. Rebuild OpenCV with CUDA support" << std::endl;
+        MS_LOG_INFO("[AnimeGANProcessor]   ❌ No GPU support detected - using CPU");
+        MS_LOG_INFO("[AnimeGANProcessor]   💡 To enable GPU:");
+        MS_LOG_INFO("[AnimeGANProcessor]      1. Install NVIDIA GPU with CUDA support");
+        MS_LOG_INFO("[AnimeGANProcessor]      2. Install CUDA Toolkit (11.0 or later)");
+        MS_LOG_INFO("[AnimeGANProcessor]      3. Rebuild OpenCV with CUDA support");
         
         return false;
         
     } catch (const cv::Exception& e) {
-        std::cerr << "[AnimeGANProcessor] Error detecting GPU: " << e.what() << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] Error detecting GPU: " << e.what());
         return false;
     }
 }
 
-cv::Mat AnimeGANProcessor::PreprocessFrame(const cv::Mat& input)
+cv::Mat AnimeGANProcessor::PreprocessFrame(const cv::Mat& input, const cv::Size& netSize)
 {
     if (input.empty()) {
         return cv::Mat();
@@ -278,7 +410,7 @@ cv::Mat AnimeGANProcessor::PreprocessFrame(const cv::Mat& input)
     cv::Mat processed;
     
     // Resize to model input size
-    cv::resize(input, processed, cv::Size(m_inputWidth, m_inputHeight), 0, 0, cv::INTER_LINEAR);
+    cv::resize(input, processed, netSize, 0, 0, cv::INTER_LINEAR);
     
     // Convert BGR to RGB (most models expect RGB)
     cv::cvtColor(processed, processed, cv::COLOR_BGR2RGB);
@@ -321,7 +453,15 @@ cv::Mat AnimeGANProcessor::PostprocessFrame(const cv::Mat& output, const cv::Siz
 
 cv::Mat AnimeGANProcessor::RunInference(const cv::Mat& input)
 {
-    if (input.empty() || !m_modelLoaded) {
+    if (!m_inference || !m_modelLoaded) {
+        return cv::Mat();
+    }
+    return RunInferenceOn(*m_inference, input, cv::Size(m_inputWidth, m_inputHeight));
+}
+
+cv::Mat AnimeGANProcessor::RunInferenceOn(InferenceBackend& backend, const cv::Mat& input, const cv::Size& netSize)
+{
+    if (input.empty()) {
         return cv::Mat();
     }
     
@@ -329,7 +469,7 @@ cv::Mat AnimeGANProcessor::RunInference(const cv::Mat& input)
     cv::Size originalSize = input.size();
     
     // Preprocess
-    cv::Mat preprocessed = PreprocessFrame(input);
+    cv::Mat preprocessed = PreprocessFrame(input, netSize);
     if (preprocessed.empty()) {
         return cv::Mat();
     }
@@ -338,11 +478,11 @@ cv::Mat AnimeGANProcessor::RunInference(const cv::Mat& input)
     cv::Mat blob = cv::dnn::blobFromImage(preprocessed, 1.0, preprocessed.size(), 
                                           cv::Scalar(), false, false, CV_32F);
     
-    // Set input
-    m_net.setInput(blob);
-    
     // Run forward pass
-    cv::Mat output = m_net.forward();
+    cv::Mat output;
+    if (!backend.Run(blob, output)) {
+        return cv::Mat();
+    }
     
     // Extract image from blob (assuming output is [1, C, H, W])
     std::vector<cv::Mat> channels;
@@ -372,6 +512,728 @@ cv::Mat AnimeGANProcessor::RunInference(const cv::Mat& input)
     return result;
 }
 
+void AnimeGANProcessor::BuildResampleTable(int srcLength, int dstLength, ResampleTable& table)
+{
+    if (table.srcLength == srcLength && table.dstLength == dstLength) {
+        return;
+    }
+
+    // Same sampling grid as cv::resize INTER_LINEAR (pixel centers aligned)
+    table.srcLength = srcLength;
+    table.dstLength = dstLength;
+    table.index0.resize(dstLength);
+    table.index1.resize(dstLength);
+    table.weight.resize(dstLength);
+
+    double scale = static_cast<double>(srcLength) / dstLength;
+    for (int i = 0; i < dstLength; ++i) {
+        double src = std::max(0.0, (i + 0.5) * scale - 0.5);
+        int i0 = std::min(static_cast<int>(src), srcLength - 1);
+        table.index0[i] = i0;
+        table.index1[i] = std::min(i0 + 1, srcLength - 1);
+        table.weight[i] = static_cast<float>(src - i0);
+    }
+}
+
+void AnimeGANProcessor::FusedPreprocess(const cv::Mat& input, int netWidth, int netHeight)
+{
+    // resize + BGR->RGB + [-1, 1] normalization + HWC->CHW in one pass,
+    // written straight into the persistent network input blob
+    int blobShape[] = {1, 3, netHeight, netWidth};
+    m_inputBlob.create(4, blobShape, CV_32F);
+
+    BuildResampleTable(input.cols, netWidth, m_preX);
+    BuildResampleTable(input.rows, netHeight, m_preY);
+
+    const int planeSize = netWidth * netHeight;
+    float* red = m_inputBlob.ptr<float>();
+    float* green = red + planeSize;
+    float* blue = green + planeSize;
+
+    cv::parallel_for_(cv::Range(0, netHeight), [&](const cv::Range& range) {
+        const float norm = 1.0f / 127.5f;
+        for (int y = range.start; y < range.end; ++y) {
+            const cv::Vec3b* row0 = input.ptr<cv::Vec3b>(m_preY.index0[y]);
+            const cv::Vec3b* row1 = input.ptr<cv::Vec3b>(m_preY.index1[y]);
+            float wy = m_preY.weight[y];
+            int offset = y * netWidth;
+
+            for (int x = 0; x < netWidth; ++x) {
+                int x0 = m_preX.index0[x];
+                int x1 = m_preX.index1[x];
+                float wx = m_preX.weight[x];
+
+                float v[3];
+                for (int c = 0; c < 3; ++c) {
+                    float top = row0[x0][c] + (row0[x1][c] - row0[x0][c]) * wx;
+                    float bottom = row1[x0][c] + (row1[x1][c] - row1[x0][c]) * wx;
+                    v[c] = (top + (bottom - top) * wy) * norm - 1.0f;
+                }
+
+                blue[offset + x] = v[0];
+                green[offset + x] = v[1];
+                red[offset + x] = v[2];
+            }
+        }
+    });
+}
+
+void AnimeGANProcessor::FusedPostprocess(const cv::Mat& output, const cv::Mat& original, cv::Mat& dst,
+                                         bool temporal)
+{
+    const int outH = output.size[2];
+    const int outW = output.size[3];
+    const int planeSize = outH * outW;
+    const float* red = output.ptr<float>();
+    const float* green = red + planeSize;
+    const float* blue = green + planeSize;
+
+    BuildResampleTable(outW, original.cols, m_postX);
+    BuildResampleTable(outH, original.rows, m_postY);
+
+    // With temporal mixing, dst holds the previous output and is read and
+    // replaced in the same pass
+    temporal = temporal && !dst.empty() && dst.size() == original.size() && dst.type() == CV_8UC3;
+    if (!temporal) {
+        dst.create(original.size(), CV_8UC3);
+    }
+
+    const float blend = m_blendWeight;
+    const float temporalWeight = temporal ? m_temporalBlendWeight : 1.0f;
+
+    cv::parallel_for_(cv::Range(0, original.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            int r0 = m_postY.index0[y] * outW;
+            int r1 = m_postY.index1[y] * outW;
+            float wy = m_postY.weight[y];
+            const cv::Vec3b* orig = original.ptr<cv::Vec3b>(y);
+            cv::Vec3b* out = dst.ptr<cv::Vec3b>(y);
+
+            for (int x = 0; x < original.cols; ++x) {
+                int x0 = m_postX.index0[x];
+                int x1 = m_postX.index1[x];
+                float wx = m_postX.weight[x];
+
+                // BGR order: read the RGB planes in reverse
+                const float* planes[3] = {blue, green, red};
+                for (int c = 0; c < 3; ++c) {
+                    const float* p = planes[c];
+                    float top = p[r0 + x0] + (p[r0 + x1] - p[r0 + x0]) * wx;
+                    float bottom = p[r1 + x0] + (p[r1 + x1] - p[r1 + x0]) * wx;
+                    float v = (top + (bottom - top) * wy + 1.0f) * 127.5f;
+                    v = std::max(0.0f, std::min(255.0f, v));
+
+                    v = v * blend + orig[x][c] * (1.0f - blend);
+                    v = v * temporalWeight + out[x][c] * (1.0f - temporalWeight);
+                    out[x][c] = cv::saturate_cast<uchar>(v);
+                }
+            }
+        }
+    });
+}
+
+bool AnimeGANProcessor::StylizeFused(const cv::Mat& input, const cv::Size& netSize, cv::Mat& dst, bool temporal)
+{
+    // Static-shape models take their export size whatever was asked for
+    cv::Size fixedSize = m_inference ? m_inference->GetFixedInputSize() : cv::Size();
+    cv::Size size = fixedSize.area() > 0 ? fixedSize : netSize;
+
+    FusedPreprocess(input, size.width, size.height);
+    cv::Mat output;
+    if (!m_inference || !m_inference->Run(m_inputBlob, output)) {
+        return false;
+    }
+
+    if (output.dims != 4 || output.size[1] != 3 || output.type() != CV_32F) {
+        return false;
+    }
+
+    FusedPostprocess(output, input, dst, temporal);
+    return true;
+}
+
+cv::Mat AnimeGANProcessor::RunInferenceFused(const cv::Mat& input)
+{
+    if (input.empty() || !m_modelLoaded || input.type() != CV_8UC3) {
+        return cv::Mat();
+    }
+
+    if (!StylizeFused(input, cv::Size(m_inputWidth, m_inputHeight), m_previousOutput, true)) {
+        // Unexpected output layout - use the generic path for this frame
+        cv::Mat result = RunInference(input);
+        if (!result.empty() && m_blendWeight < 1.0f) {
+            result = BlendWithOriginal(input, result, m_blendWeight);
+        }
+        return result.empty() ? result : StabilizeOutput(result);
+    }
+
+    return m_previousOutput;
+}
+
+cv::Mat AnimeGANProcessor::StylizeFrame(const cv::Mat& input)
+{
+    if (m_personOnly && EnsureSegmenter()) {
+        // Style net only sees the person crop; background is composited around it
+        return RunInferencePerson(input);
+    }
+
+    if (m_useFusedPipeline) {
+        // Blend and temporal stabilization are folded into the post-processing pass
+        return RunInferenceFused(input);
+    }
+
+    // Run inference
+    cv::Mat animeResult = RunInference(input);
+
+    if (!animeResult.empty()) {
+        // Blend with original if blend weight < 1.0
+        if (m_blendWeight < 1.0f) {
+            animeResult = BlendWithOriginal(input, animeResult, m_blendWeight);
+        }
+
+        // Apply temporal stabilization
+        animeResult = StabilizeOutput(animeResult);
+    }
+
+    return animeResult;
+}
+
+void AnimeGANProcessor::StartModelCache()
+{
+    // The active model is the first entry; the rest load in the background
+    m_modelCache.SetMemoryBudget(m_modelCacheBudgetMB * 1024 * 1024);
+    m_modelCache.Insert(m_modelPath, m_inference, StyleModelCache::ReadModelFile(m_modelPath));
+    m_modelCache.Start(MakeModelLoader(), m_inputWidth, m_inputHeight);
+
+    for (const auto& path : m_preloadModels) {
+        if (path != m_modelPath) {
+            m_modelCache.Preload(path);
+        }
+    }
+}
+
+StyleModelCache::Loader AnimeGANProcessor::MakeModelLoader() const
+{
+    ModelLoadSettings settings;
+    settings.backendChoice = m_backendChoice;
+    settings.threadsPerInstance = m_threadsPerInstance;
+    settings.backend = m_backend;
+    settings.target = m_target;
+    settings.poolInstances = m_netInstances;
+    settings.warmupSize = cv::Size(m_inputWidth, m_inputHeight);
+
+    return [settings](const std::string& path, const StyleModelCache::ModelBytes& bytes) {
+        return LoadCachedModel(path, bytes, settings);
+    };
+}
+
+std::shared_ptr<InferenceBackend> AnimeGANProcessor::LoadCachedModel(const std::string& path,
+                                                                     const StyleModelCache::ModelBytes& bytes,
+                                                                     const ModelLoadSettings& settings)
+{
+    // Runs on the cache thread. Engine selection follows Initialize, and
+    // OpenCV DNN nets get the backend/target Initialize settled on.
+    InferenceBackend::Type type = settings.backendChoice == InferenceBackend::AUTO ? InferenceBackend::DetectType(path)
+                                                                                    : settings.backendChoice;
+#ifdef HAVE_ONNX
+    if (type == InferenceBackend::ORT_CPU) {
+        auto backend = std::make_shared<OrtCpuBackend>(settings.threadsPerInstance);
+        if (!backend->LoadFromMemory(*bytes, path)) {
+            return nullptr;
+        }
+        return backend;
+    }
+#else
+    if (type == InferenceBackend::ORT_CPU) {
+        type = InferenceBackend::OPENCV_ONNX;
+    }
+#endif
+
+    cv::dnn::Net net = OpenCVDnnBackend::ReadNet(path, type, bytes.get());
+    if (net.empty()) {
+        return nullptr;
+    }
+    net.setPreferableBackend(settings.backend);
+    net.setPreferableTarget(settings.target);
+    auto backend = std::make_shared<OpenCVDnnBackend>(net, type);
+
+    // Net pool instances are built (and warmed up) here too, so a style
+    // switch with net_instances > 1 only swaps them in
+    if (settings.poolInstances > 1) {
+        int blobShape[] = {1, 3, settings.warmupSize.height, settings.warmupSize.width};
+        cv::Mat dummy(4, blobShape, CV_32F, cv::Scalar(0));
+        std::vector<cv::dnn::Net> instances;
+        for (int i = 0; i < settings.poolInstances; ++i) {
+            cv::dnn::Net instance = OpenCVDnnBackend::ReadNet(path, type, bytes.get());
+            if (instance.empty()) {
+                return nullptr;
+            }
+            instance.setPreferableBackend(settings.backend);
+            instance.setPreferableTarget(settings.target);
+            instance.setInput(dummy);
+            instance.forward();
+            instances.push_back(instance);
+        }
+        backend->SetPoolInstances(instances);
+    }
+    return backend;
+}
+
+void AnimeGANProcessor::CheckPendingModel()
+{
+    std::shared_ptr<InferenceBackend> backend = m_modelCache.Get(m_pendingModelPath);
+    if (backend) {
+        ActivateModel(m_pendingModelPath, backend);
+        m_pendingModelPath.clear();
+    } else if (m_modelCache.HasFailed(m_pendingModelPath)) {
+        MS_LOG_ERROR("[AnimeGANProcessor] Could not load style " << m_pendingModelPath
+                  << ", keeping " << m_modelPath);
+        m_pendingModelPath.clear();
+    }
+}
+
+void AnimeGANProcessor::ActivateModel(const std::string& path, const std::shared_ptr<InferenceBackend>& backend)
+{
+    m_inference = backend;
+    m_backendType = backend->GetType();
+    if (auto* dnn = dynamic_cast<OpenCVDnnBackend*>(backend.get())) {
+        m_net = dnn->GetNet();
+    }
+
+    cv::Size fixedSize = backend->GetFixedInputSize();
+    if (fixedSize.area() > 0) {
+        m_inputWidth = fixedSize.width;
+        m_inputHeight = fixedSize.height;
+    }
+
+    UpdateAdaptiveForModel();
+
+    m_modelPath = path;
+
+    // Warped keyframes hold the old style
+    m_keyframeStyled.release();
+
+    if (m_netInstances > 1) {
+        // Pool instances are per model; cached models bring theirs along
+        StartNetPool();
+    }
+
+    MS_LOG_INFO("[AnimeGANProcessor] Switched style to: " << path);
+}
+
+bool AnimeGANProcessor::StartNetPool()
+{
+    m_netPool.Stop();
+    if (m_backendType == InferenceBackend::ORT_CPU) {
+        // ONNX Runtime parallelizes inside the session; size it with threads_per_instance
+        MS_LOG_INFO("[AnimeGANProcessor] Net instances apply to OpenCV DNN engines only");
+        return false;
+    }
+
+    // Instances built on the cache thread with the model are used as they
+    // are; otherwise (initial start, net_instances changed) they are loaded
+    // here and kept with the model for the next switch back to it
+    auto* dnn = dynamic_cast<OpenCVDnnBackend*>(m_inference.get());
+    std::vector<cv::dnn::Net> nets;
+    if (dnn && static_cast<int>(dnn->GetPoolInstances().size()) == m_netInstances) {
+        nets = dnn->GetPoolInstances();
+    } else {
+        // Every instance gets the same model and backend as the primary net
+        // ONNX instances parse the model bytes already held by the style cache
+        StyleModelCache::ModelBytes bytes = m_modelCache.GetBytes(m_modelPath);
+        try {
+            for (int i = 0; i < m_netInstances; ++i) {
+                cv::dnn::Net net = OpenCVDnnBackend::ReadNet(m_modelPath, m_backendType, bytes.get());
+                if (net.empty()) {
+                    MS_LOG_ERROR("[AnimeGANProcessor] Net pool unavailable, using a single instance");
+                    return false;
+                }
+                net.setPreferableBackend(m_backend);
+                net.setPreferableTarget(m_target);
+                nets.push_back(net);
+            }
+        } catch (const cv::Exception& e) {
+            MS_LOG_ERROR("[AnimeGANProcessor] Net pool failed to load model: " << e.what());
+            return false;
+        }
+        if (dnn) {
+            dnn->SetPoolInstances(nets);
+        }
+    }
+
+    if (!m_netPool.Start(nets)) {
+        MS_LOG_ERROR("[AnimeGANProcessor] Net pool unavailable, using a single instance");
+        return false;
+    }
+    return true;
+}
+
+cv::Mat AnimeGANProcessor::RunInferencePooled(const cv::Mat& input, double& timestamp)
+{
+    // Blend runs on the worker; temporal stabilization needs frame order and
+    // runs after the reorder buffer. The job carries this frame's settings,
+    // so workers never read members the frame thread may be changing.
+    InferenceBackend::Type type = m_backendType;
+    cv::Size netSize(m_inputWidth, m_inputHeight);
+    float blendWeight = m_blendWeight;
+    auto job = [type, netSize, blendWeight](cv::dnn::Net& net, const cv::Mat& frame) {
+        OpenCVDnnBackend backend(net, type);
+        cv::Mat result = RunInferenceOn(backend, frame, netSize);
+        if (!result.empty() && blendWeight < 1.0f) {
+            result = BlendWithOriginal(frame, result, blendWeight);
+        }
+        return result;
+    };
+
+    // The pool keeps the frame until its instance is done, and camera buffers
+    // are reused, so it gets its own copy
+    m_netPool.Submit(input.clone(), timestamp, job);
+
+    // Submit blocked until this instance's previous frame finished, so the
+    // oldest frame in flight is normally ready here. Until there is a styled
+    // frame to hold (pool start, size change) wait for it, so the stream
+    // never flashes the unstyled camera image.
+    const bool haveStyled = !m_previousOutput.empty() && m_previousOutput.size() == input.size();
+    cv::Mat styled;
+    double styledTimestamp = 0.0;
+    if (!m_netPool.Pop(styled, styledTimestamp, !haveStyled)) {
+        // Pipeline still filling: hold the last styled output rather than stall
+        return haveStyled ? m_previousOutput.clone() : cv::Mat();
+    }
+
+    if (styled.empty()) {
+        return styled;
+    }
+
+    timestamp = styledTimestamp;
+    return StabilizeOutput(styled);
+}
+
+cv::Mat AnimeGANProcessor::RunKeyframeTemporal(const cv::Mat& input)
+{
+    if (input.empty() || input.type() != CV_8UC3) {
+        return cv::Mat();
+    }
+
+    // Flow runs on a small grayscale copy; its cost is independent of the
+    // camera resolution
+    const int flowWidth = std::min(input.cols, 160);
+    m_flowScale = static_cast<float>(flowWidth) / input.cols;
+    cv::Size flowSize(flowWidth, std::max(1, cvRound(input.rows * m_flowScale)));
+    cv::Mat small, gray;
+    cv::resize(input, small, flowSize, 0, 0, cv::INTER_AREA);
+    cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+
+    const float q = m_keyframeQuality;
+    const double frameBudget = 1000.0 / m_targetFPS;
+
+    bool haveKeyframe = !m_keyframeStyled.empty() && m_keyframeStyled.size() == input.size() &&
+                        m_keyframeGray.size() == gray.size();
+    bool keyframe = !haveKeyframe || q >= 1.0f;
+    cv::Mat warped;
+
+    if (!keyframe) {
+        auto warpStart = std::chrono::high_resolution_clock::now();
+
+        // Backward flow: for every current pixel, where it was in the keyframe.
+        // The flow from the previous frame is a good initial guess since both
+        // are measured against the same keyframe.
+        int flags = m_flow.size() == gray.size() ? cv::OPTFLOW_USE_INITIAL_FLOW : 0;
+        cv::calcOpticalFlowFarneback(gray, m_keyframeGray, m_flow, 0.5, 3, 11, 3, 5, 1.1, flags);
+
+        // Photometric occlusion test: where the warped keyframe does not match
+        // the current frame, the flow has nothing valid to carry
+        cv::Mat lowMap(m_flow.size(), CV_32FC2);
+        for (int y = 0; y < m_flow.rows; ++y) {
+            const cv::Point2f* f = m_flow.ptr<cv::Point2f>(y);
+            cv::Point2f* m = lowMap.ptr<cv::Point2f>(y);
+            for (int x = 0; x < m_flow.cols; ++x) {
+                m[x] = cv::Point2f(x + f[x].x, y + f[x].y);
+            }
+        }
+        cv::Mat warpedGray, difference;
+        cv::remap(m_keyframeGray, warpedGray, lowMap, cv::noArray(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+        cv::absdiff(warpedGray, gray, difference);
+        cv::threshold(difference, m_occlusion, 24, 1.0, cv::THRESH_BINARY);
+        m_occlusion.convertTo(m_occlusion, CV_32F);
+        double occludedFraction = cv::mean(m_occlusion)[0];
+        cv::GaussianBlur(m_occlusion, m_occlusion, cv::Size(5, 5), 0);
+
+        cv::Mat magnitude;
+        std::vector<cv::Mat> components;
+        cv::split(m_flow, components);
+        cv::magnitude(components[0], components[1], magnitude);
+        m_lastMotion = cv::mean(magnitude)[0] / m_flowScale;
+
+        // One knob: q = 0 warps as long as the measured net latency demands,
+        // q = 1 runs the network on every frame. Between keyframes the output
+        // must average out to the frame budget, so (L + (N-1)W) / N <= budget.
+        int latencyInterval = 1;
+        if (m_keyframeLatency > frameBudget && m_warpTime < frameBudget) {
+            latencyInterval = static_cast<int>(std::ceil((m_keyframeLatency - m_warpTime) / (frameBudget - m_warpTime)));
+        }
+        int minInterval = std::max(1, static_cast<int>(std::lround(latencyInterval * (1.0f - q))));
+        int maxInterval = std::max(minInterval, static_cast<int>(std::lround(1.0f + 11.0f * (1.0f - q))));
+        double motionLimit = 0.5 + 7.5 * (1.0 - q);        // Mean displacement, full-res pixels
+        double occlusionLimit = 0.02 + 0.2 * (1.0 - q);    // Fraction of pixels
+
+        m_framesSinceKeyframe++;
+        keyframe = m_framesSinceKeyframe >= maxInterval ||
+                   (m_framesSinceKeyframe >= minInterval &&
+                    (m_lastMotion > motionLimit || occludedFraction > occlusionLimit));
+
+        warped = WarpKeyframe(input);
+
+        auto warpEnd = std::chrono::high_resolution_clock::now();
+        double warpMs = std::chrono::duration<double, std::milli>(warpEnd - warpStart).count();
+        m_warpTime = m_warpTime > 0.0 ? m_warpTime * 0.9 + warpMs * 0.1 : warpMs;
+    }
+
+    if (!keyframe) {
+        // Keep the temporal history motion-compensated for when the network runs again
+        warped.copyTo(m_previousOutput);
+        return warped;
+    }
+
+    // Cross-fade the new keyframe against the warped estimate rather than the
+    // unaligned previous output, so stabilization no longer ghosts on motion
+    if (!warped.empty()) {
+        warped.copyTo(m_previousOutput);
+    }
+
+    auto netStart = std::chrono::high_resolution_clock::now();
+    cv::Mat result = StylizeFrame(input);
+    auto netEnd = std::chrono::high_resolution_clock::now();
+    double netMs = std::chrono::duration<double, std::milli>(netEnd - netStart).count();
+    m_keyframeLatency = m_keyframeLatency > 0.0 ? m_keyframeLatency * 0.8 + netMs * 0.2 : netMs;
+
+    if (result.empty()) {
+        return result;
+    }
+
+    result.copyTo(m_keyframeStyled);
+    gray.copyTo(m_keyframeGray);
+    m_flow.release();
+    m_framesSinceKeyframe = 0;
+    m_keyframeCount++;
+    return result;
+}
+
+cv::Mat AnimeGANProcessor::WarpKeyframe(const cv::Mat& input)
+{
+    // Upsample the low-res flow into an absolute sampling map and the
+    // occlusion weight to full resolution
+    cv::Mat flow, occlusion;
+    cv::resize(m_flow, flow, input.size(), 0, 0, cv::INTER_LINEAR);
+    cv::resize(m_occlusion, occlusion, input.size(), 0, 0, cv::INTER_LINEAR);
+
+    m_warpMap.create(input.size(), CV_32FC2);
+    const float inv = 1.0f / m_flowScale;
+    cv::parallel_for_(cv::Range(0, input.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            const cv::Point2f* f = flow.ptr<cv::Point2f>(y);
+            cv::Point2f* m = m_warpMap.ptr<cv::Point2f>(y);
+            for (int x = 0; x < input.cols; ++x) {
+                m[x] = cv::Point2f(x + f[x].x * inv, y + f[x].y * inv);
+            }
+        }
+    });
+
+    cv::Mat warped;
+    cv::remap(m_keyframeStyled, warped, m_warpMap, cv::noArray(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+
+    // Occluded/disoccluded areas fall back to the camera frame, blended the
+    // same way the stylized output is blended with the original
+    cv::parallel_for_(cv::Range(0, input.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            const float* o = occlusion.ptr<float>(y);
+            const cv::Vec3b* src = input.ptr<cv::Vec3b>(y);
+            cv::Vec3b* dst = warped.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < input.cols; ++x) {
+                float w = o[x];
+                if (w <= 0.0f) {
+                    continue;
+                }
+                for (int c = 0; c < 3; ++c) {
+                    dst[x][c] = cv::saturate_cast<uchar>(dst[x][c] * (1.0f - w) + src[x][c] * w);
+                }
+            }
+        }
+    });
+
+    return warped;
+}
+
+void AnimeGANProcessor::ApplyAdaptiveInputSize(int size)
+{
+    if (size <= 0 || (size == m_inputWidth && size == m_inputHeight)) {
+        return;
+    }
+
+    // Ladder sizes are square network inputs; the fused resample tables and
+    // blob follow the new size on the next frame
+    MS_LOG_INFO("[AnimeGANProcessor] Input size " << m_inputWidth << "x" << m_inputHeight << " -> "
+              << size << "x" << size << " (smoothed " << m_resolutionController.GetSmoothedLatency()
+              << "ms, budget " << m_resolutionController.GetBudget() << "ms)");
+    m_inputWidth = size;
+    m_inputHeight = size;
+}
+
+void AnimeGANProcessor::UpdateAdaptiveForModel()
+{
+    bool fixed = m_inference && m_inference->GetFixedInputSize().area() > 0;
+    bool enabled = m_adaptiveRequested && !fixed;
+    if (enabled == m_resolutionController.IsEnabled()) {
+        return;
+    }
+
+    if (!enabled) {
+        MS_LOG_INFO("[AnimeGANProcessor] Model has a fixed input size, adaptive resolution suspended");
+        m_resolutionController.SetEnabled(false);
+        return;
+    }
+
+    MS_LOG_INFO("[AnimeGANProcessor] Model accepts any input size, adaptive resolution resumed");
+    m_resolutionController.SetCurrentSize(std::max(m_inputWidth, m_inputHeight));
+    m_resolutionController.SetEnabled(true);
+    m_resolutionController.ResetStats();
+    ApplyAdaptiveInputSize(m_resolutionController.GetCurrentSize());
+}
+
+bool AnimeGANProcessor::EnsureSegmenter()
+{
+    if (m_segmenterReady) {
+        return true;
+    }
+    if (m_segmenter) {
+        // Initialization already failed once - stay on the full-frame path
+        return false;
+    }
+
+    m_segmenter = std::make_unique<VirtualBackgroundProcessor>();
+    m_segmenterReady = m_segmenter->Initialize();
+    if (!m_segmenterReady) {
+        MS_LOG_ERROR("[AnimeGANProcessor] Person segmentation unavailable, stylizing full frame");
+    }
+    return m_segmenterReady;
+}
+
+cv::Size AnimeGANProcessor::FitNetSize(const cv::Size& region, int pixelBudget)
+{
+    // Match the region aspect ratio within the pixel budget, never upsampling
+    // past the region itself. Dimensions snap to multiples of 32 so a drifting
+    // box does not reshape the network every frame.
+    double aspect = static_cast<double>(region.width) / std::max(1, region.height);
+    double budget = std::min(static_cast<double>(pixelBudget), static_cast<double>(region.area()));
+    double width = std::sqrt(budget * aspect);
+    double height = budget / std::max(1.0, width);
+
+    auto snap = [](double v) { return std::max(64, static_cast<int>(std::lround(v / 32.0)) * 32); };
+    return cv::Size(snap(width), snap(height));
+}
+
+cv::Mat AnimeGANProcessor::RunInferencePerson(const cv::Mat& input)
+{
+    if (input.empty() || !m_modelLoaded || input.type() != CV_8UC3) {
+        return cv::Mat();
+    }
+
+    auto segStart = std::chrono::high_resolution_clock::now();
+    cv::Mat mask = m_segmenter->ComputePersonMask(input);
+    auto segEnd = std::chrono::high_resolution_clock::now();
+    m_segmentationTime = std::chrono::duration<double, std::milli>(segEnd - segStart).count();
+
+    cv::Rect bounds(0, 0, input.cols, input.rows);
+    cv::Rect person;
+    if (!mask.empty() && mask.size() == input.size()) {
+        person = cv::boundingRect(mask > 127);
+    }
+    if (person.area() <= 0) {
+        // Nobody in view - nothing worth the style net beyond the full frame
+        return RunInferenceFused(input);
+    }
+
+    // Pad so hair/shoulders cut by the mask edge still get stylized, then
+    // smooth the box so the crop (and net size) does not jitter
+    float padX = person.width * 0.1f;
+    float padY = person.height * 0.1f;
+    cv::Rect2f target(person.x - padX, person.y - padY, person.width + 2 * padX, person.height + 2 * padY);
+    if (m_personBox.area() <= 0.0f) {
+        m_personBox = target;
+    } else {
+        const float alpha = 0.3f;
+        m_personBox.x += alpha * (target.x - m_personBox.x);
+        m_personBox.y += alpha * (target.y - m_personBox.y);
+        m_personBox.width += alpha * (target.width - m_personBox.width);
+        m_personBox.height += alpha * (target.height - m_personBox.height);
+    }
+
+    cv::Rect crop = cv::Rect(m_personBox) & bounds;
+    if (crop.area() <= 0) {
+        return RunInferenceFused(input);
+    }
+
+    const int pixelBudget = m_inputWidth * m_inputHeight;
+    cv::Size personNet = FitNetSize(crop.size(), pixelBudget);
+    auto personStart = std::chrono::high_resolution_clock::now();
+    if (!StylizeFused(input(crop), personNet, m_personStyled, false)) {
+        return RunInferenceFused(input);
+    }
+    double personMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - personStart).count();
+
+    // Background: the camera frame itself, or a low-res stylization that is
+    // refreshed only every m_backgroundInterval frames
+    double backgroundNetPixels = 0.0;
+    const cv::Mat* background = &input;
+    if (m_stylizeBackground) {
+        cv::Size backgroundNet = FitNetSize(
+            cv::Size(static_cast<int>(input.cols * m_backgroundScale), static_cast<int>(input.rows * m_backgroundScale)),
+            pixelBudget);
+        if (m_backgroundStyled.size() != input.size() || ++m_backgroundAge >= static_cast<uint64_t>(m_backgroundInterval)) {
+            if (StylizeFused(input, backgroundNet, m_backgroundStyled, false)) {
+                m_backgroundAge = 0;
+            } else {
+                m_backgroundStyled.release();
+            }
+        }
+        if (!m_backgroundStyled.empty()) {
+            background = &m_backgroundStyled;
+            backgroundNetPixels = static_cast<double>(backgroundNet.area()) / m_backgroundInterval;
+        }
+    }
+
+    // Composite the stylized person over the background using the soft mask
+    cv::Mat composite = background->clone();
+    for (int y = 0; y < crop.height; ++y) {
+        const uchar* alphaRow = mask.ptr<uchar>(crop.y + y) + crop.x;
+        const cv::Vec3b* styledRow = m_personStyled.ptr<cv::Vec3b>(y);
+        cv::Vec3b* dstRow = composite.ptr<cv::Vec3b>(crop.y + y) + crop.x;
+        for (int x = 0; x < crop.width; ++x) {
+            int a = alphaRow[x];
+            if (a == 0) {
+                continue;
+            }
+            for (int c = 0; c < 3; ++c) {
+                dstRow[x][c] = static_cast<uchar>((styledRow[x][c] * a + dstRow[x][c] * (255 - a) + 127) / 255);
+            }
+        }
+    }
+
+    // Compute saving vs the full-frame path (one style net run at
+    // m_inputWidth x m_inputHeight), estimated in milliseconds from this
+    // frame's style net cost per net pixel. The segmentation pass counts
+    // against the saving; negative means person mode cost more.
+    double personNetPixels = static_cast<double>(personNet.area());
+    double msPerNetPixel = personMs / personNetPixels;
+    double fullFrameMs = msPerNetPixel * pixelBudget;
+    double personModeMs = m_segmentationTime + msPerNetPixel * (personNetPixels + backgroundNetPixels);
+    double saving = fullFrameMs > 0.0 ? 1.0 - personModeMs / fullFrameMs : 0.0;
+    m_computeSaving = m_computeSaving * 0.9 + saving * 0.1;
+
+    return StabilizeOutput(composite);
+}
+
 cv::Mat AnimeGANProcessor::StabilizeOutput(const cv::Mat& current)
 {
     if (current.empty()) {
@@ -396,7 +1258,7 @@ cv::Mat AnimeGANProcessor::StabilizeOutput(const cv::Mat& current)
     return stabilized;
 }
 
-cv::Mat AnimeGANProcessor::BlendWithOriginal(const cv::Mat& original, const cv::Mat& anime)
+cv::Mat AnimeGANProcessor::BlendWithOriginal(const cv::Mat& original, const cv::Mat& anime, float blendWeight)
 {
     if (original.empty() || anime.empty()) {
         return anime.clone();
@@ -407,7 +1269,7 @@ cv::Mat AnimeGANProcessor::BlendWithOriginal(const cv::Mat& original, const cv::
     }
     
     cv::Mat blended;
-    cv::addWeighted(anime, m_blendWeight, original, 1.0f - m_blendWeight, 0, blended);
+    cv::addWeighted(anime, blendWeight, original, 1.0f - blendWeight, 0, blended);
     
     return blended;
 }
@@ -444,9 +1306,91 @@ bool AnimeGANProcessor::SetParameter(const std::string& name, const std::string&
             bool useFP16 = (value == "true" || value == "1" || value == "yes");
             SetUseFP16(useFP16);
             return true;
+        } else if (name == "fused_pipeline") {
+            SetUseFusedPipeline(value == "true" || value == "1" || value == "yes");
+            return true;
+        } else if (name == "temporal_mode") {
+            if (value != "blend" && value != "keyframe") {
+                return false;
+            }
+            SetKeyframeMode(value == "keyframe", m_keyframeQuality);
+            return true;
+        } else if (name == "keyframe_quality") {
+            SetKeyframeMode(m_keyframeMode, std::stof(value));
+            return true;
+        } else if (name == "target_fps") {
+            m_targetFPS = std::max(1.0, std::min(240.0, std::stod(value)));
+            m_resolutionController.SetBudget(1000.0 / m_targetFPS);
+            return true;
+        } else if (name == "frame_budget_ms") {
+            m_resolutionController.SetBudget(std::stod(value));
+            return true;
+        } else if (name == "adaptive_resolution") {
+            SetAdaptiveResolution(value == "true" || value == "1" || value == "yes");
+            return true;
+        } else if (name == "resolution_ladder") {
+            std::vector<int> sizes;
+            if (!ResolutionController::ParseLadder(value, sizes)) {
+                return false;
+            }
+            m_resolutionController.SetLadder(sizes);
+            return true;
+        } else if (name == "net_instances") {
+            SetNetInstances(std::stoi(value), m_threadsPerInstance);
+            return true;
+        } else if (name == "threads_per_instance") {
+            SetNetInstances(m_netInstances, std::stoi(value));
+            return true;
+        } else if (name == "preload_models") {
+            // Comma-separated model paths
+            std::vector<std::string> paths;
+            size_t start = 0;
+            while (start <= value.size()) {
+                size_t end = value.find(',', start);
+                if (end == std::string::npos) {
+                    end = value.size();
+                }
+                std::string path = value.substr(start, end - start);
+                path.erase(0, path.find_first_not_of(" \t"));
+                path.erase(path.find_last_not_of(" \t") + 1);
+                if (!path.empty()) {
+                    paths.push_back(path);
+                }
+                start = end + 1;
+            }
+            PreloadModels(paths);
+            return true;
+        } else if (name == "model_cache_mb") {
+            SetModelCacheBudget(static_cast<size_t>(std::max(0, std::stoi(value))));
+            return true;
+        } else if (name == "inference_backend") {
+            InferenceBackend::Type type;
+            if (!InferenceBackend::ParseType(value, type)) {
+                return false;
+            }
+            SetInferenceBackend(type);
+            return true;
+        } else if (name == "style_region") {
+            if (value != "full" && value != "person") {
+                return false;
+            }
+            SetPersonOnly(value == "person");
+            return true;
+        } else if (name == "background_style") {
+            if (value != "passthrough" && value != "stylized") {
+                return false;
+            }
+            SetBackgroundStyle(value == "stylized", m_backgroundInterval, m_backgroundScale);
+            return true;
+        } else if (name == "background_interval") {
+            SetBackgroundStyle(m_stylizeBackground, std::stoi(value), m_backgroundScale);
+            return true;
+        } else if (name == "background_scale") {
+            SetBackgroundStyle(m_stylizeBackground, m_backgroundInterval, std::stof(value));
+            return true;
         }
     } catch (const std::exception& e) {
-        std::cerr << "[AnimeGANProcessor] SetParameter error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[AnimeGANProcessor] SetParameter error: " << e.what());
         return false;
     }
     return false;
@@ -464,6 +1408,36 @@ std::map<std::string, std::string> AnimeGANProcessor::GetParameters() const
     params["use_gpu"] = m_useGPU ? "true" : "false";
     params["use_fp16"] = (m_useFP16 && m_target == cv::dnn::DNN_TARGET_CUDA_FP16) ? "true" : "false";
     params["model_loaded"] = m_modelLoaded ? "true" : "false";
+    params["fused_pipeline"] = m_useFusedPipeline ? "true" : "false";
+    params["temporal_mode"] = m_keyframeMode ? "keyframe" : "blend";
+    params["keyframe_quality"] = std::to_string(m_keyframeQuality);
+    params["target_fps"] = std::to_string(m_targetFPS);
+    params["adaptive_resolution"] = m_adaptiveRequested ? "true" : "false";
+    params["adaptive_resolution_active"] = m_resolutionController.IsEnabled() ? "true" : "false";
+    params["resolution_ladder"] = m_resolutionController.GetLadderString();
+    params["resolution_current"] = std::to_string(m_inputWidth) + "x" + std::to_string(m_inputHeight);
+    params["frame_budget_ms"] = std::to_string(m_resolutionController.GetBudget());
+    params["deadline_misses"] = std::to_string(m_resolutionController.GetMisses());
+    params["frames_measured"] = std::to_string(m_resolutionController.GetFrames());
+    params["latency_smoothed_ms"] = std::to_string(m_resolutionController.GetSmoothedLatency());
+    params["resolution_steps"] = std::to_string(m_resolutionController.GetStepsDown()) + " down, " +
+                                 std::to_string(m_resolutionController.GetStepsUp()) + " up";
+    params["keyframe_latency_ms"] = std::to_string(m_keyframeLatency);
+    params["warp_time_ms"] = std::to_string(m_warpTime);
+    params["net_instances"] = std::to_string(m_netInstances);
+    params["threads_per_instance"] = std::to_string(m_threadsPerInstance);
+    params["model_cache_mb"] = std::to_string(m_modelCacheBudgetMB);
+    params["model_cache_used_mb"] = std::to_string(m_modelCache.GetMemoryUsage() / (1024 * 1024));
+    params["model_cache_entries"] = std::to_string(m_modelCache.GetEntryCount());
+    params["pending_model"] = m_pendingModelPath;
+    params["inference_backend"] = InferenceBackend::GetTypeName(m_backendChoice);
+    params["inference_engine"] = m_modelLoaded ? InferenceBackend::GetTypeName(m_backendType) : "none";
+    params["style_region"] = m_personOnly ? "person" : "full";
+    params["background_style"] = m_stylizeBackground ? "stylized" : "passthrough";
+    params["background_interval"] = std::to_string(m_backgroundInterval);
+    params["background_scale"] = std::to_string(m_backgroundScale);
+    params["compute_saving"] = std::to_string(m_computeSaving);
+    params["segmentation_time_ms"] = std::to_string(m_segmentationTime);
     params["backend"] = m_backend == cv::dnn::DNN_BACKEND_CUDA ? "CUDA" : "CPU";
     params["target"] = m_target == cv::dnn::DNN_TARGET_CUDA_FP16 ? "CUDA_FP16" : 
                        m_target == cv::dnn::DNN_TARGET_CUDA ? "CUDA_FP32" : "CPU";
@@ -477,21 +1451,59 @@ double AnimeGANProcessor::GetExpectedProcessingTime() const
 
 void AnimeGANProcessor::SetModelPath(const std::string& path)
 {
+#ifdef HAVE_OPENCV
+    if (m_modelLoaded && path != m_modelPath) {
+        // Switch through the style cache instead of reloading in this thread
+        std::shared_ptr<InferenceBackend> backend = m_modelCache.Get(path);
+        if (backend) {
+            ActivateModel(path, backend);
+            m_pendingModelPath.clear();
+        } else if (!std::filesystem::exists(path)) {
+            MS_LOG_ERROR("[AnimeGANProcessor] ERROR: Model file not found: " << path);
+        } else {
+            m_pendingModelPath = path;
+            m_modelCache.Preload(path);
+            MS_LOG_INFO("[AnimeGANProcessor] Loading style in background: " << path
+                      << " (current style stays active)");
+        }
+        return;
+    }
+#endif
     m_modelPath = path;
-    std::cout << "[AnimeGANProcessor] Model path set to: " << m_modelPath << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] Model path set to: " << m_modelPath);
+}
+
+void AnimeGANProcessor::PreloadModels(const std::vector<std::string>& paths)
+{
+#ifdef HAVE_OPENCV
+    m_preloadModels = paths;
+    if (m_modelLoaded) {
+        for (const auto& path : m_preloadModels) {
+            m_modelCache.Preload(path);
+        }
+    }
+#endif
+}
+
+void AnimeGANProcessor::SetModelCacheBudget(size_t megabytes)
+{
+#ifdef HAVE_OPENCV
+    m_modelCacheBudgetMB = std::max<size_t>(16, megabytes);
+    m_modelCache.SetMemoryBudget(m_modelCacheBudgetMB * 1024 * 1024);
+#endif
 }
 
 void AnimeGANProcessor::SetInputSize(int width, int height)
 {
     m_inputWidth = std::max(128, std::min(1024, width));
     m_inputHeight = std::max(128, std::min(1024, height));
-    std::cout << "[AnimeGANProcessor] Input size set to: " << m_inputWidth << "x" << m_inputHeight << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] Input size set to: " << m_inputWidth << "x" << m_inputHeight);
 }
 
 void AnimeGANProcessor::SetBlendWeight(float weight)
 {
     m_blendWeight = std::max(0.0f, std::min(1.0f, weight));
-    std::cout << "[AnimeGANProcessor] Blend weight set to: " << m_blendWeight << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] Blend weight set to: " << m_blendWeight);
 }
 
 bool AnimeGANProcessor::IsGPUAvailable() const
@@ -518,11 +1530,11 @@ bool AnimeGANProcessor::SupportsRealTime() const
 void AnimeGANProcessor::SetUseGPU(bool useGPU)
 {
     m_useGPU = useGPU;
-    std::cout << "[AnimeGANProcessor] GPU usage " << (useGPU ? "enabled" : "disabled") << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] GPU usage " << (useGPU ? "enabled" : "disabled"));
     
     // If model is already loaded, need to reinitialize with new backend
     if (m_modelLoaded) {
-        std::cout << "[AnimeGANProcessor] Reinitializing model with new backend settings..." << std::endl;
+        MS_LOG_INFO("[AnimeGANProcessor] Reinitializing model with new backend settings...");
         Cleanup();
         Initialize();
     }
@@ -531,14 +1543,115 @@ void AnimeGANProcessor::SetUseGPU(bool useGPU)
 void AnimeGANProcessor::SetUseFP16(bool useFP16)
 {
     m_useFP16 = useFP16;
-    std::cout << "[AnimeGANProcessor] FP16 mode " << (useFP16 ? "enabled" : "disabled") << std::endl;
+    MS_LOG_INFO("[AnimeGANProcessor] FP16 mode " << (useFP16 ? "enabled" : "disabled"));
     
     // If model is already loaded and GPU is enabled, reinitialize
     if (m_modelLoaded && m_useGPU && m_gpuAvailable) {
-        std::cout << "[AnimeGANProcessor] Reinitializing model with new precision settings..." << std::endl;
+        MS_LOG_INFO("[AnimeGANProcessor] Reinitializing model with new precision settings...");
+        Cleanup();
+        Initialize();
+    }
+}
+
+void AnimeGANProcessor::SetUseFusedPipeline(bool fused)
+{
+#ifdef HAVE_OPENCV
+    m_useFusedPipeline = fused;
+    m_previousOutput.release();
+    MS_LOG_INFO("[AnimeGANProcessor] Fused pre/post-processing " << (fused ? "enabled" : "disabled"));
+#endif
+}
+
+void AnimeGANProcessor::SetKeyframeMode(bool enabled, float quality)
+{
+#ifdef HAVE_OPENCV
+    m_keyframeMode = enabled;
+    m_keyframeQuality = std::max(0.0f, std::min(1.0f, quality));
+    m_keyframeStyled.release();
+    m_keyframeGray.release();
+    m_flow.release();
+    m_framesSinceKeyframe = 0;
+    MS_LOG_INFO("[AnimeGANProcessor] Temporal mode: " << (enabled ? "keyframe + flow warp" : "blend")
+              << " (quality " << m_keyframeQuality << ")");
+#endif
+}
+
+void AnimeGANProcessor::SetInferenceBackend(InferenceBackend::Type type)
+{
+#ifdef HAVE_OPENCV
+    m_backendChoice = type;
+    MS_LOG_INFO("[AnimeGANProcessor] Inference backend: " << InferenceBackend::GetTypeName(type));
+
+    // The engine is chosen at load time
+    if (m_modelLoaded) {
+        MS_LOG_INFO("[AnimeGANProcessor] Reinitializing model with new backend...");
         Cleanup();
         Initialize();
     }
+#endif
+}
+
+void AnimeGANProcessor::SetAdaptiveResolution(bool enabled)
+{
+#ifdef HAVE_OPENCV
+    m_adaptiveRequested = enabled;
+    if (enabled && m_inference && m_inference->GetFixedInputSize().area() > 0) {
+        MS_LOG_INFO("[AnimeGANProcessor] Model has a fixed input size, adaptive resolution unavailable");
+        enabled = false;
+    }
+
+    m_resolutionController.SetCurrentSize(std::max(m_inputWidth, m_inputHeight));
+    m_resolutionController.SetEnabled(enabled);
+    m_resolutionController.ResetStats();
+    if (enabled) {
+        ApplyAdaptiveInputSize(m_resolutionController.GetCurrentSize());
+    }
+    MS_LOG_INFO("[AnimeGANProcessor] Adaptive resolution " << (enabled ? "enabled" : "disabled")
+              << " (budget " << m_resolutionController.GetBudget() << "ms, ladder "
+              << m_resolutionController.GetLadderString() << ")");
+#endif
+}
+
+void AnimeGANProcessor::SetNetInstances(int instances, int threadsPerInstance)
+{
+#ifdef HAVE_OPENCV
+    m_netInstances = std::max(1, std::min(16, instances));
+    m_threadsPerInstance = std::max(0, threadsPerInstance);
+    m_netPool.Stop();
+    m_previousOutput.release();
+
+    // Models preloaded from now on build the new number of pool instances
+    m_modelCache.SetLoader(MakeModelLoader());
+
+    if (m_modelLoaded && m_netInstances > 1) {
+        StartNetPool();
+    }
+    MS_LOG_INFO("[AnimeGANProcessor] Net instances: " << m_netInstances);
+#endif
+}
+
+void AnimeGANProcessor::SetPersonOnly(bool personOnly)
+{
+#ifdef HAVE_OPENCV
+    m_personOnly = personOnly;
+    m_personBox = cv::Rect2f();
+    m_backgroundStyled.release();
+    m_previousOutput.release();
+    m_computeSaving = 0.0;
+    MS_LOG_INFO("[AnimeGANProcessor] Style region: " << (personOnly ? "person only" : "full frame"));
+#endif
+}
+
+void AnimeGANProcessor::SetBackgroundStyle(bool stylized, int interval, float scale)
+{
+#ifdef HAVE_OPENCV
+    m_stylizeBackground = stylized;
+    m_backgroundInterval = std::max(1, std::min(120, interval));
+    m_backgroundScale = std::max(0.1f, std::min(1.0f, scale));
+    m_backgroundStyled.release();
+    MS_LOG_INFO("[AnimeGANProcessor] Background: " << (stylized ? "stylized" : "passthrough")
+              << " (every " << m_backgroundInterval << " frames at " << m_backgroundScale << "x)");
+#endif
 }
 
 std::string AnimeGANProcessor::GetGPUInfo() const
@@ -1,8 +1,15 @@
 #pragma once
 
 #include "ai_processor.h"
+#include "inference_backend.h"
+#include "resolution_controller.h"
+#include "style_model_cache.h"
+#include "parallel_net_pool.h"
 #include <string>
 #include <memory>
+#include <vector>
+
+class VirtualBackgroundProcessor;
 
 #ifdef HAVE_OPENCV
 #include <opencv2/dnn.hpp>
@@ -45,12 +52,21 @@ public:
     bool SupportsRealTime() const override;
 
     // Specific methods
-    void SetModelPath(const std::string& path);
+    void SetModelPath(const std::string& path);  // Once loaded, switches through the style cache
+    void PreloadModels(const std::vector<std::string>& paths);  // Load in the background after Initialize
+    void SetModelCacheBudget(size_t megabytes);
     void SetInputSize(int width, int height);
     void SetBlendWeight(float weight);  // 0.0 = original, 1.0 = full anime
     bool IsGPUAvailable() const;
     void SetUseGPU(bool useGPU);
     void SetUseFP16(bool useFP16);  // Enable half-precision for faster GPU inference
+    void SetUseFusedPipeline(bool fused);  // Single-pass pre/post-processing kernels
+    void SetKeyframeMode(bool enabled, float quality);  // quality: 0 = throughput, 1 = every frame
+    void SetInferenceBackend(InferenceBackend::Type type);  // AUTO picks by model file type
+    void SetNetInstances(int instances, int threadsPerInstance = 0);  // Frame-parallel CPU inference
+    void SetAdaptiveResolution(bool enabled);  // Step input size to hold the frame budget
+    void SetPersonOnly(bool personOnly);   // Stylize only the segmented person crop
+    void SetBackgroundStyle(bool stylized, int interval, float scale);  // Low-res/low-rate background
     std::string GetGPUInfo() const;
 
 private:
@@ -77,13 +93,130 @@ private:
     // Performance tracking
     double m_processingTime;
     uint64_t m_frameCounter;
+
+    // Fused pre/post-processing: one pass from camera frame to network blob,
+    // one pass from network output to the final blended/stabilized frame
+    struct ResampleTable {
+        int srcLength = 0;
+        int dstLength = 0;
+        std::vector<int> index0;
+        std::vector<int> index1;
+        std::vector<float> weight;      // Weight of index1
+    };
+
+    bool m_useFusedPipeline;
+    cv::Mat m_inputBlob;                // Persistent [1, 3, H, W] network input
+    ResampleTable m_preX, m_preY;       // Frame -> network input
+    ResampleTable m_postX, m_postY;     // Network output -> frame
+
+    static void BuildResampleTable(int srcLength, int dstLength, ResampleTable& table);
+    void FusedPreprocess(const cv::Mat& input, int netWidth, int netHeight);
+    void FusedPostprocess(const cv::Mat& output, const cv::Mat& original, cv::Mat& dst, bool temporal);
+    bool StylizeFused(const cv::Mat& input, const cv::Size& netSize, cv::Mat& dst, bool temporal);
+    cv::Mat RunInferenceFused(const cv::Mat& input);
+
+    // Person-only stylization: the net runs on the bounding crop of the
+    // segmented person at the full pixel budget, so the person gets a higher
+    // effective resolution for the same cost. The background is passed
+    // through, or stylized at low resolution every few frames.
+    bool m_personOnly;
+    bool m_stylizeBackground;
+    int m_backgroundInterval;           // Frames between background refreshes
+    float m_backgroundScale;            // Background net size relative to the frame
+    std::unique_ptr<VirtualBackgroundProcessor> m_segmenter;
+    bool m_segmenterReady;
+    cv::Rect2f m_personBox;             // Smoothed crop in frame coordinates
+    cv::Mat m_personStyled;             // Stylized crop
+    cv::Mat m_backgroundStyled;         // Stylized background at frame size
+    uint64_t m_backgroundAge;           // Frames since the background was stylized
+    double m_segmentationTime;
+    double m_computeSaving;             // Smoothed fraction of full-frame cost saved (segmentation included)
+
+    // Keyframe temporal mode: the net runs only on keyframes; frames in
+    // between warp the last stylized keyframe along low-res dense flow, with
+    // occluded areas falling back to the camera frame. Keyframes are chosen
+    // from measured net latency, motion and occlusion, scaled by one quality knob.
+    bool m_keyframeMode;
+    float m_keyframeQuality;
+    double m_targetFPS;
+    cv::Mat m_keyframeStyled;           // Last network output at frame size
+    cv::Mat m_keyframeGray;             // Low-res gray camera frame of that keyframe
+    cv::Mat m_flow;                     // Low-res flow, current -> keyframe (CV_32FC2)
+    cv::Mat m_occlusion;                // Low-res occlusion weight (CV_32F, 0-1)
+    cv::Mat m_warpMap;                  // Full-res sampling map (CV_32FC2)
+    float m_flowScale;                  // Flow resolution / frame resolution
+    int m_framesSinceKeyframe;
+    double m_keyframeLatency;           // Smoothed network time per keyframe
+    double m_warpTime;                  // Smoothed flow + warp time per frame
+    double m_lastMotion;                // Mean displacement since keyframe, full-res pixels
+    uint64_t m_keyframeCount;           // Keyframes since the last log line
+
+    // Frame-parallel inference: K net instances take consecutive frames
+    // round-robin; outputs come back in order, K - 1 frames late
+    ParallelNetPool m_netPool;
+    int m_netInstances;
+    int m_threadsPerInstance;           // ONNX Runtime intra-op threads, 0 = all cores
+
+    // Engine running m_net (OpenCV DNN) or an ONNX Runtime session
+    InferenceBackend::Type m_backendChoice;
+    InferenceBackend::Type m_backendType;
+    std::shared_ptr<InferenceBackend> m_inference;
+
+    // Style switching: preloaded, warmed-up engines; a switch to a model that
+    // is still loading takes effect on the first frame after it is ready
+    StyleModelCache m_modelCache;
+    std::vector<std::string> m_preloadModels;
+    std::string m_pendingModelPath;
+    size_t m_modelCacheBudgetMB;
+
+    // Adaptive input size against the frame budget (dynamic-shape models only)
+    ResolutionController m_resolutionController;
+    bool m_adaptiveRequested;           // User setting; suspended while a fixed-shape model is active
+
+    void ApplyAdaptiveInputSize(int size);
+    // Enable the controller as requested unless the active model has a fixed input size
+    void UpdateAdaptiveForModel();
+
+    // Engine settings for models loaded on the cache thread, copied when the
+    // loader is created so later SetParameter() calls never race it
+    struct ModelLoadSettings {
+        InferenceBackend::Type backendChoice;
+        int threadsPerInstance;
+        cv::dnn::Backend backend;
+        cv::dnn::Target target;
+        int poolInstances;                  // > 1: also build net pool instances
+        cv::Size warmupSize;
+    };
+
+    void StartModelCache();
+    StyleModelCache::Loader MakeModelLoader() const;
+    static std::shared_ptr<InferenceBackend> LoadCachedModel(const std::string& path, const StyleModelCache::ModelBytes& bytes,
+                                                             const ModelLoadSettings& settings);
+    void CheckPendingModel();
+    void ActivateModel(const std::string& path, const std::shared_ptr<InferenceBackend>& backend);
+
+#ifdef HAVE_ONNX
+    bool InitializeOrtBackend();
+#endif
+    bool StartNetPool();
+    cv::Mat RunInferencePooled(const cv::Mat& input, double& timestamp);
+
+    cv::Mat StylizeFrame(const cv::Mat& input);
+    cv::Mat RunKeyframeTemporal(const cv::Mat& input);
+    cv::Mat WarpKeyframe(const cv::Mat& input);
+
+    bool EnsureSegmenter();
+    static cv::Size FitNetSize(const cv::Size& region, int pixelBudget);
+    cv::Mat RunInferencePerson(const cv::Mat& input);
     
-    // Helper methods
-    cv::Mat PreprocessFrame(const cv::Mat& input);
-    cv::Mat PostprocessFrame(const cv::Mat& output, const cv::Size& targetSize);
+    // Helper methods (the static ones also run on net pool workers and only
+    // use what they are passed)
+    static cv::Mat PreprocessFrame(const cv::Mat& input, const cv::Size& netSize);
+    static cv::Mat PostprocessFrame(const cv::Mat& output, const cv::Size& targetSize);
     cv::Mat RunInference(const cv::Mat& input);
+    static cv::Mat RunInferenceOn(InferenceBackend& backend, const cv::Mat& input, const cv::Size& netSize);
     cv::Mat StabilizeOutput(const cv::Mat& current);
-    cv::Mat BlendWithOriginal(const cv::Mat& original, const cv::Mat& anime);
+    static cv::Mat BlendWithOriginal(const cv::Mat& original, const cv::Mat& anime, float blendWeight);
     
     // GPU detection
     bool DetectGPUSupport();
@@ -1,5 +1,5 @@
 #include "cartoon_buffered_filter_processor.h"
-#include <iostream>
+#include "logger.h"
 #include <chrono>
 #include <algorithm>
 
@@ -8,15 +8,20 @@
 #endif
 
 CartoonBufferedFilterProcessor::CartoonBufferedFilterProcessor()
-    : m_style(SIMPLE),
+    : m_ringHead(0),
+      m_ringCount(0),
+      m_bufferSize(5),  // 5 frames at 30fps = ~0.17 seconds delay (reduced from 10 for performance)
+      m_histogramDivide(0),
+      m_framesAccumulated(0),
+      m_temporalFilter(TEMPORAL_EMA),
+      m_style(SIMPLE),
       m_edgeThreshold(100),
       m_smoothingLevel(3),
       m_colorLevels(6),
-      m_bufferSize(5),  // 5 frames at 30fps = ~0.17 seconds delay (reduced from 10 for performance)
       m_frameCounter(0),
       m_processingTime(0.0)
 {
-    std::cout << "[CartoonBufferedFilterProcessor] Initializing with buffer size: " << m_bufferSize << std::endl;
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Initializing with buffer size: " << m_bufferSize);
 }
 
 CartoonBufferedFilterProcessor::~CartoonBufferedFilterProcessor()
@@ -26,22 +31,20 @@ CartoonBufferedFilterProcessor::~CartoonBufferedFilterProcessor()
 
 bool CartoonBufferedFilterProcessor::Initialize()
 {
-    std::cout << "[CartoonBufferedFilterProcessor] Initialize called" << std::endl;
-    std::cout << "[CartoonBufferedFilterProcessor] Style: " << static_cast<int>(m_style) << std::endl;
-    std::cout << "[CartoonBufferedFilterProcessor] Edge Threshold: " << m_edgeThreshold << std::endl;
-    std::cout << "[CartoonBufferedFilterProcessor] Smoothing Level: " << m_smoothingLevel << std::endl;
-    std::cout << "[CartoonBufferedFilterProcessor] Color Levels: " << m_colorLevels << std::endl;
-    std::cout << "[CartoonBufferedFilterProcessor] Buffer Size: " << m_bufferSize << " frames" << std::endl;
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Initialize called");
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Style: " << static_cast<int>(m_style));
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Edge Threshold: " << m_edgeThreshold);
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Smoothing Level: " << m_smoothingLevel);
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Color Levels: " << m_colorLevels);
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Buffer Size: " << m_bufferSize << " frames");
     return true;
 }
 
 void CartoonBufferedFilterProcessor::Cleanup()
 {
-    std::cout << "[CartoonBufferedFilterProcessor] Cleanup called" << std::endl;
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Cleanup called");
 #ifdef HAVE_OPENCV
-    m_frameBuffer.clear();
-    m_edgeBuffer.clear();
-    m_quantizedBuffer.clear();
+    ResetTemporalState();
 #endif
 }
 
@@ -78,98 +81,171 @@ void CartoonBufferedFilterProcessor::AddFrameToBuffer(const cv::Mat& frame)
 {
     if (frame.empty()) return;
     
-    // Apply bilateral filtering for smooth colors
-    cv::Mat smoothed = frame.clone();
-    for (int i = 0; i < m_smoothingLevel; ++i) {
-        cv::Mat temp;
-        cv::bilateralFilter(smoothed, temp, 7, 40, 40);
-        temp.copyTo(smoothed);
-    }
-    
-    // Enhance saturation
-    cv::Mat hsv;
-    cv::cvtColor(smoothed, hsv, cv::COLOR_BGR2HSV);
-    for (int y = 0; y < hsv.rows; ++y) {
-        cv::Vec3b* row = hsv.ptr<cv::Vec3b>(y);
-        for (int x = 0; x < hsv.cols; ++x) {
-            row[x][1] = cv::saturate_cast<uint8_t>(row[x][1] * 1.5f);
-        }
-    }
-    cv::cvtColor(hsv, smoothed, cv::COLOR_HSV2BGR);
+    // Edge-preserving smoothing equivalent to m_smoothingLevel bilateral passes (d=7, sigma 40)
+    cv::Mat smoothed;
+    m_smoother.Apply(frame, smoothed, 7, 40, m_smoothingLevel);
     
-    // Store smoothed frame
-    m_frameBuffer.push_back(smoothed.clone());
-    if (m_frameBuffer.size() > static_cast<size_t>(m_bufferSize)) {
-        m_frameBuffer.pop_front();
-    }
+    // Enhance saturation (cached LUT instead of an HSV round trip)
+    ColorLut3D::ScaleSaturationValue(smoothed, 1.5);
     
-    // Detect and store edges
     cv::Mat edges = DetectEdges(smoothed);
-    m_edgeBuffer.push_back(edges.clone());
-    if (m_edgeBuffer.size() > static_cast<size_t>(m_bufferSize)) {
-        m_edgeBuffer.pop_front();
-    }
-    
-    // Quantize and store colors
     cv::Mat quantized = QuantizeColors(smoothed, m_colorLevels);
-    m_quantizedBuffer.push_back(quantized.clone());
-    if (m_quantizedBuffer.size() > static_cast<size_t>(m_bufferSize)) {
-        m_quantizedBuffer.pop_front();
+
+    int divideValue = std::max(1, 256 / m_colorLevels);
+    if (m_edgeOutput.size() != edges.size() || divideValue != m_histogramDivide) {
+        ResetTemporalState();
+        m_histogramDivide = divideValue;
     }
-}
 
-cv::Mat CartoonBufferedFilterProcessor::ComputeTemporalMedianEdges()
-{
-    if (m_edgeBuffer.empty()) {
-        return cv::Mat();
+    // Window and median need the frame that falls out of the window
+    bool needsRing = m_temporalFilter != TEMPORAL_EMA;
+    bool full = needsRing && m_ringCount == m_bufferSize;
+    if (needsRing && m_edgeRing.empty()) {
+        m_edgeRing.resize(m_bufferSize);
+        m_colorRing.resize(m_bufferSize);
     }
-    
-    if (m_edgeBuffer.size() == 1) {
-        return m_edgeBuffer[0].clone();
+    const cv::Mat noFrame;
+    const cv::Mat& evictedEdges = full ? m_edgeRing[m_ringHead] : noFrame;
+    const cv::Mat& evictedColors = full ? m_colorRing[m_ringHead] : noFrame;
+
+    switch (m_temporalFilter) {
+        case TEMPORAL_EMA:
+            UpdateRecursiveAverage(edges, quantized);
+            break;
+        case TEMPORAL_WINDOW:
+            UpdateWindowAverage(edges, quantized, evictedEdges, evictedColors);
+            break;
+        case TEMPORAL_MEDIAN:
+            UpdateTemporalMedian(edges, quantized, evictedEdges, evictedColors);
+            break;
     }
-    
-    // Use weighted temporal blending instead of median for performance
-    // Start with most recent frame and blend with older frames
-    cv::Mat result = m_edgeBuffer.back().clone();
-    
-    // Blend with previous frames using exponential decay
-    double alpha = 0.7;  // Weight for current accumulated result
-    for (int i = m_edgeBuffer.size() - 2; i >= 0; --i) {
-        cv::addWeighted(result, alpha, m_edgeBuffer[i], 1.0 - alpha, 0, result);
-        alpha *= 0.9;  // Decay older frames
+
+    if (needsRing) {
+        // Slots keep their allocation; copyTo reuses it
+        edges.copyTo(m_edgeRing[m_ringHead]);
+        quantized.copyTo(m_colorRing[m_ringHead]);
+        m_ringHead = (m_ringHead + 1) % m_bufferSize;
+        m_ringCount = std::min(m_ringCount + 1, m_bufferSize);
     }
-    
-    return result;
+    m_framesAccumulated++;
 }
 
-cv::Mat CartoonBufferedFilterProcessor::ComputeTemporalMedianColors()
+void CartoonBufferedFilterProcessor::ResetTemporalState()
 {
-    if (m_quantizedBuffer.empty()) {
-        return cv::Mat();
+    m_edgeRing.clear();
+    m_colorRing.clear();
+    m_ringHead = 0;
+    m_ringCount = 0;
+    m_framesAccumulated = 0;
+    m_edgeAccum.release();
+    m_colorAccum.release();
+    m_edgeVotes.release();
+    m_colorHistogram.release();
+    m_edgeOutput.release();
+    m_colorOutput.release();
+}
+
+void CartoonBufferedFilterProcessor::UpdateRecursiveAverage(const cv::Mat& edges, const cv::Mat& colors)
+{
+    // EMA with the same center of mass as an N-frame window
+    const double alpha = 2.0 / (m_bufferSize + 1);
+
+    if (m_framesAccumulated == 0) {
+        edges.convertTo(m_edgeAccum, CV_32F);
+        colors.convertTo(m_colorAccum, CV_32FC3);
+    } else {
+        cv::accumulateWeighted(edges, m_edgeAccum, alpha);
+        cv::accumulateWeighted(colors, m_colorAccum, alpha);
     }
-    
-    if (m_quantizedBuffer.size() == 1) {
-        return m_quantizedBuffer[0].clone();
+
+    m_edgeAccum.convertTo(m_edgeOutput, CV_8U);
+    m_colorAccum.convertTo(m_colorOutput, CV_8UC3);
+}
+
+void CartoonBufferedFilterProcessor::UpdateWindowAverage(const cv::Mat& edges, const cv::Mat& colors,
+                                                         const cv::Mat& evictedEdges, const cv::Mat& evictedColors)
+{
+    // Running sums (16-bit holds 30 frames of 8-bit values): add the new
+    // frame, subtract the one leaving the window
+    if (m_framesAccumulated == 0) {
+        m_edgeAccum = cv::Mat::zeros(edges.size(), CV_16U);
+        m_colorAccum = cv::Mat::zeros(colors.size(), CV_16UC3);
     }
-    
-    // Use weighted temporal blending instead of median for performance
-    // Start with most recent frame and blend with older frames
-    cv::Mat result = m_quantizedBuffer.back().clone();
-    
-    // Blend with previous frames using exponential decay
-    double alpha = 0.7;  // Weight for current accumulated result
-    for (int i = m_quantizedBuffer.size() - 2; i >= 0; --i) {
-        cv::addWeighted(result, alpha, m_quantizedBuffer[i], 1.0 - alpha, 0, result);
-        alpha *= 0.9;  // Decay older frames
+
+    cv::add(m_edgeAccum, edges, m_edgeAccum, cv::noArray(), CV_16U);
+    cv::add(m_colorAccum, colors, m_colorAccum, cv::noArray(), CV_16U);
+    int count = m_ringCount + 1;
+    if (!evictedEdges.empty()) {
+        cv::subtract(m_edgeAccum, evictedEdges, m_edgeAccum, cv::noArray(), CV_16U);
+        cv::subtract(m_colorAccum, evictedColors, m_colorAccum, cv::noArray(), CV_16U);
+        count = m_ringCount;
     }
-    
-    return result;
+
+    m_edgeAccum.convertTo(m_edgeOutput, CV_8U, 1.0 / count);
+    m_colorAccum.convertTo(m_colorOutput, CV_8UC3, 1.0 / count);
+}
+
+void CartoonBufferedFilterProcessor::UpdateTemporalMedian(const cv::Mat& edges, const cv::Mat& colors,
+                                                          const cv::Mat& evictedEdges, const cv::Mat& evictedColors)
+{
+    // Quantized colors take few distinct values, so each pixel channel keeps
+    // a small histogram over the window; edges are binary, so a vote count
+    // is their histogram. Cost depends on the bin count, not the window.
+    const int divide = m_histogramDivide;
+    const int bins = 255 / divide + 1;
+    if (m_framesAccumulated == 0) {
+        m_edgeVotes = cv::Mat::zeros(edges.size(), CV_8U);
+        m_colorHistogram = cv::Mat::zeros(colors.rows, colors.cols * 3 * bins, CV_8U);
+        m_edgeOutput.create(edges.size(), CV_8U);
+        m_colorOutput.create(colors.size(), CV_8UC3);
+    }
+
+    const bool evict = !evictedEdges.empty();
+    const int count = evict ? m_ringCount : m_ringCount + 1;
+    const int half = (count + 1) / 2;
+
+    cv::parallel_for_(cv::Range(0, colors.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            const uchar* edgeIn = edges.ptr<uchar>(y);
+            const cv::Vec3b* colorIn = colors.ptr<cv::Vec3b>(y);
+            const uchar* edgeOld = evict ? evictedEdges.ptr<uchar>(y) : nullptr;
+            const cv::Vec3b* colorOld = evict ? evictedColors.ptr<cv::Vec3b>(y) : nullptr;
+            uchar* votes = m_edgeVotes.ptr<uchar>(y);
+            uchar* histogram = m_colorHistogram.ptr<uchar>(y);
+            uchar* edgeOut = m_edgeOutput.ptr<uchar>(y);
+            cv::Vec3b* colorOut = m_colorOutput.ptr<cv::Vec3b>(y);
+
+            for (int x = 0; x < colors.cols; ++x) {
+                // Edge pixels are dark (0) in the inverted edge map
+                votes[x] += edgeIn[x] < 128 ? 1 : 0;
+                if (evict) {
+                    votes[x] -= edgeOld[x] < 128 ? 1 : 0;
+                }
+                edgeOut[x] = votes[x] * 2 > count ? 0 : 255;
+
+                for (int c = 0; c < 3; ++c) {
+                    uchar* bin = histogram + (x * 3 + c) * bins;
+                    bin[colorIn[x][c] / divide]++;
+                    if (evict) {
+                        bin[colorOld[x][c] / divide]--;
+                    }
+
+                    int level = 0;
+                    int seen = bin[0];
+                    while (seen < half && level < bins - 1) {
+                        seen += bin[++level];
+                    }
+                    colorOut[x][c] = static_cast<uchar>(level * divide);
+                }
+            }
+        }
+    });
 }
 
 void CartoonBufferedFilterProcessor::ApplyBufferedCartoon(cv::Mat& outputFrame)
 {
     // Start temporal filtering as soon as we have 2 frames (reduced from half-buffer)
-    if (m_frameBuffer.size() < 2) {
+    if (m_framesAccumulated < 2) {
         // Not enough frames yet, just process current frame normally
         cv::Mat edges = DetectEdges(outputFrame);
         cv::Mat quantized = QuantizeColors(outputFrame, m_colorLevels);
@@ -179,24 +255,16 @@ void CartoonBufferedFilterProcessor::ApplyBufferedCartoon(cv::Mat& outputFrame)
     }
     
     try {
-        // Compute temporally filtered edges using weighted blending
-        cv::Mat blendedEdges = ComputeTemporalMedianEdges();
-        
-        // Compute temporally filtered colors using weighted blending
-        cv::Mat blendedColors = ComputeTemporalMedianColors();
-        
-        if (blendedEdges.empty() || blendedColors.empty()) {
+        if (m_edgeOutput.empty() || m_colorOutput.empty()) {
             return;  // Failed to compute blending
         }
         
-        // Apply edges to colors
-        CombineEdgesWithColors(blendedColors, blendedEdges);
-        
-        // Copy result to output
-        blendedColors.copyTo(outputFrame);
+        // Apply filtered edges to filtered colors, straight into the output
+        m_colorOutput.copyTo(outputFrame);
+        CombineEdgesWithColors(outputFrame, m_edgeOutput);
         
     } catch (const std::exception& e) {
-        std::cerr << "[CartoonBufferedFilterProcessor] ApplyBufferedCartoon error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[CartoonBufferedFilterProcessor] ApplyBufferedCartoon error: " << e.what());
     }
 }
 
@@ -238,19 +306,8 @@ cv::Mat CartoonBufferedFilterProcessor::QuantizeColors(const cv::Mat& src, int l
         return src.clone();
     }
 
-    cv::Mat dst = src.clone();
-    int divideValue = std::max(1, 256 / levels);
-
-    // Fast quantization using pointer-based access
-    for (int y = 0; y < dst.rows; ++y) {
-        cv::Vec3b* row = dst.ptr<cv::Vec3b>(y);
-        for (int x = 0; x < dst.cols; ++x) {
-            row[x][0] = (row[x][0] / divideValue) * divideValue;
-            row[x][1] = (row[x][1] / divideValue) * divideValue;
-            row[x][2] = (row[x][2] / divideValue) * divideValue;
-        }
-    }
-
+    cv::Mat dst;
+    ColorLut3D::Posterize(src, dst, std::max(1, 256 / levels), 0);
     return dst;
 }
 
@@ -298,6 +355,16 @@ bool CartoonBufferedFilterProcessor::SetParameter(const std::string& name, const
             int level = std::stoi(value);
             SetSmoothingLevel(level);
             return true;
+        } else if (name == "smoothing_method") {
+            EdgePreservingSmoother::Method method;
+            if (!EdgePreservingSmoother::ParseMethod(value, method)) {
+                return false;
+            }
+            m_smoother.SetMethod(method);
+            return true;
+        } else if (name == "smoothing_scale") {
+            m_smoother.SetDownscale(std::stoi(value));
+            return true;
         } else if (name == "color_levels") {
             int levels = std::stoi(value);
             SetColorLevels(levels);
@@ -306,9 +373,20 @@ bool CartoonBufferedFilterProcessor::SetParameter(const std::string& name, const
             int size = std::stoi(value);
             SetBufferSize(size);
             return true;
+        } else if (name == "temporal_filter") {
+            if (value == "ema") {
+                SetTemporalFilter(TEMPORAL_EMA);
+            } else if (value == "window") {
+                SetTemporalFilter(TEMPORAL_WINDOW);
+            } else if (value == "median") {
+                SetTemporalFilter(TEMPORAL_MEDIAN);
+            } else {
+                return false;
+            }
+            return true;
         }
     } catch (const std::exception& e) {
-        std::cerr << "[CartoonBufferedFilterProcessor] SetParameter error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[CartoonBufferedFilterProcessor] SetParameter error: " << e.what());
         return false;
     }
     return false;
@@ -320,8 +398,12 @@ std::map<std::string, std::string> CartoonBufferedFilterProcessor::GetParameters
     params["style"] = std::to_string(static_cast<int>(m_style));
     params["edge_threshold"] = std::to_string(m_edgeThreshold);
     params["smoothing_level"] = std::to_string(m_smoothingLevel);
+    params["smoothing_method"] = EdgePreservingSmoother::GetMethodName(m_smoother.GetMethod());
+    params["smoothing_scale"] = std::to_string(m_smoother.GetDownscale());
     params["color_levels"] = std::to_string(m_colorLevels);
     params["buffer_size"] = std::to_string(m_bufferSize);
+    params["temporal_filter"] = m_temporalFilter == TEMPORAL_WINDOW ? "window" :
+                                m_temporalFilter == TEMPORAL_MEDIAN ? "median" : "ema";
     return params;
 }
 
@@ -333,7 +415,7 @@ double CartoonBufferedFilterProcessor::GetExpectedProcessingTime() const
 void CartoonBufferedFilterProcessor::SetCartoonStyle(int style)
 {
     m_style = static_cast<CartoonStyle>(std::max(0, std::min(2, style)));
-    std::cout << "[CartoonBufferedFilterProcessor] Style changed to: " << static_cast<int>(m_style) << std::endl;
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Style changed to: " << static_cast<int>(m_style));
 }
 
 void CartoonBufferedFilterProcessor::SetEdgeThreshold(int threshold)
@@ -354,5 +436,18 @@ void CartoonBufferedFilterProcessor::SetColorLevels(int levels)
 void CartoonBufferedFilterProcessor::SetBufferSize(int size)
 {
     m_bufferSize = std::max(3, std::min(30, size));  // Between 3 and 30 frames
-    std::cout << "[CartoonBufferedFilterProcessor] Buffer size changed to: " << m_bufferSize << " frames" << std::endl;
+#ifdef HAVE_OPENCV
+    ResetTemporalState();
+#endif
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Buffer size changed to: " << m_bufferSize << " frames");
+}
+
+void CartoonBufferedFilterProcessor::SetTemporalFilter(TemporalFilter filter)
+{
+    m_temporalFilter = filter;
+#ifdef HAVE_OPENCV
+    ResetTemporalState();
+#endif
+    MS_LOG_INFO("[CartoonBufferedFilterProcessor] Temporal filter: "
+              << (filter == TEMPORAL_WINDOW ? "window" : filter == TEMPORAL_MEDIAN ? "median" : "ema"));
 }
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "ai_processor.h"
+#include "color_lut.h"
+#include "edge_preserving_smoother.h"
 #include <atomic>
-#include <deque>
+#include <vector>
 
 #ifdef HAVE_OPENCV
 #include <opencv2/opencv.hpp>
@@ -30,7 +32,15 @@ public:
     void SetEdgeThreshold(int threshold);
     void SetSmoothingLevel(int level);
     void SetColorLevels(int levels);
-    void SetBufferSize(int size);  // Default 10 frames
+    void SetBufferSize(int size);  // Default 5 frames
+
+    // How buffered frames are combined; every mode costs the same for any buffer size
+    enum TemporalFilter {
+        TEMPORAL_EMA = 0,       // Recursive average, no frame storage
+        TEMPORAL_WINDOW = 1,    // Mean of the last N frames (running sum)
+        TEMPORAL_MEDIAN = 2     // Per-pixel median of the last N frames (running histogram)
+    };
+    void SetTemporalFilter(TemporalFilter filter);
 
 private:
     enum CartoonStyle {
@@ -50,17 +60,37 @@ private:
     void CombineEdgesWithColors(cv::Mat& frame, const cv::Mat& edges);
     
     // Buffered processing
-    cv::Mat ComputeTemporalMedianEdges();
-    cv::Mat ComputeTemporalMedianColors();
     void AddFrameToBuffer(const cv::Mat& frame);
+    void ResetTemporalState();
+    void UpdateRecursiveAverage(const cv::Mat& edges, const cv::Mat& colors);
+    void UpdateWindowAverage(const cv::Mat& edges, const cv::Mat& colors,
+                             const cv::Mat& evictedEdges, const cv::Mat& evictedColors);
+    void UpdateTemporalMedian(const cv::Mat& edges, const cv::Mat& colors,
+                              const cv::Mat& evictedEdges, const cv::Mat& evictedColors);
     
-    // Frame buffers
-    std::deque<cv::Mat> m_frameBuffer;         // Raw input frames
-    std::deque<cv::Mat> m_edgeBuffer;          // Detected edges
-    std::deque<cv::Mat> m_quantizedBuffer;     // Quantized colors
+    // Preallocated rings (window and median modes only)
+    std::vector<cv::Mat> m_edgeRing;           // Detected edges
+    std::vector<cv::Mat> m_colorRing;          // Quantized colors
+    int m_ringHead;                            // Next slot to overwrite
+    int m_ringCount;                           // Valid slots
     int m_bufferSize;                          // Number of frames to buffer
+
+    // Running state
+    cv::Mat m_edgeAccum;                       // EMA (CV_32F) or window sum (CV_16U)
+    cv::Mat m_colorAccum;                      // EMA (CV_32FC3) or window sum (CV_16UC3)
+    cv::Mat m_edgeVotes;                       // Median: edge count in window, CV_8U
+    cv::Mat m_colorHistogram;                  // Median: per pixel channel level counts, CV_8U
+    int m_histogramDivide;                     // Quantization step the histogram was built for
+    int m_framesAccumulated;
+    cv::Mat m_edgeOutput;                      // Filtered edges, CV_8U
+    cv::Mat m_colorOutput;                     // Filtered colors, CV_8UC3
 #endif
 
+    TemporalFilter m_temporalFilter;
+
+    // Color flattening (domain transform by default, bilateral for A/B)
+    EdgePreservingSmoother m_smoother;
+
     // Parameters
     CartoonStyle m_style;
     int m_edgeThreshold;
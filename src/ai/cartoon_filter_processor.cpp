@@ -1,5 +1,5 @@
 #include "cartoon_filter_processor.h"
-#include <iostream>
+#include "logger.h"
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -8,6 +8,13 @@
 #include <opencv2/opencv.hpp>
 #endif
 
+namespace {
+// Fused compose: band height and the rows of context its edge stages need
+// (2 for the 5x5 blur, 1 for the Laplacian, 1 for the dilate)
+const int kBandRows = 32;
+const int kBandHalo = 4;
+}
+
 CartoonFilterProcessor::CartoonFilterProcessor()
     : m_style(SIMPLE),
       m_edgeThreshold(100),
@@ -15,10 +22,12 @@ CartoonFilterProcessor::CartoonFilterProcessor()
       m_colorLevels(8),
       m_addOutlineOnly(false),
       m_preserveDetails(true),
+      m_fusedPipeline(true),
+      m_composeTime(0.0),
       m_frameCounter(0),
       m_processingTime(0.0)
 {
-    std::cout << "[CartoonFilterProcessor] Initializing..." << std::endl;
+    MS_LOG_INFO("[CartoonFilterProcessor] Initializing...");
 }
 
 CartoonFilterProcessor::~CartoonFilterProcessor()
@@ -28,20 +37,21 @@ CartoonFilterProcessor::~CartoonFilterProcessor()
 
 bool CartoonFilterProcessor::Initialize()
 {
-    std::cout << "[CartoonFilterProcessor] Initialize called" << std::endl;
-    std::cout << "[CartoonFilterProcessor] Style: " << static_cast<int>(m_style) << std::endl;
-    std::cout << "[CartoonFilterProcessor] Edge Threshold: " << m_edgeThreshold << std::endl;
-    std::cout << "[CartoonFilterProcessor] Smoothing Level: " << m_smoothingLevel << std::endl;
-    std::cout << "[CartoonFilterProcessor] Color Levels: " << m_colorLevels << std::endl;
+    MS_LOG_INFO("[CartoonFilterProcessor] Initialize called");
+    MS_LOG_INFO("[CartoonFilterProcessor] Style: " << static_cast<int>(m_style));
+    MS_LOG_INFO("[CartoonFilterProcessor] Edge Threshold: " << m_edgeThreshold);
+    MS_LOG_INFO("[CartoonFilterProcessor] Smoothing Level: " << m_smoothingLevel);
+    MS_LOG_INFO("[CartoonFilterProcessor] Color Levels: " << m_colorLevels);
     return true;
 }
 
 void CartoonFilterProcessor::Cleanup()
 {
-    std::cout << "[CartoonFilterProcessor] Cleanup called" << std::endl;
+    MS_LOG_INFO("[CartoonFilterProcessor] Cleanup called");
     m_previousEdges.release();
     m_previousFrame.release();
     m_previousQuantized.release();
+    m_nextEdges.release();
 }
 
 Frame CartoonFilterProcessor::ProcessFrame(const Frame& input)
@@ -91,54 +101,18 @@ void CartoonFilterProcessor::ApplySimpleCartoon(cv::Mat& frame)
     }
 
     try {
-        // Apply bilateral filtering for smooth colors
-        cv::Mat smoothed = frame.clone();
-        
-        // Multiple passes with moderate parameters for better quality
-        for (int i = 0; i < m_smoothingLevel; ++i) {
-            cv::Mat temp;
-            // Use smaller sigma for more detailed smoothing
-            cv::bilateralFilter(smoothed, temp, 7, 40, 40);
-            temp.copyTo(smoothed);
-        }
+        // Edge-preserving smoothing equivalent to m_smoothingLevel bilateral passes (d=7, sigma 40)
+        cv::Mat smoothed;
+        m_smoother.Apply(frame, smoothed, 7, 40, m_smoothingLevel);
 
-        // Enhance saturation for more vibrant cartoon colors
-        cv::Mat hsv;
-        cv::cvtColor(smoothed, hsv, cv::COLOR_BGR2HSV);
-        for (int y = 0; y < hsv.rows; ++y) {
-            cv::Vec3b* row = hsv.ptr<cv::Vec3b>(y);
-            for (int x = 0; x < hsv.cols; ++x) {
-                row[x][1] = cv::saturate_cast<uint8_t>(row[x][1] * 1.5f);  // Stronger saturation
-            }
-        }
-        cv::cvtColor(hsv, smoothed, cv::COLOR_HSV2BGR);
+        // Enhance saturation for more vibrant cartoon colors (cached LUT instead of an HSV round trip)
+        ColorLut3D::ScaleSaturationValue(smoothed, 1.5);
 
         // Very aggressive fast quantization - 4 levels = 64 total colors (4^3)
         // Much faster than k-means but still dramatic cartoon effect
-        cv::Mat quantized = QuantizeColors(smoothed, 6);  // Increased to 6 for smoother look
-        
-        // Smooth color transitions between frames - stronger temporal filtering
-        if (!m_previousQuantized.empty() && quantized.size() == m_previousQuantized.size()) {
-            cv::addWeighted(quantized, 0.5, m_previousQuantized, 0.5, 0, quantized);  // 50-50 blend for stability
-        }
-        quantized.copyTo(m_previousQuantized);
-
-        // Edge detection
-        cv::Mat edges = DetectEdges(smoothed);
-        
-        // Stabilize edges across frames to reduce flickering
-        cv::Mat stableEdges = StabilizeEdges(edges);
-
-        // Apply edges
-        if (!stableEdges.empty()) {
-            CombineEdgesWithColors(quantized, stableEdges);
-        }
-
-        if (!quantized.empty()) {
-            quantized.copyTo(frame);
-        }
+        ComposeCartoon(smoothed, 6, frame);  // 6 levels per channel
     } catch (const std::exception& e) {
-        std::cerr << "[CartoonFilterProcessor] ApplySimpleCartoon error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[CartoonFilterProcessor] ApplySimpleCartoon error: " << e.what());
     }
 }
 
@@ -149,51 +123,18 @@ void CartoonFilterProcessor::ApplyDetailedCartoon(cv::Mat& frame)
     }
 
     try {
-        // Smoothing for detailed cartoon effect
-        cv::Mat smoothed = frame.clone();
-        for (int i = 0; i < m_smoothingLevel; ++i) {
-            cv::Mat temp;
-            // Smaller sigma for more detail preservation
-            cv::bilateralFilter(smoothed, temp, 8, 50, 50);
-            temp.copyTo(smoothed);
-        }
+        // Smoothing for detailed cartoon effect (bilateral d=8, sigma 50 per level)
+        cv::Mat smoothed;
+        m_smoother.Apply(frame, smoothed, 8, 50, m_smoothingLevel);
 
-        // Enhance saturation aggressively
-        cv::Mat hsv;
-        cv::cvtColor(smoothed, hsv, cv::COLOR_BGR2HSV);
-        for (int y = 0; y < hsv.rows; ++y) {
-            cv::Vec3b* row = hsv.ptr<cv::Vec3b>(y);
-            for (int x = 0; x < hsv.cols; ++x) {
-                row[x][1] = cv::saturate_cast<uint8_t>(row[x][1] * 1.6f);  // Much stronger saturation
-            }
-        }
-        cv::cvtColor(hsv, smoothed, cv::COLOR_HSV2BGR);
+        // Enhance saturation aggressively (cached LUT instead of an HSV round trip)
+        ColorLut3D::ScaleSaturationValue(smoothed, 1.6);
 
         // Very aggressive fast quantization - 3 levels = 27 total colors (3^3)
         // Extreme cartoon effect for detailed style
-        cv::Mat quantized = QuantizeColors(smoothed, 5);  // Increased to 5 for better stability
-        
-        // Smooth color transitions between frames - stronger temporal filtering
-        if (!m_previousQuantized.empty() && quantized.size() == m_previousQuantized.size()) {
-            cv::addWeighted(quantized, 0.5, m_previousQuantized, 0.5, 0, quantized);  // 50-50 blend for stability
-        }
-        quantized.copyTo(m_previousQuantized);
-
-        // Edge detection
-        cv::Mat edges = DetectEdges(smoothed);
-        
-        // Stabilize edges across frames to reduce flickering
-        cv::Mat stableEdges = StabilizeEdges(edges);
-
-        if (!stableEdges.empty() && !quantized.empty()) {
-            CombineEdgesWithColors(quantized, stableEdges);
-        }
-
-        if (!quantized.empty()) {
-            quantized.copyTo(frame);
-        }
+        ComposeCartoon(smoothed, 5, frame);  // 5 levels per channel
     } catch (const std::exception& e) {
-        std::cerr << "[CartoonFilterProcessor] ApplyDetailedCartoon error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[CartoonFilterProcessor] ApplyDetailedCartoon error: " << e.what());
     }
 }
 
@@ -204,51 +145,169 @@ void CartoonFilterProcessor::ApplyAnimeStyle(cv::Mat& frame)
     }
 
     try {
-        // Strong smoothing for anime look
-        cv::Mat smoothed = frame.clone();
-        for (int i = 0; i < m_smoothingLevel; ++i) {
-            cv::Mat temp;
-            // Use multiple passes with smaller sigma instead of large single pass
-            cv::bilateralFilter(smoothed, temp, 9, 60, 60);
-            temp.copyTo(smoothed);
-        }
+        // Strong smoothing for anime look (bilateral d=9, sigma 60 per level)
+        cv::Mat smoothed;
+        m_smoother.Apply(frame, smoothed, 9, 60, m_smoothingLevel);
 
-        // Enhance saturation for vibrant anime colors
-        cv::Mat hsv;
-        cv::cvtColor(smoothed, hsv, cv::COLOR_BGR2HSV);
-        for (int y = 0; y < hsv.rows; ++y) {
-            cv::Vec3b* row = hsv.ptr<cv::Vec3b>(y);
-            for (int x = 0; x < hsv.cols; ++x) {
-                row[x][1] = cv::saturate_cast<uint8_t>(row[x][1] * 1.8f);  // Maximum saturation boost
-            }
-        }
-        cv::cvtColor(hsv, smoothed, cv::COLOR_HSV2BGR);
+        // Enhance saturation for vibrant anime colors (cached LUT instead of an HSV round trip)
+        ColorLut3D::ScaleSaturationValue(smoothed, 1.8);
 
         // Very aggressive fast quantization - 4 levels for anime = 64 colors (4^3)
-        cv::Mat quantized = QuantizeColors(smoothed, 6);  // Increased to 6 for smoother look
-        
-        // Smooth color transitions between frames - stronger temporal filtering
-        if (!m_previousQuantized.empty() && quantized.size() == m_previousQuantized.size()) {
-            cv::addWeighted(quantized, 0.5, m_previousQuantized, 0.5, 0, quantized);  // 50-50 blend for stability
-        }
-        quantized.copyTo(m_previousQuantized);
+        ComposeCartoon(smoothed, 6, frame);  // 6 levels per channel
+    } catch (const std::exception& e) {
+        MS_LOG_ERROR("[CartoonFilterProcessor] ApplyAnimeStyle error: " << e.what());
+    }
+}
 
-        // Edge detection
-        cv::Mat edges = DetectEdges(smoothed);
-        
-        // Stabilize edges across frames to reduce flickering
-        cv::Mat stableEdges = StabilizeEdges(edges);
+void CartoonFilterProcessor::ComposeCartoon(const cv::Mat& smoothed, int levels, cv::Mat& frame)
+{
+    auto start = std::chrono::high_resolution_clock::now();
 
-        if (!stableEdges.empty() && !quantized.empty()) {
-            CombineEdgesWithColors(quantized, stableEdges);
-        }
+    if (m_fusedPipeline) {
+        ComposeFused(smoothed, levels, frame);
+    } else {
+        ComposeSeparate(smoothed, levels, frame);
+    }
 
-        if (!quantized.empty()) {
-            quantized.copyTo(frame);
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "[CartoonFilterProcessor] ApplyAnimeStyle error: " << e.what() << std::endl;
+    m_composeTime = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void CartoonFilterProcessor::ComposeSeparate(const cv::Mat& smoothed, int levels, cv::Mat& frame)
+{
+    cv::Mat quantized = QuantizeColors(smoothed, levels);
+    
+    // Smooth color transitions between frames - stronger temporal filtering
+    if (!m_previousQuantized.empty() && quantized.size() == m_previousQuantized.size()) {
+        cv::addWeighted(quantized, 0.5, m_previousQuantized, 0.5, 0, quantized);  // 50-50 blend for stability
+    }
+    quantized.copyTo(m_previousQuantized);
+
+    // Edge detection
+    cv::Mat edges = DetectEdges(smoothed);
+    
+    // Stabilize edges across frames to reduce flickering
+    cv::Mat stableEdges = StabilizeEdges(edges);
+
+    if (!stableEdges.empty() && !quantized.empty()) {
+        CombineEdgesWithColors(quantized, stableEdges);
+    }
+
+    if (!quantized.empty()) {
+        quantized.copyTo(frame);
+    }
+}
+
+void CartoonFilterProcessor::ComposeFused(const cv::Mat& smoothed, int levels, cv::Mat& frame)
+{
+    // Same stages as ComposeSeparate, run band by band: each band computes
+    // its edges (plus a halo of rows for the 5x5 blur, the Laplacian and the
+    // dilate) and then makes one pass over its pixels for quantize, temporal
+    // blend, edge hysteresis, dilate and outline. Every intermediate stays in
+    // cache; DRAM sees the smoothed input, the two history buffers and the output.
+    const int rows = smoothed.rows;
+    const int cols = smoothed.cols;
+    if (smoothed.type() != CV_8UC3) {
+        ComposeSeparate(smoothed, levels, frame);
+        return;
+    }
+
+    const bool haveQuantized = m_previousQuantized.size() == smoothed.size() &&
+                               m_previousQuantized.type() == CV_8UC3;
+    const bool haveEdges = m_previousEdges.size() == smoothed.size() && m_previousEdges.type() == CV_8UC1;
+    if (!haveQuantized) {
+        m_previousQuantized.create(smoothed.size(), CV_8UC3);
     }
+    // Neighboring bands read the old edges in their halo, so write elsewhere
+    m_nextEdges.create(smoothed.size(), CV_8UC1);
+    frame.create(smoothed.size(), CV_8UC3);
+
+    const cv::Mat posterize = ColorLut3D::GetPosterizeTable(std::max(1, 256 / levels), 0);
+    const uint8_t* quantize = posterize.ptr<uint8_t>();
+
+    const int threshold = std::max(15, m_edgeThreshold / 6);
+    const int bands = (rows + kBandRows - 1) / kBandRows;
+
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        cv::Mat gray, blurred, laplacian, strength, stable;
+        for (int band = range.start; band < range.end; ++band) {
+            const int y0 = band * kBandRows;
+            const int y1 = std::min(rows, y0 + kBandRows);
+            const int h0 = std::max(0, y0 - kBandHalo);
+            const int h1 = std::min(rows, y1 + kBandHalo);
+
+            // Edge strength for the band and halo (halo rows with a wrong
+            // border are never read back)
+            cv::cvtColor(smoothed.rowRange(h0, h1), gray, cv::COLOR_BGR2GRAY);
+            cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 1.0);
+            cv::Laplacian(blurred, laplacian, CV_16S, 1);
+            cv::convertScaleAbs(laplacian, strength);
+
+            // Hysteresis against last frame's edges, one row above and below
+            // the band for the dilate (255 = no edge, dark = edge)
+            const int s0 = std::max(0, y0 - 1);
+            const int s1 = std::min(rows, y1 + 1);
+            stable.create(s1 - s0, cols, CV_8UC1);
+            for (int y = s0; y < s1; ++y) {
+                const uint8_t* edgeStrength = strength.ptr<uint8_t>(y - h0);
+                const uint8_t* prevRow = haveEdges ? m_previousEdges.ptr<uint8_t>(y) : nullptr;
+                uint8_t* stabRow = stable.ptr<uint8_t>(y - s0);
+                for (int x = 0; x < cols; ++x) {
+                    uint8_t currVal = edgeStrength[x] > threshold ? 0 : 255;
+                    if (!prevRow || currVal < 120) {
+                        stabRow[x] = currVal;
+                    } else if (currVal < 180 && prevRow[x] < 220) {
+                        stabRow[x] = cv::saturate_cast<uint8_t>((currVal * 0.3f) + (prevRow[x] * 0.7f));
+                    } else if (prevRow[x] < 180) {
+                        stabRow[x] = cv::saturate_cast<uint8_t>(prevRow[x] * 0.85f);
+                    } else {
+                        stabRow[x] = 255;
+                    }
+                }
+            }
+
+            for (int y = y0; y < y1; ++y) {
+                // 3x3 elliptical (cross) dilate; outside the image is ignored
+                const uint8_t* center = stable.ptr<uint8_t>(y - s0);
+                const uint8_t* above = y > 0 ? stable.ptr<uint8_t>(y - 1 - s0) : center;
+                const uint8_t* below = y + 1 < rows ? stable.ptr<uint8_t>(y + 1 - s0) : center;
+                uint8_t* edgeRow = m_nextEdges.ptr<uint8_t>(y);
+                for (int x = 0; x < cols; ++x) {
+                    uint8_t v = std::max(center[x], std::max(above[x], below[x]));
+                    if (x > 0) {
+                        v = std::max(v, center[x - 1]);
+                    }
+                    if (x + 1 < cols) {
+                        v = std::max(v, center[x + 1]);
+                    }
+                    edgeRow[x] = v;
+                }
+
+                // Quantize per channel, blend 50/50 with last frame,
+                // remember the blend, darken outlines
+                const cv::Vec3b* in = smoothed.ptr<cv::Vec3b>(y);
+                cv::Vec3b* out = frame.ptr<cv::Vec3b>(y);
+                cv::Vec3b* previous = m_previousQuantized.ptr<cv::Vec3b>(y);
+                for (int x = 0; x < cols; ++x) {
+                    cv::Vec3b color(quantize[in[x][0]], quantize[in[x][1]], quantize[in[x][2]]);
+                    if (haveQuantized) {
+                        for (int c = 0; c < 3; ++c) {
+                            color[c] = static_cast<uint8_t>((color[c] + previous[x][c] + 1) >> 1);
+                        }
+                    }
+                    previous[x] = color;
+                    if (edgeRow[x] < 220) {
+                        for (int c = 0; c < 3; ++c) {
+                            color[c] = cv::saturate_cast<uint8_t>(color[c] * 0.3f);
+                        }
+                    }
+                    out[x] = color;
+                }
+            }
+        }
+    }, bands);
+
+    std::swap(m_previousEdges, m_nextEdges);
 }
 
 cv::Mat CartoonFilterProcessor::StabilizeEdges(const cv::Mat& currentEdges)
@@ -344,20 +403,8 @@ cv::Mat CartoonFilterProcessor::QuantizeColors(const cv::Mat& src, int levels)
         return src.clone();
     }
 
-    cv::Mat dst = src.clone();
-    int divideValue = std::max(1, 256 / levels);
-
-    // Fast quantization using pointer-based access
-    // This is much faster than k-means for real-time processing
-    for (int y = 0; y < dst.rows; ++y) {
-        cv::Vec3b* row = dst.ptr<cv::Vec3b>(y);
-        for (int x = 0; x < dst.cols; ++x) {
-            row[x][0] = (row[x][0] / divideValue) * divideValue;
-            row[x][1] = (row[x][1] / divideValue) * divideValue;
-            row[x][2] = (row[x][2] / divideValue) * divideValue;
-        }
-    }
-
+    cv::Mat dst;
+    ColorLut3D::Posterize(src, dst, std::max(1, 256 / levels), 0);
     return dst;
 }
 
@@ -405,13 +452,26 @@ bool CartoonFilterProcessor::SetParameter(const std::string& name, const std::st
             int level = std::stoi(value);
             SetSmoothingLevel(level);
             return true;
+        } else if (name == "fused_pipeline") {
+            m_fusedPipeline = (value == "true" || value == "1");
+            return true;
+        } else if (name == "smoothing_method") {
+            EdgePreservingSmoother::Method method;
+            if (!EdgePreservingSmoother::ParseMethod(value, method)) {
+                return false;
+            }
+            m_smoother.SetMethod(method);
+            return true;
+        } else if (name == "smoothing_scale") {
+            m_smoother.SetDownscale(std::stoi(value));
+            return true;
         } else if (name == "color_levels") {
             int levels = std::stoi(value);
             SetColorLevels(levels);
             return true;
         }
     } catch (const std::exception& e) {
-        std::cerr << "[CartoonFilterProcessor] SetParameter error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[CartoonFilterProcessor] SetParameter error: " << e.what());
         return false;
     }
     return false;
@@ -423,6 +483,10 @@ std::map<std::string, std::string> CartoonFilterProcessor::GetParameters() const
     params["style"] = std::to_string(static_cast<int>(m_style));
     params["edge_threshold"] = std::to_string(m_edgeThreshold);
     params["smoothing_level"] = std::to_string(m_smoothingLevel);
+    params["smoothing_method"] = EdgePreservingSmoother::GetMethodName(m_smoother.GetMethod());
+    params["smoothing_scale"] = std::to_string(m_smoother.GetDownscale());
+    params["fused_pipeline"] = m_fusedPipeline ? "true" : "false";
+    params["compose_ms"] = std::to_string(m_composeTime);
     params["color_levels"] = std::to_string(m_colorLevels);
     return params;
 }
@@ -435,7 +499,7 @@ double CartoonFilterProcessor::GetExpectedProcessingTime() const
 void CartoonFilterProcessor::SetCartoonStyle(int style)
 {
     m_style = static_cast<CartoonStyle>(std::max(0, std::min(2, style)));
-    std::cout << "[CartoonFilterProcessor] Style changed to: " << static_cast<int>(m_style) << std::endl;
+    MS_LOG_INFO("[CartoonFilterProcessor] Style changed to: " << static_cast<int>(m_style));
 }
 
 void CartoonFilterProcessor::SetEdgeThreshold(int threshold)
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ai_processor.h"
+#include "color_lut.h"
+#include "edge_preserving_smoother.h"
 #include <atomic>
 
 #ifdef HAVE_OPENCV
@@ -49,14 +51,23 @@ private:
     cv::Mat DetectEdges(const cv::Mat& src);
     cv::Mat QuantizeColors(const cv::Mat& src, int levels);
     void CombineEdgesWithColors(cv::Mat& frame, const cv::Mat& edges);
+
+    // Everything after smoothing: quantize, temporal blend, edges, outlines
+    void ComposeCartoon(const cv::Mat& smoothed, int levels, cv::Mat& frame);
+    void ComposeSeparate(const cv::Mat& smoothed, int levels, cv::Mat& frame);   // One full-frame pass per stage
+    void ComposeFused(const cv::Mat& smoothed, int levels, cv::Mat& frame);      // One cache-resident pass per band
     
     // Temporal coherence for stable edges
     cv::Mat m_previousEdges;
     cv::Mat m_previousFrame;
     cv::Mat StabilizeEdges(const cv::Mat& currentEdges);
     cv::Mat m_previousQuantized;  // Store previous quantized frame for smoother transitions
+    cv::Mat m_nextEdges;          // Fused path writes here, then swaps with m_previousEdges
 #endif
 
+    // Color flattening (domain transform by default, bilateral for A/B)
+    EdgePreservingSmoother m_smoother;
+
     // Parameters
     CartoonStyle m_style;
     int m_edgeThreshold;
@@ -64,6 +75,10 @@ private:
     int m_colorLevels;
     bool m_addOutlineOnly;
     bool m_preserveDetails;
+    bool m_fusedPipeline;
+
+    // Post-smoothing stage time (compose_ms)
+    double m_composeTime;
 
     mutable std::atomic<uint64_t> m_frameCounter;
     double m_processingTime;
@@ -0,0 +1,220 @@
+#include "color_lut.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace {
+const size_t kMaxCachedTables = 32;     // Oldest table dropped beyond this
+const int kSmoothGrid = 33;             // Grid for smooth transforms (HSV scales)
+
+struct LutCache {
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<const ColorLut3D>> tables;
+    std::deque<std::string> order;      // Insertion order for eviction
+};
+
+LutCache& GetLutCache()
+{
+    static LutCache cache;
+    return cache;
+}
+}
+
+ColorLut3D::ColorLut3D()
+    : m_gridSize(0)
+{
+    std::fill(m_lower, m_lower + 256, 0);
+    std::fill(m_fraction, m_fraction + 256, 0.0f);
+}
+
+#ifdef HAVE_OPENCV
+
+bool ColorLut3D::Build(int gridSize, const Transform& transform)
+{
+    const int n = gridSize <= 17 ? 17 : (gridSize <= 33 ? 33 : 65);
+
+    // Nodes are rounded to 8-bit values; the lookup tables below use the
+    // rounded positions, so interpolation stays exact at every node
+    std::vector<int> nodes(n);
+    for (int i = 0; i < n; ++i) {
+        nodes[i] = static_cast<int>(std::lround(i * 255.0 / (n - 1)));
+    }
+
+    // Every grid color as one image: row = b * N + g, column = r
+    cv::Mat colors(n * n, n, CV_8UC3);
+    for (int b = 0; b < n; ++b) {
+        for (int g = 0; g < n; ++g) {
+            cv::Vec3b* row = colors.ptr<cv::Vec3b>(b * n + g);
+            for (int r = 0; r < n; ++r) {
+                row[r] = cv::Vec3b(static_cast<uchar>(nodes[b]), static_cast<uchar>(nodes[g]),
+                                   static_cast<uchar>(nodes[r]));
+            }
+        }
+    }
+
+    transform(colors);
+    if (colors.rows != n * n || colors.cols != n || colors.type() != CV_8UC3) {
+        return false;
+    }
+
+    m_table.resize(static_cast<size_t>(n) * n * n * 3);
+    for (int row = 0; row < n * n; ++row) {
+        std::copy(colors.ptr<uchar>(row), colors.ptr<uchar>(row) + n * 3, m_table.data() + row * n * 3);
+    }
+
+    int lower = 0;
+    for (int v = 0; v < 256; ++v) {
+        while (lower < n - 2 && v >= nodes[lower + 1]) {
+            lower++;
+        }
+        m_lower[v] = static_cast<uint16_t>(lower);
+        m_fraction[v] = std::min(1.0f, static_cast<float>(v - nodes[lower]) / (nodes[lower + 1] - nodes[lower]));
+    }
+
+    m_gridSize = n;
+    return true;
+}
+
+void ColorLut3D::Apply(const cv::Mat& src, cv::Mat& dst) const
+{
+    if (src.empty() || src.type() != CV_8UC3 || !IsBuilt()) {
+        if (dst.data != src.data) {
+            src.copyTo(dst);
+        }
+        return;
+    }
+
+    dst.create(src.size(), CV_8UC3);
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            ApplyRow(src.ptr<cv::Vec3b>(y), dst.ptr<cv::Vec3b>(y), src.cols);
+        }
+    });
+}
+
+void ColorLut3D::ApplyRow(const cv::Vec3b* in, cv::Vec3b* out, int count) const
+{
+    const int n = m_gridSize;
+    const int strideB = n * n * 3;
+    const int strideG = n * 3;
+    const int strideR = 3;
+    const uint8_t* table = m_table.data();
+
+    for (int x = 0; x < count; ++x) {
+        const uint8_t b = in[x][0];
+        const uint8_t g = in[x][1];
+        const uint8_t r = in[x][2];
+        const float fb = m_fraction[b];
+        const float fg = m_fraction[g];
+        const float fr = m_fraction[r];
+        const uint8_t* c000 = table + m_lower[b] * strideB + m_lower[g] * strideG + m_lower[r] * strideR;
+        const uint8_t* c111 = c000 + strideB + strideG + strideR;
+
+        // Split the cell into six tetrahedra by the order of the
+        // fractions; each walks c000 -> one edge -> one face -> c111
+        const uint8_t* c1;
+        const uint8_t* c2;
+        float w0, w1, w2, w3;
+        if (fb >= fg) {
+            if (fg >= fr) {
+                c1 = c000 + strideB; c2 = c1 + strideG;
+                w1 = fb - fg; w2 = fg - fr; w3 = fr;
+            } else if (fb >= fr) {
+                c1 = c000 + strideB; c2 = c1 + strideR;
+                w1 = fb - fr; w2 = fr - fg; w3 = fg;
+            } else {
+                c1 = c000 + strideR; c2 = c1 + strideB;
+                w1 = fr - fb; w2 = fb - fg; w3 = fg;
+            }
+        } else {
+            if (fr >= fg) {
+                c1 = c000 + strideR; c2 = c1 + strideG;
+                w1 = fr - fg; w2 = fg - fb; w3 = fb;
+            } else if (fr >= fb) {
+                c1 = c000 + strideG; c2 = c1 + strideR;
+                w1 = fg - fr; w2 = fr - fb; w3 = fb;
+            } else {
+                c1 = c000 + strideG; c2 = c1 + strideB;
+                w1 = fg - fb; w2 = fb - fr; w3 = fr;
+            }
+        }
+        w0 = 1.0f - w1 - w2 - w3;
+
+        for (int ch = 0; ch < 3; ++ch) {
+            float v = w0 * c000[ch] + w1 * c1[ch] + w2 * c2[ch] + w3 * c111[ch];
+            out[x][ch] = static_cast<uchar>(v + 0.5f);
+        }
+    }
+}
+
+std::shared_ptr<const ColorLut3D> ColorLut3D::GetCached(const std::string& key, int gridSize,
+                                                        const Transform& transform)
+{
+    const std::string fullKey = key + "@" + std::to_string(gridSize);
+    LutCache& cache = GetLutCache();
+
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.tables.find(fullKey);
+        if (it != cache.tables.end()) {
+            return it->second;
+        }
+    }
+
+    // Build outside the lock; a concurrent builder of the same key just loses
+    auto lut = std::make_shared<ColorLut3D>();
+    if (!lut->Build(gridSize, transform)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto inserted = cache.tables.emplace(fullKey, lut);
+    if (inserted.second) {
+        cache.order.push_back(fullKey);
+        while (cache.order.size() > kMaxCachedTables) {
+            cache.tables.erase(cache.order.front());
+            cache.order.pop_front();
+        }
+    }
+    return inserted.first->second;
+}
+
+void ColorLut3D::ScaleSaturationValue(cv::Mat& image, double saturation, double value)
+{
+    // HSV round trip sampled once per factor pair; smooth, so interpolated
+    std::string key = "hsv_scale:" + std::to_string(saturation) + "," + std::to_string(value);
+    auto lut = GetCached(key, kSmoothGrid, [saturation, value](cv::Mat& colors) {
+        cv::Mat hsv;
+        cv::cvtColor(colors, hsv, cv::COLOR_BGR2HSV);
+        std::vector<cv::Mat> channels;
+        cv::split(hsv, channels);
+        channels[1] = channels[1] * saturation;     // Saturates at 255
+        channels[2] = channels[2] * value;
+        cv::merge(channels, hsv);
+        cv::cvtColor(hsv, colors, cv::COLOR_HSV2BGR);
+    });
+
+    if (lut) {
+        lut->Apply(image, image);
+    }
+}
+
+cv::Mat ColorLut3D::GetPosterizeTable(int step, int offset)
+{
+    step = std::max(1, step);
+    cv::Mat table(1, 256, CV_8U);
+    uint8_t* entries = table.ptr<uint8_t>();
+    for (int v = 0; v < 256; ++v) {
+        entries[v] = cv::saturate_cast<uint8_t>((v / step) * step + offset);
+    }
+    return table;
+}
+
+void ColorLut3D::Posterize(const cv::Mat& src, cv::Mat& dst, int step, int offset)
+{
+    cv::LUT(src, GetPosterizeTable(step, offset), dst);
+}
+
+#endif  // HAVE_OPENCV
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * 3D Color LUT
+ *
+ * Samples a smooth per-pixel color operation (HSV saturation and value
+ * scales, ...) once on an N x N x N grid of BGR colors and replaces the
+ * per-frame conversion loops with a tetrahedral lookup (four fetches) per
+ * pixel. Grid sizes are 17, 33 or 65.
+ *
+ * Tables are shared process-wide through GetCached(), keyed by the caller's
+ * parameter string, so changing a parameter rebuilds one small table instead
+ * of slowing every frame.
+ *
+ * Step functions such as posterization would be moved by grid sampling, and
+ * per-channel operations do not need a 3D table: Posterize() maps each
+ * channel through a 256-entry table, which is exact and cheaper.
+ */
+class ColorLut3D {
+public:
+    ColorLut3D();
+
+    bool IsBuilt() const { return !m_table.empty(); }
+    int GetGridSize() const { return m_gridSize; }
+
+#ifdef HAVE_OPENCV
+    /**
+     * Pixel-local operation on an 8-bit BGR image, applied in place. It is run
+     * once on an image holding every grid color, so it must not depend on
+     * neighboring pixels or on the image size.
+     */
+    using Transform = std::function<void(cv::Mat& colors)>;
+
+    /**
+     * Sample a transform on the grid
+     * @param gridSize Nodes per axis (17, 33 or 65; other values are rounded up)
+     * @return false if the transform changed the image size or type
+     */
+    bool Build(int gridSize, const Transform& transform);
+
+    // Map an 8-bit BGR image through the table (src and dst may alias)
+    void Apply(const cv::Mat& src, cv::Mat& dst) const;
+
+    /**
+     * Shared table for a parameter set, built on first use
+     * @param key Caller-chosen description of the transform and its parameters
+     */
+    static std::shared_ptr<const ColorLut3D> GetCached(const std::string& key, int gridSize,
+                                                       const Transform& transform);
+
+    // HSV saturation and value scale (saturating) through a shared table, in place
+    static void ScaleSaturationValue(cv::Mat& image, double saturation, double value = 1.0);
+
+    // Per-channel posterization table: v -> min(255, (v / step) * step + offset), 1 x 256 CV_8U
+    static cv::Mat GetPosterizeTable(int step, int offset);
+    // Posterize an 8-bit image exactly (cv::LUT with GetPosterizeTable)
+    static void Posterize(const cv::Mat& src, cv::Mat& dst, int step, int offset);
+#endif
+
+private:
+#ifdef HAVE_OPENCV
+    // Map one row of BGR pixels (in and out may alias)
+    void ApplyRow(const cv::Vec3b* in, cv::Vec3b* out, int count) const;
+#endif
+
+    int m_gridSize;
+    std::vector<uint8_t> m_table;       // BGR triples, index ((b * N) + g) * N + r
+
+    // Per 8-bit channel value: lower node and weight of the upper node
+    uint16_t m_lower[256];
+    float m_fraction[256];
+};
@@ -0,0 +1,254 @@
+#include "color_transfer.h"
+#include <algorithm>
+
+ColorTransferEngine::ColorTransferEngine()
+    : m_mode(HISTOGRAM),
+      m_sampleStride(4),
+      m_histogramDecay(0.3f),
+      m_samplePhase(0),
+      m_imageSignature(0),
+      m_imageHistValid(false),
+      m_referenceHistValid(false)
+{
+}
+
+void ColorTransferEngine::SetMode(Mode mode)
+{
+    if (mode != m_mode) {
+        m_mode = mode;
+        Reset();
+    }
+}
+
+void ColorTransferEngine::SetSampleStride(int stride)
+{
+    m_sampleStride = std::max(1, std::min(16, stride));
+    m_samplePhase = 0;
+}
+
+void ColorTransferEngine::SetHistogramDecay(float decay)
+{
+    m_histogramDecay = std::max(0.0f, std::min(1.0f, decay));
+}
+
+void ColorTransferEngine::Reset()
+{
+    m_samplePhase = 0;
+    m_imageSignature = 0;
+    m_imageHistValid = false;
+    m_referenceHistValid = false;
+}
+
+bool ColorTransferEngine::ParseMode(const std::string& name, Mode& mode)
+{
+    if (name == "histogram" || name == "0") {
+        mode = HISTOGRAM;
+    } else if (name == "mean_std" || name == "1") {
+        mode = MEAN_STD;
+    } else if (name == "cached_lut" || name == "2") {
+        mode = CACHED_LUT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string ColorTransferEngine::GetModeName(Mode mode)
+{
+    switch (mode) {
+        case HISTOGRAM: return "histogram";
+        case MEAN_STD: return "mean_std";
+        case CACHED_LUT: return "cached_lut";
+    }
+    return "unknown";
+}
+
+#ifdef HAVE_OPENCV
+
+cv::Mat ColorTransferEngine::Apply(const cv::Mat& image, const cv::Mat& reference)
+{
+    if (image.empty() || reference.empty() ||
+        image.type() != CV_8UC3 || reference.type() != CV_8UC3) {
+        return image.clone();
+    }
+
+    switch (m_mode) {
+        case HISTOGRAM:
+            return ApplyHistogram(image, reference);
+        case MEAN_STD:
+            return ApplyMeanStd(image, reference);
+        case CACHED_LUT:
+        default:
+            return ApplyCachedLUT(image, reference);
+    }
+}
+
+cv::Mat ColorTransferEngine::ApplyHistogram(const cv::Mat& image, const cv::Mat& reference)
+{
+    Histogram imageHist, referenceHist;
+    ComputeHistogram(image, 1, 0, imageHist);
+    ComputeHistogram(reference, 1, 0, referenceHist);
+    BuildMatchingLUT(imageHist, referenceHist, m_lut);
+
+    cv::Mat result;
+    cv::LUT(image, m_lut, result);
+    return result;
+}
+
+cv::Mat ColorTransferEngine::ApplyMeanStd(const cv::Mat& image, const cv::Mat& reference)
+{
+    cv::Mat imageLab, referenceLab;
+    cv::cvtColor(image, imageLab, cv::COLOR_BGR2Lab);
+    cv::cvtColor(reference, referenceLab, cv::COLOR_BGR2Lab);
+
+    cv::Scalar imageMean, imageStd, referenceMean, referenceStd;
+    cv::meanStdDev(imageLab, imageMean, imageStd);
+    cv::meanStdDev(referenceLab, referenceMean, referenceStd);
+
+    // The per-channel affine map (x - mu_i) * (sd_r / sd_i) + mu_r is exact as
+    // a 256-entry table on 8-bit Lab, so the remap is a single LUT pass
+    m_lut.create(1, 256, CV_8UC3);
+    cv::Vec3b* lut = m_lut.ptr<cv::Vec3b>(0);
+    for (int c = 0; c < 3; ++c) {
+        double scale = imageStd[c] > 1e-3 ? referenceStd[c] / imageStd[c] : 1.0;
+        for (int v = 0; v < 256; ++v) {
+            lut[v][c] = cv::saturate_cast<uchar>((v - imageMean[c]) * scale + referenceMean[c]);
+        }
+    }
+
+    cv::LUT(imageLab, m_lut, imageLab);
+
+    cv::Mat result;
+    cv::cvtColor(imageLab, result, cv::COLOR_Lab2BGR);
+    return result;
+}
+
+cv::Mat ColorTransferEngine::ApplyCachedLUT(const cv::Mat& image, const cv::Mat& reference)
+{
+    // The recolored image (target person face) rarely changes - only rebuild
+    // its histogram when the content signature changes
+    uint64_t signature = ComputeSignature(image);
+    if (!m_imageHistValid || signature != m_imageSignature) {
+        ComputeHistogram(image, 1, 0, m_imageHist);
+        m_imageSignature = signature;
+        m_imageHistValid = true;
+    }
+
+    // Sample the reference on a sparse grid whose offset rotates every call,
+    // so consecutive frames together cover every pixel
+    Histogram sampled;
+    int stride = m_sampleStride;
+    if (reference.rows < stride * 4 || reference.cols < stride * 4) {
+        stride = 1;
+    }
+    ComputeHistogram(reference, stride, m_samplePhase % (stride * stride), sampled);
+    m_samplePhase = (m_samplePhase + 1) % (m_sampleStride * m_sampleStride);
+
+    if (!m_referenceHistValid) {
+        m_referenceHist = sampled;
+        m_referenceHistValid = true;
+    } else {
+        float keep = 1.0f - m_histogramDecay;
+        for (int c = 0; c < 3; ++c) {
+            for (int v = 0; v < 256; ++v) {
+                m_referenceHist[c][v] = m_referenceHist[c][v] * keep + sampled[c][v] * m_histogramDecay;
+            }
+        }
+    }
+
+    BuildMatchingLUT(m_imageHist, m_referenceHist, m_lut);
+
+    cv::Mat result;
+    cv::LUT(image, m_lut, result);
+    return result;
+}
+
+void ColorTransferEngine::ComputeHistogram(const cv::Mat& image, int stride, int phase, Histogram& hist)
+{
+    // Integer counts first, normalized at the end so histograms sampled with
+    // different strides stay comparable
+    std::array<std::array<uint32_t, 256>, 3> counts{};
+
+    int offsetY = phase / stride;
+    int offsetX = phase % stride;
+    uint32_t samples = 0;
+
+    for (int y = offsetY; y < image.rows; y += stride) {
+        const cv::Vec3b* row = image.ptr<cv::Vec3b>(y);
+        for (int x = offsetX; x < image.cols; x += stride) {
+            counts[0][row[x][0]]++;
+            counts[1][row[x][1]]++;
+            counts[2][row[x][2]]++;
+            samples++;
+        }
+    }
+
+    float norm = samples > 0 ? 1.0f / samples : 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        for (int v = 0; v < 256; ++v) {
+            hist[c][v] = counts[c][v] * norm;
+        }
+    }
+}
+
+void ColorTransferEngine::BuildMatchingLUT(const Histogram& from, const Histogram& to, cv::Mat& lut)
+{
+    lut.create(1, 256, CV_8UC3);
+    cv::Vec3b* table = lut.ptr<cv::Vec3b>(0);
+
+    for (int c = 0; c < 3; ++c) {
+        std::array<float, 256> fromCDF, toCDF;
+        float fromSum = 0.0f, toSum = 0.0f;
+        for (int v = 0; v < 256; ++v) {
+            fromSum += from[c][v];
+            toSum += to[c][v];
+            fromCDF[v] = fromSum;
+            toCDF[v] = toSum;
+        }
+
+        if (fromSum <= 0.0f || toSum <= 0.0f) {
+            for (int v = 0; v < 256; ++v) {
+                table[v][c] = static_cast<uchar>(v);
+            }
+            continue;
+        }
+
+        // Both CDFs are monotonic, so the inverse lookup is a single merge walk
+        int k = 0;
+        for (int v = 0; v < 256; ++v) {
+            float target = fromCDF[v] / fromSum;
+            while (k < 255 && toCDF[k] / toSum < target) {
+                k++;
+            }
+            table[v][c] = static_cast<uchar>(k);
+        }
+    }
+}
+
+uint64_t ColorTransferEngine::ComputeSignature(const cv::Mat& image)
+{
+    // FNV-1a over the dimensions and a sparse 8x8 sample grid
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    mix(static_cast<uint64_t>(image.rows));
+    mix(static_cast<uint64_t>(image.cols));
+
+    for (int gy = 0; gy < 8; ++gy) {
+        int y = (image.rows - 1) * gy / 7;
+        const cv::Vec3b* row = image.ptr<cv::Vec3b>(y);
+        for (int gx = 0; gx < 8; ++gx) {
+            int x = (image.cols - 1) * gx / 7;
+            mix((static_cast<uint64_t>(row[x][0]) << 16) |
+                (static_cast<uint64_t>(row[x][1]) << 8) |
+                 static_cast<uint64_t>(row[x][2]));
+        }
+    }
+
+    return hash;
+}
+
+#endif  // HAVE_OPENCV
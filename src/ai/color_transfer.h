@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Color Transfer Engine
+ *
+ * Matches the color distribution of an image to a reference image, e.g. so a
+ * replacement face picks up the lighting of the live camera frame.
+ *
+ * Modes:
+ * - HISTOGRAM:  per-channel histogram/CDF matching, recomputed on every call
+ * - MEAN_STD:   mean/std transfer in Lab space (one statistics pass, one LUT remap)
+ * - CACHED_LUT: histogram matching where the recolored image's histogram is
+ *               cached and the reference histogram is updated incrementally
+ *               from a subsampled pixel grid
+ *
+ * All modes finish with a single 3-channel cv::LUT pass (no split/merge).
+ */
+class ColorTransferEngine {
+public:
+    enum Mode {
+        HISTOGRAM,
+        MEAN_STD,
+        CACHED_LUT
+    };
+
+    ColorTransferEngine();
+
+    void SetMode(Mode mode);
+    Mode GetMode() const { return m_mode; }
+
+    // Grid stride used when sampling the reference in CACHED_LUT mode (1-16)
+    void SetSampleStride(int stride);
+    int GetSampleStride() const { return m_sampleStride; }
+
+    // Weight of the newest samples in the running reference histogram (0.0-1.0)
+    void SetHistogramDecay(float decay);
+    float GetHistogramDecay() const { return m_histogramDecay; }
+
+    // Drop all cached histograms (e.g. when the target person changes)
+    void Reset();
+
+    static bool ParseMode(const std::string& name, Mode& mode);
+    static std::string GetModeName(Mode mode);
+
+#ifdef HAVE_OPENCV
+    /**
+     * Recolor an 8-bit BGR image so its color distribution matches the reference.
+     * The two images may have different sizes.
+     * @return Recolored copy of image (or a plain copy if inputs are unusable)
+     */
+    cv::Mat Apply(const cv::Mat& image, const cv::Mat& reference);
+#endif
+
+private:
+    // Normalized per-channel (B, G, R) histograms
+    using Histogram = std::array<std::array<float, 256>, 3>;
+
+#ifdef HAVE_OPENCV
+    cv::Mat ApplyHistogram(const cv::Mat& image, const cv::Mat& reference);
+    cv::Mat ApplyMeanStd(const cv::Mat& image, const cv::Mat& reference);
+    cv::Mat ApplyCachedLUT(const cv::Mat& image, const cv::Mat& reference);
+
+    static void ComputeHistogram(const cv::Mat& image, int stride, int phase, Histogram& hist);
+    static void BuildMatchingLUT(const Histogram& from, const Histogram& to, cv::Mat& lut);
+    static uint64_t ComputeSignature(const cv::Mat& image);
+
+    cv::Mat m_lut;  // 1x256 CV_8UC3 remap table
+#endif
+
+    Mode m_mode;
+    int m_sampleStride;
+    float m_histogramDecay;
+    int m_samplePhase;
+
+    // CACHED_LUT state
+    uint64_t m_imageSignature;
+    bool m_imageHistValid;
+    bool m_referenceHistValid;
+    Histogram m_imageHist;
+    Histogram m_referenceHist;
+};
@@ -0,0 +1,184 @@
+#include "ditherer.h"
+#include <algorithm>
+
+namespace {
+// Wavefront tile: kTileRows rows, kTileCols columns, each row shifted two
+// columns left of the one above so a pixel's upper-right inputs are already
+// final. kTileCols must be at least 2 * kTileRows + 2 for tiles on one
+// anti-diagonal to touch disjoint pixels.
+const int kTileRows = 16;
+const int kTileCols = 64;
+
+const int kBayerSize = 8;
+const uint8_t kBayer8[kBayerSize][kBayerSize] = {
+    { 0, 32,  8, 40,  2, 34, 10, 42},
+    {48, 16, 56, 24, 50, 18, 58, 26},
+    {12, 44,  4, 36, 14, 46,  6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22},
+    { 3, 35, 11, 43,  1, 33,  9, 41},
+    {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47,  7, 39, 13, 45,  5, 37},
+    {63, 31, 55, 23, 61, 29, 53, 21}
+};
+}
+
+Ditherer::Ditherer()
+    : m_method(WAVEFRONT)
+{
+}
+
+bool Ditherer::ParseMethod(const std::string& name, Method& method)
+{
+    if (name == "floyd_steinberg" || name == "fs") {
+        method = FLOYD_STEINBERG;
+    } else if (name == "wavefront") {
+        method = WAVEFRONT;
+    } else if (name == "bayer" || name == "ordered") {
+        method = ORDERED_BAYER;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string Ditherer::GetMethodName(Method method)
+{
+    switch (method) {
+        case FLOYD_STEINBERG: return "floyd_steinberg";
+        case WAVEFRONT: return "wavefront";
+        case ORDERED_BAYER: return "bayer";
+    }
+    return "unknown";
+}
+
+#ifdef HAVE_OPENCV
+
+void Ditherer::Apply(const cv::Mat& src, cv::Mat& dst)
+{
+    if (src.empty() || src.type() != CV_8UC3) {
+        if (dst.data != src.data) {
+            src.copyTo(dst);
+        }
+        return;
+    }
+
+    if (m_method == ORDERED_BAYER) {
+        OrderedBayer(src, dst);
+        return;
+    }
+
+    if (dst.data != src.data) {
+        src.copyTo(dst);
+    }
+    if (m_method == FLOYD_STEINBERG) {
+        FloydSteinberg(dst);
+    } else {
+        Wavefront(dst);
+    }
+}
+
+void Ditherer::FloydSteinberg(cv::Mat& dithered)
+{
+    // Floyd-Steinberg dithering for retro look
+    for (int y = 0; y < dithered.rows - 1; ++y) {
+        for (int x = 1; x < dithered.cols - 1; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                int oldPixel = dithered.at<cv::Vec3b>(y, x)[c];
+                int newPixel = (oldPixel > 128) ? 255 : 0;
+                dithered.at<cv::Vec3b>(y, x)[c] = newPixel;
+
+                int error = oldPixel - newPixel;
+
+                // Distribute error to neighboring pixels
+                dithered.at<cv::Vec3b>(y, x + 1)[c] =
+                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y, x + 1)[c] + error * 7 / 16);
+                dithered.at<cv::Vec3b>(y + 1, x - 1)[c] =
+                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y + 1, x - 1)[c] + error * 3 / 16);
+                dithered.at<cv::Vec3b>(y + 1, x)[c] =
+                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y + 1, x)[c] + error * 5 / 16);
+                dithered.at<cv::Vec3b>(y + 1, x + 1)[c] =
+                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y + 1, x + 1)[c] + error * 1 / 16);
+            }
+        }
+    }
+}
+
+void Ditherer::Wavefront(cv::Mat& image)
+{
+    // Same visiting rule as FloydSteinberg (rows 0..rows-2, columns
+    // 1..cols-2). Tile (band, j) waits for (band, j - 1) and (band - 1, j + 1),
+    // so all tiles with j + 2 * band == step can run at once, and every
+    // pixel still receives its error terms in row-major order (saturating
+    // adds do not commute, so the order matters for identical output).
+    const int lastRow = image.rows - 1;
+    const int cols = image.cols;
+    if (lastRow < 1 || cols < 3) {
+        return;
+    }
+
+    const int bands = (lastRow + kTileRows - 1) / kTileRows;
+    const int tilesPerBand = (cols + 2 * (kTileRows - 1) + kTileCols - 1) / kTileCols;
+    const int steps = tilesPerBand + 2 * (bands - 1);
+
+    for (int step = 0; step < steps; ++step) {
+        const int firstBand = std::max(0, (step - tilesPerBand + 2) / 2);
+        const int lastBand = std::min(bands - 1, step / 2);
+        if (firstBand > lastBand) {
+            continue;
+        }
+
+        cv::parallel_for_(cv::Range(firstBand, lastBand + 1), [&](const cv::Range& range) {
+            for (int band = range.start; band < range.end; ++band) {
+                const int tile = step - 2 * band;
+                const int y0 = band * kTileRows;
+                const int y1 = std::min(lastRow, y0 + kTileRows);
+
+                for (int y = y0; y < y1; ++y) {
+                    const int shift = 2 * (y - y0);
+                    const int x0 = std::max(1, tile * kTileCols - shift);
+                    const int x1 = std::min(cols - 1, tile * kTileCols - shift + kTileCols);
+                    uint8_t* row = image.ptr<uint8_t>(y);
+                    uint8_t* below = image.ptr<uint8_t>(y + 1);
+
+                    for (int x = x0; x < x1; ++x) {
+                        for (int c = 0; c < 3; ++c) {
+                            const int i = x * 3 + c;
+                            int oldPixel = row[i];
+                            int newPixel = (oldPixel > 128) ? 255 : 0;
+                            row[i] = static_cast<uint8_t>(newPixel);
+
+                            int error = oldPixel - newPixel;
+                            row[i + 3] = cv::saturate_cast<uint8_t>(row[i + 3] + error * 7 / 16);
+                            below[i - 3] = cv::saturate_cast<uint8_t>(below[i - 3] + error * 3 / 16);
+                            below[i] = cv::saturate_cast<uint8_t>(below[i] + error * 5 / 16);
+                            below[i + 3] = cv::saturate_cast<uint8_t>(below[i + 3] + error * 1 / 16);
+                        }
+                    }
+                }
+            }
+        });
+    }
+}
+
+void Ditherer::OrderedBayer(const cv::Mat& src, cv::Mat& dst)
+{
+    // Threshold map built once per frame size: channel value > threshold -> 255
+    if (m_thresholds.rows != src.rows || m_thresholds.cols != src.cols * 3) {
+        m_thresholds.create(src.rows, src.cols * 3, CV_8UC1);
+        for (int y = 0; y < src.rows; ++y) {
+            uint8_t* row = m_thresholds.ptr<uint8_t>(y);
+            for (int x = 0; x < src.cols; ++x) {
+                // Cell centers of 64 levels over 0-255
+                uint8_t threshold = static_cast<uint8_t>(kBayer8[y % kBayerSize][x % kBayerSize] * 4 + 2);
+                row[x * 3] = row[x * 3 + 1] = row[x * 3 + 2] = threshold;
+            }
+        }
+    }
+
+    // Per-element compare on the interleaved bytes (writes 255 / 0)
+    cv::Mat result;
+    cv::compare(src.reshape(1), m_thresholds, result, cv::CMP_GT);
+    result.reshape(3).copyTo(dst);
+}
+
+#endif  // HAVE_OPENCV
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Ditherer
+ *
+ * One-bit-per-channel dithering of 8-bit BGR images for the retro pixel art
+ * look (every channel ends up 0 or 255):
+ *
+ * - FLOYD_STEINBERG: serial error diffusion (reference, single core)
+ * - WAVEFRONT:       the same error diffusion, bit-identical output, with
+ *                    skewed tiles scheduled along anti-diagonals so tiles on
+ *                    one diagonal run on different threads
+ * - ORDERED_BAYER:   8x8 Bayer threshold map; every pixel is independent, so
+ *                    it is one vectorized compare over the whole frame
+ */
+class Ditherer {
+public:
+    enum Method {
+        FLOYD_STEINBERG,
+        WAVEFRONT,
+        ORDERED_BAYER
+    };
+
+    Ditherer();
+
+    void SetMethod(Method method) { m_method = method; }
+    Method GetMethod() const { return m_method; }
+
+    static bool ParseMethod(const std::string& name, Method& method);
+    static std::string GetMethodName(Method method);
+
+#ifdef HAVE_OPENCV
+    // Dither an 8-bit BGR image (src and dst may alias)
+    void Apply(const cv::Mat& src, cv::Mat& dst);
+#endif
+
+private:
+#ifdef HAVE_OPENCV
+    void FloydSteinberg(cv::Mat& image);
+    void Wavefront(cv::Mat& image);
+    void OrderedBayer(const cv::Mat& src, cv::Mat& dst);
+
+    cv::Mat m_thresholds;   // Bayer thresholds tiled to the last frame size, one byte per channel
+#endif
+
+    Method m_method;
+};
@@ -0,0 +1,252 @@
+#include "edge_preserving_smoother.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+const int kDomainIterations = 3;       // Separable H+V passes of the recursive filter
+// Domain transform sums |dI| over the three channels (L1) where the bilateral
+// filter uses the Euclidean color distance; scale sigma so edges stop alike
+const double kRangeScale = 1.7;
+}
+
+EdgePreservingSmoother::EdgePreservingSmoother()
+    : m_method(DOMAIN_TRANSFORM),
+      m_downscale(1)
+{
+}
+
+void EdgePreservingSmoother::SetDownscale(int factor)
+{
+    m_downscale = factor >= 4 ? 4 : (factor >= 2 ? 2 : 1);
+}
+
+bool EdgePreservingSmoother::ParseMethod(const std::string& name, Method& method)
+{
+    if (name == "bilateral") {
+        method = BILATERAL;
+    } else if (name == "domain_transform" || name == "dt") {
+        method = DOMAIN_TRANSFORM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string EdgePreservingSmoother::GetMethodName(Method method)
+{
+    switch (method) {
+        case BILATERAL: return "bilateral";
+        case DOMAIN_TRANSFORM: return "domain_transform";
+    }
+    return "unknown";
+}
+
+#ifdef HAVE_OPENCV
+
+void EdgePreservingSmoother::Apply(const cv::Mat& src, cv::Mat& dst, int diameter, double sigmaColor, int passes)
+{
+    if (src.empty() || src.type() != CV_8UC3) {
+        src.copyTo(dst);
+        return;
+    }
+
+    passes = std::max(1, passes);
+    int scale = m_downscale;
+    if (src.cols / scale < 16 || src.rows / scale < 16) {
+        scale = 1;
+    }
+
+    if (scale == 1) {
+        ApplyAtScale(src, dst, diameter, sigmaColor, passes, 1);
+        return;
+    }
+
+    // The upsampler reads the full-res guide while writing dst
+    cv::Mat guide = dst.data == src.data ? src.clone() : src;
+    cv::resize(guide, m_small, cv::Size(guide.cols / scale, guide.rows / scale), 0, 0, cv::INTER_AREA);
+    ApplyAtScale(m_small, m_smallSmoothed, diameter, sigmaColor, passes, scale);
+    JointUpsample(m_smallSmoothed, m_small, guide, dst, sigmaColor);
+}
+
+void EdgePreservingSmoother::ApplyAtScale(const cv::Mat& src, cv::Mat& dst, int diameter, double sigmaColor,
+                                          int passes, int scale)
+{
+    if (m_method == BILATERAL) {
+        int d = std::max(3, diameter / scale);
+        cv::Mat current = src;
+        cv::Mat temp;
+        for (int i = 0; i < passes; ++i) {
+            cv::bilateralFilter(current, temp, d, sigmaColor, sigmaColor);
+            current = temp.clone();
+        }
+        current.copyTo(dst);
+        return;
+    }
+
+    // One bilateral pass of diameter d is roughly a box of the same width
+    // (sigma ~ d / 3.5); n passes compound to sqrt(n) times that
+    double sigmaSpatial = diameter / 3.5 * std::sqrt(static_cast<double>(passes)) / scale;
+    DomainTransform(src, dst, std::max(0.5, sigmaSpatial), sigmaColor * kRangeScale);
+}
+
+void EdgePreservingSmoother::DomainTransform(const cv::Mat& src, cv::Mat& dst, double sigmaSpatial,
+                                             double sigmaRange)
+{
+    const int rows = src.rows;
+    const int cols = src.cols;
+    src.convertTo(m_image, CV_32FC3);
+    m_dx.create(rows, cols, CV_32F);
+    m_dy.create(rows, cols, CV_32F);
+    m_weights.create(rows, cols, CV_32F);
+
+    // Derivatives of the domain transform: 1 + (sigma_s / sigma_r) * sum_c |dI_c|
+    const float ratio = static_cast<float>(sigmaSpatial / sigmaRange);
+    cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            const cv::Vec3f* row = m_image.ptr<cv::Vec3f>(y);
+            const cv::Vec3f* above = m_image.ptr<cv::Vec3f>(std::max(0, y - 1));
+            float* dx = m_dx.ptr<float>(y);
+            float* dy = m_dy.ptr<float>(y);
+            dx[0] = 1.0f;
+            for (int x = 1; x < cols; ++x) {
+                dx[x] = 1.0f + ratio * (std::abs(row[x][0] - row[x - 1][0]) +
+                                        std::abs(row[x][1] - row[x - 1][1]) +
+                                        std::abs(row[x][2] - row[x - 1][2]));
+            }
+            for (int x = 0; x < cols; ++x) {
+                dy[x] = 1.0f + ratio * (std::abs(row[x][0] - above[x][0]) +
+                                        std::abs(row[x][1] - above[x][1]) +
+                                        std::abs(row[x][2] - above[x][2]));
+            }
+        }
+    });
+
+    const double normalizer = std::sqrt(std::pow(4.0, kDomainIterations) - 1.0);
+    for (int i = 0; i < kDomainIterations; ++i) {
+        // Halve the kernel each iteration so the passes sum to sigma_s
+        double sigmaPass = sigmaSpatial * std::sqrt(3.0) * std::pow(2.0, kDomainIterations - i - 1) / normalizer;
+        double logA = -std::sqrt(2.0) / sigmaPass;
+
+        // Feedback coefficient a^d per pixel
+        cv::multiply(m_dx, cv::Scalar(logA), m_weights);
+        cv::exp(m_weights, m_weights);
+
+        cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& range) {
+            for (int y = range.start; y < range.end; ++y) {
+                cv::Vec3f* row = m_image.ptr<cv::Vec3f>(y);
+                const float* w = m_weights.ptr<float>(y);
+                for (int x = 1; x < cols; ++x) {
+                    row[x] += w[x] * (row[x - 1] - row[x]);
+                }
+                for (int x = cols - 2; x >= 0; --x) {
+                    row[x] += w[x + 1] * (row[x + 1] - row[x]);
+                }
+            }
+        });
+
+        cv::multiply(m_dy, cv::Scalar(logA), m_weights);
+        cv::exp(m_weights, m_weights);
+
+        // Vertical recursion walks rows in order; column stripes keep the
+        // inner loop contiguous
+        cv::parallel_for_(cv::Range(0, cols), [&](const cv::Range& range) {
+            for (int y = 1; y < rows; ++y) {
+                cv::Vec3f* row = m_image.ptr<cv::Vec3f>(y);
+                const cv::Vec3f* prev = m_image.ptr<cv::Vec3f>(y - 1);
+                const float* w = m_weights.ptr<float>(y);
+                for (int x = range.start; x < range.end; ++x) {
+                    row[x] += w[x] * (prev[x] - row[x]);
+                }
+            }
+            for (int y = rows - 2; y >= 0; --y) {
+                cv::Vec3f* row = m_image.ptr<cv::Vec3f>(y);
+                const cv::Vec3f* next = m_image.ptr<cv::Vec3f>(y + 1);
+                const float* w = m_weights.ptr<float>(y + 1);
+                for (int x = range.start; x < range.end; ++x) {
+                    row[x] += w[x] * (next[x] - row[x]);
+                }
+            }
+        }, std::max(1, cols / 64));
+    }
+
+    m_image.convertTo(dst, CV_8UC3);
+}
+
+void EdgePreservingSmoother::JointUpsample(const cv::Mat& small, const cv::Mat& smallGuide, const cv::Mat& guide,
+                                           cv::Mat& dst, double sigmaRange)
+{
+    // Bilinear taps reweighted by how well each low-res guide sample matches
+    // the full-res guide pixel, so taps across an edge drop out
+    std::vector<float> rangeWeight(3 * 255 + 1);
+    const double sigma = std::max(1.0, sigmaRange * kRangeScale);
+    for (size_t d = 0; d < rangeWeight.size(); ++d) {
+        rangeWeight[d] = static_cast<float>(std::exp(-(static_cast<double>(d) * d) / (2.0 * sigma * sigma)));
+    }
+
+    const float scaleX = static_cast<float>(small.cols) / guide.cols;
+    const float scaleY = static_cast<float>(small.rows) / guide.rows;
+    std::vector<int> x0(guide.cols);
+    std::vector<int> x1(guide.cols);
+    std::vector<float> fx(guide.cols);
+    for (int x = 0; x < guide.cols; ++x) {
+        float sx = std::max(0.0f, (x + 0.5f) * scaleX - 0.5f);
+        x0[x] = std::min(static_cast<int>(sx), small.cols - 1);
+        x1[x] = std::min(x0[x] + 1, small.cols - 1);
+        fx[x] = std::min(1.0f, sx - x0[x]);
+    }
+
+    dst.create(guide.size(), CV_8UC3);
+    cv::parallel_for_(cv::Range(0, guide.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            float sy = std::max(0.0f, (y + 0.5f) * scaleY - 0.5f);
+            int y0 = std::min(static_cast<int>(sy), small.rows - 1);
+            int y1 = std::min(y0 + 1, small.rows - 1);
+            float fy = std::min(1.0f, sy - y0);
+
+            const cv::Vec3b* g = guide.ptr<cv::Vec3b>(y);
+            const cv::Vec3b* sg[2] = {smallGuide.ptr<cv::Vec3b>(y0), smallGuide.ptr<cv::Vec3b>(y1)};
+            const cv::Vec3b* sv[2] = {small.ptr<cv::Vec3b>(y0), small.ptr<cv::Vec3b>(y1)};
+            cv::Vec3b* out = dst.ptr<cv::Vec3b>(y);
+
+            for (int x = 0; x < guide.cols; ++x) {
+                const int xs[2] = {x0[x], x1[x]};
+                const float wxs[2] = {1.0f - fx[x], fx[x]};
+                const float wys[2] = {1.0f - fy, fy};
+
+                float sum[3] = {0.0f, 0.0f, 0.0f};
+                float bilinear[3] = {0.0f, 0.0f, 0.0f};
+                float total = 0.0f;
+                for (int j = 0; j < 2; ++j) {
+                    for (int i = 0; i < 2; ++i) {
+                        const cv::Vec3b& tapGuide = sg[j][xs[i]];
+                        const cv::Vec3b& tap = sv[j][xs[i]];
+                        int distance = std::abs(g[x][0] - tapGuide[0]) + std::abs(g[x][1] - tapGuide[1]) +
+                                       std::abs(g[x][2] - tapGuide[2]);
+                        float spatial = wxs[i] * wys[j];
+                        float w = spatial * rangeWeight[distance];
+                        for (int c = 0; c < 3; ++c) {
+                            sum[c] += w * tap[c];
+                            bilinear[c] += spatial * tap[c];
+                        }
+                        total += w;
+                    }
+                }
+
+                // No tap resembles this pixel (thin detail lost at low res): plain bilinear
+                if (total > 1e-4f) {
+                    float inv = 1.0f / total;
+                    out[x] = cv::Vec3b(cv::saturate_cast<uchar>(sum[0] * inv),
+                                       cv::saturate_cast<uchar>(sum[1] * inv),
+                                       cv::saturate_cast<uchar>(sum[2] * inv));
+                } else {
+                    out[x] = cv::Vec3b(cv::saturate_cast<uchar>(bilinear[0]),
+                                       cv::saturate_cast<uchar>(bilinear[1]),
+                                       cv::saturate_cast<uchar>(bilinear[2]));
+                }
+            }
+        }
+    });
+}
+
+#endif  // HAVE_OPENCV
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Edge-Preserving Smoother
+ *
+ * Color flattening for the cartoon filters. Callers describe the smoothing in
+ * bilateral terms (diameter, color sigma, passes) and the engine picks the
+ * implementation:
+ *
+ * - BILATERAL:        iterated cv::bilateralFilter (reference, cost grows
+ *                     with diameter and passes)
+ * - DOMAIN_TRANSFORM: recursive domain-transform filter (Gastal & Oliveira),
+ *                     three separable passes whose cost is O(pixels) for any
+ *                     spatial sigma
+ *
+ * With a downscale factor > 1 the filter runs on a reduced frame and is
+ * brought back with joint bilateral upsampling guided by the full-resolution
+ * input, so edges stay where the camera frame has them.
+ */
+class EdgePreservingSmoother {
+public:
+    enum Method {
+        BILATERAL,
+        DOMAIN_TRANSFORM
+    };
+
+    EdgePreservingSmoother();
+
+    void SetMethod(Method method) { m_method = method; }
+    Method GetMethod() const { return m_method; }
+
+    // Smoothing resolution divisor (1, 2 or 4)
+    void SetDownscale(int factor);
+    int GetDownscale() const { return m_downscale; }
+
+    static bool ParseMethod(const std::string& name, Method& method);
+    static std::string GetMethodName(Method method);
+
+#ifdef HAVE_OPENCV
+    /**
+     * Smooth an 8-bit BGR image
+     * @param diameter Bilateral neighborhood diameter of one pass
+     * @param sigmaColor Bilateral color sigma (0-255 scale)
+     * @param passes Number of bilateral passes the result should match
+     */
+    void Apply(const cv::Mat& src, cv::Mat& dst, int diameter, double sigmaColor, int passes);
+#endif
+
+private:
+#ifdef HAVE_OPENCV
+    void ApplyAtScale(const cv::Mat& src, cv::Mat& dst, int diameter, double sigmaColor, int passes, int scale);
+    void DomainTransform(const cv::Mat& src, cv::Mat& dst, double sigmaSpatial, double sigmaRange);
+    void JointUpsample(const cv::Mat& small, const cv::Mat& smallGuide, const cv::Mat& guide,
+                       cv::Mat& dst, double sigmaRange);
+
+    // Scratch reused across frames of the same size
+    cv::Mat m_image;        // CV_32FC3 working image
+    cv::Mat m_dx;           // Horizontal domain-transform derivative, CV_32F
+    cv::Mat m_dy;           // Vertical domain-transform derivative, CV_32F
+    cv::Mat m_weights;      // Per-pass feedback coefficients, CV_32F
+    cv::Mat m_small;
+    cv::Mat m_smallSmoothed;
+#endif
+
+    Method m_method;
+    int m_downscale;
+};
@@ -0,0 +1,410 @@
+#include "face_detection_service.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/dnn.hpp>
+#endif
+
+namespace {
+const float kDefaultDetectionScale = 0.5f;
+const int kDefaultMinFaceSize = 40;
+const int kDefaultDetectInterval = 5;
+const int kDefaultMaxMissed = 5;
+
+// Smallest face each backend finds, in pixels of the image it runs on
+// (cascade training window, YuNet's finest anchors)
+const int kCascadeWindow = 24;
+const int kYuNetWindow = 16;
+
+const double kCascadeScaleFactor = 1.1;
+const int kDefaultCascadeNeighbors = 4;
+const float kYuNetScore = 0.6f;
+const float kYuNetNms = 0.3f;
+const int kYuNetTopK = 50;
+
+// Region re-detection: search window of kRegionExpand x the predicted face,
+// scaled so the face is about kRegionFaceSize pixels, for faces between
+// kRegionMinRatio and kRegionMaxRatio of the predicted size
+const float kRegionExpand = 2.0f;
+const float kRegionFaceSize = 64.0f;
+const float kRegionMinRatio = 0.6f;
+const float kRegionMaxRatio = 1.6f;
+
+// Overlapping search windows can find one face twice
+const float kDuplicateIoU = 0.5f;
+
+std::vector<std::string> GetModelCandidates(FaceDetectionService::Backend backend)
+{
+    if (backend == FaceDetectionService::YUNET) {
+        return {
+            "models/face_detection_yunet_2023mar.onnx",
+            "models/face_detection_yunet_2022mar.onnx",
+            "../../../models/face_detection_yunet_2023mar.onnx"
+        };
+    }
+
+    const std::string file = backend == FaceDetectionService::HAAR ? "haarcascade_frontalface_default.xml"
+                                                                   : "lbpcascade_frontalface_improved.xml";
+    const std::string folder = backend == FaceDetectionService::HAAR ? "haarcascades/" : "lbpcascades/";
+    return {
+        file,
+        "data/" + file,
+        "../data/" + file,
+        "D:/DevTools/opencv/build/etc/" + folder + file,
+        "D:/DevTools/opencv/sources/data/" + folder + file,
+        "C:/opencv/build/etc/" + folder + file,
+        "C:/opencv/data/" + folder + file
+    };
+}
+
+#ifdef HAVE_OPENCV
+float IoU(const cv::Rect& a, const cv::Rect& b)
+{
+    int intersection = (a & b).area();
+    int unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0 ? static_cast<float>(intersection) / unionArea : 0.0f;
+}
+#endif
+}
+
+FaceDetectionService::FaceDetectionService()
+    : m_backend(HAAR),
+      m_loaded(false),
+      m_detectionScale(kDefaultDetectionScale),
+      m_minFaceSize(kDefaultMinFaceSize),
+      m_minNeighbors(kDefaultCascadeNeighbors),
+      m_detectInterval(kDefaultDetectInterval),
+      m_framesSinceSearch(0),
+      m_lastDetectMs(0.0),
+      m_lastFullSearch(false),
+      m_fullSearches(0),
+      m_regionSearches(0)
+{
+    // Report faces from their first detection; a missed re-detection coasts
+    m_tracker.SetMinHits(1);
+    m_tracker.SetMaxMissed(kDefaultMaxMissed);
+}
+
+bool FaceDetectionService::ParseBackend(const std::string& name, Backend& backend)
+{
+    if (name == "haar") {
+        backend = HAAR;
+    } else if (name == "lbp") {
+        backend = LBP;
+    } else if (name == "yunet") {
+        backend = YUNET;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string FaceDetectionService::GetBackendName(Backend backend)
+{
+    switch (backend) {
+        case HAAR: return "haar";
+        case LBP: return "lbp";
+        case YUNET: return "yunet";
+    }
+    return "unknown";
+}
+
+bool FaceDetectionService::IsBackendAvailable(Backend backend)
+{
+#ifdef HAVE_OPENCV
+#ifdef HAVE_FACE_DETECTOR_YN
+    (void)backend;
+    return true;
+#else
+    return backend != YUNET;
+#endif
+#else
+    (void)backend;
+    return false;
+#endif
+}
+
+bool FaceDetectionService::Load(Backend backend, const std::string& modelPath)
+{
+#ifdef HAVE_OPENCV
+    if (!IsBackendAvailable(backend)) {
+        MS_LOG_ERROR("[FaceDetection] " << GetBackendName(backend) << " needs OpenCV 4.5.4 or newer");
+        return false;
+    }
+
+    std::vector<std::string> candidates = modelPath.empty() ? GetModelCandidates(backend)
+                                                            : std::vector<std::string>{modelPath};
+    for (const auto& path : candidates) {
+        if (!std::filesystem::exists(path)) {
+            continue;
+        }
+
+        try {
+            if (backend == YUNET) {
+#ifdef HAVE_FACE_DETECTOR_YN
+                cv::Ptr<cv::FaceDetectorYN> yunet = cv::FaceDetectorYN::create(
+                    path, "", cv::Size(320, 320), kYuNetScore, kYuNetNms, kYuNetTopK,
+                    cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_CPU);
+                if (!yunet) {
+                    continue;
+                }
+                m_yunet = yunet;
+#endif
+                m_cascade = cv::CascadeClassifier();
+            } else {
+                cv::CascadeClassifier cascade;
+                if (!cascade.load(path)) {
+                    continue;
+                }
+                m_cascade = cascade;
+#ifdef HAVE_FACE_DETECTOR_YN
+                m_yunet.release();
+#endif
+            }
+        } catch (const cv::Exception& e) {
+            MS_LOG_ERROR("[FaceDetection] Failed to load " << path << ": " << e.what());
+            continue;
+        }
+
+        m_backend = backend;
+        m_modelPath = path;
+        m_loaded = true;
+        ResetTracking();
+        MS_LOG_INFO("[FaceDetection] Loaded " << GetBackendName(backend) << " detector from: " << path);
+        return true;
+    }
+
+    MS_LOG_WARN("[FaceDetection] Could not load a " << GetBackendName(backend) << " detector"
+                << (modelPath.empty() ? "" : " from " + modelPath));
+    return false;
+#else
+    (void)backend;
+    (void)modelPath;
+    return false;
+#endif
+}
+
+bool FaceDetectionService::LoadFrom(const FaceDetectionService& other)
+{
+    if (!other.IsLoaded() || !Load(other.m_backend, other.m_modelPath)) {
+        return false;
+    }
+    m_detectionScale = other.m_detectionScale;
+    m_minFaceSize = other.m_minFaceSize;
+    m_minNeighbors = other.m_minNeighbors;
+    m_detectInterval = other.m_detectInterval;
+    m_tracker.SetMaxMissed(other.m_tracker.GetMaxMissed());
+    return true;
+}
+
+void FaceDetectionService::SetDetectionScale(float scale)
+{
+    m_detectionScale = std::max(0.1f, std::min(1.0f, scale));
+}
+
+void FaceDetectionService::SetMinFaceSize(int pixels)
+{
+    m_minFaceSize = std::max(8, pixels);
+}
+
+void FaceDetectionService::SetMinNeighbors(int neighbors)
+{
+    m_minNeighbors = std::max(1, neighbors);
+}
+
+void FaceDetectionService::SetDetectInterval(int frames)
+{
+    m_detectInterval = std::max(1, frames);
+}
+
+void FaceDetectionService::SetMaxMissed(int frames)
+{
+    m_tracker.SetMaxMissed(frames);
+}
+
+void FaceDetectionService::ResetTracking()
+{
+    m_tracker.Reset();
+    m_framesSinceSearch = 0;
+}
+
+#ifdef HAVE_OPENCV
+
+void FaceDetectionService::Detect(const cv::Mat& frame, std::vector<cv::Rect>& faces)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    faces.clear();
+
+    if (m_loaded && !frame.empty()) {
+        cv::Mat bgr = frame;
+        if (frame.channels() == 4) {
+            cv::cvtColor(frame, bgr, cv::COLOR_BGRA2BGR);
+        }
+
+        try {
+            SearchFrame(bgr, faces);
+            m_fullSearches++;
+        } catch (const cv::Exception& e) {
+            MS_LOG_ERROR("[FaceDetection] Exception: " << e.what());
+            faces.clear();
+        }
+    }
+
+    m_lastFullSearch = true;
+    m_lastDetectMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void FaceDetectionService::Track(const cv::Mat& frame, std::vector<cv::Rect>& faces)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    faces.clear();
+
+    if (!m_loaded || frame.empty()) {
+        m_lastDetectMs = 0.0;
+        return;
+    }
+
+    cv::Mat bgr = frame;
+    if (frame.channels() == 4) {
+        cv::cvtColor(frame, bgr, cv::COLOR_BGRA2BGR);
+    }
+
+    m_framesSinceSearch++;
+    const bool fullSearch = m_tracker.GetTrackCount() == 0 || m_framesSinceSearch >= m_detectInterval;
+
+    m_candidates.clear();
+    try {
+        if (fullSearch) {
+            SearchFrame(bgr, m_candidates);
+            m_fullSearches++;
+            m_framesSinceSearch = 0;
+        } else {
+            for (size_t i = 0; i < m_tracker.GetTrackCount(); ++i) {
+                float x, y, width, height;
+                m_tracker.GetPredictedBox(i, 1.0f, x, y, width, height);
+                SearchRegion(bgr, cv::Rect2f(x, y, width, height), m_candidates);
+            }
+        }
+    } catch (const cv::Exception& e) {
+        MS_LOG_ERROR("[FaceDetection] Exception: " << e.what());
+        m_candidates.clear();
+    }
+
+    m_detections.clear();
+    for (size_t i = 0; i < m_candidates.size(); ++i) {
+        const cv::Rect& box = m_candidates[i];
+        bool duplicate = false;
+        for (size_t j = 0; j < i && !duplicate; ++j) {
+            duplicate = IoU(box, m_candidates[j]) > kDuplicateIoU;
+        }
+        if (!duplicate) {
+            m_detections.push_back({static_cast<float>(box.x), static_cast<float>(box.y),
+                                    static_cast<float>(box.width), static_cast<float>(box.height), 1.0f});
+        }
+    }
+    m_tracker.Update(m_detections, 1.0f);
+
+    const cv::Rect bounds(0, 0, bgr.cols, bgr.rows);
+    for (size_t i = 0; i < m_tracker.GetTrackCount(); ++i) {
+        if (!m_tracker.IsConfirmed(i)) continue;
+
+        float x, y, width, height;
+        m_tracker.GetBox(i, x, y, width, height);
+        cv::Rect face = cv::Rect(cvRound(x), cvRound(y), cvRound(width), cvRound(height)) & bounds;
+        if (!face.empty()) {
+            faces.push_back(face);
+        }
+    }
+
+    m_lastFullSearch = fullSearch;
+    m_lastDetectMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void FaceDetectionService::SearchFrame(const cv::Mat& bgr, std::vector<cv::Rect>& faces)
+{
+    // Shrink no further than keeps min_face_size at the detector's window
+    const int window = GetDetectorWindow();
+    const float scale = std::min(1.0f, std::max(m_detectionScale, static_cast<float>(window) / m_minFaceSize));
+
+    cv::Mat level = bgr;
+    if (scale < 1.0f) {
+        cv::resize(bgr, m_level, cv::Size(), scale, scale, cv::INTER_AREA);
+        level = m_level;
+    }
+    RunDetector(level, std::max(window, cvRound(m_minFaceSize * scale)), 0, scale, cv::Point(), faces);
+}
+
+void FaceDetectionService::SearchRegion(const cv::Mat& bgr, const cv::Rect2f& predicted, std::vector<cv::Rect>& faces)
+{
+    const float size = std::max(predicted.width, predicted.height);
+    if (size < 1.0f) {
+        return;
+    }
+
+    const float half = size * kRegionExpand * 0.5f;
+    const float centerX = predicted.x + predicted.width * 0.5f;
+    const float centerY = predicted.y + predicted.height * 0.5f;
+    cv::Rect region(cvFloor(centerX - half), cvFloor(centerY - half), cvCeil(half * 2.0f), cvCeil(half * 2.0f));
+    region &= cv::Rect(0, 0, bgr.cols, bgr.rows);
+    if (region.empty()) {
+        return;
+    }
+
+    const float scale = std::min(1.0f, kRegionFaceSize / size);
+    cv::Mat level = bgr(region);
+    if (scale < 1.0f) {
+        cv::resize(bgr(region), m_level, cv::Size(), scale, scale, cv::INTER_AREA);
+        level = m_level;
+    }
+
+    const float faceSize = size * scale;
+    const int window = GetDetectorWindow();
+    const int minSize = std::max(window, cvRound(std::max(m_minFaceSize * scale, faceSize * kRegionMinRatio)));
+    const int maxSize = std::max(minSize + 1, cvRound(faceSize * kRegionMaxRatio));
+    RunDetector(level, minSize, maxSize, scale, region.tl(), faces);
+    m_regionSearches++;
+}
+
+void FaceDetectionService::RunDetector(const cv::Mat& image, int minSize, int maxSize, float scale,
+                                       const cv::Point& offset, std::vector<cv::Rect>& faces)
+{
+    const float inverse = 1.0f / scale;
+
+    if (m_backend == YUNET) {
+#ifdef HAVE_FACE_DETECTOR_YN
+        // Rows of [x, y, w, h, 5 landmarks (x, y), score]
+        m_yunet->setInputSize(image.size());
+        m_yunet->detect(image, m_yunetFaces);
+        for (int row = 0; row < m_yunetFaces.rows; ++row) {
+            const float* data = m_yunetFaces.ptr<float>(row);
+            const float size = std::max(data[2], data[3]);
+            if (size < minSize || (maxSize > 0 && size > maxSize)) continue;
+
+            faces.emplace_back(offset.x + cvRound(data[0] * inverse), offset.y + cvRound(data[1] * inverse),
+                               cvRound(data[2] * inverse), cvRound(data[3] * inverse));
+        }
+#endif
+        return;
+    }
+
+    cv::cvtColor(image, m_gray, cv::COLOR_BGR2GRAY);
+    cv::equalizeHist(m_gray, m_gray);
+    m_cascade.detectMultiScale(m_gray, m_boxes, kCascadeScaleFactor, m_minNeighbors, 0,
+                               cv::Size(minSize, minSize), maxSize > 0 ? cv::Size(maxSize, maxSize) : cv::Size());
+    for (const cv::Rect& box : m_boxes) {
+        faces.emplace_back(offset.x + cvRound(box.x * inverse), offset.y + cvRound(box.y * inverse),
+                           cvRound(box.width * inverse), cvRound(box.height * inverse));
+    }
+}
+
+int FaceDetectionService::GetDetectorWindow() const
+{
+    return m_backend == YUNET ? kYuNetWindow : kCascadeWindow;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "multi_object_tracker.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#include <opencv2/objdetect.hpp>
+
+// cv::FaceDetectorYN (YuNet on cv::dnn) exists from OpenCV 4.5.4
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || \
+    (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 4)))
+#define HAVE_FACE_DETECTOR_YN 1
+#endif
+#endif
+
+/**
+ * Face Detection Service
+ *
+ * Face boxes for the face filter and person replacement processors, with
+ * one place that knows how to find and run the detectors:
+ *
+ * - HAAR:  Haar cascade (haarcascade_frontalface_default.xml)
+ * - LBP:   LBP cascade (lbpcascade_frontalface_improved.xml), integer
+ *          features, several times faster than Haar at similar recall on
+ *          frontal faces
+ * - YUNET: YuNet CNN through cv::FaceDetectorYN / cv::dnn
+ *          (models/face_detection_yunet_*.onnx), best recall on turned
+ *          and partly covered faces
+ *
+ * Detect() searches the whole frame on a downscaled pyramid level (scale
+ * raised as needed so min_face_size stays above the detector's window).
+ * Track() is for camera streams: a full search every detect_interval frames
+ * (and while nothing is tracked), otherwise only a window around each
+ * tracked face's predicted box is re-detected at a fixed face size. Boxes
+ * go through a MultiObjectTracker, so faces coast on their Kalman
+ * prediction for a few frames when a re-detection misses.
+ *
+ * Cascades and nets are not thread-safe: use one instance per thread
+ * (LoadFrom() gives a worker its own copy of a configured service).
+ */
+class FaceDetectionService {
+public:
+    enum Backend {
+        HAAR,
+        LBP,
+        YUNET
+    };
+
+    FaceDetectionService();
+
+    /**
+     * Load a backend
+     * @param modelPath Cascade XML / YuNet ONNX; empty searches the usual locations
+     * @return false (previous backend kept) if nothing could be loaded
+     */
+    bool Load(Backend backend, const std::string& modelPath = "");
+    // Load the same backend and model as `other` and copy its settings
+    bool LoadFrom(const FaceDetectionService& other);
+    bool IsLoaded() const { return m_loaded; }
+    Backend GetBackend() const { return m_backend; }
+    const std::string& GetModelPath() const { return m_modelPath; }
+
+    static bool ParseBackend(const std::string& name, Backend& backend);
+    static std::string GetBackendName(Backend backend);
+    // YUNET needs OpenCV 4.5.4 or newer
+    static bool IsBackendAvailable(Backend backend);
+
+    // Smallest pyramid level for full-frame searches (default 0.5)
+    void SetDetectionScale(float scale);
+    float GetDetectionScale() const { return m_detectionScale; }
+
+    // Smallest face reported, in frame pixels (default 40)
+    void SetMinFaceSize(int pixels);
+    int GetMinFaceSize() const { return m_minFaceSize; }
+
+    // Cascade backends: overlapping hits needed to keep a face (default 4, lower finds more)
+    void SetMinNeighbors(int neighbors);
+    int GetMinNeighbors() const { return m_minNeighbors; }
+
+    // Track(): frames between full-frame searches (default 5, 1 = every frame)
+    void SetDetectInterval(int frames);
+    int GetDetectInterval() const { return m_detectInterval; }
+
+    // Track(): frames a face survives on its prediction without a detection (default 5)
+    void SetMaxMissed(int frames);
+
+    void ResetTracking();
+
+    double GetLastDetectMs() const { return m_lastDetectMs; }
+    bool WasLastFullSearch() const { return m_lastFullSearch; }
+    uint64_t GetFullSearchCount() const { return m_fullSearches; }
+    uint64_t GetRegionSearchCount() const { return m_regionSearches; }
+
+#ifdef HAVE_OPENCV
+    // Stateless full-frame detection (8-bit BGR or BGRA)
+    void Detect(const cv::Mat& frame, std::vector<cv::Rect>& faces);
+    // Detection with tracking state for consecutive frames of one stream
+    void Track(const cv::Mat& frame, std::vector<cv::Rect>& faces);
+#endif
+
+private:
+#ifdef HAVE_OPENCV
+    void SearchFrame(const cv::Mat& bgr, std::vector<cv::Rect>& faces);
+    void SearchRegion(const cv::Mat& bgr, const cv::Rect2f& predicted, std::vector<cv::Rect>& faces);
+    // Run the backend on `image` (already scaled); boxes are mapped back by 1 / scale + offset
+    void RunDetector(const cv::Mat& image, int minSize, int maxSize, float scale,
+                     const cv::Point& offset, std::vector<cv::Rect>& faces);
+    int GetDetectorWindow() const;
+
+    cv::CascadeClassifier m_cascade;
+#ifdef HAVE_FACE_DETECTOR_YN
+    cv::Ptr<cv::FaceDetectorYN> m_yunet;
+#endif
+
+    // Scratch reused across frames
+    cv::Mat m_level;
+    cv::Mat m_gray;
+    cv::Mat m_yunetFaces;
+    std::vector<cv::Rect> m_boxes;
+    std::vector<cv::Rect> m_candidates;
+    std::vector<MultiObjectTracker::Detection> m_detections;
+#endif
+
+    Backend m_backend;
+    bool m_loaded;
+    std::string m_modelPath;
+    float m_detectionScale;
+    int m_minFaceSize;
+    int m_minNeighbors;
+    int m_detectInterval;
+    int m_framesSinceSearch;
+
+    MultiObjectTracker m_tracker;
+
+    double m_lastDetectMs;
+    bool m_lastFullSearch;
+    uint64_t m_fullSearches;
+    uint64_t m_regionSearches;
+};
@@ -1,5 +1,7 @@
 #include "face_filter_processor.h"
-#include <iostream>
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <cmath>
 
@@ -8,13 +10,40 @@
 #include <opencv2/imgproc.hpp>
 #endif
 
+namespace {
+// Detection settings the filter has always used: smaller and less certain
+// faces than the service defaults, so distant faces still get accessories
+const int kFaceMinSize = 30;
+const int kFaceMinNeighbors = 3;
+
+// Sprite cache keys; variants use consecutive keys
+enum SpriteKey {
+    kGlassesSprite = 1,
+    kGlassesImageSprite,
+    kShineSprite,
+    kHatSprite,                         // + color index
+    kHatImageSprite = kHatSprite + 3,
+    kPompomSprite,
+    kBubbleSprite,                      // + dot pulse
+    kPointerSprite = kBubbleSprite + 4
+};
+const int kHatColors = 3;
+const int kBubblePulses = 4;
+
+// Transparent border around drawn sprites for outlines centered on the shape edge
+const int kSpritePadding = 3;
+}
+
 FaceFilterProcessor::FaceFilterProcessor()
-    : m_glassesEnabled(true)
+    : m_overlayMs(0.0)
+    , m_glassesEnabled(true)
     , m_hatEnabled(true)
     , m_speechBubbleEnabled(true)
     , m_speechBubbleText("Hello Meeting!")
     , m_frameCounter(0)
 {
+    m_faceService.SetMinFaceSize(kFaceMinSize);
+    m_faceService.SetMinNeighbors(kFaceMinNeighbors);
 }
 
 FaceFilterProcessor::~FaceFilterProcessor() {
@@ -24,48 +53,25 @@ FaceFilterProcessor::~FaceFilterProcessor() {
 bool FaceFilterProcessor::Initialize() {
 #ifdef HAVE_OPENCV
     try {
-        // Load face detection cascade
-        std::string cascadePath = "haarcascade_frontalface_default.xml";
-
-        // Try multiple possible locations for the cascade file
-        std::vector<std::string> possiblePaths = {
-            cascadePath,
-            "data/" + cascadePath,
-            "../data/" + cascadePath,
-            "D:/DevTools/opencv/build/etc/haarcascades/" + cascadePath,
-            "D:/DevTools/opencv/sources/data/haarcascades/" + cascadePath,
-            "C:/opencv/data/haarcascades/" + cascadePath
-        };
-
-        bool cascadeLoaded = false;
-        for (const auto& path : possiblePaths) {
-            if (faceCascade.load(path)) {
-                std::cout << "[FaceFilter] Loaded face cascade from: " << path << std::endl;
-                cascadeLoaded = true;
-                break;
-            }
-        }
-
-        if (!cascadeLoaded) {
-            std::cerr << "[FaceFilter] Failed to load face cascade classifier!" << std::endl;
-            std::cerr << "[FaceFilter] Please ensure OpenCV data files are available." << std::endl;
+        // Face detector: the backend chosen via face_detector, else Haar
+        if (!m_faceService.IsLoaded() && !m_faceService.Load(FaceDetectionService::HAAR)) {
+            MS_LOG_ERROR("[FaceFilter] Failed to load a face detector!");
+            MS_LOG_ERROR("[FaceFilter] Please ensure OpenCV data files are available.");
             return false;
         }
 
-        std::cout << "[FaceFilter] Face cascade loaded successfully" << std::endl;
-
         // Load accessory images
         glassesImage = LoadAccessoryImage("glasses.png");
         hatImage = LoadAccessoryImage("funny_hat.png");
 
-        std::cout << "[FaceFilter] Face Filter Processor initialized successfully" << std::endl;
+        MS_LOG_INFO("[FaceFilter] Face Filter Processor initialized successfully");
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "[FaceFilter] Initialization error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[FaceFilter] Initialization error: " << e.what());
         return false;
     }
 #else
-    std::cerr << "[FaceFilter] OpenCV not available - Face Filter Processor disabled" << std::endl;
+    MS_LOG_ERROR("[FaceFilter] OpenCV not available - Face Filter Processor disabled");
     return false;
 #endif
 }
@@ -81,17 +87,18 @@ Frame FaceFilterProcessor::ProcessFrame(const Frame& input) {
     try {
         // Detect faces
         std::vector<cv::Rect> faces;
-        DetectFaces(input.data, faces);
+        m_faceService.Track(input.data, faces);
 
-        std::cout << "[FaceFilter] Detected " << faces.size() << " faces in frame " << m_frameCounter << std::endl;
+        MS_LOG_DEBUG("[FaceFilter] Detected " << faces.size() << " faces in frame " << m_frameCounter);
 
         // Add status text to show filter is active
         cv::putText(output.data, "FACE FILTER ACTIVE", cv::Point(10, 30), 
                    cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 255, 0), 2);
 
         // Apply effects to detected faces
+        auto overlayStart = std::chrono::steady_clock::now();
         for (const auto& face : faces) {
-            std::cout << "[FaceFilter] Processing face at (" << face.x << "," << face.y << ") size " << face.width << "x" << face.height << std::endl;
+            MS_LOG_DEBUG("[FaceFilter] Processing face at (" << face.x << "," << face.y << ") size " << face.width << "x" << face.height);
             
             // Always draw a visible rectangle around detected faces for debugging
             cv::rectangle(output.data, face, cv::Scalar(0, 255, 0), 3); // Green rectangle
@@ -106,11 +113,12 @@ Frame FaceFilterProcessor::ProcessFrame(const Frame& input) {
                 AddSpeechBubble(output.data, face, m_speechBubbleText);
             }
         }
+        m_overlayMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - overlayStart).count();
 
         m_frameCounter++;
 
     } catch (const std::exception& e) {
-        std::cerr << "[FaceFilter] Frame processing error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[FaceFilter] Frame processing error: " << e.what());
         // Return original frame on error
     }
 #endif
@@ -123,9 +131,10 @@ void FaceFilterProcessor::Cleanup() {
     // Release resources
     glassesImage.release();
     hatImage.release();
-    faceCascade = cv::CascadeClassifier();
 #endif
-    std::cout << "[FaceFilter] Face Filter Processor cleaned up" << std::endl;
+    m_spriteCache.Clear();
+    m_faceService.ResetTracking();
+    MS_LOG_INFO("[FaceFilter] Face Filter Processor cleaned up");
 }
 
 std::string FaceFilterProcessor::GetName() const {
@@ -151,7 +160,22 @@ bool FaceFilterProcessor::SetParameter(const std::string& name, const std::strin
         m_speechBubbleEnabled = (value == "true" || value == "1");
         return true;
     } else if (name == "speech_bubble_text") {
-        m_speechBubbleText = value;
+        SetSpeechBubbleText(value);
+        return true;
+    } else if (name == "face_detector") {
+        FaceDetectionService::Backend backend;
+        return FaceDetectionService::ParseBackend(value, backend) && m_faceService.Load(backend);
+    } else if (name == "face_detect_interval") {
+        m_faceService.SetDetectInterval(std::stoi(value));
+        return true;
+    } else if (name == "face_detection_scale") {
+        m_faceService.SetDetectionScale(std::stof(value));
+        return true;
+    } else if (name == "face_min_size") {
+        m_faceService.SetMinFaceSize(std::stoi(value));
+        return true;
+    } else if (name == "face_min_neighbors") {
+        m_faceService.SetMinNeighbors(std::stoi(value));
         return true;
     }
     return false;
@@ -162,7 +186,14 @@ std::map<std::string, std::string> FaceFilterProcessor::GetParameters() const {
         {"glasses_enabled", m_glassesEnabled ? "true" : "false"},
         {"hat_enabled", m_hatEnabled ? "true" : "false"},
         {"speech_bubble_enabled", m_speechBubbleEnabled ? "true" : "false"},
-        {"speech_bubble_text", m_speechBubbleText}
+        {"speech_bubble_text", m_speechBubbleText},
+        {"face_detector", FaceDetectionService::GetBackendName(m_faceService.GetBackend())},
+        {"face_detect_interval", std::to_string(m_faceService.GetDetectInterval())},
+        {"face_detection_scale", std::to_string(m_faceService.GetDetectionScale())},
+        {"face_min_size", std::to_string(m_faceService.GetMinFaceSize())},
+        {"face_min_neighbors", std::to_string(m_faceService.GetMinNeighbors())},
+        {"face_detect_ms", std::to_string(m_faceService.GetLastDetectMs())},
+        {"overlay_ms", std::to_string(m_overlayMs)}
     };
 }
 
@@ -183,118 +214,132 @@ void FaceFilterProcessor::SetSpeechBubbleEnabled(bool enabled) {
 }
 
 void FaceFilterProcessor::SetSpeechBubbleText(const std::string& text) {
+    if (text == m_speechBubbleText) return;
     m_speechBubbleText = text;
+
+    // Bubble sprites contain the rendered text
+    for (int pulse = 0; pulse < kBubblePulses; ++pulse) {
+        m_spriteCache.Invalidate(kBubbleSprite + pulse);
+    }
 }
 
 #ifdef HAVE_OPENCV
 
-void FaceFilterProcessor::DetectFaces(const cv::Mat& frame, std::vector<cv::Rect>& faces) {
-    if (faceCascade.empty()) {
-        std::cerr << "[FaceFilter] Face cascade not loaded!" << std::endl;
+void FaceFilterProcessor::AddVirtualGlasses(cv::Mat& frame, const cv::Rect& face) {
+    // Calculate glass dimensions based on face size (bucketed, so the sprite is reused)
+    int faceSize = m_spriteCache.QuantizeSize(face.width);
+    int glassesWidth = faceSize * 0.7;
+    int glassesHeight = glassesWidth * 0.4;
+    int glassesX = face.x + face.width / 2 - glassesWidth / 2;
+    int glassesY = static_cast<int>(face.y + face.height * 0.35) - glassesHeight / 2;
+    const int pad = kSpritePadding;
+
+    if (!glassesImage.empty()) {
+        int imageHeight = std::max(1, glassesWidth * glassesImage.rows / glassesImage.cols);
+        const auto& sprite = m_spriteCache.Get(kGlassesImageSprite, glassesWidth, imageHeight,
+            [this](cv::Mat& bgra) { cv::resize(glassesImage, bgra, bgra.size(), 0, 0, cv::INTER_AREA); });
+        SpriteCache::Composite(frame, sprite, cv::Point(glassesX, glassesY + glassesHeight / 2 - imageHeight / 2));
         return;
     }
 
-    cv::Mat gray;
-    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray, gray);
+    const auto& glasses = m_spriteCache.Get(kGlassesSprite, glassesWidth + 2 * pad, glassesHeight + 2 * pad,
+        [&](cv::Mat& bgra) {
+            const cv::Scalar lensColor(100, 200, 255, 255);  // Cyan
+            int centerY = pad + glassesHeight / 2;
+
+            // Left and right lens
+            for (int lensX : {pad + glassesWidth / 4, pad + 3 * glassesWidth / 4}) {
+                cv::ellipse(bgra, cv::Point(lensX, centerY), cv::Size(glassesWidth / 4, glassesHeight / 2),
+                            0, 0, 360, lensColor, 3);   // Outline
+                cv::ellipse(bgra, cv::Point(lensX, centerY), cv::Size(glassesWidth / 4 - 3, glassesHeight / 2 - 3),
+                            0, 0, 360, lensColor, -1);  // Filled
+            }
 
-    // Detect faces
-    faceCascade.detectMultiScale(gray, faces, 1.1, 3, 0, cv::Size(30, 30));
-    
-    std::cout << "[FaceFilter] Face detection completed, found " << faces.size() << " faces" << std::endl;
-}
-
-void FaceFilterProcessor::AddVirtualGlasses(cv::Mat& frame, const cv::Rect& face) {
-    // Calculate glass dimensions based on face size
-    int eyeY = face.y + face.height * 0.35;
-    int glassesWidth = face.width * 0.7;
-    int glassesHeight = glassesWidth * 0.4;
-    int glassesX = face.x + face.width * 0.15;
-    int glassesY = eyeY - glassesHeight / 2;
-
-    // Draw left lens
-    cv::ellipse(frame, 
-                cv::Point(glassesX + glassesWidth / 4, glassesY + glassesHeight / 2),
-                cv::Size(glassesWidth / 4, glassesHeight / 2),
-                0, 0, 360, cv::Scalar(100, 200, 255), 3);  // Cyan outline
-    cv::ellipse(frame, 
-                cv::Point(glassesX + glassesWidth / 4, glassesY + glassesHeight / 2),
-                cv::Size(glassesWidth / 4 - 3, glassesHeight / 2 - 3),
-                0, 0, 360, cv::Scalar(100, 200, 255), -1);  // Filled cyan
-
-    // Draw right lens
-    cv::ellipse(frame, 
-                cv::Point(glassesX + 3 * glassesWidth / 4, glassesY + glassesHeight / 2),
-                cv::Size(glassesWidth / 4, glassesHeight / 2),
-                0, 0, 360, cv::Scalar(100, 200, 255), 3);  // Cyan outline
-    cv::ellipse(frame, 
-                cv::Point(glassesX + 3 * glassesWidth / 4, glassesY + glassesHeight / 2),
-                cv::Size(glassesWidth / 4 - 3, glassesHeight / 2 - 3),
-                0, 0, 360, cv::Scalar(100, 200, 255), -1);  // Filled cyan
-
-    // Draw bridge between lenses
-    int bridgeY = glassesY + glassesHeight / 2;
-    cv::line(frame,
-             cv::Point(glassesX + glassesWidth / 4 + glassesWidth / 8, bridgeY),
-             cv::Point(glassesX + 3 * glassesWidth / 4 - glassesWidth / 8, bridgeY),
-             cv::Scalar(100, 200, 255), 2);
+            // Bridge between lenses
+            cv::line(bgra,
+                     cv::Point(pad + glassesWidth / 4 + glassesWidth / 8, centerY),
+                     cv::Point(pad + 3 * glassesWidth / 4 - glassesWidth / 8, centerY),
+                     lensColor, 2);
+        });
+    SpriteCache::Composite(frame, glasses, cv::Point(glassesX - pad, glassesY - pad));
 
     // Add shine effect (animation based on frame counter)
-    int shineOffset = (m_frameCounter / 5) % (glassesWidth / 4);
-    cv::line(frame,
-             cv::Point(glassesX + glassesWidth / 4 - glassesWidth / 8 + shineOffset, glassesY + glassesHeight / 4),
-             cv::Point(glassesX + glassesWidth / 4 - glassesWidth / 8 + shineOffset + glassesWidth / 8, glassesY + glassesHeight / 4 - glassesHeight / 8),
-             cv::Scalar(255, 255, 200), 2);  // Light yellow shine
+    int shineWidth = glassesWidth / 8;
+    int shineHeight = glassesHeight / 8;
+    const auto& shine = m_spriteCache.Get(kShineSprite, shineWidth + 2 * pad, shineHeight + 2 * pad,
+        [&](cv::Mat& bgra) {
+            cv::line(bgra, cv::Point(pad, pad + shineHeight), cv::Point(pad + shineWidth, pad),
+                     cv::Scalar(255, 255, 200, 255), 2);  // Light yellow shine
+        });
+    int shineOffset = (m_frameCounter / 5) % std::max(1, glassesWidth / 4);
+    SpriteCache::Composite(frame, shine,
+                           cv::Point(glassesX + glassesWidth / 4 - shineWidth + shineOffset - pad,
+                                     glassesY + glassesHeight / 4 - shineHeight - pad));
 }
 
 void FaceFilterProcessor::AddFunnyHat(cv::Mat& frame, const cv::Rect& face) {
     // Draw a party hat above the face
+    int faceSize = m_spriteCache.QuantizeSize(face.width);
     int hatX = face.x + face.width / 2;
     int hatY = face.y - face.height * 0.3;
-    int hatWidth = face.width * 0.6;
-    int hatHeight = face.height * 0.4;
-
-    // Hat color changes based on frame counter for animation
-    int colorCycle = (m_frameCounter / 10) % 3;
-    cv::Scalar hatColor;
-    switch (colorCycle) {
-        case 0: hatColor = cv::Scalar(0, 255, 255);    break;  // Cyan
-        case 1: hatColor = cv::Scalar(255, 0, 255);    break;  // Magenta
-        case 2: hatColor = cv::Scalar(255, 255, 0);    break;  // Yellow
-        default: hatColor = cv::Scalar(0, 255, 255);   break;  // Cyan
+    int hatWidth = faceSize * 0.6;
+    int hatHeight = faceSize * 0.4;
+    const int brim = 5;  // Hat base overhang
+    const int pad = kSpritePadding;
+
+    if (!hatImage.empty()) {
+        int imageWidth = hatWidth + 2 * brim;
+        int imageHeight = std::max(1, imageWidth * hatImage.rows / hatImage.cols);
+        const auto& sprite = m_spriteCache.Get(kHatImageSprite, imageWidth, imageHeight,
+            [this](cv::Mat& bgra) { cv::resize(hatImage, bgra, bgra.size(), 0, 0, cv::INTER_AREA); });
+        SpriteCache::Composite(frame, sprite, cv::Point(hatX - imageWidth / 2, hatY + hatHeight + brim - imageHeight));
+        return;
     }
 
-    // Draw hat body (triangle)
-    std::vector<cv::Point> hatPoints = {
-        cv::Point(hatX, hatY + hatHeight),           // Bottom middle
-        cv::Point(hatX - hatWidth / 2, hatY),        // Top left
-        cv::Point(hatX + hatWidth / 2, hatY)         // Top right
-    };
-    cv::fillConvexPoly(frame, hatPoints, hatColor);
-    std::vector<std::vector<cv::Point>> hatPointsVec = {hatPoints};
-    cv::polylines(frame, hatPointsVec, true, cv::Scalar(0, 0, 0), 2, cv::LINE_AA);  // Black outline
-
-    // Draw hat base
-    cv::rectangle(frame,
-                  cv::Point(hatX - hatWidth / 2 - 5, hatY + hatHeight - 10),
-                  cv::Point(hatX + hatWidth / 2 + 5, hatY + hatHeight + 5),
-                  hatColor, -1);
-    cv::rectangle(frame,
-                  cv::Point(hatX - hatWidth / 2 - 5, hatY + hatHeight - 10),
-                  cv::Point(hatX + hatWidth / 2 + 5, hatY + hatHeight + 5),
-                  cv::Scalar(0, 0, 0), 2);
-
-    // Draw pom-pom on top (bobbing animation)
+    // Hat color changes based on frame counter for animation (one sprite per color)
+    int colorIndex = (m_frameCounter / 10) % kHatColors;
+    const auto& hat = m_spriteCache.Get(kHatSprite + colorIndex,
+                                        hatWidth + 2 * (brim + pad), hatHeight + brim + 2 * pad,
+        [&](cv::Mat& bgra) {
+            static const cv::Scalar hatColors[kHatColors] = {
+                cv::Scalar(0, 255, 255, 255),   // Cyan
+                cv::Scalar(255, 0, 255, 255),   // Magenta
+                cv::Scalar(255, 255, 0, 255)    // Yellow
+            };
+            const cv::Scalar& hatColor = hatColors[colorIndex];
+            const cv::Scalar outline(0, 0, 0, 255);
+            int centerX = brim + pad + hatWidth / 2;
+
+            // Hat body (triangle)
+            std::vector<cv::Point> hatPoints = {
+                cv::Point(centerX, pad + hatHeight),            // Bottom middle
+                cv::Point(centerX - hatWidth / 2, pad),         // Top left
+                cv::Point(centerX + hatWidth / 2, pad)          // Top right
+            };
+            cv::fillConvexPoly(bgra, hatPoints, hatColor);
+            std::vector<std::vector<cv::Point>> hatPointsVec = {hatPoints};
+            cv::polylines(bgra, hatPointsVec, true, outline, 2, cv::LINE_AA);  // Black outline
+
+            // Hat base
+            cv::Point baseTopLeft(centerX - hatWidth / 2 - brim, pad + hatHeight - 10);
+            cv::Point baseBottomRight(centerX + hatWidth / 2 + brim, pad + hatHeight + brim);
+            cv::rectangle(bgra, baseTopLeft, baseBottomRight, hatColor, -1);
+            cv::rectangle(bgra, baseTopLeft, baseBottomRight, outline, 2);
+        });
+    SpriteCache::Composite(frame, hat, cv::Point(hatX - hatWidth / 2 - brim - pad, hatY - pad));
+
+    // Pom-pom on top (bobbing animation)
     int pompomOffset = (int)(3 * sin(m_frameCounter * 0.1));  // Sine wave bob
-    int pompomRadius = hatWidth / 8;
-    cv::circle(frame,
-               cv::Point(hatX, hatY - pompomRadius + pompomOffset),
-               pompomRadius,
-               cv::Scalar(255, 100, 100), -1);  // Red pom-pom
-    cv::circle(frame,
-               cv::Point(hatX, hatY - pompomRadius + pompomOffset),
-               pompomRadius,
-               cv::Scalar(0, 0, 0), 2);  // Black outline
+    int pompomRadius = std::max(1, hatWidth / 8);
+    int pompomSize = 2 * (pompomRadius + pad);
+    const auto& pompom = m_spriteCache.Get(kPompomSprite, pompomSize, pompomSize,
+        [&](cv::Mat& bgra) {
+            cv::Point center(pompomRadius + pad, pompomRadius + pad);
+            cv::circle(bgra, center, pompomRadius, cv::Scalar(255, 100, 100, 255), -1);  // Red pom-pom
+            cv::circle(bgra, center, pompomRadius, cv::Scalar(0, 0, 0, 255), 2);         // Black outline
+        });
+    SpriteCache::Composite(frame, pompom,
+                           cv::Point(hatX - pompomRadius - pad, hatY - 2 * pompomRadius + pompomOffset - pad));
 }
 
 void FaceFilterProcessor::AddSpeechBubble(cv::Mat& frame, const cv::Rect& face, const std::string& text) {
@@ -311,61 +356,58 @@ void FaceFilterProcessor::AddSpeechBubble(cv::Mat& frame, const cv::Rect& face,
     // Clamp to frame boundaries
     int drawX = bubbleX - bubbleWidth / 2;
     int drawY = bubbleY - bubbleHeight;
-    
+
     if (drawX < 10) drawX = 10;
     if (drawY < 10) drawY = 10;
     if (drawX + bubbleWidth > frame.cols - 10) drawX = frame.cols - bubbleWidth - 10;
 
-    // Draw bubble background with gradient effect
-    cv::Scalar bubbleBG = cv::Scalar(255, 255, 200);    // Light yellow
-    cv::Scalar bubbleBorder = cv::Scalar(0, 0, 0);      // Black border
-    cv::Scalar textColor = cv::Scalar(0, 0, 0);         // Black text
-
-    // Draw filled rectangle
-    cv::rectangle(frame,
-                  cv::Point(drawX, drawY),
-                  cv::Point(drawX + bubbleWidth, drawY + bubbleHeight),
-                  bubbleBG, -1);
-
-    // Draw border
-    cv::rectangle(frame,
-                  cv::Point(drawX, drawY),
-                  cv::Point(drawX + bubbleWidth, drawY + bubbleHeight),
-                  bubbleBorder, 2);
+    const cv::Scalar bubbleBG(255, 255, 200, 255);     // Light yellow
+    const cv::Scalar bubbleBorder(0, 0, 0, 255);       // Black border
+    const int pad = kSpritePadding;
+
+    // Bubble with text, one sprite per dot pulse. Keyed by size only:
+    // SetSpeechBubbleText() invalidates them when the text changes
+    int pulse = (m_frameCounter / 5) % kBubblePulses;
+    const auto& bubble = m_spriteCache.Get(kBubbleSprite + pulse, bubbleWidth + 2 * pad, bubbleHeight + 2 * pad,
+        [&](cv::Mat& bgra) {
+            cv::Point topLeft(pad, pad);
+            cv::Point bottomRight(pad + bubbleWidth, pad + bubbleHeight);
+            cv::rectangle(bgra, topLeft, bottomRight, bubbleBG, -1);
+            cv::rectangle(bgra, topLeft, bottomRight, bubbleBorder, 2);
+
+            // Add text with wrapping
+            std::string displayText = text;
+            if (displayText.length() > 20) {
+                displayText = displayText.substr(0, 17) + "...";
+            }
+            cv::putText(bgra, displayText,
+                        cv::Point(pad + 10, pad + bubbleHeight - 12),
+                        cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 0, 255), 1);  // Black text
+
+            // Animated dots (pulsing effect)
+            if (pulse > 0) {
+                cv::putText(bgra, std::string(pulse, '.'),
+                            cv::Point(pad + bubbleWidth - 30, pad + bubbleHeight - 12),
+                            cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(100, 100, 255, 255), 1);
+            }
+        });
+    SpriteCache::Composite(frame, bubble, cv::Point(drawX - pad, drawY - pad));
 
-    // Draw pointer triangle to face
+    // Pointer triangle to face
     int pointerX = face.x + face.width / 2;
     int pointerY = bubbleY + bubbleHeight;
-    
-    std::vector<cv::Point> pointerPoints = {
-        cv::Point(pointerX, pointerY + 15),
-        cv::Point(pointerX - 10, pointerY),
-        cv::Point(pointerX + 10, pointerY)
-    };
-    cv::fillConvexPoly(frame, pointerPoints, bubbleBG);
-    std::vector<std::vector<cv::Point>> pointerPointsVec = {pointerPoints};
-    cv::polylines(frame, pointerPointsVec, true, bubbleBorder, 2);
-
-    // Add text with wrapping
-    std::string displayText = text;
-    if (displayText.length() > 20) {
-        displayText = displayText.substr(0, 17) + "...";
-    }
-
-    cv::putText(frame, displayText,
-                cv::Point(drawX + 10, drawY + bubbleHeight - 12),
-                cv::FONT_HERSHEY_SIMPLEX, 0.5, textColor, 1);
-
-    // Add animated dots (pulsing effect)
-    int pulse = (m_frameCounter / 5) % 4;
-    std::string dots = "";
-    for (int i = 0; i < pulse; i++) dots += ".";
-    
-    if (!dots.empty()) {
-        cv::putText(frame, dots,
-                    cv::Point(drawX + bubbleWidth - 30, drawY + bubbleHeight - 12),
-                    cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(100, 100, 255), 1);
-    }
+    const auto& pointer = m_spriteCache.Get(kPointerSprite, 20 + 2 * pad, 15 + 2 * pad,
+        [&](cv::Mat& bgra) {
+            std::vector<cv::Point> pointerPoints = {
+                cv::Point(pad + 10, pad + 15),
+                cv::Point(pad, pad),
+                cv::Point(pad + 20, pad)
+            };
+            cv::fillConvexPoly(bgra, pointerPoints, bubbleBG);
+            std::vector<std::vector<cv::Point>> pointerPointsVec = {pointerPoints};
+            cv::polylines(bgra, pointerPointsVec, true, bubbleBorder, 2);
+        });
+    SpriteCache::Composite(frame, pointer, cv::Point(pointerX - 10 - pad, pointerY - pad));
 }
 
 cv::Mat FaceFilterProcessor::LoadAccessoryImage(const std::string& filename) {
@@ -383,63 +425,29 @@ cv::Mat FaceFilterProcessor::LoadAccessoryImage(const std::string& filename) {
     for (const auto& path : possiblePaths) {
         image = cv::imread(path, cv::IMREAD_UNCHANGED);
         if (!image.empty()) {
-            std::cout << "[FaceFilter] Loaded accessory: " << path << std::endl;
+            MS_LOG_INFO("[FaceFilter] Loaded accessory: " << path);
             break;
         }
     }
 
     if (image.empty()) {
-        std::cout << "[FaceFilter] Could not load accessory: " << filename << std::endl;
-        std::cout << "[FaceFilter] Creating placeholder accessory..." << std::endl;
-
-        // Create a simple colored rectangle as placeholder
-        if (filename.find("glasses") != std::string::npos) {
-            image = cv::Mat(50, 100, CV_8UC4, cv::Scalar(0, 255, 255, 128)); // Semi-transparent cyan
-        } else if (filename.find("hat") != std::string::npos) {
-            image = cv::Mat(60, 120, CV_8UC4, cv::Scalar(255, 0, 255, 128)); // Semi-transparent magenta
-        }
+        MS_LOG_INFO("[FaceFilter] Could not load accessory: " << filename << " (using built-in drawing)");
+        return image;
     }
 
-    return image;
-}
-
-void FaceFilterProcessor::OverlayImage(cv::Mat& background, const cv::Mat& overlay, const cv::Point& position) {
-    if (overlay.empty()) return;
-
-    // Ensure overlay fits within background bounds
-    cv::Rect roi(position.x, position.y, overlay.cols, overlay.rows);
-    roi = roi & cv::Rect(0, 0, background.cols, background.rows);
-
-    if (roi.width <= 0 || roi.height <= 0) return;
-
-    // Extract the region of interest
-    cv::Mat backgroundROI = background(roi);
-
-    // Handle different overlay formats
-    if (overlay.channels() == 4) { // RGBA overlay
-        cv::Mat overlayROI = overlay(cv::Rect(0, 0, roi.width, roi.height));
-
-        // Split channels
-        std::vector<cv::Mat> overlayChannels;
-        cv::split(overlayROI, overlayChannels);
-
-        // Create mask from alpha channel
-        cv::Mat mask = overlayChannels[3];
-
-        // Blend images
-        cv::Mat blended;
-        cv::addWeighted(backgroundROI, 1.0, overlayROI, 0.0, 0.0, blended);
-
-        // Apply mask
-        overlayChannels[0].copyTo(blended, mask);
-        overlayChannels[1].copyTo(blended, mask);
-        overlayChannels[2].copyTo(blended, mask);
-
-        blended.copyTo(backgroundROI);
-    } else { // Regular BGR overlay
-        cv::Mat overlayROI = overlay(cv::Rect(0, 0, roi.width, roi.height));
-        overlayROI.copyTo(backgroundROI);
+    // Sprites are scaled from a premultiplied 8-bit BGRA copy, so resampling
+    // does not bleed the color of transparent pixels into the edges
+    if (image.depth() != CV_8U) {
+        image.convertTo(image, CV_8U, image.depth() == CV_16U ? 1.0 / 257.0 : 1.0);
+    }
+    cv::Mat bgra;
+    switch (image.channels()) {
+        case 4: bgra = image; break;
+        case 3: cv::cvtColor(image, bgra, cv::COLOR_BGR2BGRA); break;
+        default: cv::cvtColor(image, bgra, cv::COLOR_GRAY2BGRA); break;
     }
+    SpriteCache::Premultiply(bgra);
+    return bgra;
 }
 
-#endif // HAVE_OPENCV
\ No newline at end of file
+#endif // HAVE_OPENCV
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ai_processor.h"
+#include "face_detection_service.h"
+#include "sprite_cache.h"
 #include <atomic>
 
 #ifdef HAVE_OPENCV
@@ -10,6 +12,10 @@
 /**
  * Face Filter Processor - adds funny virtual accessories to detected faces
  * Perfect for video calls and meetings!
+ *
+ * Accessories are sprites: rendered once per face size bucket (speech
+ * bubble: once per text) into the sprite cache and composited every frame.
+ * Animation only moves small parts (shine, pom-pom) or picks a variant.
  */
 class FaceFilterProcessor : public AIProcessor {
 public:
@@ -34,21 +40,24 @@ public:
     void SetSpeechBubbleText(const std::string& text);
 
 private:
+    // Face detection and tracking (backend selectable via face_detector)
+    FaceDetectionService m_faceService;
+
+    // Pre-rendered accessories (premultiplied, per size bucket)
+    SpriteCache m_spriteCache;
+    double m_overlayMs;
+
 #ifdef HAVE_OPENCV
-    // Face detection and overlay methods
-    void DetectFaces(const cv::Mat& frame, std::vector<cv::Rect>& faces);
+    // Overlay methods
     void AddVirtualGlasses(cv::Mat& frame, const cv::Rect& face);
     void AddFunnyHat(cv::Mat& frame, const cv::Rect& face);
     void AddSpeechBubble(cv::Mat& frame, const cv::Rect& face, const std::string& text);
 
     // Helper methods
+    // Premultiplied BGRA, empty if not found
     cv::Mat LoadAccessoryImage(const std::string& filename);
-    void OverlayImage(cv::Mat& background, const cv::Mat& overlay, const cv::Point& position);
-
-    // Face detection cascade
-    cv::CascadeClassifier faceCascade;
 
-    // Accessory images
+    // Accessory images (empty = built-in drawing)
     cv::Mat glassesImage;
     cv::Mat hatImage;
 
@@ -0,0 +1,321 @@
+#include "face_index.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char kFaceIndexMagic[4] = {'M', 'S', 'F', 'I'};
+const uint32_t kFaceIndexVersion = 1;
+}
+
+FaceIndex::FaceIndex()
+    : m_data(nullptr),
+      m_size(0)
+#ifdef _WIN32
+    , m_fileHandle(nullptr),
+      m_mappingHandle(nullptr)
+#else
+    , m_fileDescriptor(-1)
+#endif
+{
+}
+
+FaceIndex::~FaceIndex()
+{
+    Close();
+}
+
+std::string FaceIndex::GetSidecarPath(const std::string& videoPath)
+{
+    return videoPath + ".faceidx";
+}
+
+bool FaceIndex::Open(const std::string& sidecarPath)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(sidecarPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(sidecarPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    m_fileDescriptor = fd;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    // Validate header and section sizes before trusting any offsets. Counts
+    // are 32-bit, so the frame and box sections fit in 64 bits; the embedding
+    // section (boxCount x embeddingDim) is checked by division instead.
+    const Header* header = GetHeader();
+    const uint64_t payload = static_cast<uint64_t>(m_size) - sizeof(Header);
+    const uint64_t fixedSections = static_cast<uint64_t>(header->frameCount) * sizeof(FrameEntry) +
+                                   static_cast<uint64_t>(header->boxCount) * sizeof(Box);
+    bool sizesValid = fixedSections <= payload;
+    if (sizesValid && header->embeddingDim > 0) {
+        const uint64_t embeddingFloats = (payload - fixedSections) / sizeof(float);
+        sizesValid = header->boxCount <= embeddingFloats / header->embeddingDim;
+    }
+
+    if (std::memcmp(header->magic, kFaceIndexMagic, 4) != 0 ||
+        header->version != kFaceIndexVersion || !sizesValid) {
+        MS_LOG_ERROR("[FaceIndex] Invalid or truncated sidecar: " << sidecarPath);
+        Close();
+        return false;
+    }
+
+    // Every frame's box range must lie inside the box section
+    const FrameEntry* entries = GetFrameEntries();
+    for (uint32_t i = 0; i < header->frameCount; ++i) {
+        if (static_cast<uint64_t>(entries[i].firstBox) + entries[i].boxCount > header->boxCount) {
+            MS_LOG_ERROR("[FaceIndex] Corrupt frame entry " << i << " in sidecar: " << sidecarPath);
+            Close();
+            return false;
+        }
+    }
+
+    MS_LOG_INFO("[FaceIndex] Mapped " << sidecarPath << " (" << header->frameCount << " frames, "
+              << header->boxCount << " faces)");
+    return true;
+}
+
+void FaceIndex::Close()
+{
+#ifdef _WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle) {
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if (m_fileHandle) {
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    }
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+#else
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    if (m_fileDescriptor >= 0) {
+        ::close(m_fileDescriptor);
+    }
+    m_fileDescriptor = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+int FaceIndex::GetFrameCount() const
+{
+    return m_data ? static_cast<int>(GetHeader()->frameCount) : 0;
+}
+
+int FaceIndex::GetEmbeddingDim() const
+{
+    return m_data ? static_cast<int>(GetHeader()->embeddingDim) : 0;
+}
+
+const float* FaceIndex::GetEmbedding(int frameIndex, int faceIndex) const
+{
+    if (!m_data || frameIndex < 0 || frameIndex >= GetFrameCount() || GetEmbeddingDim() == 0) {
+        return nullptr;
+    }
+
+    const FrameEntry& entry = GetFrameEntries()[frameIndex];
+    if (faceIndex < 0 || static_cast<uint32_t>(faceIndex) >= entry.boxCount) {
+        return nullptr;
+    }
+
+    const Header* header = GetHeader();
+    const float* embeddings = reinterpret_cast<const float*>(
+        reinterpret_cast<const uint8_t*>(GetBoxes()) + header->boxCount * sizeof(Box));
+    return embeddings + static_cast<size_t>(entry.firstBox + faceIndex) * header->embeddingDim;
+}
+
+const FaceIndex::Header* FaceIndex::GetHeader() const
+{
+    return reinterpret_cast<const Header*>(m_data);
+}
+
+const FaceIndex::FrameEntry* FaceIndex::GetFrameEntries() const
+{
+    return reinterpret_cast<const FrameEntry*>(m_data + sizeof(Header));
+}
+
+const FaceIndex::Box* FaceIndex::GetBoxes() const
+{
+    return reinterpret_cast<const Box*>(
+        m_data + sizeof(Header) + GetHeader()->frameCount * sizeof(FrameEntry));
+}
+
+#ifdef HAVE_OPENCV
+
+std::vector<cv::Rect> FaceIndex::GetFaces(int frameIndex) const
+{
+    std::vector<cv::Rect> faces;
+    if (!m_data || frameIndex < 0 || frameIndex >= GetFrameCount()) {
+        return faces;
+    }
+
+    const FrameEntry& entry = GetFrameEntries()[frameIndex];
+    const Box* boxes = GetBoxes() + entry.firstBox;
+    faces.reserve(entry.boxCount);
+    for (uint32_t i = 0; i < entry.boxCount; ++i) {
+        faces.emplace_back(boxes[i].x, boxes[i].y, boxes[i].width, boxes[i].height);
+    }
+    return faces;
+}
+
+bool FaceIndex::Build(const std::string& videoPath, const std::string& sidecarPath,
+                      const FaceDetector& detector, const FaceEmbedder& embedder)
+{
+    if (!detector) {
+        return false;
+    }
+
+    cv::VideoCapture capture(videoPath);
+    if (!capture.isOpened()) {
+        MS_LOG_ERROR("[FaceIndex] Failed to open video: " << videoPath);
+        return false;
+    }
+
+    MS_LOG_INFO("[FaceIndex] Indexing faces in " << videoPath << "...");
+
+    std::vector<FrameEntry> frames;
+    std::vector<Box> boxes;
+    std::vector<float> embeddings;
+    uint32_t embeddingDim = 0;
+    bool storeEmbeddings = static_cast<bool>(embedder);
+
+    cv::Mat frame;
+    while (capture.read(frame) && !frame.empty()) {
+        FrameEntry entry;
+        entry.firstBox = static_cast<uint32_t>(boxes.size());
+        entry.boxCount = 0;
+
+        cv::Rect bounds(0, 0, frame.cols, frame.rows);
+        for (const auto& face : detector(frame)) {
+            cv::Rect clipped = face & bounds;
+            if (clipped.area() <= 0) {
+                continue;
+            }
+
+            if (storeEmbeddings) {
+                std::vector<float> embedding = embedder(frame(clipped));
+                if (embeddingDim == 0) {
+                    embeddingDim = static_cast<uint32_t>(embedding.size());
+                }
+                if (embedding.empty() || embedding.size() != embeddingDim) {
+                    // Inconsistent embedder output - keep boxes only
+                    storeEmbeddings = false;
+                    embeddings.clear();
+                    embeddingDim = 0;
+                } else {
+                    embeddings.insert(embeddings.end(), embedding.begin(), embedding.end());
+                }
+            }
+
+            Box box;
+            box.x = static_cast<int16_t>(clipped.x);
+            box.y = static_cast<int16_t>(clipped.y);
+            box.width = static_cast<int16_t>(clipped.width);
+            box.height = static_cast<int16_t>(clipped.height);
+            boxes.push_back(box);
+            entry.boxCount++;
+        }
+
+        frames.push_back(entry);
+    }
+
+    if (frames.empty()) {
+        MS_LOG_ERROR("[FaceIndex] No frames decoded from: " << videoPath);
+        return false;
+    }
+
+    Header header;
+    std::memcpy(header.magic, kFaceIndexMagic, 4);
+    header.version = kFaceIndexVersion;
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.boxCount = static_cast<uint32_t>(boxes.size());
+    header.embeddingDim = storeEmbeddings ? embeddingDim : 0;
+    header.reserved = 0;
+    header.fps = capture.get(cv::CAP_PROP_FPS);
+
+    std::ofstream out(sidecarPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        MS_LOG_ERROR("[FaceIndex] Cannot write sidecar: " << sidecarPath);
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(frames.data()), frames.size() * sizeof(FrameEntry));
+    out.write(reinterpret_cast<const char*>(boxes.data()), boxes.size() * sizeof(Box));
+    if (header.embeddingDim > 0) {
+        out.write(reinterpret_cast<const char*>(embeddings.data()), embeddings.size() * sizeof(float));
+    }
+
+    if (!out) {
+        MS_LOG_ERROR("[FaceIndex] Failed writing sidecar: " << sidecarPath);
+        return false;
+    }
+
+    MS_LOG_INFO("[FaceIndex] Wrote " << sidecarPath << ": " << header.frameCount << " frames, "
+              << header.boxCount << " faces, embedding dim " << header.embeddingDim);
+    return true;
+}
+
+#endif  // HAVE_OPENCV
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Face Index
+ *
+ * Compact binary sidecar holding per-frame face boxes (and optionally a face
+ * embedding per box) for a target video, built once by an offline pass and
+ * memory-mapped at runtime.
+ *
+ * File layout (little endian, all sections naturally aligned):
+ *   Header                               32 bytes
+ *   FrameEntry[frameCount]               8 bytes each  (first box, box count)
+ *   Box[boxCount]                        8 bytes each  (int16 x, y, w, h)
+ *   float[boxCount * embeddingDim]       optional embeddings
+ */
+class FaceIndex {
+public:
+#ifdef HAVE_OPENCV
+    using FaceDetector = std::function<std::vector<cv::Rect>(const cv::Mat&)>;
+    // Returns an embedding for the face crop (empty if unavailable)
+    using FaceEmbedder = std::function<std::vector<float>(const cv::Mat&)>;
+#endif
+
+    FaceIndex();
+    ~FaceIndex();
+
+    FaceIndex(const FaceIndex&) = delete;
+    FaceIndex& operator=(const FaceIndex&) = delete;
+
+    // Default sidecar location for a video: "<video>.faceidx"
+    static std::string GetSidecarPath(const std::string& videoPath);
+
+#ifdef HAVE_OPENCV
+    /**
+     * Offline indexing pass: decode the whole video and store the detected faces
+     * @param embedder Optional; embeddings are stored when it returns a fixed-size vector
+     * @return true if the sidecar was written
+     */
+    static bool Build(const std::string& videoPath, const std::string& sidecarPath,
+                      const FaceDetector& detector, const FaceEmbedder& embedder = nullptr);
+
+    /**
+     * Face boxes for a frame (empty if the frame is not indexed)
+     */
+    std::vector<cv::Rect> GetFaces(int frameIndex) const;
+#endif
+
+    // Memory-map an existing sidecar
+    bool Open(const std::string& sidecarPath);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    int GetFrameCount() const;
+    int GetEmbeddingDim() const;
+
+    /**
+     * Embedding for the n-th face of a frame (nullptr if none stored)
+     */
+    const float* GetEmbedding(int frameIndex, int faceIndex) const;
+
+private:
+    struct Header {
+        char magic[4];          // "MSFI"
+        uint32_t version;
+        uint32_t frameCount;
+        uint32_t boxCount;
+        uint32_t embeddingDim;
+        uint32_t reserved;
+        double fps;
+    };
+
+    struct FrameEntry {
+        uint32_t firstBox;
+        uint32_t boxCount;
+    };
+
+    struct Box {
+        int16_t x, y, width, height;
+    };
+
+    static_assert(sizeof(Header) == 32, "FaceIndex header must be 32 bytes");
+    static_assert(sizeof(FrameEntry) == 8, "FaceIndex frame entry must be 8 bytes");
+    static_assert(sizeof(Box) == 8, "FaceIndex box must be 8 bytes");
+
+    const Header* GetHeader() const;
+    const FrameEntry* GetFrameEntries() const;
+    const Box* GetBoxes() const;
+
+    // Memory mapping
+    const uint8_t* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#else
+    int m_fileDescriptor;
+#endif
+};
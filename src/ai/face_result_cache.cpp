@@ -0,0 +1,230 @@
+#include "face_result_cache.h"
+#include <algorithm>
+
+namespace {
+const float kMinTrackOverlap = 0.4f;    // IoU needed to continue a track
+const uint64_t kTrackTimeout = 30;      // Frames before an unseen track is dropped
+}
+
+FaceResultCache::FaceResultCache()
+    : m_metric(SAD),
+      m_threshold(3.0f),
+      m_maxAge(4),
+      m_frame(0),
+      m_hits(0),
+      m_misses(0)
+{
+}
+
+void FaceResultCache::SetMetric(Metric metric)
+{
+    if (metric != m_metric) {
+        m_metric = metric;
+        Clear();
+    }
+}
+
+void FaceResultCache::SetThreshold(float threshold)
+{
+    m_threshold = std::max(0.0f, threshold);
+}
+
+void FaceResultCache::SetMaxAge(int frames)
+{
+    m_maxAge = std::max(0, frames);
+}
+
+bool FaceResultCache::ParseMetric(const std::string& name, Metric& metric)
+{
+    if (name == "off" || name == "none") {
+        metric = OFF;
+    } else if (name == "sad") {
+        metric = SAD;
+    } else if (name == "phash") {
+        metric = PHASH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string FaceResultCache::GetMetricName(Metric metric)
+{
+    switch (metric) {
+        case OFF: return "off";
+        case SAD: return "sad";
+        case PHASH: return "phash";
+    }
+    return "unknown";
+}
+
+void FaceResultCache::NextFrame()
+{
+    m_frame++;
+#ifdef HAVE_OPENCV
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+        [this](const Entry& entry) { return m_frame - entry.lastSeen > kTrackTimeout; }),
+        m_entries.end());
+#endif
+}
+
+void FaceResultCache::Clear()
+{
+#ifdef HAVE_OPENCV
+    m_entries.clear();
+#endif
+}
+
+double FaceResultCache::GetHitRate() const
+{
+    uint64_t total = m_hits + m_misses;
+    return total > 0 ? static_cast<double>(m_hits) / total : 0.0;
+}
+
+void FaceResultCache::ResetStats()
+{
+    m_hits = 0;
+    m_misses = 0;
+}
+
+#ifdef HAVE_OPENCV
+
+bool FaceResultCache::Lookup(const cv::Rect& box, const cv::Mat& crop, uint64_t tag, cv::Mat& output)
+{
+    if (m_metric == OFF || crop.empty()) {
+        m_misses++;
+        return false;
+    }
+
+    Entry* entry = FindTrack(box);
+    if (!entry || entry->tag != tag || entry->age >= m_maxAge || entry->output.empty()) {
+        m_misses++;
+        return false;
+    }
+
+    cv::Mat thumbnail;
+    uint64_t hash = 0;
+    ComputeSignature(crop, thumbnail, hash);
+
+    float distance;
+    if (m_metric == SAD) {
+        distance = static_cast<float>(cv::norm(thumbnail, entry->thumbnail, cv::NORM_L1) / thumbnail.total());
+    } else {
+        uint64_t diff = hash ^ entry->hash;
+        int bits = 0;
+        while (diff) {
+            diff &= diff - 1;
+            bits++;
+        }
+        distance = static_cast<float>(bits);
+    }
+
+    if (distance > m_threshold) {
+        m_misses++;
+        return false;
+    }
+
+    // The cached output lives in its old box; map it onto the new box
+    // (translation is implicit in the placement, only the scale changes)
+    if (entry->output.size() == box.size()) {
+        output = entry->output;
+    } else {
+        cv::resize(entry->output, output, box.size(), 0, 0, cv::INTER_LINEAR);
+    }
+
+    // Signature is not refreshed on a hit, so drift is measured against the
+    // crop the output was actually computed from
+    entry->box = box;
+    entry->age++;
+    entry->lastSeen = m_frame;
+    m_hits++;
+    return true;
+}
+
+void FaceResultCache::Store(const cv::Rect& box, const cv::Mat& crop, uint64_t tag, const cv::Mat& output)
+{
+    if (m_metric == OFF || crop.empty() || output.empty()) {
+        return;
+    }
+
+    Entry* entry = FindTrack(box);
+    if (!entry) {
+        m_entries.emplace_back();
+        entry = &m_entries.back();
+    }
+
+    ComputeSignature(crop, entry->thumbnail, entry->hash);
+    entry->box = box;
+    entry->tag = tag;
+    output.copyTo(entry->output);
+    entry->age = 0;
+    entry->lastSeen = m_frame;
+}
+
+FaceResultCache::Entry* FaceResultCache::FindTrack(const cv::Rect& box)
+{
+    Entry* best = nullptr;
+    float bestOverlap = kMinTrackOverlap;
+
+    for (auto& entry : m_entries) {
+        int intersection = (entry.box & box).area();
+        int unionArea = entry.box.area() + box.area() - intersection;
+        float overlap = unionArea > 0 ? static_cast<float>(intersection) / unionArea : 0.0f;
+        if (overlap >= bestOverlap) {
+            bestOverlap = overlap;
+            best = &entry;
+        }
+    }
+
+    return best;
+}
+
+void FaceResultCache::ComputeSignature(const cv::Mat& crop, cv::Mat& thumbnail, uint64_t& hash) const
+{
+    cv::Mat gray;
+    if (crop.channels() == 3) {
+        cv::cvtColor(crop, gray, cv::COLOR_BGR2GRAY);
+    } else {
+        gray = crop;
+    }
+
+    if (m_metric == SAD) {
+        cv::resize(gray, thumbnail, cv::Size(16, 16), 0, 0, cv::INTER_AREA);
+        hash = 0;
+    } else {
+        hash = PerceptualHash(gray);
+    }
+}
+
+uint64_t FaceResultCache::PerceptualHash(const cv::Mat& gray)
+{
+    // 32x32 DCT, keep the 8x8 low-frequency block (minus DC) and threshold
+    // each coefficient against the block median
+    cv::Mat small, smallFloat, dct;
+    cv::resize(gray, small, cv::Size(32, 32), 0, 0, cv::INTER_AREA);
+    small.convertTo(smallFloat, CV_32F);
+    cv::dct(smallFloat, dct);
+
+    float coefficients[64];
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            coefficients[y * 8 + x] = dct.at<float>(y, x);
+        }
+    }
+    coefficients[0] = 0.0f;
+
+    float sorted[64];
+    std::copy(coefficients, coefficients + 64, sorted);
+    std::nth_element(sorted, sorted + 32, sorted + 64);
+    float median = sorted[32];
+
+    uint64_t hash = 0;
+    for (int i = 0; i < 64; ++i) {
+        if (coefficients[i] > median) {
+            hash |= (1ULL << i);
+        }
+    }
+    return hash;
+}
+
+#endif  // HAVE_OPENCV
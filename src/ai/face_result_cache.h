@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Face Result Cache
+ *
+ * Per-track cache of model outputs for face crops. During a video call the
+ * face crop changes very little between consecutive frames; when the new crop
+ * is close enough to the one last sent through the model, the previous output
+ * is reused (scaled/translated to the new face box) instead of re-running
+ * inference.
+ *
+ * Tracks are associated by box overlap. Similarity is either the mean
+ * absolute difference of a 16x16 grayscale thumbnail (SAD) or the Hamming
+ * distance between 64-bit DCT perceptual hashes (PHASH).
+ */
+class FaceResultCache {
+public:
+    enum Metric {
+        OFF,        // Always miss
+        SAD,        // Threshold in mean gray levels per pixel (0-255)
+        PHASH       // Threshold in differing hash bits (0-64)
+    };
+
+    FaceResultCache();
+
+    void SetMetric(Metric metric);
+    void SetThreshold(float threshold);
+    void SetMaxAge(int frames);     // Consecutive reuses before forcing inference
+
+    Metric GetMetric() const { return m_metric; }
+    float GetThreshold() const { return m_threshold; }
+    int GetMaxAge() const { return m_maxAge; }
+
+    static bool ParseMetric(const std::string& name, Metric& metric);
+    static std::string GetMetricName(Metric metric);
+
+    // Advance the frame clock; tracks unseen for a while are dropped
+    void NextFrame();
+    void Clear();
+
+    // Metrics
+    uint64_t GetHits() const { return m_hits; }
+    uint64_t GetMisses() const { return m_misses; }
+    double GetHitRate() const;
+    void ResetStats();
+
+#ifdef HAVE_OPENCV
+    /**
+     * Look up a reusable output for a face
+     * @param box Face box in frame coordinates (used for track association)
+     * @param crop Model input crop for this face
+     * @param tag Extra key that must match exactly (e.g. target frame index)
+     * @param output Receives the cached output resized to box size
+     * @return true on hit
+     */
+    bool Lookup(const cv::Rect& box, const cv::Mat& crop, uint64_t tag, cv::Mat& output);
+
+    // Record a fresh model output for a face
+    void Store(const cv::Rect& box, const cv::Mat& crop, uint64_t tag, const cv::Mat& output);
+#endif
+
+private:
+#ifdef HAVE_OPENCV
+    struct Entry {
+        cv::Rect box;
+        cv::Mat thumbnail;      // SAD signature
+        uint64_t hash;          // PHASH signature
+        uint64_t tag;
+        cv::Mat output;
+        int age;                // Reuses since last inference
+        uint64_t lastSeen;      // Frame clock
+    };
+
+    Entry* FindTrack(const cv::Rect& box);
+    void ComputeSignature(const cv::Mat& crop, cv::Mat& thumbnail, uint64_t& hash) const;
+    static uint64_t PerceptualHash(const cv::Mat& gray);
+
+    std::vector<Entry> m_entries;
+#endif
+
+    Metric m_metric;
+    float m_threshold;
+    int m_maxAge;
+    uint64_t m_frame;
+    uint64_t m_hits;
+    uint64_t m_misses;
+};
@@ -0,0 +1,222 @@
+#include "inference_backend.h"
+#include "logger.h"
+#include <algorithm>
+#include <cctype>
+#include <thread>
+
+InferenceBackend::Type InferenceBackend::DetectType(const std::string& modelPath)
+{
+    std::string lower = modelPath;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    auto endsWith = [&lower](const std::string& suffix) {
+        return lower.size() >= suffix.size() &&
+               lower.compare(lower.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    if (endsWith(".onnx")) {
+#ifdef HAVE_ONNX
+        return ORT_CPU;
+#else
+        return OPENCV_ONNX;
+#endif
+    }
+    return OPENCV_TORCH;
+}
+
+bool InferenceBackend::ParseType(const std::string& name, Type& type)
+{
+    if (name == "auto") {
+        type = AUTO;
+    } else if (name == "opencv_torch" || name == "torch") {
+        type = OPENCV_TORCH;
+    } else if (name == "opencv_onnx") {
+        type = OPENCV_ONNX;
+    } else if (name == "ort" || name == "onnxruntime") {
+        type = ORT_CPU;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string InferenceBackend::GetTypeName(Type type)
+{
+    switch (type) {
+        case AUTO: return "auto";
+        case OPENCV_TORCH: return "opencv_torch";
+        case OPENCV_ONNX: return "opencv_onnx";
+        case ORT_CPU: return "ort";
+    }
+    return "unknown";
+}
+
+#ifdef HAVE_OPENCV
+
+OpenCVDnnBackend::OpenCVDnnBackend(const cv::dnn::Net& net, Type type)
+    : m_net(net),
+      m_type(type)
+{
+}
+
+bool OpenCVDnnBackend::Run(const cv::Mat& input, cv::Mat& output)
+{
+    m_net.setInput(input);
+    output = m_net.forward();
+    return !output.empty();
+}
+
+cv::dnn::Net OpenCVDnnBackend::ReadNet(const std::string& modelPath, Type type, const std::vector<unsigned char>* bytes)
+{
+    if (type == OPENCV_ONNX) {
+        if (bytes && !bytes->empty()) {
+            return cv::dnn::readNetFromONNX(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+        }
+        return cv::dnn::readNetFromONNX(modelPath);
+    }
+    return cv::dnn::readNetFromTorch(modelPath);
+}
+
+#endif  // HAVE_OPENCV
+
+#if defined(HAVE_OPENCV) && defined(HAVE_ONNX)
+
+OrtCpuBackend::OrtCpuBackend(int intraOpThreads)
+    : m_env(ORT_LOGGING_LEVEL_WARNING, "InferenceBackend"),
+      m_channelsLast(false),
+      m_intraOpThreads(intraOpThreads)
+{
+}
+
+bool OrtCpuBackend::Load(const std::string& modelPath)
+{
+    return LoadSession(modelPath, nullptr);
+}
+
+bool OrtCpuBackend::LoadFromMemory(const std::vector<unsigned char>& bytes, const std::string& modelName)
+{
+    return LoadSession(modelName, &bytes);
+}
+
+bool OrtCpuBackend::LoadSession(const std::string& modelPath, const std::vector<unsigned char>* bytes)
+{
+    try {
+        int threads = m_intraOpThreads > 0 ? m_intraOpThreads
+                                           : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        m_sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        m_sessionOptions.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+        m_sessionOptions.SetIntraOpNumThreads(threads);
+
+        if (bytes) {
+            m_session = std::make_unique<Ort::Session>(m_env, bytes->data(), bytes->size(), m_sessionOptions);
+        } else {
+#ifdef _WIN32
+            std::wstring wModelPath(modelPath.begin(), modelPath.end());
+            m_session = std::make_unique<Ort::Session>(m_env, wModelPath.c_str(), m_sessionOptions);
+#else
+            m_session = std::make_unique<Ort::Session>(m_env, modelPath.c_str(), m_sessionOptions);
+#endif
+        }
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        m_inputName = m_session->GetInputNameAllocated(0, allocator).get();
+        m_outputName = m_session->GetOutputNameAllocated(0, allocator).get();
+
+        // [1, 3, H, W] or channels-last [1, H, W, 3]; non-positive dims are dynamic
+        std::vector<int64_t> shape = m_session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (shape.size() == 4) {
+            m_channelsLast = shape[3] == 3 && shape[1] != 3;
+            int64_t height = m_channelsLast ? shape[1] : shape[2];
+            int64_t width = m_channelsLast ? shape[2] : shape[3];
+            if (height > 0 && width > 0) {
+                m_fixedSize = cv::Size(static_cast<int>(width), static_cast<int>(height));
+            }
+        }
+
+        MS_LOG_INFO("[InferenceBackend] ONNX Runtime CPU session ready: " << modelPath
+                  << " (" << (m_channelsLast ? "NHWC" : "NCHW") << ", " << threads << " threads"
+                  << (m_fixedSize.area() > 0 ? ", fixed " + std::to_string(m_fixedSize.width) + "x" +
+                                                   std::to_string(m_fixedSize.height)
+                                             : std::string(", dynamic size"))
+                  << ")");
+        return true;
+
+    } catch (const Ort::Exception& e) {
+        MS_LOG_ERROR("[InferenceBackend] ONNX Runtime error: " << e.what());
+        m_session.reset();
+        return false;
+    }
+}
+
+bool OrtCpuBackend::Run(const cv::Mat& input, cv::Mat& output)
+{
+    if (!m_session || input.dims != 4 || input.type() != CV_32F) {
+        return false;
+    }
+
+    const int channels = input.size[1];
+    const int height = input.size[2];
+    const int width = input.size[3];
+    const size_t plane = static_cast<size_t>(height) * width;
+    const float* data = input.ptr<float>();
+
+    std::vector<int64_t> inputShape;
+    if (m_channelsLast) {
+        m_transposed.resize(plane * channels);
+        for (size_t i = 0; i < plane; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                m_transposed[i * channels + c] = data[c * plane + i];
+            }
+        }
+        data = m_transposed.data();
+        inputShape = {1, height, width, channels};
+    } else {
+        inputShape = {1, channels, height, width};
+    }
+
+    try {
+        auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+            memoryInfo, const_cast<float*>(data), plane * channels, inputShape.data(), inputShape.size());
+
+        const char* inputNames[] = {m_inputName.c_str()};
+        const char* outputNames[] = {m_outputName.c_str()};
+        auto outputs = m_session->Run(Ort::RunOptions{nullptr}, inputNames, &inputTensor, 1, outputNames, 1);
+        if (outputs.empty() || !outputs[0].IsTensor()) {
+            return false;
+        }
+
+        std::vector<int64_t> shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        if (shape.size() != 4) {
+            return false;
+        }
+
+        const float* result = outputs[0].GetTensorData<float>();
+        bool channelsLast = shape[3] == 3 && shape[1] != 3;
+        int outC = static_cast<int>(channelsLast ? shape[3] : shape[1]);
+        int outH = static_cast<int>(channelsLast ? shape[1] : shape[2]);
+        int outW = static_cast<int>(channelsLast ? shape[2] : shape[3]);
+        size_t outPlane = static_cast<size_t>(outH) * outW;
+
+        int blobShape[] = {1, outC, outH, outW};
+        output.create(4, blobShape, CV_32F);
+        float* dst = output.ptr<float>();
+        if (channelsLast) {
+            for (size_t i = 0; i < outPlane; ++i) {
+                for (int c = 0; c < outC; ++c) {
+                    dst[c * outPlane + i] = result[i * outC + c];
+                }
+            }
+        } else {
+            std::copy(result, result + outPlane * outC, dst);
+        }
+        return true;
+
+    } catch (const Ort::Exception& e) {
+        MS_LOG_ERROR("[InferenceBackend] ONNX Runtime inference error: " << e.what());
+        return false;
+    }
+}
+
+#endif  // HAVE_OPENCV && HAVE_ONNX
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/dnn.hpp>
+#include <opencv2/opencv.hpp>
+#endif
+
+#ifdef HAVE_ONNX
+#include <onnxruntime_cxx_api.h>
+#endif
+
+/**
+ * Inference Backend
+ *
+ * Engine-neutral interface for image-to-image networks. Processors hand over
+ * an NCHW float blob and get an NCHW float blob back, whatever engine runs the
+ * model, so the engine can be picked per model (by file type or explicitly)
+ * to use the fastest one on the host.
+ *
+ * Engines:
+ * - OPENCV_TORCH: cv::dnn with a Torch .t7 model (CPU or CUDA targets)
+ * - OPENCV_ONNX:  cv::dnn with an ONNX model (CPU or CUDA targets)
+ * - ORT_CPU:      ONNX Runtime CPU provider with full graph optimizations
+ */
+class InferenceBackend {
+public:
+    enum Type {
+        AUTO,           // Pick from the model file extension
+        OPENCV_TORCH,
+        OPENCV_ONNX,
+        ORT_CPU
+    };
+
+    virtual ~InferenceBackend() = default;
+
+    virtual Type GetType() const = 0;
+
+    // Loaded copies of the model held by this engine (memory accounting)
+    virtual size_t GetInstanceCount() const { return 1; }
+
+#ifdef HAVE_OPENCV
+    /**
+     * Run the network
+     * @param input [1, 3, H, W] CV_32F blob
+     * @param output Receives a [1, C, H', W'] CV_32F blob
+     */
+    virtual bool Run(const cv::Mat& input, cv::Mat& output) = 0;
+
+    // Input size the model was exported with, or empty if it accepts any size
+    virtual cv::Size GetFixedInputSize() const { return cv::Size(); }
+#endif
+
+    // Engine used for a model path when the type is AUTO
+    static Type DetectType(const std::string& modelPath);
+
+    static bool ParseType(const std::string& name, Type& type);
+    static std::string GetTypeName(Type type);
+};
+
+#ifdef HAVE_OPENCV
+/**
+ * cv::dnn engine. Wraps a (shared, reference-counted) cv::dnn::Net so callers
+ * can still configure CUDA backends/targets on it directly.
+ */
+class OpenCVDnnBackend : public InferenceBackend {
+public:
+    OpenCVDnnBackend(const cv::dnn::Net& net, Type type);
+
+    Type GetType() const override { return m_type; }
+    bool Run(const cv::Mat& input, cv::Mat& output) override;
+
+    cv::dnn::Net& GetNet() { return m_net; }
+
+    // Extra copies of the model for ParallelNetPool, built with the engine
+    // (e.g. on the style cache thread) so activating it does not reload them
+    void SetPoolInstances(const std::vector<cv::dnn::Net>& nets) { m_poolInstances = nets; }
+    const std::vector<cv::dnn::Net>& GetPoolInstances() const { return m_poolInstances; }
+    size_t GetInstanceCount() const override { return 1 + m_poolInstances.size(); }
+
+    // Reads a .t7 (OPENCV_TORCH) or .onnx (OPENCV_ONNX) model; throws cv::Exception on failure.
+    // ONNX models are parsed from `bytes` when given (Torch can only load from file).
+    static cv::dnn::Net ReadNet(const std::string& modelPath, Type type,
+                                const std::vector<unsigned char>* bytes = nullptr);
+
+private:
+    cv::dnn::Net m_net;
+    Type m_type;
+    std::vector<cv::dnn::Net> m_poolInstances;
+};
+#endif
+
+#if defined(HAVE_OPENCV) && defined(HAVE_ONNX)
+/**
+ * ONNX Runtime CPU engine. Models exported channels-last (NHWC, typical of
+ * TensorFlow AnimeGAN ports) are transposed at the boundary, so callers
+ * always see NCHW.
+ */
+class OrtCpuBackend : public InferenceBackend {
+public:
+    explicit OrtCpuBackend(int intraOpThreads = 0);
+
+    bool Load(const std::string& modelPath);
+    bool LoadFromMemory(const std::vector<unsigned char>& bytes, const std::string& modelName);
+
+    Type GetType() const override { return ORT_CPU; }
+    bool Run(const cv::Mat& input, cv::Mat& output) override;
+    cv::Size GetFixedInputSize() const override { return m_fixedSize; }
+
+private:
+    bool LoadSession(const std::string& modelPath, const std::vector<unsigned char>* bytes);
+
+    Ort::Env m_env;
+    Ort::SessionOptions m_sessionOptions;
+    std::unique_ptr<Ort::Session> m_session;
+    std::string m_inputName;
+    std::string m_outputName;
+    bool m_channelsLast;
+    cv::Size m_fixedSize;
+    int m_intraOpThreads;
+    std::vector<float> m_transposed;    // NHWC staging buffer
+};
+#endif
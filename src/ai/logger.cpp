@@ -0,0 +1,356 @@
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+const size_t kTextSize = 496;               // Characters kept per message (longer ones are cut)
+const uint32_t kRingSize = 256;             // Records per thread (power of two)
+const int kFlushIntervalMs = 5;
+const int64_t kSiteWindowMs = 1000;
+
+int64_t NowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Milliseconds, advanced by the flusher on every wakeup: rate limiting reads
+// this instead of the clock
+std::atomic<int64_t> g_coarseNowMs{NowUs() / 1000};
+}
+
+std::atomic<int> Logger::s_level{MS_LOG_LEVEL_DEBUG};
+
+struct Logger::Record {
+    int64_t timeUs;
+    int32_t level;
+    uint32_t suppressed;
+    uint32_t length;
+    char text[kTextSize];
+};
+
+namespace {
+// Single-producer (owning thread) / single-consumer (flusher) ring
+struct Ring {
+    Logger::Record records[kRingSize];
+    std::atomic<uint32_t> head{0};          // Next slot the owner writes
+    std::atomic<uint32_t> tail{0};          // Next slot the flusher reads
+    std::atomic<uint32_t> dropped{0};
+    std::atomic<bool> retired{false};       // Owning thread has exited
+};
+
+// Fixed-buffer stream target: writes land directly in a ring record
+class RecordBuffer : public std::streambuf {
+public:
+    void Reset(char* begin, size_t size) { setp(begin, begin + size); }
+    size_t Length() const { return static_cast<size_t>(pptr() - pbase()); }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        // Full: drop the rest of the message
+        return traits_type::not_eof(ch);
+    }
+};
+
+// Call sites that have suppressed messages. Never destroyed: sites are
+// function-local statics and unregister from their own destructors, which
+// may run after the flusher's during static destruction.
+struct SiteRegistry {
+    std::mutex mutex;
+    std::vector<Logger::Site*> sites;
+};
+
+SiteRegistry& GetSiteRegistry()
+{
+    static SiteRegistry* registry = new SiteRegistry;
+    return *registry;
+}
+
+void WriteSuppressed(const Logger::Site& site, uint32_t suppressed)
+{
+    std::cerr << "[Logger] " << suppressed << " messages suppressed at "
+              << site.GetFile() << ":" << site.GetLine() << "\n";
+}
+
+class Flusher {
+public:
+    static Flusher& Instance()
+    {
+        static Flusher flusher;
+        return flusher;
+    }
+
+    void Register(const std::shared_ptr<Ring>& ring)
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_rings.push_back(ring);
+    }
+
+
+    // Drain every ring to the console
+    void Drain()
+    {
+        std::lock_guard<std::mutex> drainLock(m_drainMutex);
+
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            rings = m_rings;
+        }
+
+        m_batch.clear();
+        uint64_t dropped = 0;
+        for (const auto& ring : rings) {
+            uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint32_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail) {
+                m_batch.push_back(ring->records[tail & (kRingSize - 1)]);
+            }
+            ring->tail.store(tail, std::memory_order_release);
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+        }
+
+        // Interleave threads in time order
+        std::stable_sort(m_batch.begin(), m_batch.end(),
+                         [](const Logger::Record& a, const Logger::Record& b) { return a.timeUs < b.timeUs; });
+
+        bool wroteOut = false;
+        bool wroteErr = false;
+        for (const auto& record : m_batch) {
+            std::ostream& out = record.level >= MS_LOG_LEVEL_WARN ? std::cerr : std::cout;
+            out.write(record.text, record.length);
+            if (record.suppressed > 0) {
+                out << " (+" << record.suppressed << " suppressed)";
+            }
+            out << '\n';
+            (record.level >= MS_LOG_LEVEL_WARN ? wroteErr : wroteOut) = true;
+        }
+        if (dropped > 0) {
+            std::cerr << "[Logger] " << dropped << " messages dropped (ring full)\n";
+            wroteErr = true;
+        }
+        if (wroteOut) std::cout.flush();
+        if (wroteErr) std::cerr.flush();
+
+        // Forget rings of exited threads once they are empty
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [](const std::shared_ptr<Ring>& ring) {
+            return ring->retired.load(std::memory_order_acquire) &&
+                   ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+        }), m_rings.end());
+    }
+
+    // Report suppressed counts of sites that went quiet (a busy site reports
+    // them with its next message instead); at exit, of every remaining site
+    void ReportSuppressed(bool all)
+    {
+        std::lock_guard<std::mutex> drainLock(m_drainMutex);
+        SiteRegistry& registry = GetSiteRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        const int64_t nowMs = g_coarseNowMs.load(std::memory_order_relaxed);
+        bool wrote = false;
+        for (Logger::Site* site : registry.sites) {
+            uint32_t suppressed = site->TakeSuppressed(nowMs, all);
+            if (suppressed > 0) {
+                WriteSuppressed(*site, suppressed);
+                wrote = true;
+            }
+        }
+        if (wrote) std::cerr.flush();
+    }
+
+private:
+    Flusher()
+        : m_running(true),
+          m_thread([this] { Run(); })
+    {
+    }
+
+    ~Flusher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_running = false;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+        Drain();
+        ReportSuppressed(true);
+    }
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        int64_t lastSiteReportMs = NowUs() / 1000;
+        while (m_running) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(kFlushIntervalMs));
+            const int64_t nowMs = NowUs() / 1000;
+            g_coarseNowMs.store(nowMs, std::memory_order_relaxed);
+            lock.unlock();
+            Drain();
+            if (nowMs - lastSiteReportMs >= kSiteWindowMs) {
+                lastSiteReportMs = nowMs;
+                ReportSuppressed(false);
+            }
+            lock.lock();
+        }
+    }
+
+    std::mutex m_ringsMutex;
+    std::vector<std::shared_ptr<Ring>> m_rings;
+    std::mutex m_drainMutex;
+    std::vector<Logger::Record> m_batch;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_running;
+    std::thread m_thread;
+};
+
+// The calling thread's ring and formatting stream, created on first use
+struct ThreadLog {
+    ThreadLog()
+        : ring(std::make_shared<Ring>()),
+          stream(&buffer)
+    {
+        Flusher::Instance().Register(ring);
+    }
+
+    ~ThreadLog()
+    {
+        ring->retired.store(true, std::memory_order_release);
+    }
+
+    std::shared_ptr<Ring> ring;
+    RecordBuffer buffer;
+    std::ostream stream;
+};
+
+ThreadLog& GetThreadLog()
+{
+    thread_local ThreadLog log;
+    return log;
+}
+}
+
+bool Logger::Site::Allow(int level, uint32_t& suppressed)
+{
+    if (level >= MS_LOG_LEVEL_ERROR) {
+        return true;
+    }
+
+    const int64_t nowMs = g_coarseNowMs.load(std::memory_order_relaxed);
+    int64_t start = m_windowStart.load(std::memory_order_relaxed);
+    if (nowMs - start >= kSiteWindowMs &&
+        m_windowStart.compare_exchange_strong(start, nowMs, std::memory_order_relaxed)) {
+        m_count.store(0, std::memory_order_relaxed);
+    }
+
+    const int limit = level >= MS_LOG_LEVEL_WARN ? kWarnSiteLimit : kSiteLimit;
+    if (m_count.fetch_add(1, std::memory_order_relaxed) < static_cast<uint32_t>(limit)) {
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    if (!m_registered.exchange(true, std::memory_order_relaxed)) {
+        SiteRegistry& registry = GetSiteRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.sites.push_back(this);
+    }
+    return false;
+}
+
+Logger::Site::~Site()
+{
+    if (!m_registered.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // Static destruction: leave the registry and report what is left here,
+    // since the flusher may already be gone
+    SiteRegistry& registry = GetSiteRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.sites.erase(std::remove(registry.sites.begin(), registry.sites.end(), this),
+                             registry.sites.end());
+    }
+    uint32_t suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+    if (suppressed > 0) {
+        WriteSuppressed(*this, suppressed);
+        std::cerr.flush();
+    }
+}
+
+uint32_t Logger::Site::TakeSuppressed(int64_t nowMs, bool evenIfActive)
+{
+    if (!evenIfActive && nowMs - m_windowStart.load(std::memory_order_relaxed) < kSiteWindowMs) {
+        return 0;
+    }
+    return m_suppressed.exchange(0, std::memory_order_relaxed);
+}
+
+Logger::Message::Message(int level, uint32_t suppressed)
+    : m_record(nullptr)
+{
+    ThreadLog& log = GetThreadLog();
+    Ring& ring = *log.ring;
+
+    const uint32_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= kRingSize && level >= MS_LOG_LEVEL_ERROR) {
+        // Errors are never dropped: make room by writing out what is queued
+        Flusher::Instance().Drain();
+    }
+    if (head - ring.tail.load(std::memory_order_acquire) >= kRingSize) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_record = &ring.records[head & (kRingSize - 1)];
+    m_record->timeUs = NowUs();
+    m_record->level = level;
+    m_record->suppressed = suppressed;
+
+    // Fresh formatting state for every message
+    log.buffer.Reset(m_record->text, kTextSize);
+    log.stream.clear();
+    log.stream.flags(std::ios_base::dec | std::ios_base::skipws);
+    log.stream.precision(6);
+    log.stream.width(0);
+    log.stream.fill(' ');
+}
+
+Logger::Message::~Message()
+{
+    if (!m_record) {
+        return;
+    }
+    ThreadLog& log = GetThreadLog();
+    m_record->length = static_cast<uint32_t>(log.buffer.Length());
+    const bool error = m_record->level >= MS_LOG_LEVEL_ERROR;
+    log.ring->head.fetch_add(1, std::memory_order_release);
+
+    // Errors are written before the caller continues, so the last ones
+    // before a crash or abort() reach the console (in order, after
+    // everything queued before them)
+    if (error) {
+        Flusher::Instance().Drain();
+    }
+}
+
+std::ostream& Logger::Message::Stream()
+{
+    return GetThreadLog().stream;
+}
+
+void Logger::Flush()
+{
+    Flusher::Instance().Drain();
+}
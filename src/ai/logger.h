@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Logger
+ *
+ * Asynchronous console logging for the frame path. MS_LOG_* formats the
+ * message on the calling thread straight into a slot of that thread's ring
+ * of fixed-size records (no locks, no allocation, no I/O); a background
+ * thread drains all rings every few milliseconds and writes INFO and DEBUG
+ * to std::cout, WARN and ERROR to std::cerr, one line per message.
+ *
+ * - Levels below MS_LOG_COMPILE_LEVEL compile to nothing (default DEBUG,
+ *   INFO when NDEBUG is defined); SetLevel() filters further at run time
+ * - Every DEBUG/INFO call site allows kSiteLimit messages per second and
+ *   every WARN site kWarnSiteLimit; the rest are counted and reported with
+ *   the site's next message, or by the flusher once the site goes quiet.
+ *   ERROR is never rate limited
+ * - ERROR is written synchronously: the calling thread drains all rings
+ *   (keeping time order) before it continues, so errors right before a
+ *   crash are not lost
+ * - A full ring drops the message (counted, reported by the flusher)
+ *   rather than block the caller; an ERROR drains the rings first instead
+ *
+ * Usage: MS_LOG_INFO("[MyProcessor] Loaded " << path << " in " << ms << " ms");
+ */
+
+#define MS_LOG_LEVEL_DEBUG 0
+#define MS_LOG_LEVEL_INFO 1
+#define MS_LOG_LEVEL_WARN 2
+#define MS_LOG_LEVEL_ERROR 3
+
+#ifndef MS_LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define MS_LOG_COMPILE_LEVEL MS_LOG_LEVEL_INFO
+#else
+#define MS_LOG_COMPILE_LEVEL MS_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+class Logger {
+public:
+    enum Level {
+        LEVEL_DEBUG = MS_LOG_LEVEL_DEBUG,
+        LEVEL_INFO = MS_LOG_LEVEL_INFO,
+        LEVEL_WARN = MS_LOG_LEVEL_WARN,
+        LEVEL_ERROR = MS_LOG_LEVEL_ERROR
+    };
+
+    static const int kSiteLimit = 20;       // DEBUG/INFO messages per call site per second
+    static const int kWarnSiteLimit = 200;  // WARN messages per call site per second
+
+    struct Record;
+
+    // Run-time level (messages below it are skipped before formatting)
+    static void SetLevel(Level level) { s_level.store(level, std::memory_order_relaxed); }
+    static Level GetLevel() { return static_cast<Level>(s_level.load(std::memory_order_relaxed)); }
+    static bool IsEnabled(int level) { return level >= s_level.load(std::memory_order_relaxed); }
+
+    // Write out everything logged so far (blocks until the console has it)
+    static void Flush();
+
+    // Per-call-site rate limit state (one static instance per MS_LOG_* use)
+    class Site {
+    public:
+        Site(const char* file, int line) : m_file(file), m_line(line) {}
+        ~Site();
+
+        // @param suppressed Receives the messages dropped since the last one let through
+        bool Allow(int level, uint32_t& suppressed);
+
+        // Flusher side: takes the suppressed count once no message has been
+        // let through for a full window (0 otherwise, unless evenIfActive)
+        uint32_t TakeSuppressed(int64_t nowMs, bool evenIfActive);
+
+        const char* GetFile() const { return m_file; }
+        int GetLine() const { return m_line; }
+
+    private:
+        const char* m_file;
+        int m_line;
+        std::atomic<int64_t> m_windowStart{-1000000};
+        std::atomic<uint32_t> m_count{0};
+        std::atomic<uint32_t> m_suppressed{0};
+        std::atomic<bool> m_registered{false};  // Known to the flusher (after its first suppression)
+    };
+
+    // One message being formatted into the calling thread's ring; committed on destruction
+    class Message {
+    public:
+        Message(int level, uint32_t suppressed);
+        ~Message();
+        Message(const Message&) = delete;
+        Message& operator=(const Message&) = delete;
+
+        explicit operator bool() const { return m_record != nullptr; }
+        std::ostream& Stream();
+
+    private:
+        Record* m_record;
+    };
+
+private:
+    static std::atomic<int> s_level;
+};
+
+#define MS_LOG(level, ...)                                                           \
+    do {                                                                             \
+        if ((level) >= MS_LOG_COMPILE_LEVEL && Logger::IsEnabled(level)) {           \
+            static Logger::Site msLogSite_(__FILE__, __LINE__);                      \
+            uint32_t msLogSuppressed_ = 0;                                           \
+            if (msLogSite_.Allow((level), msLogSuppressed_)) {                       \
+                Logger::Message msLogMessage_((level), msLogSuppressed_);            \
+                if (msLogMessage_) {                                                 \
+                    msLogMessage_.Stream() << __VA_ARGS__;                           \
+                }                                                                    \
+            }                                                                        \
+        }                                                                            \
+    } while (0)
+
+#define MS_LOG_DEBUG(...) MS_LOG(MS_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define MS_LOG_INFO(...) MS_LOG(MS_LOG_LEVEL_INFO, __VA_ARGS__)
+#define MS_LOG_WARN(...) MS_LOG(MS_LOG_LEVEL_WARN, __VA_ARGS__)
+#define MS_LOG_ERROR(...) MS_LOG(MS_LOG_LEVEL_ERROR, __VA_ARGS__)
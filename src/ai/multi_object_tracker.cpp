@@ -0,0 +1,395 @@
+#include "multi_object_tracker.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+// Noise proportional to box height (as in DeepSORT): position and velocity
+// standard deviations per frame
+const float kPositionNoise = 1.0f / 20.0f;
+const float kVelocityNoise = 1.0f / 160.0f;
+const float kInfeasibleCost = 1e4f;         // Pairs below the IoU gate
+
+float IoU(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh)
+{
+    float ix = std::max(0.0f, std::min(ax + aw, bx + bw) - std::max(ax, bx));
+    float iy = std::max(0.0f, std::min(ay + ah, by + bh) - std::max(ay, by));
+    float intersection = ix * iy;
+    float unionArea = aw * ah + bw * bh - intersection;
+    return unionArea > 0.0f ? intersection / unionArea : 0.0f;
+}
+}
+
+MultiObjectTracker::MultiObjectTracker()
+    : m_minHits(3),
+      m_maxMissed(10),
+      m_minIoU(0.1f),
+      m_historyLength(30),
+      m_nextId(1),
+      m_lastUpdateMs(0.0)
+{
+}
+
+void MultiObjectTracker::SetMinHits(int hits)
+{
+    m_minHits = std::max(1, hits);
+}
+
+void MultiObjectTracker::SetMaxMissed(int frames)
+{
+    m_maxMissed = std::max(0, frames);
+}
+
+void MultiObjectTracker::SetMinIoU(float iou)
+{
+    m_minIoU = std::max(0.0f, std::min(1.0f, iou));
+}
+
+void MultiObjectTracker::SetHistoryLength(int length)
+{
+    length = std::max(1, length);
+    if (length == m_historyLength) {
+        return;
+    }
+    // Trails restart at the new length
+    m_historyLength = length;
+    m_history.assign(m_id.size() * m_historyLength * 2, 0.0f);
+    std::fill(m_historyHead.begin(), m_historyHead.end(), 0);
+    std::fill(m_historyCount.begin(), m_historyCount.end(), 0);
+}
+
+void MultiObjectTracker::Reset()
+{
+    m_id.clear();
+    m_confirmed.clear();
+    m_hits.clear();
+    m_missed.clear();
+    m_detection.clear();
+    m_confidence.clear();
+    for (int axis = 0; axis < 4; ++axis) {
+        m_position[axis].clear();
+        m_velocity[axis].clear();
+        m_p00[axis].clear();
+        m_p01[axis].clear();
+        m_p11[axis].clear();
+    }
+    m_history.clear();
+    m_historyHead.clear();
+    m_historyCount.clear();
+    m_detectionTrackIds.clear();
+    m_nextId = 1;
+}
+
+void MultiObjectTracker::GetBox(size_t index, float& x, float& y, float& width, float& height) const
+{
+    width = std::max(1.0f, m_position[2][index]);
+    height = std::max(1.0f, m_position[3][index]);
+    x = m_position[0][index] - width * 0.5f;
+    y = m_position[1][index] - height * 0.5f;
+}
+
+void MultiObjectTracker::GetPredictedBox(size_t index, float ahead, float& x, float& y, float& width, float& height) const
+{
+    width = std::max(1.0f, m_position[2][index] + m_velocity[2][index] * ahead);
+    height = std::max(1.0f, m_position[3][index] + m_velocity[3][index] * ahead);
+    x = m_position[0][index] + m_velocity[0][index] * ahead - width * 0.5f;
+    y = m_position[1][index] + m_velocity[1][index] * ahead - height * 0.5f;
+}
+
+void MultiObjectTracker::GetVelocity(size_t index, float& vx, float& vy) const
+{
+    vx = m_velocity[0][index];
+    vy = m_velocity[1][index];
+}
+
+void MultiObjectTracker::GetHistory(size_t index, std::vector<float>& points) const
+{
+    points.clear();
+    const int count = m_historyCount[index];
+    const float* ring = &m_history[index * m_historyLength * 2];
+    int slot = (m_historyHead[index] - count + m_historyLength) % m_historyLength;
+    for (int i = 0; i < count; ++i) {
+        points.push_back(ring[slot * 2]);
+        points.push_back(ring[slot * 2 + 1]);
+        slot = (slot + 1) % m_historyLength;
+    }
+}
+
+void MultiObjectTracker::Update(const std::vector<Detection>& detections, float dt)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    Predict(dt);
+
+    const int tracks = static_cast<int>(m_id.size());
+    const int count = static_cast<int>(detections.size());
+
+    // Cost 1 - IoU between each prediction and detection
+    m_cost.assign(static_cast<size_t>(tracks) * count, kInfeasibleCost);
+    for (int t = 0; t < tracks; ++t) {
+        float x, y, w, h;
+        GetBox(t, x, y, w, h);
+        float* row = &m_cost[static_cast<size_t>(t) * count];
+        for (int d = 0; d < count; ++d) {
+            const Detection& det = detections[d];
+            float iou = IoU(x, y, w, h, det.x, det.y, det.width, det.height);
+            if (iou >= m_minIoU) {
+                row[d] = 1.0f - iou;
+            }
+        }
+    }
+    SolveAssignment(m_cost, tracks, count, m_assignment);
+
+    m_detectionUsed.assign(count, 0);
+    for (int t = 0; t < tracks; ++t) {
+        int d = m_assignment[t];
+        if (d >= 0 && m_cost[static_cast<size_t>(t) * count + d] < kInfeasibleCost) {
+            Correct(t, detections[d]);
+            m_detection[t] = d;
+            m_detectionUsed[d] = 1;
+            m_hits[t]++;
+            m_missed[t] = 0;
+            if (m_hits[t] >= m_minHits) {
+                m_confirmed[t] = 1;
+            }
+            PushHistory(t);
+        } else {
+            m_detection[t] = -1;
+            m_hits[t] = 0;
+            m_missed[t]++;
+        }
+    }
+
+    // Retire tentative tracks on their first miss, confirmed ones after
+    // max_missed frames of coasting
+    for (int t = tracks - 1; t >= 0; --t) {
+        if (m_missed[t] > (m_confirmed[t] ? m_maxMissed : 0)) {
+            RemoveTrack(t);
+        }
+    }
+
+    for (int d = 0; d < count; ++d) {
+        if (!m_detectionUsed[d]) {
+            AddTrack(detections[d]);
+            m_detection.back() = d;
+        }
+    }
+
+    m_detectionTrackIds.assign(count, -1);
+    for (size_t t = 0; t < m_id.size(); ++t) {
+        if (m_detection[t] >= 0 && m_confirmed[t]) {
+            m_detectionTrackIds[m_detection[t]] = m_id[t];
+        }
+    }
+
+    m_lastUpdateMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void MultiObjectTracker::Predict(float dt)
+{
+    const size_t tracks = m_id.size();
+    for (int axis = 0; axis < 4; ++axis) {
+        float* position = m_position[axis].data();
+        const float* velocity = m_velocity[axis].data();
+        float* p00 = m_p00[axis].data();
+        float* p01 = m_p01[axis].data();
+        float* p11 = m_p11[axis].data();
+        const float* height = m_position[3].data();
+
+        for (size_t t = 0; t < tracks; ++t) {
+            // x' = x + v dt;  P' = F P F^T + Q dt
+            const float qPosition = kPositionNoise * height[t];
+            const float qVelocity = kVelocityNoise * height[t];
+            position[t] += velocity[t] * dt;
+            p00[t] += dt * (2.0f * p01[t] + dt * p11[t]) + qPosition * qPosition * dt;
+            p01[t] += dt * p11[t];
+            p11[t] += qVelocity * qVelocity * dt;
+        }
+    }
+}
+
+void MultiObjectTracker::Correct(size_t track, const Detection& detection)
+{
+    const float measurement[4] = {
+        detection.x + detection.width * 0.5f, detection.y + detection.height * 0.5f,
+        detection.width, detection.height
+    };
+    const float r = kPositionNoise * m_position[3][track];
+    const float noise = r * r;
+
+    for (int axis = 0; axis < 4; ++axis) {
+        float& p00 = m_p00[axis][track];
+        float& p01 = m_p01[axis][track];
+        float& p11 = m_p11[axis][track];
+
+        // Position is measured: S = p00 + R, K = (p00, p01) / S
+        const float s = p00 + noise;
+        const float k0 = p00 / s;
+        const float k1 = p01 / s;
+        const float innovation = measurement[axis] - m_position[axis][track];
+        m_position[axis][track] += k0 * innovation;
+        m_velocity[axis][track] += k1 * innovation;
+
+        p11 -= k1 * p01;
+        p01 *= (1.0f - k0);
+        p00 *= (1.0f - k0);
+    }
+    m_confidence[track] = detection.confidence;
+}
+
+void MultiObjectTracker::AddTrack(const Detection& detection)
+{
+    const float state[4] = {
+        detection.x + detection.width * 0.5f, detection.y + detection.height * 0.5f,
+        detection.width, detection.height
+    };
+    const float positionStd = 2.0f * kPositionNoise * detection.height;
+    const float velocityStd = 10.0f * kVelocityNoise * detection.height;
+
+    m_id.push_back(m_nextId++);
+    m_confirmed.push_back(m_minHits <= 1 ? 1 : 0);
+    m_hits.push_back(1);
+    m_missed.push_back(0);
+    m_detection.push_back(-1);
+    m_confidence.push_back(detection.confidence);
+    for (int axis = 0; axis < 4; ++axis) {
+        m_position[axis].push_back(state[axis]);
+        m_velocity[axis].push_back(0.0f);
+        m_p00[axis].push_back(positionStd * positionStd);
+        m_p01[axis].push_back(0.0f);
+        m_p11[axis].push_back(velocityStd * velocityStd);
+    }
+    m_history.resize(m_id.size() * m_historyLength * 2);
+    m_historyHead.push_back(0);
+    m_historyCount.push_back(0);
+    PushHistory(m_id.size() - 1);
+}
+
+void MultiObjectTracker::RemoveTrack(size_t track)
+{
+    // Swap with the last track and pop, field by field
+    const size_t last = m_id.size() - 1;
+    auto moveLast = [track, last](auto& field) {
+        field[track] = field[last];
+        field.pop_back();
+    };
+    moveLast(m_id);
+    moveLast(m_confirmed);
+    moveLast(m_hits);
+    moveLast(m_missed);
+    moveLast(m_detection);
+    moveLast(m_confidence);
+    for (int axis = 0; axis < 4; ++axis) {
+        moveLast(m_position[axis]);
+        moveLast(m_velocity[axis]);
+        moveLast(m_p00[axis]);
+        moveLast(m_p01[axis]);
+        moveLast(m_p11[axis]);
+    }
+    moveLast(m_historyHead);
+    moveLast(m_historyCount);
+
+    const size_t ring = static_cast<size_t>(m_historyLength) * 2;
+    std::copy(m_history.begin() + last * ring, m_history.begin() + (last + 1) * ring,
+              m_history.begin() + track * ring);
+    m_history.resize(last * ring);
+}
+
+void MultiObjectTracker::PushHistory(size_t track)
+{
+    float* ring = &m_history[track * m_historyLength * 2];
+    int& head = m_historyHead[track];
+    ring[head * 2] = m_position[0][track];
+    ring[head * 2 + 1] = m_position[1][track];
+    head = (head + 1) % m_historyLength;
+    m_historyCount[track] = std::min(m_historyCount[track] + 1, m_historyLength);
+}
+
+double MultiObjectTracker::SolveAssignment(const std::vector<float>& cost, int rows, int cols,
+                                           std::vector<int>& rowToCol)
+{
+    rowToCol.assign(std::max(0, rows), -1);
+    if (rows <= 0 || cols <= 0) {
+        return 0.0;
+    }
+
+    // Hungarian algorithm with potentials (shortest augmenting paths),
+    // O(n^2 m) for n <= m; the smaller side is the one being assigned
+    const bool transposed = rows > cols;
+    const int n = transposed ? cols : rows;
+    const int m = transposed ? rows : cols;
+    auto at = [&](int i, int j) -> double {
+        return transposed ? cost[static_cast<size_t>(j) * cols + i] : cost[static_cast<size_t>(i) * cols + j];
+    };
+
+    // Scratch kept per thread so steady-state updates do not allocate
+    const double infinity = std::numeric_limits<double>::infinity();
+    thread_local std::vector<double> u, v, minValue;
+    thread_local std::vector<int> match, way;
+    thread_local std::vector<char> used;
+    u.assign(n + 1, 0.0);
+    v.assign(m + 1, 0.0);
+    minValue.resize(m + 1);
+    match.assign(m + 1, 0);
+    way.assign(m + 1, 0);
+    used.resize(m + 1);
+
+    for (int i = 1; i <= n; ++i) {
+        match[0] = i;
+        int column = 0;
+        std::fill(minValue.begin(), minValue.end(), infinity);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[column] = 1;
+            const int row = match[column];
+            double delta = infinity;
+            int next = 0;
+            for (int j = 1; j <= m; ++j) {
+                if (used[j]) {
+                    continue;
+                }
+                double reduced = at(row - 1, j - 1) - u[row] - v[j];
+                if (reduced < minValue[j]) {
+                    minValue[j] = reduced;
+                    way[j] = column;
+                }
+                if (minValue[j] < delta) {
+                    delta = minValue[j];
+                    next = j;
+                }
+            }
+            for (int j = 0; j <= m; ++j) {
+                if (used[j]) {
+                    u[match[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minValue[j] -= delta;
+                }
+            }
+            column = next;
+        } while (match[column] != 0);
+
+        // Flip the augmenting path
+        do {
+            const int previous = way[column];
+            match[column] = match[previous];
+            column = previous;
+        } while (column != 0);
+    }
+
+    double total = 0.0;
+    for (int j = 1; j <= m; ++j) {
+        if (match[j] == 0) {
+            continue;
+        }
+        const int i = match[j] - 1;
+        total += at(i, j - 1);
+        if (transposed) {
+            rowToCol[j - 1] = i;
+        } else {
+            rowToCol[i] = j - 1;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Multi-Object Tracker
+ *
+ * SORT-style box tracker for the person tracker:
+ * - Constant-velocity Kalman filter per track on center x/y, width and
+ *   height (four decoupled position/velocity filters)
+ * - Optimal one-to-one assignment of detections to predicted tracks
+ *   (Hungarian algorithm on 1 - IoU, gated by a minimum IoU)
+ * - Birth/death hysteresis: a track is confirmed after min_hits consecutive
+ *   matches and survives max_missed unmatched frames on its prediction
+ *
+ * Tracks live in a flat structure-of-arrays store (one vector per field,
+ * removal by swapping with the last track), including a fixed-size ring of
+ * recent centers per track for motion trails. No OpenCV dependency.
+ */
+class MultiObjectTracker {
+public:
+    struct Detection {
+        float x, y, width, height;      // Top-left corner and size, pixels
+        float confidence;
+    };
+
+    MultiObjectTracker();
+
+    // Frames of consecutive matches before a track is reported (default 3)
+    void SetMinHits(int hits);
+    int GetMinHits() const { return m_minHits; }
+
+    // Frames a confirmed track coasts on its prediction before removal (default 10)
+    void SetMaxMissed(int frames);
+    int GetMaxMissed() const { return m_maxMissed; }
+
+    // Minimum IoU between prediction and detection for a match (default 0.1)
+    void SetMinIoU(float iou);
+    float GetMinIoU() const { return m_minIoU; }
+
+    // Centers kept per track for trails (default 30)
+    void SetHistoryLength(int length);
+    int GetHistoryLength() const { return m_historyLength; }
+
+    /**
+     * Predict every track forward by dt frames, match the detections and
+     * update, create and retire tracks. dt may exceed 1 when detection only
+     * runs every few frames.
+     */
+    void Update(const std::vector<Detection>& detections, float dt = 1.0f);
+    void Reset();
+
+    // Track store (index 0 .. GetTrackCount() - 1, valid until the next Update)
+    size_t GetTrackCount() const { return m_id.size(); }
+    int GetTrackId(size_t index) const { return m_id[index]; }
+    bool IsConfirmed(size_t index) const { return m_confirmed[index] != 0; }
+    int GetMissedFrames(size_t index) const { return m_missed[index]; }
+    int GetDetectionIndex(size_t index) const { return m_detection[index]; }    // -1 if unmatched this frame
+    float GetConfidence(size_t index) const { return m_confidence[index]; }
+    void GetBox(size_t index, float& x, float& y, float& width, float& height) const;
+    // Box extrapolated `ahead` frames past the last Update (state unchanged),
+    // for frames where the detector does not run
+    void GetPredictedBox(size_t index, float ahead, float& x, float& y, float& width, float& height) const;
+    void GetVelocity(size_t index, float& vx, float& vy) const;
+
+    // Trail of track centers, oldest first (x0, y0, x1, y1, ...)
+    void GetHistory(size_t index, std::vector<float>& points) const;
+
+    // Track id per detection of the last Update (-1 = not yet confirmed)
+    const std::vector<int>& GetDetectionTrackIds() const { return m_detectionTrackIds; }
+
+    double GetLastUpdateMs() const { return m_lastUpdateMs; }
+    int GetIdCount() const { return m_nextId - 1; }     // Tracks ever created
+
+    /**
+     * Minimum-cost assignment of a rows x cols cost matrix (row-major)
+     * @param rowToCol Receives the column of each row, -1 when rows > cols
+     *                 leaves the row unassigned
+     * @return Total cost of the assignment
+     */
+    static double SolveAssignment(const std::vector<float>& cost, int rows, int cols, std::vector<int>& rowToCol);
+
+private:
+    void Predict(float dt);
+    void Correct(size_t track, const Detection& detection);
+    void AddTrack(const Detection& detection);
+    void RemoveTrack(size_t track);
+    void PushHistory(size_t track);
+
+    int m_minHits;
+    int m_maxMissed;
+    float m_minIoU;
+    int m_historyLength;
+    int m_nextId;
+    double m_lastUpdateMs;
+
+    // Track store: one entry per track in every vector
+    std::vector<int> m_id;
+    std::vector<uint8_t> m_confirmed;
+    std::vector<int> m_hits;                // Consecutive matches
+    std::vector<int> m_missed;              // Consecutive misses
+    std::vector<int> m_detection;           // Detection matched this frame
+    std::vector<float> m_confidence;
+    // Kalman state per axis (0 = center x, 1 = center y, 2 = width, 3 = height):
+    // position, velocity and the 2x2 covariance (p00, p01, p11)
+    std::vector<float> m_position[4];
+    std::vector<float> m_velocity[4];
+    std::vector<float> m_p00[4];
+    std::vector<float> m_p01[4];
+    std::vector<float> m_p11[4];
+    // Trail ring per track: m_historyLength (x, y) pairs starting at track * m_historyLength * 2
+    std::vector<float> m_history;
+    std::vector<int> m_historyHead;
+    std::vector<int> m_historyCount;
+
+    // Scratch reused across updates
+    std::vector<float> m_cost;
+    std::vector<int> m_assignment;
+    std::vector<uint8_t> m_detectionUsed;
+    std::vector<int> m_detectionTrackIds;
+};
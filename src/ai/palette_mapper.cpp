@@ -0,0 +1,517 @@
+#include "palette_mapper.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+const int kGridBits = 5;                        // Bits per channel of the lookup grid
+const int kGridSize = 1 << kGridBits;           // Cells per axis
+const int kCellWidth = 256 / kGridSize;         // 8-bit values per cell
+const size_t kMaxColors = 256;                  // Candidate indices are one byte
+// Lab is not linear in BGR, so the cell radius measured at its corners is
+// widened slightly before pruning candidates
+const float kRadiusMargin = 1.1f;
+const int kMinCellWidth = 4;                    // Ambiguous cells split down to this width
+
+// sRGB channel value (0-255) to linear light
+float SrgbToLinear(float value)
+{
+    float c = value / 255.0f;
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+// Lab companding f(t) = cbrt(t) (linear near black), tabulated and linearly
+// interpolated. Palette, grid and pixels all go through the same table, so
+// the nearest-color search stays exact in this space while the per-pixel
+// refinement avoids three cbrt calls.
+const int kLabTableSize = 4096;
+const float kLabTableMax = 1.01f;                   // X/Xn can slightly exceed 1
+
+struct LabTable {
+    float values[kLabTableSize + 2];
+    LabTable()
+    {
+        for (int i = 0; i <= kLabTableSize + 1; ++i) {
+            double t = static_cast<double>(i) * kLabTableMax / kLabTableSize;
+            values[i] = static_cast<float>(t > 0.008856 ? std::cbrt(t) : 7.787 * t + 16.0 / 116.0);
+        }
+    }
+};
+
+const LabTable& GetLabTable()
+{
+    static LabTable table;
+    return table;
+}
+
+float LabF(float t)
+{
+    const LabTable& table = GetLabTable();
+    float position = std::min(std::max(t, 0.0f), kLabTableMax) * (kLabTableSize / kLabTableMax);
+    int index = std::min(static_cast<int>(position), kLabTableSize);
+    float fraction = position - index;
+    return table.values[index] + fraction * (table.values[index + 1] - table.values[index]);
+}
+
+// Each 8-bit channel's contribution to X/Xn, Y/Yn, Z/Zn (sRGB, D65), so a
+// pixel needs nine table reads instead of three pow calls
+struct XyzTable {
+    float values[3][256][3];    // [channel b, g, r][value][x, y, z]
+    XyzTable()
+    {
+        const float matrix[3][3] = {            // Columns b, g, r
+            {0.1805f / 0.95047f, 0.3576f / 0.95047f, 0.4124f / 0.95047f},
+            {0.0722f, 0.7152f, 0.2126f},
+            {0.9505f / 1.08883f, 0.1192f / 1.08883f, 0.0193f / 1.08883f}
+        };
+        for (int v = 0; v < 256; ++v) {
+            float linear = SrgbToLinear(static_cast<float>(v));
+            for (int channel = 0; channel < 3; ++channel) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    values[channel][v][axis] = matrix[axis][channel] * linear;
+                }
+            }
+        }
+    }
+};
+
+const XyzTable& GetXyzTable()
+{
+    static XyzTable table;
+    return table;
+}
+
+// CIELAB (D65) of an 8-bit BGR color
+void BgrToLab(int b, int g, int r, float* lab)
+{
+    const XyzTable& table = GetXyzTable();
+    const float* tb = table.values[0][b];
+    const float* tg = table.values[1][g];
+    const float* tr = table.values[2][r];
+    float fx = LabF(tb[0] + tg[0] + tr[0]);
+    float fy = LabF(tb[1] + tg[1] + tr[1]);
+    float fz = LabF(tb[2] + tg[2] + tr[2]);
+    lab[0] = 116.0f * fy - 16.0f;
+    lab[1] = 500.0f * (fx - fy);
+    lab[2] = 200.0f * (fy - fz);
+}
+
+float DistanceSquared(const float* a, const float* b)
+{
+    float d0 = a[0] - b[0];
+    float d1 = a[1] - b[1];
+    float d2 = a[2] - b[2];
+    return d0 * d0 + d1 * d1 + d2 * d2;
+}
+
+// Palettes as 0xRRGGBB
+const uint32_t kGameBoy[] = {0x0f380f, 0x306230, 0x8bac0f, 0x9bbc0f};
+const uint32_t kPico8[] = {
+    0x000000, 0x1d2b53, 0x7e2553, 0x008751, 0xab5236, 0x5f574f, 0xc2c3c7, 0xfff1e8,
+    0xff004d, 0xffa300, 0xffec27, 0x00e436, 0x29adff, 0x83769c, 0xff77a8, 0xffccaa
+};
+const uint32_t kCga[] = {
+    0x000000, 0x0000aa, 0x00aa00, 0x00aaaa, 0xaa0000, 0xaa00aa, 0xaa5500, 0xaaaaaa,
+    0x555555, 0x5555ff, 0x55ff55, 0x55ffff, 0xff5555, 0xff55ff, 0xffff55, 0xffffff
+};
+
+void AppendRgb(std::vector<uint8_t>& bgr, uint32_t rgb)
+{
+    bgr.push_back(static_cast<uint8_t>(rgb & 0xff));
+    bgr.push_back(static_cast<uint8_t>((rgb >> 8) & 0xff));
+    bgr.push_back(static_cast<uint8_t>((rgb >> 16) & 0xff));
+}
+
+void AppendRgb(std::vector<uint8_t>& bgr, int r, int g, int b)
+{
+    AppendRgb(bgr, (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | static_cast<uint32_t>(b));
+}
+
+std::string Trim(const std::string& text)
+{
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(start, end - start + 1);
+}
+
+// Six hex digits at `offset`, then end of line or whitespace
+bool IsHexColor(const std::string& line, size_t offset)
+{
+    if (line.size() < offset + 6 ||
+        line.find_first_not_of("0123456789abcdefABCDEF", offset) < offset + 6) {
+        return false;
+    }
+    return line.size() == offset + 6 || std::isspace(static_cast<unsigned char>(line[offset + 6]));
+}
+}
+
+PaletteMapper::PaletteMapper()
+    : m_buildTimeMs(0.0)
+{
+}
+
+std::vector<std::string> PaletteMapper::GetBuiltinNames()
+{
+    return {"gameboy", "pico8", "cga", "ega64", "xterm256"};
+}
+
+bool PaletteMapper::GetBuiltin(const std::string& name, std::vector<uint8_t>& bgr)
+{
+    bgr.clear();
+    if (name == "gameboy") {
+        for (uint32_t rgb : kGameBoy) {
+            AppendRgb(bgr, rgb);
+        }
+    } else if (name == "pico8") {
+        for (uint32_t rgb : kPico8) {
+            AppendRgb(bgr, rgb);
+        }
+    } else if (name == "cga") {
+        for (uint32_t rgb : kCga) {
+            AppendRgb(bgr, rgb);
+        }
+    } else if (name == "ega64") {
+        // Two bits per channel
+        for (int i = 0; i < 64; ++i) {
+            AppendRgb(bgr, ((i >> 4) & 3) * 85, ((i >> 2) & 3) * 85, (i & 3) * 85);
+        }
+    } else if (name == "xterm256") {
+        // 16 system colors, 6x6x6 cube, 24 grays
+        for (uint32_t rgb : kCga) {
+            AppendRgb(bgr, rgb);
+        }
+        const int cube[6] = {0, 95, 135, 175, 215, 255};
+        for (int i = 0; i < 216; ++i) {
+            AppendRgb(bgr, cube[i / 36], cube[(i / 6) % 6], cube[i % 6]);
+        }
+        for (int i = 0; i < 24; ++i) {
+            AppendRgb(bgr, 8 + i * 10, 8 + i * 10, 8 + i * 10);
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool PaletteMapper::ParseFile(const std::string& path, std::vector<uint8_t>& bgr)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    bgr.clear();
+    std::string line;
+    bool first = true;
+    bool jasc = false;
+    int jascHeaderLines = 0;
+    while (std::getline(file, line)) {
+        line = Trim(line);
+        if (first) {
+            first = false;
+            if (line == "GIMP Palette") {
+                continue;
+            }
+            if (line == "JASC-PAL") {
+                jasc = true;
+                continue;
+            }
+        }
+        if (jasc && jascHeaderLines < 2) {
+            jascHeaderLines++;      // Version and color count
+            continue;
+        }
+        // "#RRGGBB" is a color; any other '#' line is a comment
+        const bool hashColor = !line.empty() && line[0] == '#' && IsHexColor(line, 1);
+        if (line.empty() || (line[0] == '#' && !hashColor) || line[0] == ';' ||
+            line.compare(0, 5, "Name:") == 0 || line.compare(0, 8, "Columns:") == 0) {
+            continue;
+        }
+
+        // "R G B [name]" (GIMP, JASC) or "RRGGBB" (hex)
+        std::istringstream fields(line);
+        int r, g, b;
+        if (fields >> r >> g >> b) {
+            if (r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255) {
+                return false;
+            }
+            AppendRgb(bgr, r, g, b);
+            continue;
+        }
+
+        const size_t offset = hashColor ? 1 : 0;
+        if (!IsHexColor(line, offset)) {
+            return false;
+        }
+        AppendRgb(bgr, static_cast<uint32_t>(std::stoul(line.substr(offset, 6), nullptr, 16)));
+    }
+    return true;
+}
+
+bool PaletteMapper::Load(const std::string& nameOrPath)
+{
+    std::vector<uint8_t> bgr;
+    if (!GetBuiltin(nameOrPath, bgr) && !ParseFile(nameOrPath, bgr)) {
+        return false;
+    }
+    if (!SetPalette(bgr)) {
+        return false;
+    }
+    m_name = nameOrPath;
+    return true;
+}
+
+bool PaletteMapper::SetPalette(const std::vector<uint8_t>& bgr)
+{
+    const size_t colors = bgr.size() / 3;
+    if (bgr.size() % 3 != 0 || colors < 2 || colors > kMaxColors) {
+        return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    m_paletteBgr = bgr;
+    m_paletteLab.resize(colors * 3);
+    for (size_t i = 0; i < colors; ++i) {
+        BgrToLab(bgr[i * 3], bgr[i * 3 + 1], bgr[i * 3 + 2], &m_paletteLab[i * 3]);
+    }
+    m_name = "custom";
+    BuildGrid();
+
+    m_buildTimeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return true;
+}
+
+void PaletteMapper::Clear()
+{
+    m_name.clear();
+    m_paletteBgr.clear();
+    m_paletteLab.clear();
+    m_cells.clear();
+    m_candidates.clear();
+    m_buildTimeMs = 0.0;
+}
+
+void PaletteMapper::BuildGrid()
+{
+    const int colors = static_cast<int>(GetColorCount());
+
+    // Lab distance between every pair of palette entries
+    std::vector<float> separation(static_cast<size_t>(colors) * colors);
+    for (int i = 0; i < colors; ++i) {
+        for (int j = 0; j < colors; ++j) {
+            separation[i * colors + j] = std::sqrt(DistanceSquared(&m_paletteLab[i * 3], &m_paletteLab[j * 3]));
+        }
+    }
+
+    std::vector<uint8_t> all(colors);
+    for (int i = 0; i < colors; ++i) {
+        all[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<float> distances(colors);
+
+    // Entries of `superset` that can be nearest to some color of the cube
+    // [lo, lo + width - 1]^3, appended to m_candidates
+    auto appendCandidates = [&](const int* lo, int width, const uint8_t* superset, int supersetCount) {
+        const int hi[3] = {lo[0] + width - 1, lo[1] + width - 1, lo[2] + width - 1};
+        float center[3];
+        BgrToLab(lo[0] + width / 2, lo[1] + width / 2, lo[2] + width / 2, center);
+
+        // Farthest corner bounds how far any color in the cell is from its
+        // (integer) center
+        float radiusSquared = 0.0f;
+        for (int corner = 0; corner < 8; ++corner) {
+            float lab[3];
+            BgrToLab((corner & 4) ? hi[0] : lo[0], (corner & 2) ? hi[1] : lo[1], (corner & 1) ? hi[2] : lo[2], lab);
+            radiusSquared = std::max(radiusSquared, DistanceSquared(center, lab));
+        }
+        const float radius = std::sqrt(radiusSquared) * kRadiusMargin;
+
+        int nearest = superset[0];
+        for (int k = 0; k < supersetCount; ++k) {
+            int i = superset[k];
+            distances[i] = DistanceSquared(center, &m_paletteLab[i * 3]);
+            if (distances[i] < distances[nearest]) {
+                nearest = i;
+            }
+        }
+
+        // Entry p can win somewhere in the cell only if the plane bisecting
+        // p and the center's nearest entry q passes within the cell radius
+        // of the center: (|p - c|^2 - |q - c|^2) / (2 |p - q|) <= radius
+        const float* nearestSeparation = &separation[nearest * colors];
+        for (int k = 0; k < supersetCount; ++k) {
+            int i = superset[k];
+            if (i == nearest || distances[i] - distances[nearest] <= 2.0f * radius * nearestSeparation[i]) {
+                m_candidates.push_back(static_cast<uint8_t>(i));
+            }
+        }
+    };
+
+    const size_t cells = static_cast<size_t>(kGridSize) * kGridSize * kGridSize;
+    m_cells.assign(cells, Cell());
+    m_candidates.clear();
+
+    for (int b = 0; b < kGridSize; ++b) {
+        for (int g = 0; g < kGridSize; ++g) {
+            for (int r = 0; r < kGridSize; ++r) {
+                const int lo[3] = {b * kCellWidth, g * kCellWidth, r * kCellWidth};
+                Cell& cell = m_cells[(static_cast<size_t>(b) * kGridSize + g) * kGridSize + r];
+                cell.first = static_cast<uint32_t>(m_candidates.size());
+                appendCandidates(lo, kCellWidth, all.data(), colors);
+                cell.count = static_cast<uint32_t>(m_candidates.size()) - cell.first;
+            }
+        }
+    }
+
+    // Split ambiguous cells into octants, each pruned against its parent's
+    // candidates, until one candidate is left or the cell is kMinCellWidth wide.
+    // Children are appended, so this walks the growing array once.
+    std::vector<uint8_t> parentCandidates;
+    std::vector<int> cellLow(cells * 3);
+    for (size_t i = 0; i < cells; ++i) {
+        cellLow[i * 3] = static_cast<int>(i >> (2 * kGridBits)) * kCellWidth;
+        cellLow[i * 3 + 1] = static_cast<int>((i >> kGridBits) & (kGridSize - 1)) * kCellWidth;
+        cellLow[i * 3 + 2] = static_cast<int>(i & (kGridSize - 1)) * kCellWidth;
+    }
+    std::vector<int> cellWidth(cells, kCellWidth);
+
+    for (size_t i = 0; i < m_cells.size(); ++i) {
+        const int width = cellWidth[i];
+        if (m_cells[i].count <= 1 || width <= kMinCellWidth) {
+            continue;
+        }
+
+        parentCandidates.assign(m_candidates.begin() + m_cells[i].first,
+                                m_candidates.begin() + m_cells[i].first + m_cells[i].count);
+        const int lo[3] = {cellLow[i * 3], cellLow[i * 3 + 1], cellLow[i * 3 + 2]};
+        const int half = width / 2;
+        const uint32_t firstChild = static_cast<uint32_t>(m_cells.size());
+
+        for (int octant = 0; octant < 8; ++octant) {
+            const int childLow[3] = {lo[0] + ((octant & 4) ? half : 0), lo[1] + ((octant & 2) ? half : 0),
+                                     lo[2] + ((octant & 1) ? half : 0)};
+            Cell child;
+            child.first = static_cast<uint32_t>(m_candidates.size());
+            appendCandidates(childLow, half, parentCandidates.data(), static_cast<int>(parentCandidates.size()));
+            child.count = static_cast<uint32_t>(m_candidates.size()) - child.first;
+
+            m_cells.push_back(child);
+            cellLow.insert(cellLow.end(), childLow, childLow + 3);
+            cellWidth.push_back(half);
+        }
+
+        // count 0 marks a split cell; first is its first child
+        m_cells[i].first = firstChild;
+        m_cells[i].count = 0;
+    }
+}
+
+double PaletteMapper::GetRefinedColorRatio() const
+{
+    // Share of 8-bit colors whose leaf still needs the Lab comparison
+    if (m_cells.empty()) {
+        return 0.0;
+    }
+    const size_t cells = static_cast<size_t>(kGridSize) * kGridSize * kGridSize;
+    double ambiguous = 0.0;
+    std::vector<std::pair<size_t, double>> stack;
+    for (size_t i = 0; i < cells; ++i) {
+        stack.emplace_back(i, 1.0 / cells);
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            const Cell& cell = m_cells[node.first];
+            if (cell.count == 0) {
+                for (int octant = 0; octant < 8; ++octant) {
+                    stack.emplace_back(cell.first + octant, node.second / 8.0);
+                }
+            } else if (cell.count > 1) {
+                ambiguous += node.second;
+            }
+        }
+    }
+    return ambiguous;
+}
+
+uint8_t PaletteMapper::Refine(const uint8_t* bgr, const uint8_t* candidates, int count) const
+{
+    float lab[3];
+    BgrToLab(bgr[0], bgr[1], bgr[2], lab);
+
+    uint8_t best = candidates[0];
+    float bestDistance = DistanceSquared(lab, &m_paletteLab[best * 3]);
+    for (int i = 1; i < count; ++i) {
+        float distance = DistanceSquared(lab, &m_paletteLab[candidates[i] * 3]);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = candidates[i];
+        }
+    }
+    return best;
+}
+
+void PaletteMapper::MapRow(const uint8_t* in, uint8_t* out, int count) const
+{
+    if (!IsLoaded()) {
+        if (in != out) {
+            std::copy(in, in + count * 3, out);
+        }
+        return;
+    }
+
+    const Cell* cells = m_cells.data();
+    const uint8_t* candidates = m_candidates.data();
+    const uint8_t* palette = m_paletteBgr.data();
+    const int shift = 8 - kGridBits;
+
+    for (int x = 0; x < count; ++x) {
+        const uint8_t* pixel = in + x * 3;
+        const Cell* cell = &cells[(static_cast<size_t>(pixel[0] >> shift) << (2 * kGridBits)) |
+                                  (static_cast<size_t>(pixel[1] >> shift) << kGridBits) |
+                                  static_cast<size_t>(pixel[2] >> shift)];
+
+        // Descend split cells by the next bit of each channel
+        for (int bit = shift - 1; cell->count == 0; --bit) {
+            const int octant = (((pixel[0] >> bit) & 1) << 2) | (((pixel[1] >> bit) & 1) << 1) |
+                               ((pixel[2] >> bit) & 1);
+            cell = &cells[cell->first + octant];
+        }
+
+        // One candidate: plain table fetch; otherwise exact Lab comparison
+        const uint8_t index = cell->count == 1 ? candidates[cell->first]
+                                               : Refine(pixel, candidates + cell->first, static_cast<int>(cell->count));
+        const uint8_t* color = palette + index * 3;
+        out[x * 3] = color[0];
+        out[x * 3 + 1] = color[1];
+        out[x * 3 + 2] = color[2];
+    }
+}
+
+#ifdef HAVE_OPENCV
+
+void PaletteMapper::Apply(const cv::Mat& src, cv::Mat& dst) const
+{
+    if (src.empty() || src.type() != CV_8UC3 || !IsLoaded()) {
+        if (dst.data != src.data) {
+            src.copyTo(dst);
+        }
+        return;
+    }
+
+    dst.create(src.size(), CV_8UC3);
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            MapRow(src.ptr<uint8_t>(y), dst.ptr<uint8_t>(y), src.cols);
+        }
+    });
+}
+
+#endif  // HAVE_OPENCV
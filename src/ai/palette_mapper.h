@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Palette Mapper
+ *
+ * Maps 8-bit BGR images to the perceptually nearest color of a fixed palette
+ * (2-256 entries: built-in retro palettes or user palette files).
+ *
+ * Loading a palette builds a 32x32x32 grid over BGR (5 bits per channel).
+ * Each cell stores the palette entries that can be nearest (in CIELAB) to
+ * any color inside it; cells with several candidates are split into octants
+ * (once, to 6 bits per channel) and re-pruned. Most pixels reach a single-candidate
+ * leaf and map with table fetches only; the rest convert to Lab and compare
+ * against their few candidates, so results match a full nearest-color search.
+ *
+ * Palette files: GIMP (.gpl), JASC-PAL (.pal) or one RRGGBB / #RRGGBB hex color per
+ * line (.hex, as exported by lospec.com).
+ */
+class PaletteMapper {
+public:
+    PaletteMapper();
+
+    /**
+     * Load a built-in palette by name or a palette file by path
+     * Built-ins: gameboy (4), pico8 (16), cga (16), ega64 (64), xterm256 (256)
+     * @return false (palette unchanged) if the name is unknown, the file is
+     *         unreadable, or it holds fewer than 2 or more than 256 colors
+     */
+    bool Load(const std::string& nameOrPath);
+
+    // Palette as packed BGR triples (3 bytes per color)
+    bool SetPalette(const std::vector<uint8_t>& bgr);
+    void Clear();
+
+    bool IsLoaded() const { return !m_paletteBgr.empty(); }
+    const std::string& GetName() const { return m_name; }
+    size_t GetColorCount() const { return m_paletteBgr.size() / 3; }
+    const std::vector<uint8_t>& GetPaletteBgr() const { return m_paletteBgr; }
+    double GetBuildTimeMs() const { return m_buildTimeMs; }
+    double GetRefinedColorRatio() const;   // Share of colors that need the Lab refinement
+
+    static std::vector<std::string> GetBuiltinNames();
+
+    // Map one row of BGR pixels (in and out may alias)
+    void MapRow(const uint8_t* in, uint8_t* out, int count) const;
+
+#ifdef HAVE_OPENCV
+    // Map an 8-bit BGR image (src and dst may alias)
+    void Apply(const cv::Mat& src, cv::Mat& dst) const;
+#endif
+
+private:
+    static bool ParseFile(const std::string& path, std::vector<uint8_t>& bgr);
+    static bool GetBuiltin(const std::string& name, std::vector<uint8_t>& bgr);
+    void BuildGrid();
+    uint8_t Refine(const uint8_t* bgr, const uint8_t* candidates, int count) const;
+
+    std::string m_name;
+    std::vector<uint8_t> m_paletteBgr;      // 3 bytes per entry
+    std::vector<float> m_paletteLab;        // 3 floats per entry
+
+    // Lookup tree: cell ((b >> 3) * 32 + (g >> 3)) * 32 + (r >> 3) is a root.
+    // A leaf lists its candidates at m_candidates[first .. first + count);
+    // count 0 means the cell is split and its 8 octants start at m_cells[first].
+    struct Cell {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+    std::vector<Cell> m_cells;
+    std::vector<uint8_t> m_candidates;
+
+    double m_buildTimeMs;
+};
@@ -0,0 +1,190 @@
+#include "parallel_net_pool.h"
+#include "logger.h"
+#include <algorithm>
+
+ParallelNetPool::ParallelNetPool()
+    : m_running(false),
+      m_nextSubmit(0),
+      m_nextPop(0),
+      m_nextInstance(0)
+{
+}
+
+ParallelNetPool::~ParallelNetPool()
+{
+    Stop();
+}
+
+size_t ParallelNetPool::GetInFlight() const
+{
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+    return static_cast<size_t>(m_nextSubmit - m_nextPop);
+}
+
+#ifdef HAVE_OPENCV
+
+bool ParallelNetPool::Start(const std::vector<cv::dnn::Net>& nets)
+{
+    Stop();
+
+    if (nets.empty() || nets.size() > 16) {
+        return false;
+    }
+
+    int instances = static_cast<int>(nets.size());
+
+    for (int i = 0; i < instances; ++i) {
+        if (nets[i].empty()) {
+            MS_LOG_ERROR("[ParallelNetPool] Net instance " << i << " is not loaded");
+            m_instances.clear();
+            return false;
+        }
+        auto instance = std::make_unique<Instance>();
+        instance->net = nets[i];
+        m_instances.push_back(std::move(instance));
+    }
+
+    m_nextSubmit = 0;
+    m_nextPop = 0;
+    m_nextInstance = 0;
+    m_reorder.clear();
+    m_running = true;
+
+    for (auto& instance : m_instances) {
+        Instance* slot = instance.get();
+        slot->thread = std::thread([this, slot]() { WorkerLoop(*slot); });
+    }
+
+    MS_LOG_INFO("[ParallelNetPool] Started " << instances << " instances");
+    return true;
+}
+
+void ParallelNetPool::Submit(const cv::Mat& frame, double timestamp, const FrameJob& job)
+{
+    if (!m_running || m_instances.empty()) {
+        return;
+    }
+
+    Instance& instance = *m_instances[m_nextInstance];
+    m_nextInstance = (m_nextInstance + 1) % m_instances.size();
+
+    std::unique_lock<std::mutex> lock(instance.mutex);
+    instance.wake.wait(lock, [&]() { return !instance.busy || !m_running; });
+    if (!m_running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> resultLock(m_resultMutex);
+        instance.sequence = m_nextSubmit++;
+    }
+    instance.timestamp = timestamp;
+    instance.frame = frame;
+    instance.job = job;
+    instance.busy = true;
+    instance.wake.notify_all();
+}
+
+bool ParallelNetPool::Pop(cv::Mat& output, double& timestamp, bool wait)
+{
+    std::unique_lock<std::mutex> lock(m_resultMutex);
+    if (m_nextPop == m_nextSubmit) {
+        return false;
+    }
+
+    auto ready = [this]() { return m_reorder.count(m_nextPop) > 0 || !m_running; };
+    if (wait) {
+        m_resultReady.wait(lock, ready);
+    }
+
+    auto it = m_reorder.find(m_nextPop);
+    if (it == m_reorder.end()) {
+        return false;
+    }
+
+    output = it->second.output;
+    timestamp = it->second.timestamp;
+    m_reorder.erase(it);
+    m_nextPop++;
+    return true;
+}
+
+void ParallelNetPool::WorkerLoop(Instance& instance)
+{
+    while (true) {
+        uint64_t sequence;
+        double timestamp;
+        cv::Mat frame;
+        FrameJob job;
+        {
+            std::unique_lock<std::mutex> lock(instance.mutex);
+            instance.wake.wait(lock, [&]() { return instance.busy || !m_running; });
+            if (!m_running) {
+                return;
+            }
+            sequence = instance.sequence;
+            timestamp = instance.timestamp;
+            frame = instance.frame;
+            job = instance.job;
+        }
+
+        cv::Mat output;
+        try {
+            if (job) {
+                output = job(instance.net, frame);
+            }
+        } catch (const std::exception& e) {
+            MS_LOG_ERROR("[ParallelNetPool] Inference failed: " << e.what());
+        } catch (...) {
+            MS_LOG_ERROR("[ParallelNetPool] Inference failed: unknown exception");
+        }
+
+        // Failed frames still get a (empty) slot so the reorder buffer never stalls
+        {
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_reorder[sequence] = Result{timestamp, output};
+        }
+        m_resultReady.notify_all();
+
+        {
+            std::lock_guard<std::mutex> lock(instance.mutex);
+            instance.frame.release();
+            instance.job = nullptr;
+            instance.busy = false;
+        }
+        instance.wake.notify_all();
+    }
+}
+
+#endif  // HAVE_OPENCV
+
+void ParallelNetPool::Stop()
+{
+#ifdef HAVE_OPENCV
+    if (m_running) {
+        m_running = false;
+        for (auto& instance : m_instances) {
+            {
+                std::lock_guard<std::mutex> lock(instance->mutex);
+            }
+            instance->wake.notify_all();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+        }
+        m_resultReady.notify_all();
+
+        for (auto& instance : m_instances) {
+            if (instance->thread.joinable()) {
+                instance->thread.join();
+            }
+        }
+    }
+
+    m_reorder.clear();
+#endif
+    m_instances.clear();
+    m_nextSubmit = 0;
+    m_nextPop = 0;
+    m_nextInstance = 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/dnn.hpp>
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Parallel Net Pool
+ *
+ * Frame-parallel inference for CPU-bound networks. A single cv::dnn::Net
+ * forward pass stops scaling well beyond a handful of threads, so instead K
+ * independent net instances each take whole frames, dispatched round-robin.
+ *
+ * Each instance runs its forward passes serially on its own worker thread.
+ * cv::dnn has no per-net thread setting and the pool never changes OpenCV's
+ * process-wide thread count, so other cv::parallel_for_ users are not
+ * throttled; OpenCV runs a parallel region that starts while another is
+ * active inline on the calling thread, so at most one pass at a time also
+ * borrows OpenCV's shared workers.
+ *
+ * Outputs go through a reorder buffer and come back in submission order with
+ * their original timestamps. Throughput scales with K at the cost of up to
+ * K - 1 frames of added latency.
+ */
+class ParallelNetPool {
+public:
+#ifdef HAVE_OPENCV
+    // Runs one frame through a net instance; called concurrently with distinct nets.
+    // Submitted with each frame, so everything it needs is captured by value.
+    using FrameJob = std::function<cv::Mat(cv::dnn::Net& net, const cv::Mat& frame)>;
+#endif
+
+    ParallelNetPool();
+    ~ParallelNetPool();
+
+    ParallelNetPool(const ParallelNetPool&) = delete;
+    ParallelNetPool& operator=(const ParallelNetPool&) = delete;
+
+#ifdef HAVE_OPENCV
+    /**
+     * Start one worker thread per net instance
+     * @param nets Loaded and configured instances of one model (1-16), not used elsewhere while running
+     */
+    bool Start(const std::vector<cv::dnn::Net>& nets);
+
+    /**
+     * Queue a frame on the next instance. Blocks while that instance is still
+     * busy with its previous frame, which bounds the frames in flight to K.
+     * The frame must not be modified by the caller afterwards.
+     */
+    void Submit(const cv::Mat& frame, double timestamp, const FrameJob& job);
+
+    /**
+     * Take the next output in submission order
+     * @param wait Block until it is available
+     * @return false if the next output is not ready (or nothing is in flight)
+     */
+    bool Pop(cv::Mat& output, double& timestamp, bool wait);
+#endif
+
+    void Stop();
+
+    bool IsRunning() const { return m_running; }
+    int GetInstanceCount() const { return static_cast<int>(m_instances.size()); }
+    size_t GetInFlight() const;
+
+private:
+#ifdef HAVE_OPENCV
+    struct Instance {
+        cv::dnn::Net net;
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool busy = false;
+        uint64_t sequence = 0;
+        double timestamp = 0.0;
+        cv::Mat frame;
+        FrameJob job;
+    };
+
+    struct Result {
+        double timestamp;
+        cv::Mat output;
+    };
+
+    void WorkerLoop(Instance& instance);
+
+    std::vector<std::unique_ptr<Instance>> m_instances;
+    std::map<uint64_t, Result> m_reorder;    // Completed outputs keyed by sequence
+    std::condition_variable m_resultReady;
+#else
+    std::vector<int> m_instances;
+#endif
+
+    mutable std::mutex m_resultMutex;
+    std::atomic<bool> m_running;
+    uint64_t m_nextSubmit;
+    uint64_t m_nextPop;
+    size_t m_nextInstance;
+};
@@ -0,0 +1,421 @@
+#include "person_detector.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+namespace {
+const float kDefaultConfidence = 0.5f;
+const float kDefaultNms = 0.4f;
+
+// "person" in COCO (darknet YOLO), VOC (MobileNet-SSD) and the TF object
+// detection API label map (1-based, 0 = background)
+const int kCocoPersonClass = 0;
+const int kVocPersonClass = 15;
+const int kTensorflowPersonClass = 1;
+
+// SKIN_LUT: frame downscale per axis, and the skin cluster in YCrCb
+// (Cr 133-173, Cb 77-127) with a floor on luma to drop dark noise
+const int kSkinDownscale = 4;
+const float kSkinCrMin = 133.0f;
+const float kSkinCrMax = 173.0f;
+const float kSkinCbMin = 77.0f;
+const float kSkinCbMax = 127.0f;
+const float kSkinLumaMin = 40.0f;
+
+// Skin classification of every 5-bit BGR cell (evaluated at the cell center),
+// indexed (b >> 3) << 10 | (g >> 3) << 5 | (r >> 3): 32 KB, stays in cache
+const std::vector<uint8_t>& GetSkinLut()
+{
+    static const std::vector<uint8_t> lut = [] {
+        std::vector<uint8_t> table(32 * 32 * 32);
+        for (int b = 0; b < 32; ++b) {
+            for (int g = 0; g < 32; ++g) {
+                for (int r = 0; r < 32; ++r) {
+                    float blue = b * 8 + 4.0f;
+                    float green = g * 8 + 4.0f;
+                    float red = r * 8 + 4.0f;
+                    float luma = 0.299f * red + 0.587f * green + 0.114f * blue;
+                    float cr = (red - luma) * 0.713f + 128.0f;
+                    float cb = (blue - luma) * 0.564f + 128.0f;
+                    bool skin = luma >= kSkinLumaMin && cr >= kSkinCrMin && cr <= kSkinCrMax &&
+                                cb >= kSkinCbMin && cb <= kSkinCbMax;
+                    table[(b << 10) | (g << 5) | r] = skin ? 255 : 0;
+                }
+            }
+        }
+        return table;
+    }();
+    return lut;
+}
+
+bool EndsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string ReplaceExtension(const std::string& path, const std::string& from, const std::string& to)
+{
+    return path.substr(0, path.size() - from.size()) + to;
+}
+}
+
+PersonDetector::PersonDetector()
+    : m_method(DNN),
+      m_modelLoaded(false),
+      m_format(YOLO_DARKNET),
+      m_personClass(kCocoPersonClass),
+      m_confidenceThreshold(kDefaultConfidence),
+      m_nmsThreshold(kDefaultNms),
+      m_lastDetectMs(0.0)
+{
+}
+
+PersonDetector::Method PersonDetector::GetActiveMethod() const
+{
+    if (m_method == DNN) {
+        return m_modelLoaded ? DNN : SKIN_LUT;
+    }
+    return m_method;
+}
+
+bool PersonDetector::ParseMethod(const std::string& name, Method& method)
+{
+    if (name == "skin") {
+        method = SKIN;
+    } else if (name == "skin_lut") {
+        method = SKIN_LUT;
+    } else if (name == "dnn") {
+        method = DNN;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string PersonDetector::GetMethodName(Method method)
+{
+    switch (method) {
+        case SKIN: return "skin";
+        case SKIN_LUT: return "skin_lut";
+        case DNN: return "dnn";
+    }
+    return "unknown";
+}
+
+void PersonDetector::SetConfidenceThreshold(float threshold)
+{
+    m_confidenceThreshold = std::max(0.0f, std::min(1.0f, threshold));
+}
+
+void PersonDetector::SetNmsThreshold(float threshold)
+{
+    m_nmsThreshold = std::max(0.0f, std::min(1.0f, threshold));
+}
+
+bool PersonDetector::LoadModel(const std::string& modelPath)
+{
+#ifdef HAVE_OPENCV
+    ModelFormat format;
+    std::string configPath;
+    if (EndsWith(modelPath, ".weights")) {
+        format = YOLO_DARKNET;
+        configPath = ReplaceExtension(modelPath, ".weights", ".cfg");
+    } else if (EndsWith(modelPath, ".caffemodel")) {
+        format = CAFFE_SSD;
+        configPath = ReplaceExtension(modelPath, ".caffemodel", ".prototxt");
+    } else if (EndsWith(modelPath, ".pb")) {
+        format = TENSORFLOW_SSD;
+        configPath = ReplaceExtension(modelPath, ".pb", ".pbtxt");
+    } else {
+        MS_LOG_ERROR("[PersonDetector] Unsupported model format: " << modelPath);
+        return false;
+    }
+
+    if (!std::filesystem::exists(modelPath) || !std::filesystem::exists(configPath)) {
+        return false;
+    }
+
+    try {
+        cv::dnn::Net net;
+        switch (format) {
+            case YOLO_DARKNET: net = cv::dnn::readNetFromDarknet(configPath, modelPath); break;
+            case CAFFE_SSD: net = cv::dnn::readNetFromCaffe(configPath, modelPath); break;
+            case TENSORFLOW_SSD: net = cv::dnn::readNetFromTensorflow(modelPath, configPath); break;
+        }
+        if (net.empty()) {
+            return false;
+        }
+        net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+
+        m_net = net;
+        m_outputNames = m_net.getUnconnectedOutLayersNames();
+        m_format = format;
+        m_personClass = format == YOLO_DARKNET ? kCocoPersonClass
+                      : format == CAFFE_SSD ? kVocPersonClass : kTensorflowPersonClass;
+        m_inputSize = format == YOLO_DARKNET ? cv::Size(416, 416) : cv::Size(300, 300);
+        m_modelPath = modelPath;
+        m_modelLoaded = true;
+
+        MS_LOG_INFO("[PersonDetector] Loaded " << modelPath << " (" << m_outputNames.size()
+                  << " output layers, input " << m_inputSize.width << "x" << m_inputSize.height << ")");
+        return true;
+    } catch (const cv::Exception& e) {
+        MS_LOG_ERROR("[PersonDetector] Failed to load " << modelPath << ": " << e.what());
+        return false;
+    }
+#else
+    (void)modelPath;
+    return false;
+#endif
+}
+
+#ifdef HAVE_OPENCV
+
+void PersonDetector::Detect(const cv::Mat& frame, std::vector<Detection>& detections)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    detections.clear();
+
+    if (!frame.empty()) {
+        cv::Mat bgr = frame;
+        if (frame.channels() == 4) {
+            cv::cvtColor(frame, bgr, cv::COLOR_BGRA2BGR);
+        }
+
+        try {
+            switch (GetActiveMethod()) {
+                case DNN: DetectDnn(bgr, detections); break;
+                case SKIN_LUT: DetectSkinLut(bgr, detections); break;
+                case SKIN: DetectSkin(bgr, detections); break;
+            }
+        } catch (const cv::Exception& e) {
+            MS_LOG_ERROR("[PersonDetector] Exception: " << e.what());
+            detections.clear();
+        }
+    }
+
+    m_lastDetectMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void PersonDetector::DetectDnn(const cv::Mat& bgr, std::vector<Detection>& detections)
+{
+    cv::Mat blob;
+    switch (m_format) {
+        case YOLO_DARKNET:
+            cv::dnn::blobFromImage(bgr, blob, 1.0 / 255.0, m_inputSize, cv::Scalar(), true, false);
+            break;
+        case CAFFE_SSD:
+            cv::dnn::blobFromImage(bgr, blob, 1.0 / 127.5, m_inputSize, cv::Scalar(127.5, 127.5, 127.5), false, false);
+            break;
+        case TENSORFLOW_SSD:
+            cv::dnn::blobFromImage(bgr, blob, 1.0, m_inputSize, cv::Scalar(), true, false);
+            break;
+    }
+    m_net.setInput(blob);
+    m_net.forward(m_outputs, m_outputNames);
+
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    const float width = static_cast<float>(bgr.cols);
+    const float height = static_cast<float>(bgr.rows);
+
+    if (m_format == YOLO_DARKNET) {
+        // Region layers: one row per anchor, [cx, cy, w, h, objectness, class scores...]
+        // with coordinates relative to the image
+        for (const cv::Mat& output : m_outputs) {
+            for (int row = 0; row < output.rows; ++row) {
+                const float* data = output.ptr<float>(row);
+                float score = data[5 + m_personClass];
+                if (score < m_confidenceThreshold) continue;
+
+                float boxWidth = data[2] * width;
+                float boxHeight = data[3] * height;
+                boxes.emplace_back(cvRound(data[0] * width - boxWidth * 0.5f), cvRound(data[1] * height - boxHeight * 0.5f),
+                                   cvRound(boxWidth), cvRound(boxHeight));
+                scores.push_back(score);
+            }
+        }
+    } else {
+        // DetectionOutput: [1, 1, N, 7] rows of [image, class, score, x1, y1, x2, y2]
+        const cv::Mat& output = m_outputs[0];
+        const float* data = reinterpret_cast<const float*>(output.data);
+        const size_t count = output.total() / 7;
+        for (size_t i = 0; i < count; ++i, data += 7) {
+            if (static_cast<int>(data[1]) != m_personClass || data[2] < m_confidenceThreshold) continue;
+
+            cv::Point topLeft(cvRound(data[3] * width), cvRound(data[4] * height));
+            cv::Point bottomRight(cvRound(data[5] * width), cvRound(data[6] * height));
+            boxes.emplace_back(topLeft, bottomRight);
+            scores.push_back(data[2]);
+        }
+    }
+
+    std::vector<int> keep;
+    cv::dnn::NMSBoxes(boxes, scores, m_confidenceThreshold, m_nmsThreshold, keep);
+
+    const cv::Rect bounds(0, 0, bgr.cols, bgr.rows);
+    for (int index : keep) {
+        cv::Rect box = boxes[index] & bounds;
+        if (box.area() > 0) {
+            detections.push_back({box, scores[index]});
+        }
+    }
+}
+
+void PersonDetector::DetectSkin(const cv::Mat& bgr, std::vector<Detection>& detections)
+{
+    cv::Mat hsv;
+    cv::cvtColor(bgr, hsv, cv::COLOR_BGR2HSV);
+
+    // Skin color range in HSV
+    // H: 0-20 or 170-180 (red-ish), S: 10-40, V: 60-255
+    cv::Mat mask1, mask2;
+    cv::inRange(hsv, cv::Scalar(0, 10, 60), cv::Scalar(20, 40, 255), mask1);
+    cv::inRange(hsv, cv::Scalar(170, 10, 60), cv::Scalar(180, 40, 255), mask2);
+
+    cv::Mat skinMask = mask1 | mask2;
+
+    // Morphological operations to clean up
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(15, 15));
+    cv::morphologyEx(skinMask, skinMask, cv::MORPH_CLOSE, kernel);
+    cv::morphologyEx(skinMask, skinMask, cv::MORPH_OPEN, kernel);
+
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(skinMask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    const int minArea = static_cast<int>(bgr.rows * bgr.cols * 0.01);  // 1% of frame
+    const int maxArea = static_cast<int>(bgr.rows * bgr.cols * 0.8);   // 80% of frame
+
+    for (const auto& contour : contours) {
+        double area = cv::contourArea(contour);
+        if (area <= minArea || area >= maxArea) continue;
+
+        cv::Rect box = cv::boundingRect(contour);
+
+        // Expand the box slightly to capture more of the person
+        int expand = std::max(10, std::min(box.width, box.height) / 10);
+        box.x = std::max(0, box.x - expand);
+        box.y = std::max(0, box.y - expand);
+        box.width = std::min(bgr.cols - box.x, box.width + 2 * expand);
+        box.height = std::min(bgr.rows - box.y, box.height + 2 * expand);
+
+        float confidence = std::min(1.0f, static_cast<float>(area / (bgr.rows * bgr.cols * 0.15)));
+        detections.push_back({box, confidence});
+    }
+
+    if (!detections.empty()) {
+        return;
+    }
+
+    // No skin regions: fall back to person-shaped edge contours
+    cv::Mat gray;
+    cv::cvtColor(bgr, gray, cv::COLOR_BGR2GRAY);
+
+    cv::Mat edges;
+    cv::Canny(gray, edges, 50, 150);
+
+    cv::Mat edgeKernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    cv::dilate(edges, edges, edgeKernel, cv::Point(-1, -1), 2);
+
+    contours.clear();
+    cv::findContours(edges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    for (const auto& contour : contours) {
+        double area = cv::contourArea(contour);
+        if (area <= minArea || area >= maxArea) continue;
+
+        cv::Rect box = cv::boundingRect(contour);
+        float aspectRatio = static_cast<float>(box.width) / std::max(1, box.height);
+        if (aspectRatio > 0.25f && aspectRatio < 2.0f) {
+            detections.push_back({box, 0.5f});
+        }
+    }
+}
+
+void PersonDetector::DetectSkinLut(const cv::Mat& bgr, std::vector<Detection>& detections)
+{
+    cv::Size smallSize(std::max(1, bgr.cols / kSkinDownscale), std::max(1, bgr.rows / kSkinDownscale));
+    cv::resize(bgr, m_small, smallSize, 0, 0, cv::INTER_AREA);
+
+    // Classify straight from BGR through the table
+    const uint8_t* lut = GetSkinLut().data();
+    m_skinMask.create(m_small.size(), CV_8UC1);
+    for (int y = 0; y < m_small.rows; ++y) {
+        const cv::Vec3b* in = m_small.ptr<cv::Vec3b>(y);
+        uint8_t* out = m_skinMask.ptr<uint8_t>(y);
+        for (int x = 0; x < m_small.cols; ++x) {
+            out[x] = lut[((in[x][0] >> 3) << 10) | ((in[x][1] >> 3) << 5) | (in[x][2] >> 3)];
+        }
+    }
+
+    // 5x5 at this scale covers about the 15x15 ellipse of SKIN; rectangular
+    // kernels run as one row pass and one column pass
+    static const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(5, 5));
+    cv::morphologyEx(m_skinMask, m_skinMask, cv::MORPH_CLOSE, kernel);
+    cv::morphologyEx(m_skinMask, m_skinMask, cv::MORPH_OPEN, kernel);
+
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(m_skinMask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    const double smallArea = static_cast<double>(m_small.total());
+    const double minArea = smallArea * 0.01;   // 1% of frame
+    const double maxArea = smallArea * 0.8;    // 80% of frame
+    const double scaleX = static_cast<double>(bgr.cols) / m_small.cols;
+    const double scaleY = static_cast<double>(bgr.rows) / m_small.rows;
+    const cv::Rect bounds(0, 0, bgr.cols, bgr.rows);
+
+    auto toFrame = [&](const cv::Rect& box) {
+        return cv::Rect(cvRound(box.x * scaleX), cvRound(box.y * scaleY),
+                        cvRound(box.width * scaleX), cvRound(box.height * scaleY)) & bounds;
+    };
+
+    for (const auto& contour : contours) {
+        double area = cv::contourArea(contour);
+        if (area <= minArea || area >= maxArea) continue;
+
+        cv::Rect box = toFrame(cv::boundingRect(contour));
+
+        // Expand the box slightly to capture more of the person
+        int expand = std::max(10, std::min(box.width, box.height) / 10);
+        box.x = std::max(0, box.x - expand);
+        box.y = std::max(0, box.y - expand);
+        box.width = std::min(bgr.cols - box.x, box.width + 2 * expand);
+        box.height = std::min(bgr.rows - box.y, box.height + 2 * expand);
+
+        float confidence = std::min(1.0f, static_cast<float>(area / (smallArea * 0.15)));
+        detections.push_back({box, confidence});
+    }
+
+    if (!detections.empty()) {
+        return;
+    }
+
+    // No skin regions: person-shaped edge contours, also at the small scale
+    // (one 3x3 dilation here spans about two 5x5 dilations at full size)
+    cv::Mat gray;
+    cv::cvtColor(m_small, gray, cv::COLOR_BGR2GRAY);
+
+    cv::Mat edges;
+    cv::Canny(gray, edges, 50, 150);
+    cv::dilate(edges, edges, cv::Mat());
+
+    contours.clear();
+    cv::findContours(edges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    for (const auto& contour : contours) {
+        double area = cv::contourArea(contour);
+        if (area <= minArea || area >= maxArea) continue;
+
+        cv::Rect box = cv::boundingRect(contour);
+        float aspectRatio = static_cast<float>(box.width) / std::max(1, box.height);
+        if (aspectRatio > 0.25f && aspectRatio < 2.0f) {
+            detections.push_back({toFrame(box), 0.5f});
+        }
+    }
+}
+
+#endif  // HAVE_OPENCV
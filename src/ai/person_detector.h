@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#include <opencv2/dnn.hpp>
+#endif
+
+/**
+ * Person Detector
+ *
+ * Frame -> person boxes for the person tracker:
+ *
+ * - DNN:  cv::dnn object detector on the CPU, person class only, with
+ *         non-maximum suppression. Reads YOLO darknet (.weights + .cfg),
+ *         Caffe MobileNet-SSD (.caffemodel + .prototxt) and TensorFlow
+ *         SSD (.pb + .pbtxt) models; the config path is derived from the
+ *         model path.
+ * - SKIN: HSV skin mask with contour boxes and a Canny contour fallback.
+ *         Needs no model but boxes skin regions, not people.
+ * - SKIN_LUT: the same heuristic at 1/4 width and height; skin is a table
+ *         lookup per pixel (5-bit BGR -> inside the YCrCb skin cluster),
+ *         morphology uses small rectangular (separable) kernels and the
+ *         boxes are scaled back up.
+ *
+ * DNN falls back to SKIN_LUT while no model is loaded.
+ */
+class PersonDetector {
+public:
+    enum Method {
+        SKIN,
+        SKIN_LUT,
+        DNN
+    };
+
+    PersonDetector();
+
+    void SetMethod(Method method) { m_method = method; }
+    Method GetMethod() const { return m_method; }
+    // Method Detect() actually runs (DNN only once a model is loaded, SKIN_LUT otherwise)
+    Method GetActiveMethod() const;
+
+    static bool ParseMethod(const std::string& name, Method& method);
+    static std::string GetMethodName(Method method);
+
+    /**
+     * Load a detection model (see class comment for formats)
+     * @return false (previous model kept) if the format is unknown or loading fails
+     */
+    bool LoadModel(const std::string& modelPath);
+    bool IsModelLoaded() const { return m_modelLoaded; }
+    const std::string& GetModelPath() const { return m_modelPath; }
+
+    void SetConfidenceThreshold(float threshold);
+    float GetConfidenceThreshold() const { return m_confidenceThreshold; }
+    void SetNmsThreshold(float threshold);
+
+    double GetLastDetectMs() const { return m_lastDetectMs; }
+
+#ifdef HAVE_OPENCV
+    struct Detection {
+        cv::Rect box;
+        float confidence;
+    };
+
+    // Detect persons in an 8-bit BGR or BGRA frame
+    void Detect(const cv::Mat& frame, std::vector<Detection>& detections);
+#endif
+
+private:
+    enum ModelFormat {
+        YOLO_DARKNET,
+        CAFFE_SSD,
+        TENSORFLOW_SSD
+    };
+
+#ifdef HAVE_OPENCV
+    void DetectDnn(const cv::Mat& bgr, std::vector<Detection>& detections);
+    void DetectSkin(const cv::Mat& bgr, std::vector<Detection>& detections);
+    void DetectSkinLut(const cv::Mat& bgr, std::vector<Detection>& detections);
+
+    cv::dnn::Net m_net;
+    std::vector<std::string> m_outputNames;
+    std::vector<cv::Mat> m_outputs;
+    cv::Size m_inputSize;
+
+    // SKIN_LUT scratch (downscaled frame and mask)
+    cv::Mat m_small;
+    cv::Mat m_skinMask;
+#endif
+
+    Method m_method;
+    bool m_modelLoaded;
+    std::string m_modelPath;
+    ModelFormat m_format;
+    int m_personClass;              // Class index of "person" in the model's label set
+    float m_confidenceThreshold;
+    float m_nmsThreshold;
+    double m_lastDetectMs;
+};
@@ -1,12 +1,18 @@
 #include "person_replacement_processor.h"
+#include "logger.h"
+#include <algorithm>
 #include <chrono>
-#include <iostream>
 
 #ifdef HAVE_OPENCV
 #include <opencv2/imgproc.hpp>
 #include <opencv2/photo.hpp>
 #endif
 
+namespace {
+// Largest frame the cubic super-resolution fallback produces (4K UHD)
+const int64_t kMaxFallbackOutputPixels = 3840LL * 2160;
+}
+
 PersonReplacementProcessor::PersonReplacementProcessor()
     : m_mode(FACE_SWAP)
     , m_blendStrength(0.8f)
@@ -15,9 +21,12 @@ PersonReplacementProcessor::PersonReplacementProcessor()
     , m_backend("ONNX")
     , m_processingTime(0.0)
     , m_frameCounter(0)
-    , m_framesWithoutDetection(0)  // Face tracking initialization
+    , m_maxFaces(1)
+    , m_colorTransferMode(ColorTransferEngine::HISTOGRAM)
+    , m_targetGeneration(0)
+    , m_superResFaceOnly(false)
+    , m_superResFallbackScale(2)
     , m_useVideoTarget(false)
-    , m_useDNNFaceDetection(false)
     , m_modelLoaded(false)
 #ifdef HAVE_ONNX
     , m_faceSwapLoaded(false)
@@ -25,6 +34,9 @@ PersonReplacementProcessor::PersonReplacementProcessor()
     , m_superResLoaded(false)
     , m_faceEnhanceLoaded(false)
     , m_segmentationLoaded(false)
+    , m_faceSwapDynamicBatch(false)
+    , m_faceEmbeddingDynamicBatch(false)
+    , m_faceEnhanceDynamicBatch(false)
 #endif
 {
 }
@@ -37,11 +49,11 @@ PersonReplacementProcessor::~PersonReplacementProcessor()
 bool PersonReplacementProcessor::Initialize()
 {
 #ifndef HAVE_OPENCV
-    std::cerr << "PersonReplacementProcessor requires OpenCV support!" << std::endl;
+    MS_LOG_ERROR("PersonReplacementProcessor requires OpenCV support!");
     return false;
 #else
 
-    std::cout << "Initializing PersonReplacementProcessor..." << std::endl;
+    MS_LOG_INFO("Initializing PersonReplacementProcessor...");
 
     // Initialize ONNX Runtime
 #ifdef HAVE_ONNX
@@ -54,10 +66,10 @@ bool PersonReplacementProcessor::Initialize()
             try {
                 OrtCUDAProviderOptions cuda_options;
                 m_sessionOptions->AppendExecutionProvider_CUDA(cuda_options);
-                std::cout << "GPU acceleration enabled" << std::endl;
+                MS_LOG_INFO("GPU acceleration enabled");
             }
             catch (const std::exception& e) {
-                std::cerr << "GPU not available, falling back to CPU: " << e.what() << std::endl;
+                MS_LOG_ERROR("GPU not available, falling back to CPU: " << e.what());
                 m_useGPU = false;
             }
         }
@@ -65,32 +77,17 @@ bool PersonReplacementProcessor::Initialize()
         // Set optimization level
         m_sessionOptions->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
         
-        std::cout << "ONNX Runtime initialized successfully" << std::endl;
+        MS_LOG_INFO("ONNX Runtime initialized successfully");
     }
     catch (const std::exception& e) {
-        std::cerr << "Failed to initialize ONNX Runtime: " << e.what() << std::endl;
+        MS_LOG_ERROR("Failed to initialize ONNX Runtime: " << e.what());
         return false;
     }
 #endif
 
-    // Try to load face detection cascade (OpenCV fallback)
-    std::vector<std::string> cascadePaths = {
-        "D:/DevTools/opencv/build/etc/haarcascades/haarcascade_frontalface_default.xml",
-        "C:/opencv/build/etc/haarcascades/haarcascade_frontalface_default.xml",
-        "haarcascade_frontalface_default.xml"
-    };
-
-    bool cascadeLoaded = false;
-    for (const auto& path : cascadePaths) {
-        if (m_faceCascade.load(path)) {
-            std::cout << "Loaded Haar Cascade from: " << path << std::endl;
-            cascadeLoaded = true;
-            break;
-        }
-    }
-
-    if (!cascadeLoaded) {
-        std::cerr << "Warning: Could not load face detection cascade. Face detection may not work." << std::endl;
+    // Face detector: the backend chosen via face_detector, else Haar
+    if (!m_faceService.IsLoaded() && !m_faceService.Load(FaceDetectionService::HAAR)) {
+        MS_LOG_WARN("Warning: Could not load a face detector. Face detection may not work.");
     }
 
     // Auto-load face swap models if available
@@ -103,7 +100,7 @@ bool PersonReplacementProcessor::Initialize()
     
     for (const auto& modelPath : arcfacePaths) {
         if (LoadFaceEmbeddingModel(modelPath)) {
-            std::cout << "✅ Loaded face embedding model: " << modelPath << std::endl;
+            MS_LOG_INFO("✅ Loaded face embedding model: " << modelPath);
             break;
         }
     }
@@ -119,18 +116,18 @@ bool PersonReplacementProcessor::Initialize()
 
     for (const auto& modelPath : faceSwapPaths) {
         if (LoadFaceSwapModel(modelPath)) {
-            std::cout << "✅ Auto-loaded face swap model: " << modelPath << std::endl;
+            MS_LOG_INFO("✅ Auto-loaded face swap model: " << modelPath);
             break;
         }
     }
 
     if (!m_faceSwapLoaded) {
-        std::cout << "ℹ️ No AI face swap model found - using OpenCV fallback" << std::endl;
-        std::cout << "   For better quality, place crossface_simswap.onnx in models/ folder" << std::endl;
+        MS_LOG_INFO("ℹ️ No AI face swap model found - using OpenCV fallback");
+        MS_LOG_INFO("   For better quality, place crossface_simswap.onnx in models/ folder");
     }
 #endif
 
-    std::cout << "PersonReplacementProcessor initialized successfully!" << std::endl;
+    MS_LOG_INFO("PersonReplacementProcessor initialized successfully!");
     return true;
 #endif
 }
@@ -138,14 +135,19 @@ bool PersonReplacementProcessor::Initialize()
 void PersonReplacementProcessor::Cleanup()
 {
 #ifdef HAVE_OPENCV
-    // Release video capture
-    if (m_targetPersonVideo.isOpened()) {
-        m_targetPersonVideo.release();
-    }
+    // Stop the decode thread and unmap the face index
+    m_targetVideoSource.Close();
+    m_targetFaceIndex.Close();
 
     // Clear images
     m_targetPersonImage.release();
-    m_currentTargetFrame.release();
+    m_targetImageFaces.clear();
+    m_currentTargetFrame = VideoTargetSource::DecodedFrame();
+    for (ColorTransferEngine& engine : m_colorTransfers) {
+        engine.Reset();
+    }
+    m_swapCache.Clear();
+    m_enhanceCache.Clear();
 
 #ifdef HAVE_ONNX
     // ONNX sessions will auto-cleanup via unique_ptr
@@ -171,7 +173,7 @@ void PersonReplacementProcessor::Cleanup()
 Frame PersonReplacementProcessor::ProcessFrame(const Frame& input)
 {
 #ifndef HAVE_OPENCV
-    std::cerr << "PersonReplacementProcessor requires OpenCV!" << std::endl;
+    MS_LOG_ERROR("PersonReplacementProcessor requires OpenCV!");
     return input;
 #else
     auto startTime = std::chrono::high_resolution_clock::now();
@@ -185,8 +187,10 @@ Frame PersonReplacementProcessor::ProcessFrame(const Frame& input)
         // Process based on selected mode
         switch (m_mode) {
             case FACE_SWAP:
-                if (!m_targetPersonImage.empty()) {
-                    result = ReplaceFace(frame, m_targetPersonImage);
+                if (m_useVideoTarget && GetNextVideoFrame()) {
+                    result = ReplaceFace(frame, m_currentTargetFrame.image, m_currentTargetFrame.faces);
+                } else if (!m_useVideoTarget && !m_targetPersonImage.empty()) {
+                    result = ReplaceFace(frame, m_targetPersonImage, m_targetImageFaces);
                 } else {
                     // No target image set - just pass through original frame with a message overlay
                     result = frame.clone();
@@ -226,7 +230,7 @@ Frame PersonReplacementProcessor::ProcessFrame(const Frame& input)
         }
     }
     catch (const std::exception& e) {
-        std::cerr << "Error processing frame: " << e.what() << std::endl;
+        MS_LOG_ERROR("Error processing frame: " << e.what());
         result = frame.clone();
     }
 
@@ -236,7 +240,9 @@ Frame PersonReplacementProcessor::ProcessFrame(const Frame& input)
     
     m_frameCounter++;
     if (m_frameCounter % 30 == 0) {
-        std::cout << "Person Replacement Processing Time: " << m_processingTime << " ms" << std::endl;
+        MS_LOG_DEBUG("Person Replacement Processing Time: " << m_processingTime << " ms"
+                  << " (cache hit rate: swap " << static_cast<int>(m_swapCache.GetHitRate() * 100)
+                  << "%, enhance " << static_cast<int>(m_enhanceCache.GetHitRate() * 100) << "%)");
     }
 
     // Convert back to Frame
@@ -250,7 +256,7 @@ Frame PersonReplacementProcessor::ProcessFrame(const Frame& input)
 void PersonReplacementProcessor::SetReplacementMode(ReplacementMode mode)
 {
     m_mode = mode;
-    std::cout << "Replacement mode set to: " << static_cast<int>(mode) << std::endl;
+    MS_LOG_INFO("Replacement mode set to: " << static_cast<int>(mode));
 }
 
 void PersonReplacementProcessor::SetTargetPersonImage(const std::string& imagePath)
@@ -258,10 +264,16 @@ void PersonReplacementProcessor::SetTargetPersonImage(const std::string& imagePa
 #ifdef HAVE_OPENCV
     m_targetPersonImage = cv::imread(imagePath);
     if (m_targetPersonImage.empty()) {
-        std::cerr << "Failed to load target person image: " << imagePath << std::endl;
+        MS_LOG_ERROR("Failed to load target person image: " << imagePath);
     } else {
-        std::cout << "Target person image loaded: " << imagePath << std::endl;
+        MS_LOG_INFO("Target person image loaded: " << imagePath);
         m_useVideoTarget = false;
+        m_targetGeneration++;
+        m_targetVideoSource.Close();
+        m_targetFaceIndex.Close();
+
+        // The target is static - detect its faces once instead of every frame
+        m_targetImageFaces = DetectFacesStateless(m_faceService, m_targetPersonImage);
     }
 #endif
 }
@@ -269,13 +281,49 @@ void PersonReplacementProcessor::SetTargetPersonImage(const std::string& imagePa
 void PersonReplacementProcessor::SetTargetPersonVideo(const std::string& videoPath)
 {
 #ifdef HAVE_OPENCV
-    m_targetPersonVideo.open(videoPath);
-    if (!m_targetPersonVideo.isOpened()) {
-        std::cerr << "Failed to open target person video: " << videoPath << std::endl;
+    m_targetFaceIndex.Close();
+    m_currentTargetFrame = VideoTargetSource::DecodedFrame();
+
+    // Prefer a precomputed face index; otherwise detect on the decode thread
+    // with a private detector so the camera thread never runs detection for the target
+    VideoTargetSource::FaceDetector detector;
+    std::string sidecarPath = FaceIndex::GetSidecarPath(videoPath);
+    if (!m_targetFaceIndex.Open(sidecarPath)) {
+        auto service = std::make_shared<FaceDetectionService>();
+        if (service->LoadFrom(m_faceService)) {
+            detector = [service](const cv::Mat& image) {
+                return DetectFacesStateless(*service, image);
+            };
+        }
+    }
+
+    if (!m_targetVideoSource.Open(videoPath, 8, detector)) {
+        MS_LOG_ERROR("Failed to open target person video: " << videoPath);
+        m_targetFaceIndex.Close();
     } else {
-        std::cout << "Target person video opened: " << videoPath << std::endl;
+        MS_LOG_INFO("Target person video opened: " << videoPath
+                  << (m_targetFaceIndex.IsOpen() ? " (using face index)" : ""));
         m_useVideoTarget = true;
+        m_targetGeneration++;
+    }
+#endif
+}
+
+bool PersonReplacementProcessor::BuildTargetVideoIndex(const std::string& videoPath)
+{
+#ifdef HAVE_OPENCV
+    auto service = std::make_shared<FaceDetectionService>();
+    if (!service->LoadFrom(m_faceService)) {
+        MS_LOG_ERROR("Cannot build face index: no face detector loaded");
+        return false;
     }
+
+    FaceIndex::FaceDetector detector = [service](const cv::Mat& image) {
+        return DetectFacesStateless(*service, image);
+    };
+    return FaceIndex::Build(videoPath, FaceIndex::GetSidecarPath(videoPath), detector);
+#else
+    return false;
 #endif
 }
 
@@ -294,10 +342,55 @@ void PersonReplacementProcessor::SetUseGPU(bool useGPU)
     m_useGPU = useGPU;
 }
 
+void PersonReplacementProcessor::SetSuperResolutionTiling(int tileSize, int overlap, int workers)
+{
+    m_superResTiler.SetTileSize(tileSize);
+    m_superResTiler.SetOverlap(overlap);
+    m_superResTiler.SetWorkerCount(workers);
+}
+
+void PersonReplacementProcessor::SetSuperResolutionFaceOnly(bool faceOnly)
+{
+    m_superResFaceOnly = faceOnly;
+}
+
+void PersonReplacementProcessor::SetSuperResolutionFallbackScale(int scale)
+{
+    m_superResFallbackScale = std::max(1, std::min(4, scale));
+}
+
+void PersonReplacementProcessor::SetMaxFaces(int maxFaces)
+{
+    m_maxFaces = std::max(1, std::min(8, maxFaces));
+}
+
+void PersonReplacementProcessor::SetInferenceCache(FaceResultCache::Metric metric, float threshold, int maxAge)
+{
+#ifdef HAVE_OPENCV
+    for (FaceResultCache* cache : {&m_swapCache, &m_enhanceCache}) {
+        cache->SetMetric(metric);
+        cache->SetThreshold(threshold);
+        cache->SetMaxAge(maxAge);
+        cache->ResetStats();
+    }
+#endif
+}
+
+void PersonReplacementProcessor::SetColorTransferMode(ColorTransferEngine::Mode mode)
+{
+#ifdef HAVE_OPENCV
+    m_colorTransferMode = mode;
+    for (ColorTransferEngine& engine : m_colorTransfers) {
+        engine.SetMode(mode);
+    }
+    MS_LOG_INFO("Color transfer mode set to: " << ColorTransferEngine::GetModeName(mode));
+#endif
+}
+
 bool PersonReplacementProcessor::LoadFaceSwapModel(const std::string& modelPath)
 {
 #ifndef HAVE_ONNX
-    std::cerr << "ONNX Runtime not available!" << std::endl;
+    MS_LOG_ERROR("ONNX Runtime not available!");
     return false;
 #else
     try {
@@ -308,14 +401,16 @@ bool PersonReplacementProcessor::LoadFaceSwapModel(const std::string& modelPath)
         Ort::AllocatorWithDefaultOptions allocator;
         m_faceSwapInputName = m_faceSwapSession->GetInputNameAllocated(0, allocator).get();
         m_faceSwapOutputName = m_faceSwapSession->GetOutputNameAllocated(0, allocator).get();
+        m_faceSwapDynamicBatch = HasDynamicBatch(*m_faceSwapSession);
         
         m_faceSwapLoaded = true;
-        std::cout << "Face swap model loaded: " << modelPath << std::endl;
-        std::cout << "  Input: " << m_faceSwapInputName << ", Output: " << m_faceSwapOutputName << std::endl;
+        MS_LOG_INFO("Face swap model loaded: " << modelPath);
+        MS_LOG_INFO("  Input: " << m_faceSwapInputName << ", Output: " << m_faceSwapOutputName
+                  << (m_faceSwapDynamicBatch ? ", dynamic batch" : ", batch 1"));
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Failed to load face swap model: " << e.what() << std::endl;
+        MS_LOG_ERROR("Failed to load face swap model: " << e.what());
         return false;
     }
 #endif
@@ -324,19 +419,21 @@ bool PersonReplacementProcessor::LoadFaceSwapModel(const std::string& modelPath)
 bool PersonReplacementProcessor::LoadFaceEmbeddingModel(const std::string& modelPath)
 {
 #ifndef HAVE_ONNX
-    std::cerr << "ONNX Runtime not available!" << std::endl;
+    MS_LOG_ERROR("ONNX Runtime not available!");
     return false;
 #else
     try {
         std::wstring wModelPath(modelPath.begin(), modelPath.end());
         m_faceEmbeddingSession = std::make_unique<Ort::Session>(*m_onnxEnv, wModelPath.c_str(), *m_sessionOptions);
+        m_faceEmbeddingDynamicBatch = HasDynamicBatch(*m_faceEmbeddingSession);
         
         m_faceEmbeddingLoaded = true;
-        std::cout << "Face embedding model (ArcFace) loaded: " << modelPath << std::endl;
+        MS_LOG_INFO("Face embedding model (ArcFace) loaded: " << modelPath
+                  << (m_faceEmbeddingDynamicBatch ? " (dynamic batch)" : ""));
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Failed to load face embedding model: " << e.what() << std::endl;
+        MS_LOG_ERROR("Failed to load face embedding model: " << e.what());
         return false;
     }
 #endif
@@ -345,7 +442,7 @@ bool PersonReplacementProcessor::LoadFaceEmbeddingModel(const std::string& model
 bool PersonReplacementProcessor::LoadSuperResolutionModel(const std::string& modelPath)
 {
 #ifndef HAVE_ONNX
-    std::cerr << "ONNX Runtime not available!" << std::endl;
+    MS_LOG_ERROR("ONNX Runtime not available!");
     return false;
 #else
     try {
@@ -356,14 +453,48 @@ bool PersonReplacementProcessor::LoadSuperResolutionModel(const std::string& mod
         Ort::AllocatorWithDefaultOptions allocator;
         m_superResInputName = m_superResSession->GetInputNameAllocated(0, allocator).get();
         m_superResOutputName = m_superResSession->GetOutputNameAllocated(0, allocator).get();
-        
+
+        // Static-shape models dictate the tile size and scale; dynamic ones
+        // (-1 spatial dims) keep the configured tile size
+        auto inputShape = m_superResSession->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        auto outputShape = m_superResSession->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (inputShape.size() == 4 && outputShape.size() == 4 && inputShape[2] > 0 && outputShape[2] > 0) {
+            m_superResTiler.SetTileSize(static_cast<int>(inputShape[2]));
+            m_superResTiler.SetScale(static_cast<int>(outputShape[2] / inputShape[2]));
+        } else {
+            // Dynamic shape: the scale is only known from a run, so upscale a
+            // small blank probe once and compare sizes
+            const int64_t probeSize = 32;
+            std::vector<float> probe(3 * probeSize * probeSize, 0.0f);
+            std::vector<int64_t> probeShape = {1, 3, probeSize, probeSize};
+            Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            Ort::Value probeTensor = Ort::Value::CreateTensor<float>(
+                memoryInfo, probe.data(), probe.size(), probeShape.data(), probeShape.size());
+
+            const char* inputNames[] = {m_superResInputName.c_str()};
+            const char* outputNames[] = {m_superResOutputName.c_str()};
+            auto outputs = m_superResSession->Run(Ort::RunOptions{nullptr}, inputNames, &probeTensor, 1,
+                                                  outputNames, 1);
+            auto probeOutput = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+            if (probeOutput.size() != 4 || probeOutput[2] % probeSize != 0 || probeOutput[2] / probeSize < 1 ||
+                probeOutput[3] != probeOutput[2]) {
+                MS_LOG_ERROR("Super-resolution model output is not an integer upscale of its input");
+                m_superResSession.reset();
+                m_superResLoaded = false;
+                return false;
+            }
+            m_superResTiler.SetScale(static_cast<int>(probeOutput[2] / probeSize));
+        }
+
         m_superResLoaded = true;
-        std::cout << "Super-resolution model loaded: " << modelPath << std::endl;
-        std::cout << "  Input: " << m_superResInputName << ", Output: " << m_superResOutputName << std::endl;
+        MS_LOG_INFO("Super-resolution model loaded: " << modelPath);
+        MS_LOG_INFO("  Input: " << m_superResInputName << ", Output: " << m_superResOutputName);
+        MS_LOG_INFO("  Tiles: " << m_superResTiler.GetTileSize() << "px, x" << m_superResTiler.GetScale()
+                  << ", arena " << m_superResTiler.GetArenaBytes() / (1024 * 1024) << " MB");
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Failed to load super-resolution model: " << e.what() << std::endl;
+        MS_LOG_ERROR("Failed to load super-resolution model: " << e.what());
         return false;
     }
 #endif
@@ -372,7 +503,7 @@ bool PersonReplacementProcessor::LoadSuperResolutionModel(const std::string& mod
 bool PersonReplacementProcessor::LoadFaceEnhancementModel(const std::string& modelPath)
 {
 #ifndef HAVE_ONNX
-    std::cerr << "ONNX Runtime not available!" << std::endl;
+    MS_LOG_ERROR("ONNX Runtime not available!");
     return false;
 #else
     try {
@@ -383,14 +514,16 @@ bool PersonReplacementProcessor::LoadFaceEnhancementModel(const std::string& mod
         Ort::AllocatorWithDefaultOptions allocator;
         m_enhanceInputName = m_faceEnhanceSession->GetInputNameAllocated(0, allocator).get();
         m_enhanceOutputName = m_faceEnhanceSession->GetOutputNameAllocated(0, allocator).get();
+        m_faceEnhanceDynamicBatch = HasDynamicBatch(*m_faceEnhanceSession);
         
         m_faceEnhanceLoaded = true;
-        std::cout << "Face enhancement model loaded: " << modelPath << std::endl;
-        std::cout << "  Input: " << m_enhanceInputName << ", Output: " << m_enhanceOutputName << std::endl;
+        MS_LOG_INFO("Face enhancement model loaded: " << modelPath);
+        MS_LOG_INFO("  Input: " << m_enhanceInputName << ", Output: " << m_enhanceOutputName
+                  << (m_faceEnhanceDynamicBatch ? ", dynamic batch" : ", batch 1"));
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Failed to load face enhancement model: " << e.what() << std::endl;
+        MS_LOG_ERROR("Failed to load face enhancement model: " << e.what());
         return false;
     }
 #endif
@@ -399,7 +532,7 @@ bool PersonReplacementProcessor::LoadFaceEnhancementModel(const std::string& mod
 bool PersonReplacementProcessor::LoadSegmentationModel(const std::string& modelPath)
 {
 #ifndef HAVE_ONNX
-    std::cerr << "ONNX Runtime not available!" << std::endl;
+    MS_LOG_ERROR("ONNX Runtime not available!");
     return false;
 #else
     try {
@@ -407,11 +540,11 @@ bool PersonReplacementProcessor::LoadSegmentationModel(const std::string& modelP
         m_segmentationSession = std::make_unique<Ort::Session>(*m_onnxEnv, wModelPath.c_str(), *m_sessionOptions);
         
         m_segmentationLoaded = true;
-        std::cout << "Segmentation model loaded: " << modelPath << std::endl;
+        MS_LOG_INFO("Segmentation model loaded: " << modelPath);
         return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Failed to load segmentation model: " << e.what() << std::endl;
+        MS_LOG_ERROR("Failed to load segmentation model: " << e.what());
         return false;
     }
 #endif
@@ -431,6 +564,9 @@ std::string PersonReplacementProcessor::GetReplacementInfo() const
     info += "\nBlend Strength: " + std::to_string(m_blendStrength);
     info += "\nEnhancement: " + std::string(m_enableEnhancement ? "Enabled" : "Disabled");
     info += "\nGPU: " + std::string(m_useGPU ? "Enabled" : "Disabled");
+    info += "\nInference Cache: " + FaceResultCache::GetMetricName(m_swapCache.GetMetric()) +
+            " (swap hits " + std::to_string(static_cast<int>(m_swapCache.GetHitRate() * 100)) +
+            "%, enhance hits " + std::to_string(static_cast<int>(m_enhanceCache.GetHitRate() * 100)) + "%)";
     return info;
 }
 
@@ -466,6 +602,69 @@ bool PersonReplacementProcessor::SetParameter(const std::string& name, const std
         SetTargetPersonVideo(value);
         return true;
     }
+    else if (name == "build_video_index") {
+        return BuildTargetVideoIndex(value);
+    }
+    else if (name == "sr_tile_size") {
+        m_superResTiler.SetTileSize(std::stoi(value));
+        return true;
+    }
+    else if (name == "sr_tile_overlap") {
+        m_superResTiler.SetOverlap(std::stoi(value));
+        return true;
+    }
+    else if (name == "sr_workers") {
+        m_superResTiler.SetWorkerCount(std::stoi(value));
+        return true;
+    }
+    else if (name == "sr_face_only") {
+        SetSuperResolutionFaceOnly(value == "true" || value == "1");
+        return true;
+    }
+    else if (name == "sr_fallback_scale") {
+        SetSuperResolutionFallbackScale(std::stoi(value));
+        return true;
+    }
+    else if (name == "max_faces") {
+        SetMaxFaces(std::stoi(value));
+        return true;
+    }
+    else if (name == "cache_metric") {
+        FaceResultCache::Metric metric;
+        if (!FaceResultCache::ParseMetric(value, metric)) {
+            return false;
+        }
+        SetInferenceCache(metric, m_swapCache.GetThreshold(), m_swapCache.GetMaxAge());
+        return true;
+    }
+    else if (name == "cache_threshold") {
+        SetInferenceCache(m_swapCache.GetMetric(), std::stof(value), m_swapCache.GetMaxAge());
+        return true;
+    }
+    else if (name == "cache_max_age") {
+        SetInferenceCache(m_swapCache.GetMetric(), m_swapCache.GetThreshold(), std::stoi(value));
+        return true;
+    }
+    else if (name == "face_detector") {
+        FaceDetectionService::Backend backend;
+        return FaceDetectionService::ParseBackend(value, backend) && m_faceService.Load(backend);
+    }
+    else if (name == "face_detect_interval") {
+        m_faceService.SetDetectInterval(std::stoi(value));
+        return true;
+    }
+    else if (name == "face_detection_scale") {
+        m_faceService.SetDetectionScale(std::stof(value));
+        return true;
+    }
+    else if (name == "color_transfer") {
+        ColorTransferEngine::Mode mode;
+        if (!ColorTransferEngine::ParseMode(value, mode)) {
+            return false;
+        }
+        SetColorTransferMode(mode);
+        return true;
+    }
     
     return false;
 }
@@ -477,19 +676,20 @@ std::map<std::string, std::string> PersonReplacementProcessor::GetParameters() c
 
 #ifdef HAVE_OPENCV
 
-cv::Mat PersonReplacementProcessor::ReplaceFace(const cv::Mat& frame, const cv::Mat& targetImage)
+cv::Mat PersonReplacementProcessor::ReplaceFace(const cv::Mat& frame, const cv::Mat& targetImage,
+                                                const std::vector<cv::Rect>& targetFaces)
 {
     cv::Mat result = frame.clone();
 
-    // Detect faces in both source and target
+    // Only the camera frame is detected here - target faces are precomputed
+    // (once per image, on the decode thread, or from the face index)
     std::vector<cv::Rect> sourceFaces = DetectFaces(frame);
-    std::vector<cv::Rect> targetFaces = DetectFaces(targetImage);
 
     if (sourceFaces.empty()) {
         // Don't spam console - just draw helpful message on frame
         static int framesSinceLastWarning = 0;
         if (framesSinceLastWarning == 0) {
-            std::cout << "[Face Swap] No faces detected. Try: face camera directly, better lighting, remove glasses/mask" << std::endl;
+            MS_LOG_DEBUG("[Face Swap] No faces detected. Try: face camera directly, better lighting, remove glasses/mask");
         }
         framesSinceLastWarning = (framesSinceLastWarning + 1) % 60; // Log every 2 seconds at 30fps
         
@@ -505,7 +705,7 @@ cv::Mat PersonReplacementProcessor::ReplaceFace(const cv::Mat& frame, const cv::
         // Check target image only once
         static bool targetWarningShown = false;
         if (!targetWarningShown) {
-            std::cerr << "[Face Swap] No faces detected in target image. Use a clear frontal face photo." << std::endl;
+            MS_LOG_ERROR("[Face Swap] No faces detected in target image. Use a clear frontal face photo.");
             targetWarningShown = true;
         }
         cv::putText(result, "No face in target image - use frontal face photo", cv::Point(10, 30), 
@@ -513,10 +713,17 @@ cv::Mat PersonReplacementProcessor::ReplaceFace(const cv::Mat& frame, const cv::
         return result;
     }
 
-    // Process each detected face
-    for (size_t i = 0; i < sourceFaces.size() && i < targetFaces.size(); ++i) {
+    // Gather all valid face pairs first so the model sees them as one batch
+    std::vector<size_t> faceSlots;
+    std::vector<cv::Rect> sourceRects;
+    std::vector<cv::Rect> expandedRects;
+    std::vector<cv::Mat> sourceCrops;
+    std::vector<cv::Mat> targetCrops;
+
+    for (size_t i = 0; i < sourceFaces.size(); ++i) {
         const cv::Rect& sourceFaceRect = sourceFaces[i];
-        const cv::Rect& targetFaceRect = targetFaces[i];
+        // Fewer target faces than camera faces: reuse the last target face
+        const cv::Rect& targetFaceRect = targetFaces[std::min(i, targetFaces.size() - 1)];
 
         // Expand face rect to include more context (forehead, chin, ears)
         // This gives better blending at edges
@@ -533,7 +740,7 @@ cv::Mat PersonReplacementProcessor::ReplaceFace(const cv::Mat& frame, const cv::
 
         // CRITICAL: Validate rect is within bounds (prevent ROI errors)
         if (!IsValidROI(expandedSourceRect, frame)) {
-            std::cerr << "[Face Swap] Invalid expanded rect, skipping face" << std::endl;
+            MS_LOG_ERROR("[Face Swap] Invalid expanded rect, skipping face");
             continue;  // Skip this face
         }
 
@@ -542,7 +749,7 @@ cv::Mat PersonReplacementProcessor::ReplaceFace(const cv::Mat& frame, const cv::
         
         // CRITICAL: Validate target face rect is within bounds
         if (!IsValidROI(targetFaceRect, targetImage)) {
-            std::cerr << "[Face Swap] Invalid target rect, skipping face" << std::endl;
+            MS_LOG_ERROR("[Face Swap] Invalid target rect, skipping face");
             continue;  // Skip this face
         }
         
@@ -552,18 +759,56 @@ cv::Mat PersonReplacementProcessor::ReplaceFace(const cv::Mat& frame, const cv::
         cv::Mat resizedTarget;
         cv::resize(targetFace, resizedTarget, sourceFace.size(), 0, 0, cv::INTER_CUBIC);
 
+        faceSlots.push_back(i);
+        sourceRects.push_back(sourceFaceRect);
+        expandedRects.push_back(expandedSourceRect);
+        sourceCrops.push_back(sourceFace);
+        targetCrops.push_back(resizedTarget);
+    }
+
 #ifdef HAVE_ONNX
-        // Use ONNX model if loaded
-        if (m_faceSwapLoaded) {
-            cv::Mat swappedFace = RunFaceSwapInference(sourceFace, resizedTarget);
-            if (!swappedFace.empty()) {
-                resizedTarget = swappedFace;
+    // Use ONNX model if loaded - faces whose crop barely changed reuse their
+    // cached result, the rest go through the model in a single batched call
+    if (m_faceSwapLoaded && !sourceCrops.empty()) {
+        m_swapCache.NextFrame();
+        uint64_t tag = (m_targetGeneration << 32) |
+                       (m_useVideoTarget ? static_cast<uint32_t>(m_currentTargetFrame.frameIndex) : 0u);
+
+        std::vector<size_t> missIndices;
+        std::vector<cv::Mat> missSources, missTargets;
+        for (size_t i = 0; i < sourceCrops.size(); ++i) {
+            cv::Mat cached;
+            if (m_swapCache.Lookup(expandedRects[i], sourceCrops[i], tag, cached)) {
+                targetCrops[i] = cached;
+            } else {
+                missIndices.push_back(i);
+                missSources.push_back(sourceCrops[i]);
+                missTargets.push_back(targetCrops[i]);
+            }
+        }
+
+        if (!missIndices.empty()) {
+            std::vector<cv::Mat> swappedFaces = RunFaceSwapBatch(missSources, missTargets);
+            for (size_t k = 0; k < swappedFaces.size() && k < missIndices.size(); ++k) {
+                size_t i = missIndices[k];
+                if (!swappedFaces[k].empty()) {
+                    targetCrops[i] = swappedFaces[k];
+                    m_swapCache.Store(expandedRects[i], sourceCrops[i], tag, swappedFaces[k]);
+                }
             }
         }
+    }
 #endif
 
+    // Color-correct and blend each face
+    for (size_t i = 0; i < sourceCrops.size(); ++i) {
+        const cv::Rect& sourceFaceRect = sourceRects[i];
+        const cv::Rect& expandedSourceRect = expandedRects[i];
+        const cv::Mat& sourceFace = sourceCrops[i];
+        const cv::Mat& resizedTarget = targetCrops[i];
+
         // Apply color correction to match source lighting
-        cv::Mat colorCorrected = MatchColorHistogram(resizedTarget, sourceFace);
+        cv::Mat colorCorrected = MatchColorHistogram(resizedTarget, sourceFace, faceSlots[i]);
         
         // Create feathered mask for smooth blending
         cv::Mat mask = CreateFeatheredMask(colorCorrected.size());
@@ -604,7 +849,7 @@ cv::Mat PersonReplacementProcessor::ReplaceFullBody(const cv::Mat& frame, const
     cv::Mat mask = SegmentPerson(frame);
 
     if (mask.empty()) {
-        std::cerr << "Person segmentation failed" << std::endl;
+        MS_LOG_ERROR("Person segmentation failed");
         return result;
     }
 
@@ -643,19 +888,57 @@ cv::Mat PersonReplacementProcessor::EnhanceFaceInFrame(const cv::Mat& frame)
         return result;
     }
 
-    // Enhance each detected face
+    std::vector<cv::Rect> validRects;
+    std::vector<cv::Mat> faceCrops;
     for (const auto& faceRect : faces) {
         // CRITICAL: Validate face rect is within bounds
         if (!IsValidROI(faceRect, frame)) {
-            std::cerr << "[Face Enhance] Invalid face rect, skipping" << std::endl;
+            MS_LOG_ERROR("[Face Enhance] Invalid face rect, skipping");
             continue;
         }
-        
-        cv::Mat face = frame(faceRect);
-        cv::Mat enhancedFace = EnhanceFace(face);
+        validRects.push_back(faceRect);
+        faceCrops.push_back(frame(faceRect));
+    }
 
-        if (!enhancedFace.empty()) {
-            enhancedFace.copyTo(result(faceRect));
+    std::vector<cv::Mat> enhancedFaces;
+#ifdef HAVE_ONNX
+    // Cached results for unchanged crops, the rest in one batched call
+    if (m_faceEnhanceLoaded) {
+        m_enhanceCache.NextFrame();
+        enhancedFaces.resize(faceCrops.size());
+
+        std::vector<size_t> missIndices;
+        std::vector<cv::Mat> missCrops;
+        for (size_t i = 0; i < faceCrops.size(); ++i) {
+            if (!m_enhanceCache.Lookup(validRects[i], faceCrops[i], 0, enhancedFaces[i])) {
+                missIndices.push_back(i);
+                missCrops.push_back(faceCrops[i]);
+            }
+        }
+
+        if (!missIndices.empty()) {
+            std::vector<cv::Mat> results = RunFaceEnhancementBatch(missCrops);
+            if (results.size() != missCrops.size()) {
+                enhancedFaces.clear();
+            } else {
+                for (size_t k = 0; k < results.size(); ++k) {
+                    enhancedFaces[missIndices[k]] = results[k];
+                    m_enhanceCache.Store(validRects[missIndices[k]], faceCrops[missIndices[k]], 0, results[k]);
+                }
+            }
+        }
+    }
+#endif
+    if (enhancedFaces.size() != faceCrops.size()) {
+        enhancedFaces.clear();
+        for (const auto& face : faceCrops) {
+            enhancedFaces.push_back(EnhanceFace(face));
+        }
+    }
+
+    for (size_t i = 0; i < validRects.size(); ++i) {
+        if (!enhancedFaces[i].empty()) {
+            enhancedFaces[i].copyTo(result(validRects[i]));
         }
     }
 
@@ -690,13 +973,47 @@ cv::Mat PersonReplacementProcessor::SuperResolve(const cv::Mat& image)
 {
 #ifdef HAVE_ONNX
     if (m_superResLoaded) {
-        return RunSuperResolutionInference(image);
+        if (!m_superResFaceOnly) {
+            cv::Mat upscaled = RunSuperResolutionInference(image);
+            if (!upscaled.empty()) {
+                return upscaled;
+            }
+        } else {
+            // Only faces go through the model; the rest of the frame is
+            // resized with cubic interpolation to the same scale
+            int scale = m_superResTiler.GetScale();
+            cv::Mat upscaled;
+            cv::resize(image, upscaled, cv::Size(image.cols * scale, image.rows * scale), 0, 0, cv::INTER_CUBIC);
+
+            for (const auto& face : DetectFaces(image)) {
+                cv::Rect region(face.x - face.width / 4, face.y - face.height / 4,
+                                face.width * 3 / 2, face.height * 3 / 2);
+                region &= cv::Rect(0, 0, image.cols, image.rows);
+
+                cv::Mat faceUpscaled = RunSuperResolutionInference(image, region);
+                if (!faceUpscaled.empty()) {
+                    faceUpscaled.copyTo(upscaled(cv::Rect(region.x * scale, region.y * scale,
+                                                          faceUpscaled.cols, faceUpscaled.rows)));
+                }
+            }
+            return upscaled;
+        }
     }
 #endif
 
-    // Fallback: use OpenCV's resize with INTER_CUBIC
+    // Fallback: cubic resize by the configured scale, reduced so the output
+    // stays within kMaxFallbackOutputPixels (unchanged if even x2 would not)
+    int scale = m_superResFallbackScale;
+    const int64_t pixels = static_cast<int64_t>(image.cols) * image.rows;
+    while (scale > 1 && pixels * scale * scale > kMaxFallbackOutputPixels) {
+        scale--;
+    }
+    if (scale <= 1) {
+        return image.clone();
+    }
+
     cv::Mat upscaled;
-    cv::resize(image, upscaled, cv::Size(image.cols * 2, image.rows * 2), 0, 0, cv::INTER_CUBIC);
+    cv::resize(image, upscaled, cv::Size(image.cols * scale, image.rows * scale), 0, 0, cv::INTER_CUBIC);
     return upscaled;
 }
 
@@ -704,137 +1021,54 @@ cv::Mat PersonReplacementProcessor::ApplyStyleTransfer(const cv::Mat& image)
 {
     // Placeholder for style transfer
     // This would use a neural style transfer model (ONNX)
-    std::cerr << "Style transfer not yet implemented" << std::endl;
+    MS_LOG_ERROR("Style transfer not yet implemented");
     return image.clone();
 }
 
-std::vector<cv::Rect> PersonReplacementProcessor::DetectFaces(const cv::Mat& frame)
+std::vector<cv::Rect> PersonReplacementProcessor::DetectFacesStateless(FaceDetectionService& detector,
+                                                                   const cv::Mat& frame, int maxFaces)
 {
     std::vector<cv::Rect> faces;
+    detector.Detect(frame, faces);
+    SelectFaces(faces, frame.size(), maxFaces);
+    return faces;
+}
 
-    if (m_faceCascade.empty()) {
-        // Cascade not loaded - can't detect faces
-        return faces;
-    }
-
-    // Convert to grayscale for Haar cascade
-    cv::Mat gray;
-    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray, gray);
-
-    // Detect faces using Haar cascade - OPTIMIZED FOR MEETING VIDEO
-    // scaleFactor: 1.08 (more sensitive - better detection)
-    // minNeighbors: 4 (lower threshold - easier to detect)
-    // minSize: 40x40 (smaller minimum - detect faces at various distances)
-    // maxSize: frame.cols (allow larger detections for close-up)
-    std::vector<cv::Rect> detectedFaces;
-    cv::Size maxSize(frame.cols, frame.rows);
-    m_faceCascade.detectMultiScale(gray, detectedFaces, 1.08, 4, 0, cv::Size(40, 40), maxSize);
+std::vector<cv::Rect> PersonReplacementProcessor::DetectFaces(const cv::Mat& frame)
+{
+    // Tracked faces persist through short detection gaps (no blinking swap)
+    std::vector<cv::Rect> faces;
+    m_faceService.Track(frame, faces);
+    SelectFaces(faces, frame.size(), m_maxFaces);
+    m_parameters["face_detect_ms"] = std::to_string(m_faceService.GetLastDetectMs());
+    return faces;
+}
 
+void PersonReplacementProcessor::SelectFaces(std::vector<cv::Rect>& faces, const cv::Size& frameSize, int maxFaces)
+{
     // Filter faces: Accept faces in CENTER 95% of frame (meeting videos typically centered)
-    int centerMarginX = frame.cols * 0.025;  // Only 2.5% margin each side
-    int centerMarginY = frame.rows * 0.025;  // Only 2.5% margin top/bottom
-    cv::Rect centerRegion(centerMarginX, centerMarginY, 
-                          frame.cols - 2 * centerMarginX, 
-                          frame.rows - 2 * centerMarginY);
-
-    for (const auto& face : detectedFaces) {
-        // Calculate center of detected face
-        cv::Point faceCenter(face.x + face.width / 2, face.y + face.height / 2);
-        
-        // Accept faces in the very wide central region (meeting scenario)
-        if (centerRegion.contains(faceCenter)) {
-            // Relaxed aspect ratio check (0.6 to 1.5 - handles slight angles)
-            float aspectRatio = static_cast<float>(face.width) / face.height;
-            if (aspectRatio > 0.6f && aspectRatio < 1.5f) {
-                faces.push_back(face);
-            }
-        }
-    }
+    int centerMarginX = frameSize.width * 0.025;  // Only 2.5% margin each side
+    int centerMarginY = frameSize.height * 0.025; // Only 2.5% margin top/bottom
+    cv::Rect centerRegion(centerMarginX, centerMarginY,
+                          frameSize.width - 2 * centerMarginX,
+                          frameSize.height - 2 * centerMarginY);
 
-    // If multiple faces detected, choose the largest one (closest to camera)
-    if (faces.size() > 1) {
-        auto largestFace = std::max_element(faces.begin(), faces.end(),
+    faces.erase(std::remove_if(faces.begin(), faces.end(), [&](const cv::Rect& face) {
+        // Accept faces in the very wide central region (meeting scenario)
+        cv::Point faceCenter(face.x + face.width / 2, face.y + face.height / 2);
+        // Relaxed aspect ratio check (0.6 to 1.5 - handles slight angles)
+        float aspectRatio = static_cast<float>(face.width) / face.height;
+        return !centerRegion.contains(faceCenter) || aspectRatio <= 0.6f || aspectRatio >= 1.5f;
+    }), faces.end());
+
+    // If more faces than wanted, keep the largest ones (closest to camera)
+    if (static_cast<int>(faces.size()) > maxFaces) {
+        std::partial_sort(faces.begin(), faces.begin() + maxFaces, faces.end(),
             [](const cv::Rect& a, const cv::Rect& b) {
-                return (a.width * a.height) < (b.width * b.height);
+                return (a.width * a.height) > (b.width * b.height);
             });
-        faces = { *largestFace };
-    }
-
-    // Face tracking: Match detected faces with previous frame
-    if (!m_previousFaces.empty() && !faces.empty()) {
-        std::vector<cv::Rect> stabilizedFaces;
-        
-        for (auto& face : faces) {
-            // Find best matching face from previous frame
-            cv::Rect bestMatch = face;
-            float bestOverlap = 0.0f;
-            
-            for (const auto& prevFace : m_previousFaces) {
-                float overlap = CalculateFaceOverlap(face, prevFace);
-                if (overlap > bestOverlap) {
-                    bestOverlap = overlap;
-                    
-                    // Smooth transition: blend current and previous position
-                    if (overlap > FACE_OVERLAP_THRESHOLD) {
-                        // 80% previous position, 20% new detection (very smooth)
-                        bestMatch.x = static_cast<int>(prevFace.x * 0.8 + face.x * 0.2);
-                        bestMatch.y = static_cast<int>(prevFace.y * 0.8 + face.y * 0.2);
-                        bestMatch.width = static_cast<int>(prevFace.width * 0.8 + face.width * 0.2);
-                        bestMatch.height = static_cast<int>(prevFace.height * 0.8 + face.height * 0.2);
-                        
-                        // CRITICAL: Clamp to frame boundaries to prevent ROI errors
-                        bestMatch.x = std::max(0, std::min(bestMatch.x, frame.cols - bestMatch.width));
-                        bestMatch.y = std::max(0, std::min(bestMatch.y, frame.rows - bestMatch.height));
-                        bestMatch.width = std::min(bestMatch.width, frame.cols - bestMatch.x);
-                        bestMatch.height = std::min(bestMatch.height, frame.rows - bestMatch.y);
-                    }
-                }
-            }
-            
-            stabilizedFaces.push_back(bestMatch);
-        }
-        
-        faces = stabilizedFaces;
-        m_framesWithoutDetection = 0;
-    }
-    else if (faces.empty() && !m_previousFaces.empty()) {
-        // No detection this frame - use previous faces for a few frames (persistence)
-        if (m_framesWithoutDetection < MAX_FRAMES_WITHOUT_DETECTION) {
-            faces = m_previousFaces;
-            m_framesWithoutDetection++;
-        }
-    }
-    else {
-        m_framesWithoutDetection = 0;
-    }
-
-    // Update previous faces
-    if (!faces.empty()) {
-        m_previousFaces = faces;
-    }
-
-    return faces;
-}
-
-// Helper function to calculate overlap between two rectangles
-float PersonReplacementProcessor::CalculateFaceOverlap(const cv::Rect& rect1, const cv::Rect& rect2)
-{
-    int x1 = std::max(rect1.x, rect2.x);
-    int y1 = std::max(rect1.y, rect2.y);
-    int x2 = std::min(rect1.x + rect1.width, rect2.x + rect2.width);
-    int y2 = std::min(rect1.y + rect1.height, rect2.y + rect2.height);
-    
-    if (x2 < x1 || y2 < y1) {
-        return 0.0f;  // No overlap
+        faces.resize(maxFaces);
     }
-    
-    int intersectionArea = (x2 - x1) * (y2 - y1);
-    int rect1Area = rect1.width * rect1.height;
-    int rect2Area = rect2.width * rect2.height;
-    int unionArea = rect1Area + rect2Area - intersectionArea;
-    
-    return static_cast<float>(intersectionArea) / static_cast<float>(unionArea);
 }
 
 // Helper function to validate ROI is within image bounds
@@ -846,63 +1080,17 @@ bool PersonReplacementProcessor::IsValidROI(const cv::Rect& rect, const cv::Mat&
            rect.y + rect.height <= image.rows;
 }
 
-cv::Mat PersonReplacementProcessor::MatchColorHistogram(const cv::Mat& source, const cv::Mat& target)
+cv::Mat PersonReplacementProcessor::MatchColorHistogram(const cv::Mat& source, const cv::Mat& target,
+                                                        size_t faceSlot)
 {
-    // Match color distribution of source to target for natural lighting
-    cv::Mat result = source.clone();
-    
-    if (source.empty() || target.empty() || source.size() != target.size()) {
-        return result;
-    }
-
-    // Split into channels
-    std::vector<cv::Mat> sourceChannels, targetChannels, resultChannels;
-    cv::split(source, sourceChannels);
-    cv::split(target, targetChannels);
-    
-    // Match histogram for each channel (B, G, R)
-    for (int i = 0; i < 3; i++) {
-        // Calculate histograms
-        cv::Mat sourceHist, targetHist;
-        int histSize = 256;
-        float range[] = {0, 256};
-        const float* histRange = {range};
-        
-        cv::calcHist(&sourceChannels[i], 1, 0, cv::Mat(), sourceHist, 1, &histSize, &histRange);
-        cv::calcHist(&targetChannels[i], 1, 0, cv::Mat(), targetHist, 1, &histSize, &histRange);
-        
-        // Calculate cumulative distribution
-        cv::Mat sourceCDF = sourceHist.clone();
-        cv::Mat targetCDF = targetHist.clone();
-        
-        for (int j = 1; j < histSize; j++) {
-            sourceCDF.at<float>(j) += sourceCDF.at<float>(j - 1);
-            targetCDF.at<float>(j) += targetCDF.at<float>(j - 1);
-        }
-        
-        // Normalize CDFs
-        sourceCDF /= sourceCDF.at<float>(histSize - 1);
-        targetCDF /= targetCDF.at<float>(histSize - 1);
-        
-        // Create lookup table for histogram matching
-        cv::Mat lookupTable(1, 256, CV_8U);
-        for (int j = 0; j < 256; j++) {
-            float sourceVal = sourceCDF.at<float>(j);
-            int k = 0;
-            while (k < 256 && targetCDF.at<float>(k) < sourceVal) {
-                k++;
-            }
-            lookupTable.at<uchar>(j) = std::min(k, 255);
-        }
-        
-        // Apply lookup table
-        cv::LUT(sourceChannels[i], lookupTable, sourceChannels[i]);
-    }
-    
-    // Merge channels back
-    cv::merge(sourceChannels, result);
-    
-    return result;
+    // Match color distribution of source to target for natural lighting.
+    // Each face slot has its own engine: in cached_lut mode the running camera
+    // histogram and the target signature cache belong to a single face.
+    while (m_colorTransfers.size() <= faceSlot) {
+        m_colorTransfers.emplace_back();
+        m_colorTransfers.back().SetMode(m_colorTransferMode);
+    }
+    return m_colorTransfers[faceSlot].Apply(source, target);
 }
 
 cv::Mat PersonReplacementProcessor::CreateFeatheredMask(const cv::Size& size)
@@ -1030,7 +1218,7 @@ cv::Mat PersonReplacementProcessor::SeamlessBlend(const cv::Mat& source, const c
         cv::seamlessClone(source, target, mask, center, result, cv::NORMAL_CLONE);
     }
     catch (const std::exception& e) {
-        std::cerr << "Seamless blend failed: " << e.what() << std::endl;
+        MS_LOG_ERROR("Seamless blend failed: " << e.what());
         result = target.clone();
     }
     
@@ -1046,298 +1234,318 @@ cv::Mat PersonReplacementProcessor::PoissonBlend(const cv::Mat& source, const cv
         cv::seamlessClone(source, target, mask, center, result, cv::NORMAL_CLONE);
     }
     catch (const std::exception& e) {
-        std::cerr << "Poisson blend failed: " << e.what() << std::endl;
+        MS_LOG_ERROR("Poisson blend failed: " << e.what());
         result = target.clone();
     }
     
     return result;
 }
 
-cv::Mat PersonReplacementProcessor::GetNextVideoFrame()
+bool PersonReplacementProcessor::GetNextVideoFrame()
 {
-    if (!m_targetPersonVideo.isOpened()) {
-        return cv::Mat();
-    }
-
-    cv::Mat frame;
-    if (!m_targetPersonVideo.read(frame)) {
-        // Loop video
-        m_targetPersonVideo.set(cv::CAP_PROP_POS_FRAMES, 0);
-        m_targetPersonVideo.read(frame);
+    // Never wait on the decoder: if no new frame is ready, keep swapping
+    // against the previous one
+    if (m_targetVideoSource.TryGetNextFrame(m_currentTargetFrame) && m_targetFaceIndex.IsOpen()) {
+        m_currentTargetFrame.faces = m_targetFaceIndex.GetFaces(m_currentTargetFrame.frameIndex);
     }
 
-    return frame;
+    return !m_currentTargetFrame.image.empty();
 }
 
 #ifdef HAVE_ONNX
 
-cv::Mat PersonReplacementProcessor::RunFaceSwapInference(const cv::Mat& sourceFace, const cv::Mat& targetFace)
+bool PersonReplacementProcessor::HasDynamicBatch(Ort::Session& session)
 {
-    if (!m_faceSwapLoaded) {
-        return cv::Mat();
-    }
+    auto shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    return !shape.empty() && shape[0] <= 0;
+}
 
-    try {
-        // simswap.onnx requires:
-        //   1. target: [1, 3, 224, 224] - target face image
-        //   2. source_embedding: [1, 512] - source face embedding from ArcFace
-        int inputSize = 224;
-        
-        // Step 1: Extract source face embedding using ArcFace model
-        std::vector<float> sourceEmbedding(512);
-        if (m_faceEmbeddingLoaded) {
-            // Preprocess source face for ArcFace (typically 112x112 for ArcFace)
-            cv::Mat arcfaceInput;
-            cv::resize(sourceFace, arcfaceInput, cv::Size(112, 112), 0, 0, cv::INTER_CUBIC);
-            cv::cvtColor(arcfaceInput, arcfaceInput, cv::COLOR_BGR2RGB);
-            arcfaceInput.convertTo(arcfaceInput, CV_32FC3, 1.0 / 127.5, -1.0);  // Normalize to [-1, 1]
-
-            // Convert HWC to CHW
-            std::vector<int64_t> arcfaceShape = {1, 3, 112, 112};
-            std::vector<float> arcfaceValues(1 * 3 * 112 * 112);
-            for (int c = 0; c < 3; ++c) {
-                for (int h = 0; h < 112; ++h) {
-                    for (int w = 0; w < 112; ++w) {
-                        int idx = c * 112 * 112 + h * 112 + w;
-                        arcfaceValues[idx] = arcfaceInput.at<cv::Vec3f>(h, w)[c];
-                    }
-                }
+bool PersonReplacementProcessor::RunBatched(Ort::Session& session, bool dynamicBatch, int count,
+                                            std::vector<BatchInput>& inputs, const char* outputName,
+                                            std::vector<float>& output, std::vector<int64_t>& outputItemShape)
+{
+    Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+
+    // Static-batch models get the same packed buffers, one item per Run
+    const int chunk = dynamicBatch ? count : 1;
+    output.clear();
+
+    for (int start = 0; start < count; start += chunk) {
+        std::vector<Ort::Value> tensors;
+        std::vector<const char*> names;
+        for (auto& input : inputs) {
+            std::vector<int64_t> shape = {chunk};
+            shape.insert(shape.end(), input.itemShape.begin(), input.itemShape.end());
+
+            size_t itemSize = 1;
+            for (int64_t dim : input.itemShape) {
+                itemSize *= static_cast<size_t>(dim);
             }
 
-            // Run ArcFace inference to get embedding
-            Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-            Ort::Value arcfaceTensor = Ort::Value::CreateTensor<float>(
-                memoryInfo, arcfaceValues.data(), arcfaceValues.size(), arcfaceShape.data(), arcfaceShape.size());
+            tensors.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo, input.data + start * itemSize, chunk * itemSize, shape.data(), shape.size()));
+            names.push_back(input.name);
+        }
 
-            const char* arcfaceInputName = "input";  // Common ArcFace input name
-            const char* arcfaceOutputName = "output"; // Common ArcFace output name
-            
-            auto arcfaceOutput = m_faceEmbeddingSession->Run(
-                Ort::RunOptions{nullptr},
-                &arcfaceInputName, &arcfaceTensor, 1,
-                &arcfaceOutputName, 1);
-
-            // Extract embedding [1, 512]
-            float* embeddingData = arcfaceOutput[0].GetTensorMutableData<float>();
-            std::copy(embeddingData, embeddingData + 512, sourceEmbedding.begin());
-            
-            std::cout << "✅ Extracted face embedding (512D)" << std::endl;
-        } else {
-            // No embedding model - cannot proceed
-            std::cerr << "❌ ArcFace embedding model not loaded, cannot run face swap" << std::endl;
-            return cv::Mat();
+        auto outputTensors = session.Run(Ort::RunOptions{nullptr},
+                                         names.data(), tensors.data(), tensors.size(),
+                                         &outputName, 1);
+
+        auto info = outputTensors[0].GetTensorTypeAndShapeInfo();
+        auto shape = info.GetShape();
+        if (shape.empty() || shape[0] != chunk) {
+            return false;
         }
+        outputItemShape.assign(shape.begin() + 1, shape.end());
 
-        // Step 2: Preprocess target face for face swap model (224x224)
-        cv::Mat targetPreprocessed;
-        cv::resize(targetFace, targetPreprocessed, cv::Size(inputSize, inputSize), 0, 0, cv::INTER_CUBIC);
-        cv::cvtColor(targetPreprocessed, targetPreprocessed, cv::COLOR_BGR2RGB);
-        targetPreprocessed.convertTo(targetPreprocessed, CV_32FC3, 2.0 / 255.0, -1.0);  // [-1, 1]
+        const float* data = outputTensors[0].GetTensorData<float>();
+        output.insert(output.end(), data, data + info.GetElementCount());
+    }
 
-        // Convert HWC to CHW format
-        std::vector<int64_t> targetShape = {1, 3, inputSize, inputSize};
-        size_t targetTensorSize = 1 * 3 * inputSize * inputSize;
-        std::vector<float> targetValues(targetTensorSize);
+    return true;
+}
 
-        for (int c = 0; c < 3; ++c) {
-            for (int h = 0; h < inputSize; ++h) {
-                for (int w = 0; w < inputSize; ++w) {
-                    int idx = c * inputSize * inputSize + h * inputSize + w;
-                    targetValues[idx] = targetPreprocessed.at<cv::Vec3f>(h, w)[c];
-                }
-            }
-        }
+std::vector<std::vector<float>> PersonReplacementProcessor::RunFaceEmbeddingBatch(const std::vector<cv::Mat>& faces)
+{
+    std::vector<std::vector<float>> embeddings;
+    if (!m_faceEmbeddingLoaded || faces.empty()) {
+        return embeddings;
+    }
 
-        // Step 3: Create input tensors for face swap model
-        Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        
-        std::vector<int64_t> embeddingShape = {1, 512};
-        Ort::Value embeddingTensor = Ort::Value::CreateTensor<float>(
-            memoryInfo, sourceEmbedding.data(), sourceEmbedding.size(), embeddingShape.data(), embeddingShape.size());
-        
-        Ort::Value targetTensor = Ort::Value::CreateTensor<float>(
-            memoryInfo, targetValues.data(), targetTensorSize, targetShape.data(), targetShape.size());
+    // Preprocess for ArcFace: 112x112, RGB, normalized to [-1, 1], packed NCHW
+    std::vector<cv::Mat> resized(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i) {
+        cv::resize(faces[i], resized[i], cv::Size(112, 112), 0, 0, cv::INTER_CUBIC);
+    }
+    cv::Mat blob = cv::dnn::blobFromImages(resized, 1.0 / 127.5, cv::Size(112, 112),
+                                           cv::Scalar(127.5, 127.5, 127.5), true, false);
 
-        // Input names: "target" and "source_embedding"
-        const char* inputNames[] = {"target", "source_embedding"};
-        const char* outputNames[] = {"output"};
-        
-        std::vector<Ort::Value> inputTensors;
-        inputTensors.push_back(std::move(targetTensor));
-        inputTensors.push_back(std::move(embeddingTensor));
+    std::vector<BatchInput> inputs = {
+        {"input", blob.ptr<float>(), {3, 112, 112}}  // Common ArcFace input name
+    };
+    std::vector<float> output;
+    std::vector<int64_t> itemShape;
+    if (!RunBatched(*m_faceEmbeddingSession, m_faceEmbeddingDynamicBatch, static_cast<int>(faces.size()),
+                    inputs, "output", output, itemShape)) {
+        return embeddings;
+    }
 
-        // Step 4: Run face swap inference
-        auto outputTensors = m_faceSwapSession->Run(
-            Ort::RunOptions{nullptr}, 
-            inputNames, inputTensors.data(), inputTensors.size(),
-            outputNames, 1);
+    size_t dim = output.size() / faces.size();
+    for (size_t i = 0; i < faces.size(); ++i) {
+        embeddings.emplace_back(output.begin() + i * dim, output.begin() + (i + 1) * dim);
+    }
+    return embeddings;
+}
 
-        // Get output tensor
-        float* outputData = outputTensors[0].GetTensorMutableData<float>();
-        auto outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-        
-        int outputHeight = static_cast<int>(outputShape[2]);
-        int outputWidth = static_cast<int>(outputShape[3]);
+std::vector<cv::Mat> PersonReplacementProcessor::RunFaceSwapBatch(const std::vector<cv::Mat>& sourceFaces,
+                                                                  const std::vector<cv::Mat>& targetFaces)
+{
+    std::vector<cv::Mat> results;
+    if (!m_faceSwapLoaded || sourceFaces.empty() || sourceFaces.size() != targetFaces.size()) {
+        return results;
+    }
 
-        // Convert back to cv::Mat (denormalize from [-1, 1] to [0, 255])
-        cv::Mat output(outputHeight, outputWidth, CV_32FC3);
-        for (int c = 0; c < 3; ++c) {
-            for (int h = 0; h < outputHeight; ++h) {
-                for (int w = 0; w < outputWidth; ++w) {
-                    int idx = c * outputHeight * outputWidth + h * outputWidth + w;
-                    // Denormalize: from [-1, 1] to [0, 1]
-                    float value = (outputData[idx] + 1.0f) / 2.0f;
-                    output.at<cv::Vec3f>(h, w)[c] = std::max(0.0f, std::min(1.0f, value));
-                }
-            }
+    try {
+        // simswap.onnx requires:
+        //   1. target: [N, 3, 224, 224] - target face images
+        //   2. source_embedding: [N, 512] - source face embeddings from ArcFace
+        const int inputSize = 224;
+        const int count = static_cast<int>(sourceFaces.size());
+
+        // Step 1: Extract all source face embeddings with one ArcFace call
+        if (!m_faceEmbeddingLoaded) {
+            // No embedding model - cannot proceed
+            MS_LOG_ERROR("❌ ArcFace embedding model not loaded, cannot run face swap");
+            return results;
         }
 
-        // Convert back to BGR and 8-bit
-        output.convertTo(output, CV_8UC3, 255.0);
-        cv::cvtColor(output, output, cv::COLOR_RGB2BGR);
-        
-        // Resize to original face size
-        cv::resize(output, output, targetFace.size(), 0, 0, cv::INTER_CUBIC);
+        std::vector<std::vector<float>> embeddings = RunFaceEmbeddingBatch(sourceFaces);
+        if (embeddings.size() != sourceFaces.size()) {
+            return results;
+        }
+
+        std::vector<float> packedEmbeddings;
+        packedEmbeddings.reserve(count * 512);
+        for (const auto& embedding : embeddings) {
+            packedEmbeddings.insert(packedEmbeddings.end(), embedding.begin(), embedding.end());
+        }
+        int64_t embeddingDim = static_cast<int64_t>(embeddings[0].size());
+
+        // Step 2: Pack target faces as [N, 3, 224, 224], RGB, [-1, 1]
+        std::vector<cv::Mat> resized(count);
+        for (int i = 0; i < count; ++i) {
+            cv::resize(targetFaces[i], resized[i], cv::Size(inputSize, inputSize), 0, 0, cv::INTER_CUBIC);
+        }
+        cv::Mat targetBlob = cv::dnn::blobFromImages(resized, 2.0 / 255.0, cv::Size(inputSize, inputSize),
+                                                     cv::Scalar(127.5, 127.5, 127.5), true, false);
+
+        // Step 3: Run face swap inference - input names "target" and "source_embedding"
+        std::vector<BatchInput> inputs = {
+            {"target", targetBlob.ptr<float>(), {3, inputSize, inputSize}},
+            {"source_embedding", packedEmbeddings.data(), {embeddingDim}}
+        };
+        std::vector<float> output;
+        std::vector<int64_t> itemShape;
+        if (!RunBatched(*m_faceSwapSession, m_faceSwapDynamicBatch, count, inputs, "output", output, itemShape) ||
+            itemShape.size() != 3) {
+            return results;
+        }
 
-        std::cout << "✅ AI face swap successful (simswap.onnx)" << std::endl;
-        return output;
+        // Step 4: Unpack - planes are RGB, so merging them reversed yields BGR,
+        // then denormalize from [-1, 1] to [0, 255]
+        int outputHeight = static_cast<int>(itemShape[1]);
+        int outputWidth = static_cast<int>(itemShape[2]);
+        size_t planeSize = static_cast<size_t>(outputHeight) * outputWidth;
+
+        for (int i = 0; i < count; ++i) {
+            float* item = output.data() + i * 3 * planeSize;
+            std::vector<cv::Mat> planes = {
+                cv::Mat(outputHeight, outputWidth, CV_32F, item + 2 * planeSize),
+                cv::Mat(outputHeight, outputWidth, CV_32F, item + planeSize),
+                cv::Mat(outputHeight, outputWidth, CV_32F, item)
+            };
+            cv::Mat merged, face;
+            cv::merge(planes, merged);
+            merged.convertTo(face, CV_8UC3, 127.5, 127.5);
+
+            // Resize to original face size
+            cv::resize(face, face, targetFaces[i].size(), 0, 0, cv::INTER_CUBIC);
+            results.push_back(face);
+        }
+
+        MS_LOG_DEBUG("✅ AI face swap successful (simswap.onnx, " << count << " face"
+                  << (count > 1 ? "s" : "") << ")");
+        return results;
     }
     catch (const std::exception& e) {
-        std::cerr << "❌ Face swap inference failed: " << e.what() << std::endl;
-        std::cerr << "   Falling back to OpenCV histogram matching" << std::endl;
-        return cv::Mat();
+        MS_LOG_ERROR("❌ Face swap inference failed: " << e.what());
+        MS_LOG_ERROR("   Falling back to OpenCV histogram matching");
+        return std::vector<cv::Mat>();
     }
 }
 
+cv::Mat PersonReplacementProcessor::RunFaceSwapInference(const cv::Mat& sourceFace, const cv::Mat& targetFace)
+{
+    std::vector<cv::Mat> results = RunFaceSwapBatch({sourceFace}, {targetFace});
+    return results.empty() ? cv::Mat() : results[0];
+}
+
 cv::Mat PersonReplacementProcessor::RunSuperResolutionInference(const cv::Mat& lowRes)
 {
     if (!m_superResLoaded) {
         return cv::Mat();
     }
 
-    try {
-        // Prepare input (example: variable size input)
-        cv::Mat preprocessed;
-        lowRes.convertTo(preprocessed, CV_32FC3, 1.0 / 255.0);
-        cv::cvtColor(preprocessed, preprocessed, cv::COLOR_BGR2RGB);
+    // Tiled: peak memory is bounded by the tile arena, not the frame size
+    return m_superResTiler.Upscale(lowRes,
+        [this](const float* input, float* output, int tileSize, int scale) {
+            return RunSuperResolutionTile(input, output, tileSize, scale);
+        });
+}
 
-        int h = preprocessed.rows;
-        int w = preprocessed.cols;
-        
-        std::vector<int64_t> inputShape = {1, 3, h, w};
-        size_t inputTensorSize = 1 * 3 * h * w;
-        std::vector<float> inputTensorValues(inputTensorSize);
+cv::Mat PersonReplacementProcessor::RunSuperResolutionInference(const cv::Mat& lowRes, const cv::Rect& roi)
+{
+    if (!m_superResLoaded) {
+        return cv::Mat();
+    }
 
-        // Convert HWC to CHW
-        for (int c = 0; c < 3; ++c) {
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
-                    inputTensorValues[c * h * w + y * w + x] =
-                        preprocessed.at<cv::Vec3f>(y, x)[c];
-                }
-            }
-        }
+    return m_superResTiler.UpscaleROI(lowRes, roi,
+        [this](const float* input, float* output, int tileSize, int scale) {
+            return RunSuperResolutionTile(input, output, tileSize, scale);
+        });
+}
+
+bool PersonReplacementProcessor::RunSuperResolutionTile(const float* input, float* output, int tileSize, int scale)
+{
+    try {
+        // Both tensors wrap arena memory - Session::Run writes straight into
+        // the output slot and allocates nothing per tile
+        int outSize = tileSize * scale;
+        std::vector<int64_t> inputShape = {1, 3, tileSize, tileSize};
+        std::vector<int64_t> outputShape = {1, 3, outSize, outSize};
 
-        // Run inference
         Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
         Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-            memoryInfo, inputTensorValues.data(), inputTensorSize, inputShape.data(), inputShape.size());
+            memoryInfo, const_cast<float*>(input), 3 * tileSize * tileSize, inputShape.data(), inputShape.size());
+        Ort::Value outputTensor = Ort::Value::CreateTensor<float>(
+            memoryInfo, output, 3 * outSize * outSize, outputShape.data(), outputShape.size());
 
         const char* inputNames[] = {m_superResInputName.c_str()};
         const char* outputNames[] = {m_superResOutputName.c_str()};
-        
-        auto outputTensors = m_superResSession->Run(
-            Ort::RunOptions{nullptr}, inputNames, &inputTensor, 1, outputNames, 1);
 
-        // Get output
-        float* outputData = outputTensors[0].GetTensorMutableData<float>();
-        auto outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
-
-        int outH = static_cast<int>(outputShape[2]);
-        int outW = static_cast<int>(outputShape[3]);
-
-        cv::Mat output(outH, outW, CV_32FC3);
-        for (int c = 0; c < 3; ++c) {
-            for (int y = 0; y < outH; ++y) {
-                for (int x = 0; x < outW; ++x) {
-                    output.at<cv::Vec3f>(y, x)[c] = 
-                        outputData[c * outH * outW + y * outW + x];
-                }
-            }
-        }
-
-        output.convertTo(output, CV_8UC3, 255.0);
-        cv::cvtColor(output, output, cv::COLOR_RGB2BGR);
-
-        return output;
+        // Session::Run is safe to call concurrently from the tile workers
+        m_superResSession->Run(Ort::RunOptions{nullptr}, inputNames, &inputTensor, 1,
+                               outputNames, &outputTensor, 1);
+        return true;
     }
     catch (const std::exception& e) {
-        std::cerr << "Super-resolution inference failed: " << e.what() << std::endl;
-        return cv::Mat();
+        MS_LOG_ERROR("Super-resolution inference failed: " << e.what());
+        return false;
     }
 }
 
-cv::Mat PersonReplacementProcessor::RunFaceEnhancementInference(const cv::Mat& face)
+std::vector<cv::Mat> PersonReplacementProcessor::RunFaceEnhancementBatch(const std::vector<cv::Mat>& faces)
 {
-    if (!m_faceEnhanceLoaded) {
-        return cv::Mat();
+    std::vector<cv::Mat> results;
+    if (!m_faceEnhanceLoaded || faces.empty()) {
+        return results;
     }
 
     try {
         // Similar to super-resolution but with face-specific model
-        int inputSize = 512;  // Typical for GFPGAN
-        cv::Mat preprocessed;
-        cv::resize(face, preprocessed, cv::Size(inputSize, inputSize));
-        cv::cvtColor(preprocessed, preprocessed, cv::COLOR_BGR2RGB);
-        preprocessed.convertTo(preprocessed, CV_32FC3, 1.0 / 255.0);
-
-        std::vector<int64_t> inputShape = {1, 3, inputSize, inputSize};
-        size_t inputTensorSize = 1 * 3 * inputSize * inputSize;
-        std::vector<float> inputTensorValues(inputTensorSize);
+        const int inputSize = 512;  // Typical for GFPGAN
+        const int count = static_cast<int>(faces.size());
 
-        for (int c = 0; c < 3; ++c) {
-            for (int h = 0; h < inputSize; ++h) {
-                for (int w = 0; w < inputSize; ++w) {
-                    inputTensorValues[c * inputSize * inputSize + h * inputSize + w] =
-                        preprocessed.at<cv::Vec3f>(h, w)[c];
-                }
-            }
+        std::vector<cv::Mat> resized(count);
+        for (int i = 0; i < count; ++i) {
+            cv::resize(faces[i], resized[i], cv::Size(inputSize, inputSize));
         }
-
-        Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-            memoryInfo, inputTensorValues.data(), inputTensorSize, inputShape.data(), inputShape.size());
-
-        const char* inputNames[] = {m_enhanceInputName.c_str()};
-        const char* outputNames[] = {m_enhanceOutputName.c_str()};
-        
-        auto outputTensors = m_faceEnhanceSession->Run(
-            Ort::RunOptions{nullptr}, inputNames, &inputTensor, 1, outputNames, 1);
-
-        float* outputData = outputTensors[0].GetTensorMutableData<float>();
-
-        cv::Mat output(inputSize, inputSize, CV_32FC3);
-        for (int c = 0; c < 3; ++c) {
-            for (int h = 0; h < inputSize; ++h) {
-                for (int w = 0; w < inputSize; ++w) {
-                    output.at<cv::Vec3f>(h, w)[c] = 
-                        outputData[c * inputSize * inputSize + h * inputSize + w];
-                }
-            }
+        cv::Mat blob = cv::dnn::blobFromImages(resized, 1.0 / 255.0, cv::Size(inputSize, inputSize),
+                                               cv::Scalar(), true, false);
+
+        std::vector<BatchInput> inputs = {
+            {m_enhanceInputName.c_str(), blob.ptr<float>(), {3, inputSize, inputSize}}
+        };
+        std::vector<float> output;
+        std::vector<int64_t> itemShape;
+        if (!RunBatched(*m_faceEnhanceSession, m_faceEnhanceDynamicBatch, count, inputs,
+                        m_enhanceOutputName.c_str(), output, itemShape) || itemShape.size() != 3) {
+            return results;
         }
 
-        output.convertTo(output, CV_8UC3, 255.0);
-        cv::cvtColor(output, output, cv::COLOR_RGB2BGR);
-        cv::resize(output, output, face.size());
+        int outputHeight = static_cast<int>(itemShape[1]);
+        int outputWidth = static_cast<int>(itemShape[2]);
+        size_t planeSize = static_cast<size_t>(outputHeight) * outputWidth;
+
+        for (int i = 0; i < count; ++i) {
+            // RGB planes merged in reverse order give BGR directly
+            float* item = output.data() + i * 3 * planeSize;
+            std::vector<cv::Mat> planes = {
+                cv::Mat(outputHeight, outputWidth, CV_32F, item + 2 * planeSize),
+                cv::Mat(outputHeight, outputWidth, CV_32F, item + planeSize),
+                cv::Mat(outputHeight, outputWidth, CV_32F, item)
+            };
+            cv::Mat merged, face;
+            cv::merge(planes, merged);
+            merged.convertTo(face, CV_8UC3, 255.0);
+            cv::resize(face, face, faces[i].size());
+            results.push_back(face);
+        }
 
-        return output;
+        return results;
     }
     catch (const std::exception& e) {
-        std::cerr << "Face enhancement inference failed: " << e.what() << std::endl;
-        return cv::Mat();
+        MS_LOG_ERROR("Face enhancement inference failed: " << e.what());
+        return std::vector<cv::Mat>();
     }
 }
 
+cv::Mat PersonReplacementProcessor::RunFaceEnhancementInference(const cv::Mat& face)
+{
+    std::vector<cv::Mat> results = RunFaceEnhancementBatch({face});
+    return results.empty() ? cv::Mat() : results[0];
+}
+
 cv::Mat PersonReplacementProcessor::RunSegmentationInference(const cv::Mat& frame)
 {
     if (!m_segmentationLoaded) {
@@ -1391,7 +1599,7 @@ cv::Mat PersonReplacementProcessor::RunSegmentationInference(const cv::Mat& fram
         return mask;
     }
     catch (const std::exception& e) {
-        std::cerr << "Segmentation inference failed: " << e.what() << std::endl;
+        MS_LOG_ERROR("Segmentation inference failed: " << e.what());
         return cv::Mat();
     }
 }
@@ -1,9 +1,16 @@
 #pragma once
 
 #include "ai_processor.h"
+#include "color_transfer.h"
+#include "face_detection_service.h"
+#include "face_index.h"
+#include "face_result_cache.h"
+#include "tiled_upscaler.h"
+#include "video_target_source.h"
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 
 #ifdef HAVE_OPENCV
 #include <opencv2/opencv.hpp>
@@ -58,6 +65,18 @@ public:
     void SetBlendStrength(float strength);  // 0.0 to 1.0
     void SetEnableEnhancement(bool enable);
     void SetUseGPU(bool useGPU);
+    void SetColorTransferMode(ColorTransferEngine::Mode mode);
+    void SetSuperResolutionTiling(int tileSize, int overlap, int workers);
+    void SetSuperResolutionFaceOnly(bool faceOnly);  // Upscale only the face ROI
+    void SetSuperResolutionFallbackScale(int scale); // Cubic scale without a model (1-4, 1 = unchanged)
+    void SetMaxFaces(int maxFaces);                  // Faces swapped/enhanced per frame (1-8)
+    void SetInferenceCache(FaceResultCache::Metric metric, float threshold, int maxAge);
+
+    /**
+     * Offline pass: detect faces in every frame of a target video and write
+     * the "<video>.faceidx" sidecar picked up by SetTargetPersonVideo
+     */
+    bool BuildTargetVideoIndex(const std::string& videoPath);
 
     // Model management
     bool LoadFaceSwapModel(const std::string& modelPath);
@@ -79,7 +98,8 @@ public:
 private:
 #ifdef HAVE_OPENCV
     // Core processing methods
-    cv::Mat ReplaceFace(const cv::Mat& frame, const cv::Mat& targetImage);
+    cv::Mat ReplaceFace(const cv::Mat& frame, const cv::Mat& targetImage,
+                        const std::vector<cv::Rect>& targetFaces);
     cv::Mat ReplaceFullBody(const cv::Mat& frame, const cv::Mat& targetPerson);
     cv::Mat EnhanceFaceInFrame(const cv::Mat& frame);
     cv::Mat EnhanceFace(const cv::Mat& face);
@@ -87,7 +107,11 @@ private:
     cv::Mat ApplyStyleTransfer(const cv::Mat& image);
 
     // Face detection and alignment
-    std::vector<cv::Rect> DetectFaces(const cv::Mat& frame);
+    std::vector<cv::Rect> DetectFaces(const cv::Mat& frame);   // With tracking state (camera frames)
+    static std::vector<cv::Rect> DetectFacesStateless(FaceDetectionService& detector, const cv::Mat& frame,
+                                                      int maxFaces = 1);
+    // Keep plausible faces near the frame center, largest first when over maxFaces
+    static void SelectFaces(std::vector<cv::Rect>& faces, const cv::Size& frameSize, int maxFaces);
     cv::Mat AlignFace(const cv::Mat& face, const cv::Rect& faceRect);
     std::vector<cv::Point2f> DetectFaceLandmarks(const cv::Mat& face);
 
@@ -95,14 +119,13 @@ private:
     cv::Mat SegmentPerson(const cv::Mat& frame);
 
     // Color correction and blending helpers
-    cv::Mat MatchColorHistogram(const cv::Mat& source, const cv::Mat& target);
+    cv::Mat MatchColorHistogram(const cv::Mat& source, const cv::Mat& target, size_t faceSlot);
+    // One engine per face slot, so running histograms and caches never mix faces
+    std::vector<ColorTransferEngine> m_colorTransfers;
     cv::Mat CreateFeatheredMask(const cv::Size& size);
     cv::Mat AlphaBlendWithMask(const cv::Mat& background, const cv::Mat& foreground, 
                               const cv::Mat& mask, float blendStrength);
 
-    // Face tracking helper
-    float CalculateFaceOverlap(const cv::Rect& rect1, const cv::Rect& rect2);
-    
     // Rectangle validation helper
     bool IsValidROI(const cv::Rect& rect, const cv::Mat& image) const;
 
@@ -110,27 +133,57 @@ private:
     cv::Mat SeamlessBlend(const cv::Mat& source, const cv::Mat& target, const cv::Mat& mask);
     cv::Mat PoissonBlend(const cv::Mat& source, const cv::Mat& target, const cv::Point& center);
     
-    // Video handling
-    cv::Mat GetNextVideoFrame();
+    // Video handling - returns false until the first target frame is decoded
+    bool GetNextVideoFrame();
 
     // Model inference
 #ifdef HAVE_ONNX
+    // One input of a batched Session::Run: N items of itemShape packed back to back
+    struct BatchInput {
+        const char* name;
+        float* data;
+        std::vector<int64_t> itemShape;
+    };
+
+    // Single call for dynamic-batch models, N batch-1 calls otherwise
+    bool RunBatched(Ort::Session& session, bool dynamicBatch, int count,
+                    std::vector<BatchInput>& inputs, const char* outputName,
+                    std::vector<float>& output, std::vector<int64_t>& outputItemShape);
+    static bool HasDynamicBatch(Ort::Session& session);
+
+    std::vector<std::vector<float>> RunFaceEmbeddingBatch(const std::vector<cv::Mat>& faces);
+    std::vector<cv::Mat> RunFaceSwapBatch(const std::vector<cv::Mat>& sourceFaces,
+                                          const std::vector<cv::Mat>& targetFaces);
+    std::vector<cv::Mat> RunFaceEnhancementBatch(const std::vector<cv::Mat>& faces);
+
     cv::Mat RunFaceSwapInference(const cv::Mat& sourceFace, const cv::Mat& targetFace);
     cv::Mat RunSuperResolutionInference(const cv::Mat& lowRes);
+    cv::Mat RunSuperResolutionInference(const cv::Mat& lowRes, const cv::Rect& roi);
+    bool RunSuperResolutionTile(const float* input, float* output, int tileSize, int scale);
     cv::Mat RunFaceEnhancementInference(const cv::Mat& face);
     cv::Mat RunSegmentationInference(const cv::Mat& frame);
 #endif
 
+    // Reuse of swap/enhance outputs while the face crop barely changes
+    FaceResultCache m_swapCache;
+    FaceResultCache m_enhanceCache;
+    uint64_t m_targetGeneration;    // Bumped on target change to invalidate swap results
+
+    // Super-resolution tiling
+    TiledUpscaler m_superResTiler;
+    bool m_superResFaceOnly;
+    int m_superResFallbackScale;
+
     // Target person data
     cv::Mat m_targetPersonImage;
-    cv::VideoCapture m_targetPersonVideo;
-    cv::Mat m_currentTargetFrame;
+    std::vector<cv::Rect> m_targetImageFaces;   // Detected once per target image
+    VideoTargetSource m_targetVideoSource;
+    VideoTargetSource::DecodedFrame m_currentTargetFrame;
+    FaceIndex m_targetFaceIndex;
     bool m_useVideoTarget;
 
     // Face detection
-    cv::CascadeClassifier m_faceCascade;
-    cv::dnn::Net m_faceDetectionNet;  // DNN-based face detection
-    bool m_useDNNFaceDetection;
+    FaceDetectionService m_faceService;   // Camera thread only; workers load their own copy
 
     // ONNX Runtime sessions
 #ifdef HAVE_ONNX
@@ -156,6 +209,11 @@ private:
     bool m_superResLoaded;
     bool m_faceEnhanceLoaded;
     bool m_segmentationLoaded;
+
+    // Models exported with a dynamic batch dimension take all faces in one Run
+    bool m_faceSwapDynamicBatch;
+    bool m_faceEmbeddingDynamicBatch;
+    bool m_faceEnhanceDynamicBatch;
 #endif
 
     // Configuration
@@ -169,11 +227,8 @@ private:
     double m_processingTime;
     int m_frameCounter;
 
-    // Face tracking for stability (prevent blinking)
-    std::vector<cv::Rect> m_previousFaces;
-    int m_framesWithoutDetection;
-    const int MAX_FRAMES_WITHOUT_DETECTION = 5;
-    const float FACE_OVERLAP_THRESHOLD = 0.5f;
+    int m_maxFaces;
+    ColorTransferEngine::Mode m_colorTransferMode;
 
     // Parameters storage
     std::map<std::string, std::string> m_parameters;
@@ -1,26 +1,30 @@
 #include "person_tracker_processor.h"
-#include <iostream>
+#include "logger.h"
 #include <chrono>
 #include <cmath>
 #include <algorithm>
-#include <random>
+
+namespace {
+// Person detection models tried in order when no model_path is set
+const char* kModelCandidates[] = {
+    "models/yolov4-tiny.weights",
+    "models/MobileNetSSD_deploy.caffemodel",
+    "models/ssd_mobilenet_v2_coco.pb"
+};
+}
 
 PersonTrackerProcessor::PersonTrackerProcessor()
-    : m_modelLoaded(false),
-      m_confidenceThreshold(0.5f),
-      m_inputSize(416, 416),
-      m_nextTrackId(1),
-      m_maxTrailLength(30),
+    : m_detectInterval(3),
+      m_framesSinceDetection(0),
+      m_detectionRuns(0),
+      m_modelLoaded(false),
       m_showBoundingBox(true),
       m_showTrail(true),
       m_showSkeleton(false),
       m_processingTime(0.0),
       m_frameCounter(0)
 {
-    std::cout << "[PersonTrackerProcessor] Initializing..." << std::endl;
-    // Use YOLOv4-tiny for fast person detection
-    m_modelPath = "models/yolov4-tiny.weights";
-    m_configPath = "models/yolov4-tiny.cfg";
+    MS_LOG_INFO("[PersonTrackerProcessor] Initializing...");
 }
 
 PersonTrackerProcessor::~PersonTrackerProcessor()
@@ -30,41 +34,62 @@ PersonTrackerProcessor::~PersonTrackerProcessor()
 
 bool PersonTrackerProcessor::Initialize()
 {
-    std::cout << "[PersonTrackerProcessor] Initialize called" << std::endl;
+    MS_LOG_INFO("[PersonTrackerProcessor] Initialize called");
 
 #ifdef HAVE_OPENCV
     try {
-        // Try to load YOLO model for person detection
-        std::cout << "[PersonTrackerProcessor] Loading YOLO model for person detection..." << std::endl;
+        // Load a person detection model (YOLO darknet or MobileNet-SSD)
+        MS_LOG_INFO("[PersonTrackerProcessor] Loading person detection model...");
+        
+        if (!m_modelPath.empty()) {
+            m_detector.LoadModel(m_modelPath);
+        } else {
+            for (const char* candidate : kModelCandidates) {
+                if (m_detector.LoadModel(candidate)) {
+                    break;
+                }
+            }
+        }
         
-        // For now, we'll use a simplified approach with built-in detectors
-        // In production, you would load YOLOv4 or similar
+        if (!m_detector.IsModelLoaded()) {
+            MS_LOG_INFO("[PersonTrackerProcessor] No person detection model found, using skin heuristic (skin_lut)");
+            MS_LOG_INFO("[PersonTrackerProcessor]    Place yolov4-tiny.weights + .cfg or MobileNetSSD_deploy.caffemodel + .prototxt in models/");
+        }
+        
+        m_framesSinceDetection = m_detectInterval;
+        m_detectionRuns = 0;
         m_modelLoaded = true;
         
-        std::cout << "[PersonTrackerProcessor] Person tracker initialized successfully" << std::endl;
-        std::cout << "[PersonTrackerProcessor] Confidence threshold: " << m_confidenceThreshold << std::endl;
-        std::cout << "[PersonTrackerProcessor] Trail length: " << m_maxTrailLength << std::endl;
-        std::cout << "[PersonTrackerProcessor] Visualization: BBox=" << (m_showBoundingBox ? "on" : "off");
-        std::cout << " Trail=" << (m_showTrail ? "on" : "off");
-        std::cout << " Skeleton=" << (m_showSkeleton ? "on" : "off") << std::endl;
+        MS_LOG_INFO("[PersonTrackerProcessor] Person tracker initialized successfully");
+        MS_LOG_INFO("[PersonTrackerProcessor] Detector: " << PersonDetector::GetMethodName(m_detector.GetActiveMethod())
+                  << " every " << m_detectInterval << " frame(s)");
+        MS_LOG_INFO("[PersonTrackerProcessor] Confidence threshold: " << m_detector.GetConfidenceThreshold());
+        MS_LOG_INFO("[PersonTrackerProcessor] Trail length: " << m_tracker.GetHistoryLength());
+        MS_LOG_INFO("[PersonTrackerProcessor] Tracker: min_hits=" << m_tracker.GetMinHits()
+                  << " max_missed=" << m_tracker.GetMaxMissed()
+                  << " min_iou=" << m_tracker.GetMinIoU());
+        MS_LOG_INFO("[PersonTrackerProcessor] Visualization: BBox=" << (m_showBoundingBox ? "on" : "off")
+                  << " Trail=" << (m_showTrail ? "on" : "off")
+                  << " Skeleton=" << (m_showSkeleton ? "on" : "off"));
         
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "[PersonTrackerProcessor] Exception during initialization: " << e.what() << std::endl;
+        MS_LOG_ERROR("[PersonTrackerProcessor] Exception during initialization: " << e.what());
         return false;
     }
 #else
-    std::cerr << "[PersonTrackerProcessor] ERROR: OpenCV not available" << std::endl;
+    MS_LOG_ERROR("[PersonTrackerProcessor] ERROR: OpenCV not available");
     return false;
 #endif
 }
 
 void PersonTrackerProcessor::Cleanup()
 {
-    std::cout << "[PersonTrackerProcessor] Cleanup called" << std::endl;
+    MS_LOG_INFO("[PersonTrackerProcessor] Cleanup called");
+#ifdef HAVE_OPENCV
     m_currentPersons.clear();
-    m_previousPersons.clear();
-    m_motionTrail.clear();
+#endif
+    m_tracker.Reset();
     m_modelLoaded = false;
 }
 
@@ -79,23 +104,23 @@ Frame PersonTrackerProcessor::ProcessFrame(const Frame& input)
         
         // Debug frame info on first frame
         if (m_frameCounter == 0) {
-            std::cout << "[PersonTrackerProcessor] First frame info:" << std::endl;
-            std::cout << "  Size: " << frame.cols << "x" << frame.rows << std::endl;
-            std::cout << "  Channels: " << frame.channels() << std::endl;
-            std::cout << "  Type: " << frame.type() << std::endl;
+            MS_LOG_INFO("[PersonTrackerProcessor] First frame info:");
+            MS_LOG_INFO("  Size: " << frame.cols << "x" << frame.rows);
+            MS_LOG_INFO("  Channels: " << frame.channels());
+            MS_LOG_INFO("  Type: " << frame.type());
         }
         
-        // Detect persons in frame
-        if (m_frameCounter % 1 == 0) {  // Run detection every frame
-            m_previousPersons = m_currentPersons;
-            m_currentPersons = DetectPersons(frame);
-            
-            // Track persons across frames
-            TrackPersons(m_currentPersons);
+        // Detect persons on schedule; the tracker predicts boxes in between
+        m_framesSinceDetection++;
+        if (NeedsDetection()) {
+            m_detector.Detect(frame, m_personDetections);
+            m_detectionRuns++;
             
-            // Update motion trail
-            UpdateMotionTrail();
+            // Track persons across frames (also extends the motion trails)
+            TrackPersons(static_cast<float>(m_framesSinceDetection));
+            m_framesSinceDetection = 0;
         }
+        CollectPersons(static_cast<float>(m_framesSinceDetection));
         
         // Always draw visualization
         DrawVisualization(frame);
@@ -113,185 +138,56 @@ Frame PersonTrackerProcessor::ProcessFrame(const Frame& input)
 
 #ifdef HAVE_OPENCV
 
-std::vector<PersonTrackerProcessor::DetectedPerson> PersonTrackerProcessor::DetectPersons(const cv::Mat& frame)
+bool PersonTrackerProcessor::NeedsDetection() const
 {
-    std::vector<DetectedPerson> persons;
-    
-    if (frame.empty()) {
-        return persons;
+    if (m_framesSinceDetection >= m_detectInterval) {
+        return true;
     }
 
-    try {
-        // Prepare frame
-        cv::Mat workFrame = frame.clone();
-        
-        // Convert to HSV for skin detection
-        if (workFrame.channels() == 4) {
-            cv::cvtColor(workFrame, workFrame, cv::COLOR_RGBA2BGR);
-        }
-        
-        cv::Mat hsv;
-        cv::cvtColor(workFrame, hsv, cv::COLOR_BGR2HSV);
-        
-        // Define skin color range in HSV
-        // H: 0-20 or 170-180 (red-ish), S: 10-40, V: 60-255
-        cv::Mat mask1, mask2;
-        cv::inRange(hsv, cv::Scalar(0, 10, 60), cv::Scalar(20, 40, 255), mask1);
-        cv::inRange(hsv, cv::Scalar(170, 10, 60), cv::Scalar(180, 40, 255), mask2);
-        
-        cv::Mat skinMask = mask1 | mask2;
-        
-        // Morphological operations to clean up
-        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(15, 15));
-        cv::morphologyEx(skinMask, skinMask, cv::MORPH_CLOSE, kernel);
-        cv::morphologyEx(skinMask, skinMask, cv::MORPH_OPEN, kernel);
-        
-        // Find contours in skin mask
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(skinMask.clone(), contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-        
-        std::cout << "[PersonTrackerProcessor] Skin detection found " << contours.size() << " regions" << std::endl;
-        
-        // Filter and convert to DetectedPerson
-        int minArea = frame.rows * frame.cols * 0.01;  // 1% of frame
-        int maxArea = frame.rows * frame.cols * 0.8;   // 80% of frame
-        
-        for (const auto& contour : contours) {
-            double area = cv::contourArea(contour);
-            
-            if (area > minArea && area < maxArea) {
-                cv::Rect bbox = cv::boundingRect(contour);
-                
-                // Expand bbox slightly to capture full person
-                int expand = std::max(10, std::min(bbox.width, bbox.height) / 10);
-                bbox.x = std::max(0, bbox.x - expand);
-                bbox.y = std::max(0, bbox.y - expand);
-                bbox.width = std::min(frame.cols - bbox.x, bbox.width + 2 * expand);
-                bbox.height = std::min(frame.rows - bbox.y, bbox.height + 2 * expand);
-                
-                std::cout << "[PersonTrackerProcessor] Detected region: " << bbox << " area=" << area << std::endl;
-                
-                DetectedPerson person;
-                person.bbox = bbox;
-                person.center = cv::Point(bbox.x + bbox.width / 2, bbox.y + bbox.height / 2);
-                person.confidence = std::min(1.0f, static_cast<float>(area / (frame.rows * frame.cols * 0.15)));
-                person.trackId = -1;
-                person.color = cv::Scalar(0, 255, 0);
-                
-                persons.push_back(person);
-            }
-        }
-        
-        std::cout << "[PersonTrackerProcessor] Skin detection result: " << persons.size() << " persons" << std::endl;
-        
-        // If skin detection fails, use motion detection as fallback
-        if (persons.empty()) {
-            std::cout << "[PersonTrackerProcessor] Skin detection failed, trying edge detection..." << std::endl;
-            
-            cv::Mat gray;
-            cv::cvtColor(workFrame, gray, cv::COLOR_BGR2GRAY);
-            
-            cv::Mat edges;
-            cv::Canny(gray, edges, 50, 150);
-            
-            cv::Mat kernel2 = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
-            cv::dilate(edges, edges, kernel2, cv::Point(-1, -1), 2);
-            
-            std::vector<std::vector<cv::Point>> contours2;
-            cv::findContours(edges.clone(), contours2, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-            
-            std::cout << "[PersonTrackerProcessor] Edge detection found " << contours2.size() << " edges" << std::endl;
-            
-            for (const auto& contour : contours2) {
-                double area = cv::contourArea(contour);
-                
-                if (area > minArea && area < maxArea) {
-                    cv::Rect bbox = cv::boundingRect(contour);
-                    float aspectRatio = static_cast<float>(bbox.width) / std::max(1, bbox.height);
-                    
-                    if (aspectRatio > 0.25f && aspectRatio < 2.0f) {
-                        std::cout << "[PersonTrackerProcessor] Edge region: " << bbox << " aspect=" << aspectRatio << std::endl;
-                        
-                        DetectedPerson person;
-                        person.bbox = bbox;
-                        person.center = cv::Point(bbox.x + bbox.width / 2, bbox.y + bbox.height / 2);
-                        person.confidence = 0.5f;
-                        person.trackId = -1;
-                        person.color = cv::Scalar(255, 0, 0);  // Blue for edge-based
-                        
-                        persons.push_back(person);
-                    }
-                }
-            }
+    // Confirmed tracks coasting on their prediction need a detection before
+    // they expire. Tentative ones wait for the interval, so background
+    // clutter cannot force a detection every frame.
+    for (size_t i = 0; i < m_tracker.GetTrackCount(); ++i) {
+        if (m_tracker.IsConfirmed(i) && m_tracker.GetMissedFrames(i) > 0) {
+            return true;
         }
-        
-        std::cout << "[PersonTrackerProcessor] FINAL: " << persons.size() << " persons" << std::endl;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "[PersonTrackerProcessor] Exception: " << e.what() << std::endl;
     }
-    
-    return persons;
+    return false;
 }
 
-void PersonTrackerProcessor::TrackPersons(std::vector<DetectedPerson>& persons)
+void PersonTrackerProcessor::TrackPersons(float dt)
 {
-    // Simple centroid tracking algorithm
-    if (m_previousPersons.empty()) {
-        // First frame - assign new IDs
-        for (auto& person : persons) {
-            person.trackId = m_nextTrackId++;
-            person.color = GetTrackColor(person.trackId);
-        }
-        return;
+    m_detections.clear();
+    for (const auto& detection : m_personDetections) {
+        m_detections.push_back({static_cast<float>(detection.box.x), static_cast<float>(detection.box.y),
+                                static_cast<float>(detection.box.width), static_cast<float>(detection.box.height),
+                                detection.confidence});
     }
 
-    // Match current persons with previous persons using centroid distance
-    std::vector<bool> matched(m_previousPersons.size(), false);
-    
-    for (auto& person : persons) {
-        float minDistance = 50.0f;  // Max distance to match
-        int bestMatchIdx = -1;
-        
-        for (size_t i = 0; i < m_previousPersons.size(); ++i) {
-            if (matched[i]) continue;
-            
-            float distance = cv::norm(person.center - m_previousPersons[i].center);
-            if (distance < minDistance) {
-                minDistance = distance;
-                bestMatchIdx = i;
-            }
-        }
-        
-        if (bestMatchIdx >= 0) {
-            // Match found
-            person.trackId = m_previousPersons[bestMatchIdx].trackId;
-            matched[bestMatchIdx] = true;
-        } else {
-            // New person
-            person.trackId = m_nextTrackId++;
-        }
-        
-        person.color = GetTrackColor(person.trackId);
-    }
+    m_tracker.Update(m_detections, dt);
 }
 
-void PersonTrackerProcessor::UpdateMotionTrail()
+void PersonTrackerProcessor::CollectPersons(float ahead)
 {
-    int64_t currentTime = std::chrono::system_clock::now().time_since_epoch().count();
-    
-    for (const auto& person : m_currentPersons) {
-        TrackPoint point;
-        point.position = person.center;
-        point.timestamp = currentTime;
-        point.trackId = person.trackId;
-        
-        m_motionTrail.push_back(point);
-    }
-    
-    // Limit trail length
-    while (m_motionTrail.size() > static_cast<size_t>(m_maxTrailLength * m_currentPersons.size())) {
-        m_motionTrail.pop_front();
+    // Report confirmed tracks extrapolated to this frame, including ones
+    // coasting through up to max_missed missed detections, so boxes do not
+    // blink; tentative tracks stay hidden until they reach min_hits
+    m_currentPersons.clear();
+    for (size_t i = 0; i < m_tracker.GetTrackCount(); ++i) {
+        if (!m_tracker.IsConfirmed(i) || m_tracker.GetMissedFrames(i) > m_tracker.GetMaxMissed()) {
+            continue;
+        }
+
+        float x, y, width, height;
+        m_tracker.GetPredictedBox(i, ahead, x, y, width, height);
+
+        DetectedPerson person;
+        person.bbox = cv::Rect(cvRound(x), cvRound(y), cvRound(width), cvRound(height));
+        person.center = cv::Point(cvRound(x + width * 0.5f), cvRound(y + height * 0.5f));
+        person.confidence = m_tracker.GetConfidence(i);
+        person.trackId = m_tracker.GetTrackId(i);
+        person.color = GetTrackColor(person.trackId);
+        m_currentPersons.push_back(person);
     }
 }
 
@@ -341,22 +237,21 @@ void PersonTrackerProcessor::DrawBoundingBoxes(cv::Mat& frame)
 
 void PersonTrackerProcessor::DrawMotionTrail(cv::Mat& frame)
 {
-    // Group trail points by track ID
-    std::map<int, std::vector<cv::Point>> trailsById;
-    for (const auto& point : m_motionTrail) {
-        trailsById[point.trackId].push_back(point.position);
-    }
-    
-    // Draw trails
-    for (const auto& [trackId, trail] : trailsById) {
-        if (trail.size() < 2) continue;
+    for (size_t i = 0; i < m_tracker.GetTrackCount(); ++i) {
+        if (!m_tracker.IsConfirmed(i)) continue;
+
+        m_tracker.GetHistory(i, m_trailPoints);
+        size_t count = m_trailPoints.size() / 2;
+        if (count < 2) continue;
         
-        cv::Scalar color = GetTrackColor(trackId);
+        cv::Scalar color = GetTrackColor(m_tracker.GetTrackId(i));
         
-        for (size_t i = 1; i < trail.size(); ++i) {
-            int thickness = static_cast<int>(2 * i / trail.size());
+        for (size_t p = 1; p < count; ++p) {
+            cv::Point from(cvRound(m_trailPoints[p * 2 - 2]), cvRound(m_trailPoints[p * 2 - 1]));
+            cv::Point to(cvRound(m_trailPoints[p * 2]), cvRound(m_trailPoints[p * 2 + 1]));
+            int thickness = static_cast<int>(2 * p / count);
             thickness = std::max(1, thickness);
-            cv::line(frame, trail[i - 1], trail[i], color, thickness, cv::LINE_AA);
+            cv::line(frame, from, to, color, thickness, cv::LINE_AA);
         }
     }
 }
@@ -408,16 +303,6 @@ cv::Scalar PersonTrackerProcessor::GetTrackColor(int trackId)
     return colors[trackId % colors.size()];
 }
 
-float PersonTrackerProcessor::CalculateIoU(const cv::Rect& box1, const cv::Rect& box2)
-{
-    // Calculate Intersection over Union for bounding boxes
-    int intersectionArea = (box1 & box2).area();
-    int unionArea = box1.area() + box2.area() - intersectionArea;
-    
-    if (unionArea == 0) return 0.0f;
-    return static_cast<float>(intersectionArea) / unionArea;
-}
-
 #endif  // HAVE_OPENCV
 
 std::string PersonTrackerProcessor::GetName() const
@@ -447,6 +332,33 @@ bool PersonTrackerProcessor::SetParameter(const std::string& name, const std::st
             return false;
         }
     }
+    else if (name == "detector") {
+        PersonDetector::Method method;
+        if (!PersonDetector::ParseMethod(value, method)) {
+            return false;
+        }
+        m_detector.SetMethod(method);
+        m_parameters[name] = value;
+        return true;
+    }
+    else if (name == "detect_interval") {
+        try {
+            SetDetectInterval(std::stoi(value));
+            m_parameters[name] = value;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+    else if (name == "model_path") {
+        // Takes effect immediately once initialized, otherwise on Initialize
+        if (m_modelLoaded && !m_detector.LoadModel(value)) {
+            return false;
+        }
+        m_modelPath = value;
+        m_parameters[name] = value;
+        return true;
+    }
     else if (name == "trail_length") {
         try {
             int length = std::stoi(value);
@@ -457,6 +369,33 @@ bool PersonTrackerProcessor::SetParameter(const std::string& name, const std::st
             return false;
         }
     }
+    else if (name == "tracker_min_hits") {
+        try {
+            m_tracker.SetMinHits(std::stoi(value));
+            m_parameters[name] = value;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+    else if (name == "tracker_max_missed") {
+        try {
+            m_tracker.SetMaxMissed(std::stoi(value));
+            m_parameters[name] = value;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+    else if (name == "tracker_min_iou") {
+        try {
+            m_tracker.SetMinIoU(std::stof(value));
+            m_parameters[name] = value;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
     else if (name == "show_bbox") {
         SetShowBoundingBox(value == "true" || value == "1");
         m_parameters[name] = value;
@@ -477,7 +416,14 @@ bool PersonTrackerProcessor::SetParameter(const std::string& name, const std::st
 
 std::map<std::string, std::string> PersonTrackerProcessor::GetParameters() const
 {
-    return m_parameters;
+    std::map<std::string, std::string> params = m_parameters;
+    params["tracks_active"] = std::to_string(m_tracker.GetTrackCount());
+    params["tracks_created"] = std::to_string(m_tracker.GetIdCount());
+    params["tracker_ms"] = std::to_string(m_tracker.GetLastUpdateMs());
+    params["detector_active"] = PersonDetector::GetMethodName(m_detector.GetActiveMethod());
+    params["detect_ms"] = std::to_string(m_detector.GetLastDetectMs());
+    params["detect_rate"] = std::to_string(m_frameCounter > 0 ? static_cast<double>(m_detectionRuns) / m_frameCounter : 0.0);
+    return params;
 }
 
 double PersonTrackerProcessor::GetExpectedProcessingTime() const
@@ -487,12 +433,17 @@ double PersonTrackerProcessor::GetExpectedProcessingTime() const
 
 void PersonTrackerProcessor::SetConfidenceThreshold(float threshold)
 {
-    m_confidenceThreshold = std::max(0.0f, std::min(1.0f, threshold));
+    m_detector.SetConfidenceThreshold(threshold);
+}
+
+void PersonTrackerProcessor::SetDetectInterval(int frames)
+{
+    m_detectInterval = std::max(1, frames);
 }
 
 void PersonTrackerProcessor::SetTrailLength(int length)
 {
-    m_maxTrailLength = std::max(1, length);
+    m_tracker.SetHistoryLength(length);
 }
 
 void PersonTrackerProcessor::SetShowBoundingBox(bool show)
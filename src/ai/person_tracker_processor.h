@@ -2,13 +2,13 @@
 #define PERSON_TRACKER_PROCESSOR_H
 
 #include "ai_processor.h"
+#include "multi_object_tracker.h"
+#include "person_detector.h"
 #include <vector>
-#include <deque>
 #include <string>
 
 #ifdef HAVE_OPENCV
 #include <opencv2/opencv.hpp>
-#include <opencv2/dnn.hpp>
 #endif
 
 // Person detection and motion tracking processor
@@ -30,12 +30,25 @@ public:
 
     // Configuration
     void SetConfidenceThreshold(float threshold);
+    void SetDetectInterval(int frames);
     void SetTrailLength(int length);
     void SetShowBoundingBox(bool show);
     void SetShowTrail(bool show);
     void SetShowSkeleton(bool show);
 
 private:
+    // Person boxes from a cv::dnn model, or the skin heuristic without one
+    PersonDetector m_detector;
+
+    // Kalman/Hungarian track store; also holds the motion trails
+    MultiObjectTracker m_tracker;
+
+    // The detector runs every m_detectInterval frames, or sooner while any
+    // track is tentative or coasting; in between the tracker predicts boxes
+    int m_detectInterval;
+    int m_framesSinceDetection;
+    int m_detectionRuns;
+
 #ifdef HAVE_OPENCV
     struct DetectedPerson {
         cv::Rect bbox;           // Bounding box
@@ -45,26 +58,15 @@ private:
         cv::Scalar color;       // Color for this person
     };
 
-    struct TrackPoint {
-        cv::Point position;
-        int64_t timestamp;
-        int trackId;
-    };
-
     // Detection
-    cv::dnn::Net m_net;
     std::string m_modelPath;
-    std::string m_configPath;
     bool m_modelLoaded;
-    float m_confidenceThreshold;
-    cv::Size m_inputSize;
+    std::vector<PersonDetector::Detection> m_personDetections;
 
     // Tracking
     std::vector<DetectedPerson> m_currentPersons;
-    std::vector<DetectedPerson> m_previousPersons;
-    std::deque<TrackPoint> m_motionTrail;
-    int m_nextTrackId;
-    int m_maxTrailLength;
+    std::vector<MultiObjectTracker::Detection> m_detections;
+    std::vector<float> m_trailPoints;
 
     // Visualization settings
     bool m_showBoundingBox;
@@ -76,15 +78,14 @@ private:
     int m_frameCounter;
 
     // Helper methods
-    std::vector<DetectedPerson> DetectPersons(const cv::Mat& frame);
-    void TrackPersons(std::vector<DetectedPerson>& persons);
-    void UpdateMotionTrail();
+    bool NeedsDetection() const;
+    void TrackPersons(float dt);
+    void CollectPersons(float ahead);
     void DrawVisualization(cv::Mat& frame);
     void DrawBoundingBoxes(cv::Mat& frame);
     void DrawMotionTrail(cv::Mat& frame);
     void DrawSkeleton(cv::Mat& frame, const DetectedPerson& person);
     cv::Scalar GetTrackColor(int trackId);
-    float CalculateIoU(const cv::Rect& box1, const cv::Rect& box2);
 #endif
 };
 
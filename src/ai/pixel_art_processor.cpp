@@ -1,11 +1,19 @@
 #include "pixel_art_processor.h"
-#include <iostream>
+#include "logger.h"
 #include <chrono>
+#include <cmath>
+#include <vector>
 
 #ifdef HAVE_OPENCV
 #include <opencv2/opencv.hpp>
 #endif
 
+namespace {
+// Canny thresholds the full-res outlines used (Sobel L1 response)
+const int kEdgeLowThreshold = 50;
+const int kEdgeHighThreshold = 150;
+}
+
 PixelArtProcessor::PixelArtProcessor()
     : m_style(MINECRAFT),
       m_pixelSize(8),
@@ -17,7 +25,7 @@ PixelArtProcessor::PixelArtProcessor()
       m_bufferSize(3),  // Small buffer for stability
       m_temporalBlendWeight(0.7)  // 70% current, 30% previous
 {
-    std::cout << "[PixelArtProcessor] Initializing with temporal stabilization" << std::endl;
+    MS_LOG_INFO("[PixelArtProcessor] Initializing with temporal stabilization");
 }
 
 PixelArtProcessor::~PixelArtProcessor()
@@ -27,19 +35,20 @@ PixelArtProcessor::~PixelArtProcessor()
 
 bool PixelArtProcessor::Initialize()
 {
-    std::cout << "[PixelArtProcessor] Initialize called" << std::endl;
-    std::cout << "[PixelArtProcessor] Style: " << static_cast<int>(m_style) << std::endl;
-    std::cout << "[PixelArtProcessor] Pixel Size: " << m_pixelSize << std::endl;
-    std::cout << "[PixelArtProcessor] Color Levels: " << m_colorLevels << std::endl;
+    MS_LOG_INFO("[PixelArtProcessor] Initialize called");
+    MS_LOG_INFO("[PixelArtProcessor] Style: " << static_cast<int>(m_style));
+    MS_LOG_INFO("[PixelArtProcessor] Pixel Size: " << m_pixelSize);
+    MS_LOG_INFO("[PixelArtProcessor] Color Levels: " << m_colorLevels);
     return true;
 }
 
 void PixelArtProcessor::Cleanup()
 {
-    std::cout << "[PixelArtProcessor] Cleanup called" << std::endl;
+    MS_LOG_INFO("[PixelArtProcessor] Cleanup called");
 #ifdef HAVE_OPENCV
     m_frameBuffer.clear();
     m_previousFrame.release();
+    m_previousEdges.release();
 #endif
 }
 
@@ -79,6 +88,25 @@ bool PixelArtProcessor::SetParameter(const std::string& name, const std::string&
     } else if (name == "dithering") {
         SetDithering(value == "true" || value == "1");
         return true;
+    } else if (name == "palette") {
+        if (value.empty() || value == "none") {
+            m_palette.Clear();
+            return true;
+        }
+        if (!m_palette.Load(value)) {
+            MS_LOG_ERROR("[PixelArtProcessor] Could not load palette: " << value);
+            return false;
+        }
+        MS_LOG_INFO("[PixelArtProcessor] Palette " << value << ": " << m_palette.GetColorCount()
+                  << " colors, built in " << m_palette.GetBuildTimeMs() << "ms");
+        return true;
+    } else if (name == "dither_mode") {
+        Ditherer::Method method;
+        if (!Ditherer::ParseMethod(value, method)) {
+            return false;
+        }
+        m_ditherer.SetMethod(method);
+        return true;
     }
     return false;
 }
@@ -91,6 +119,10 @@ std::map<std::string, std::string> PixelArtProcessor::GetParameters() const
     params["style"] = std::to_string(static_cast<int>(m_style));
     params["edge_outlines"] = m_enableEdges ? "true" : "false";
     params["dithering"] = m_enableDithering ? "true" : "false";
+    params["dither_mode"] = Ditherer::GetMethodName(m_ditherer.GetMethod());
+    params["palette"] = m_palette.IsLoaded() ? m_palette.GetName() : "none";
+    params["palette_colors"] = std::to_string(m_palette.GetColorCount());
+    params["palette_build_ms"] = std::to_string(m_palette.GetBuildTimeMs());
     return params;
 }
 
@@ -126,8 +158,8 @@ Frame PixelArtProcessor::ProcessFrame(const Frame& input)
 
     m_frameCounter++;
     if (m_frameCounter % 30 == 0) {
-        std::cout << "[PixelArtProcessor] Frame " << m_frameCounter 
-                  << " processed in " << m_processingTime << "ms" << std::endl;
+        MS_LOG_INFO("[PixelArtProcessor] Frame " << m_frameCounter 
+                  << " processed in " << m_processingTime << "ms");
     }
 
     return output;
@@ -139,83 +171,57 @@ void PixelArtProcessor::ApplyMinecraftStyle(cv::Mat& frame)
 {
     // Minecraft style: Large 8x8 blocks, vibrant colors, strong edges
     
-    // Step 1: Enhance saturation for vibrant Minecraft-like colors
-    cv::Mat hsv;
-    cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
-    std::vector<cv::Mat> channels;
-    cv::split(hsv, channels);
-    channels[1] = channels[1] * 1.4; // Boost saturation
-    cv::merge(channels, hsv);
-    cv::cvtColor(hsv, frame, cv::COLOR_HSV2BGR);
+    // Step 1: Reduce to one pixel per block; every color step below runs on this grid
+    cv::Mat grid = DownsampleToGrid(frame, m_pixelSize);
     
-    // Step 2: Pixelate to create blocky appearance
-    frame = Pixelate(frame, m_pixelSize);
+    // Step 2: Enhance saturation for vibrant Minecraft-like colors
+    ColorLut3D::ScaleSaturationValue(grid, 1.4, 1.0);
     
     // Step 3: Quantize colors to fewer levels (blocky color palette)
-    frame = QuantizeColors(frame, m_colorLevels);
+    grid = ReduceColors(grid, m_colorLevels);
     
-    // Step 4: Add strong black edge outlines
-    if (m_enableEdges) {
-        cv::Mat edges = DetectEdges(frame);
-        frame = ApplyEdgeOutlines(frame, edges);
-    }
-    
-    // Step 5: Apply temporal stabilization to reduce blinking
-    frame = StabilizeFrame(frame);
+    // Step 4: Strong black outlines, temporal stabilization and block expansion
+    RenderBlocks(grid, frame);
 }
 
 void PixelArtProcessor::ApplyAnimePixelStyle(cv::Mat& frame)
 {
     // Anime pixel style: Smaller 4x4 pixels, anime color palette, soft edges
     
-    // Step 1: Apply anime-inspired color palette
-    frame = ApplyAnimePalette(frame);
+    // Step 1: Reduce to the 4x4 block grid
+    cv::Mat grid = DownsampleToGrid(frame, 4);
     
-    // Step 2: Pixelate with smaller blocks for detail
-    frame = Pixelate(frame, 4);
+    // Step 2: Apply anime-inspired color palette
+    grid = ApplyAnimePalette(grid);
     
     // Step 3: Quantize to anime-style color levels
-    frame = QuantizeColors(frame, 8);
-    
-    // Step 4: Add subtle edge outlines
-    if (m_enableEdges) {
-        cv::Mat edges = DetectEdges(frame);
-        frame = ApplyEdgeOutlines(frame, edges);
-    }
+    grid = ReduceColors(grid, 8);
     
-    // Step 5: Apply temporal stabilization to reduce blinking
-    frame = StabilizeFrame(frame);
+    // Step 4: Outlines, temporal stabilization and block expansion
+    RenderBlocks(grid, frame);
 }
 
 void PixelArtProcessor::ApplyRetro16BitStyle(cv::Mat& frame)
 {
     // Retro 16-bit style: Medium pixels, dithering, limited colors
     
-    // Step 1: Pixelate to medium block size
-    frame = Pixelate(frame, 6);
+    // Step 1: Reduce to the 6x6 block grid
+    cv::Mat grid = DownsampleToGrid(frame, 6);
     
     // Step 2: Reduce to limited color palette (16-bit era)
-    frame = QuantizeColors(frame, 5);
-    
-    // Step 3: Apply dithering for retro look
-    if (m_enableDithering) {
-        frame = ApplyDithering(frame);
-    }
+    grid = ReduceColors(grid, 5);
     
-    // Step 4: Light edge outlines
-    if (m_enableEdges) {
-        cv::Mat edges = DetectEdges(frame);
-        // Lighter edge application for retro look
-        cv::Mat softEdges;
-        edges.convertTo(softEdges, -1, 0.6, 0);
-        frame = ApplyEdgeOutlines(frame, softEdges);
+    // Step 3: Apply dithering for retro look (one error-diffusion step per block;
+    // a fixed palette already defines the retro colors)
+    if (m_enableDithering && !m_palette.IsLoaded()) {
+        m_ditherer.Apply(grid, grid);
     }
     
-    // Step 5: Apply temporal stabilization to reduce blinking
-    frame = StabilizeFrame(frame);
+    // Step 4: Outlines, temporal stabilization and block expansion
+    RenderBlocks(grid, frame);
 }
 
-cv::Mat PixelArtProcessor::Pixelate(const cv::Mat& src, int pixelSize)
+cv::Mat PixelArtProcessor::DownsampleToGrid(const cv::Mat& src, int pixelSize)
 {
     if (src.empty() || pixelSize < 1) {
         return src.clone();
@@ -225,15 +231,22 @@ cv::Mat PixelArtProcessor::Pixelate(const cv::Mat& src, int pixelSize)
     int newWidth = std::max(1, src.cols / pixelSize);
     int newHeight = std::max(1, src.rows / pixelSize);
     
-    // Downsample
+    // One sample per block (same filter the full-res pixelation used)
     cv::Mat small;
     cv::resize(src, small, cv::Size(newWidth, newHeight), 0, 0, cv::INTER_LINEAR);
     
-    // Upsample back to original size with nearest neighbor for blocky effect
-    cv::Mat pixelated;
-    cv::resize(small, pixelated, src.size(), 0, 0, cv::INTER_NEAREST);
-    
-    return pixelated;
+    return small;
+}
+
+void PixelArtProcessor::RenderBlocks(const cv::Mat& grid, cv::Mat& frame)
+{
+    if (grid.empty() || frame.empty()) {
+        return;
+    }
+
+    cv::Mat edges = m_enableEdges ? DetectBlockEdges(grid) : cv::Mat::zeros(grid.size(), CV_8UC2);
+    StabilizeGrid(grid, edges);
+    ExpandBlocks(m_previousFrame, m_previousEdges, frame);
 }
 
 cv::Mat PixelArtProcessor::QuantizeColors(const cv::Mat& src, int colorLevels)
@@ -242,162 +255,184 @@ cv::Mat PixelArtProcessor::QuantizeColors(const cv::Mat& src, int colorLevels)
         return src.clone();
     }
     
-    cv::Mat quantized = src.clone();
-    
     // Calculate quantization step
     int step = 256 / colorLevels;
     
-    // Quantize each pixel
-    for (int y = 0; y < quantized.rows; ++y) {
-        cv::Vec3b* row = quantized.ptr<cv::Vec3b>(y);
-        for (int x = 0; x < quantized.cols; ++x) {
-            for (int c = 0; c < 3; ++c) {
-                int val = row[x][c];
-                row[x][c] = (val / step) * step + step / 2;
-            }
-        }
-    }
-    
+    // Exact per-channel posterization to the band centers
+    cv::Mat quantized;
+    ColorLut3D::Posterize(src, quantized, step, step / 2);
     return quantized;
 }
 
+cv::Mat PixelArtProcessor::ReduceColors(const cv::Mat& src, int colorLevels)
+{
+    if (!m_palette.IsLoaded()) {
+        return QuantizeColors(src, colorLevels);
+    }
+
+    cv::Mat mapped;
+    m_palette.Apply(src, mapped);
+    return mapped;
+}
+
 cv::Mat PixelArtProcessor::ApplyAnimePalette(const cv::Mat& src)
 {
     if (src.empty()) {
         return src.clone();
     }
     
-    // Enhance colors to anime-style vibrant palette
+    // Enhance colors to anime-style vibrant palette: saturation boost and
+    // slight brightness boost
     cv::Mat anime = src.clone();
-    
-    // Convert to HSV for color manipulation
-    cv::Mat hsv;
-    cv::cvtColor(anime, hsv, cv::COLOR_BGR2HSV);
-    
-    std::vector<cv::Mat> channels;
-    cv::split(hsv, channels);
-    
-    // Boost saturation and adjust brightness for anime look
-    channels[1] = channels[1] * 1.3; // Saturation boost
-    channels[2] = channels[2] * 1.1; // Slight brightness boost
-    
-    // Clamp values
-    cv::threshold(channels[1], channels[1], 255, 255, cv::THRESH_TRUNC);
-    cv::threshold(channels[2], channels[2], 255, 255, cv::THRESH_TRUNC);
-    
-    cv::merge(channels, hsv);
-    cv::cvtColor(hsv, anime, cv::COLOR_HSV2BGR);
+    ColorLut3D::ScaleSaturationValue(anime, 1.3, 1.1);
     
     return anime;
 }
 
-cv::Mat PixelArtProcessor::DetectEdges(const cv::Mat& src)
+cv::Mat PixelArtProcessor::DetectBlockEdges(const cv::Mat& grid)
 {
-    if (src.empty()) {
-        return cv::Mat();
-    }
-    
-    cv::Mat gray, edges;
-    
-    // Convert to grayscale
-    if (src.channels() == 3) {
-        cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
+    // Outlines only ever fall on block boundaries, so score each boundary
+    // once: a gray step D between two blocks is a Sobel response of 4 * D in
+    // the expanded image. Strong steps always draw; weak ones only continue
+    // a strong neighbor on the same line (Canny-style hysteresis).
+    // Channel 0 = boundary to the right block, channel 1 = to the block below.
+    cv::Mat gray;
+    if (grid.channels() == 3) {
+        cv::cvtColor(grid, gray, cv::COLOR_BGR2GRAY);
     } else {
-        gray = src.clone();
+        gray = grid;
     }
-    
-    // Use Canny edge detection for crisp pixel art edges
-    cv::Canny(gray, edges, 50, 150);
-    
-    // Dilate slightly to make edges more visible
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(2, 2));
-    cv::dilate(edges, edges, kernel);
-    
-    return edges;
-}
 
-cv::Mat PixelArtProcessor::ApplyEdgeOutlines(cv::Mat& src, const cv::Mat& edges)
-{
-    if (src.empty() || edges.empty()) {
-        return src.clone();
-    }
-    
-    cv::Mat result = src.clone();
-    
-    // Apply black outlines where edges are detected
-    for (int y = 0; y < result.rows; ++y) {
-        cv::Vec3b* row = result.ptr<cv::Vec3b>(y);
-        const uint8_t* edgeRow = edges.ptr<uint8_t>(y);
-        
-        for (int x = 0; x < result.cols; ++x) {
-            if (edgeRow[x] > 0) {
-                // Draw black outline
-                row[x] = cv::Vec3b(0, 0, 0);
+    const int rows = gray.rows;
+    const int cols = gray.cols;
+    cv::Mat strength(rows, cols, CV_16UC2, cv::Scalar::all(0));
+    for (int y = 0; y < rows; ++y) {
+        const uint8_t* row = gray.ptr<uint8_t>(y);
+        const uint8_t* below = y + 1 < rows ? gray.ptr<uint8_t>(y + 1) : nullptr;
+        cv::Vec2w* out = strength.ptr<cv::Vec2w>(y);
+        for (int x = 0; x < cols; ++x) {
+            if (x + 1 < cols) {
+                out[x][0] = static_cast<uint16_t>(4 * std::abs(row[x + 1] - row[x]));
+            }
+            if (below) {
+                out[x][1] = static_cast<uint16_t>(4 * std::abs(below[x] - row[x]));
             }
         }
     }
-    
-    return result;
+
+    cv::Mat edges(rows, cols, CV_8UC2, cv::Scalar::all(0));
+    for (int y = 0; y < rows; ++y) {
+        const cv::Vec2w* row = strength.ptr<cv::Vec2w>(y);
+        const cv::Vec2w* above = y > 0 ? strength.ptr<cv::Vec2w>(y - 1) : nullptr;
+        const cv::Vec2w* below = y + 1 < rows ? strength.ptr<cv::Vec2w>(y + 1) : nullptr;
+        cv::Vec2b* out = edges.ptr<cv::Vec2b>(y);
+        for (int x = 0; x < cols; ++x) {
+            // Vertical boundary continues up and down, horizontal left and right
+            const int right = row[x][0];
+            bool rightStrong = right >= kEdgeHighThreshold ||
+                (right >= kEdgeLowThreshold &&
+                 ((above && above[x][0] >= kEdgeHighThreshold) || (below && below[x][0] >= kEdgeHighThreshold)));
+
+            const int down = row[x][1];
+            bool downStrong = down >= kEdgeHighThreshold ||
+                (down >= kEdgeLowThreshold &&
+                 ((x > 0 && row[x - 1][1] >= kEdgeHighThreshold) ||
+                  (x + 1 < cols && row[x + 1][1] >= kEdgeHighThreshold)));
+
+            out[x] = cv::Vec2b(rightStrong ? 255 : 0, downStrong ? 255 : 0);
+        }
+    }
+
+    return edges;
 }
 
-cv::Mat PixelArtProcessor::ApplyDithering(const cv::Mat& src)
+void PixelArtProcessor::ExpandBlocks(const cv::Mat& grid, const cv::Mat& edges, cv::Mat& frame)
 {
-    if (src.empty()) {
-        return src.clone();
+    // Single nearest-neighbor expansion. Outline ink sits on the last pixel
+    // of a block and the first pixel of its neighbor (the 2px line Canny
+    // plus a 2x2 dilate left on a block boundary).
+    const int rows = frame.rows;
+    const int cols = frame.cols;
+    const int gridRows = grid.rows;
+    const int gridCols = grid.cols;
+
+    // Source block per output column / row, matching cv::resize INTER_NEAREST
+    std::vector<int> colBlock(cols), rowBlock(rows);
+    for (int x = 0; x < cols; ++x) {
+        colBlock[x] = std::min(gridCols - 1, static_cast<int>(std::floor(x * static_cast<double>(gridCols) / cols)));
     }
-    
-    cv::Mat dithered = src.clone();
-    
-    // Floyd-Steinberg dithering for retro look
-    for (int y = 0; y < dithered.rows - 1; ++y) {
-        for (int x = 1; x < dithered.cols - 1; ++x) {
-            for (int c = 0; c < 3; ++c) {
-                int oldPixel = dithered.at<cv::Vec3b>(y, x)[c];
-                int newPixel = (oldPixel > 128) ? 255 : 0;
-                dithered.at<cv::Vec3b>(y, x)[c] = newPixel;
-                
-                int error = oldPixel - newPixel;
-                
-                // Distribute error to neighboring pixels
-                dithered.at<cv::Vec3b>(y, x + 1)[c] = 
-                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y, x + 1)[c] + error * 7 / 16);
-                dithered.at<cv::Vec3b>(y + 1, x - 1)[c] = 
-                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y + 1, x - 1)[c] + error * 3 / 16);
-                dithered.at<cv::Vec3b>(y + 1, x)[c] = 
-                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y + 1, x)[c] + error * 5 / 16);
-                dithered.at<cv::Vec3b>(y + 1, x + 1)[c] = 
-                    cv::saturate_cast<uint8_t>(dithered.at<cv::Vec3b>(y + 1, x + 1)[c] + error * 1 / 16);
-            }
+    for (int y = 0; y < rows; ++y) {
+        rowBlock[y] = std::min(gridRows - 1, static_cast<int>(std::floor(y * static_cast<double>(gridRows) / rows)));
+    }
+
+    // Boundary touched by each column / row: index of the block left of /
+    // above it, or -1 inside a block
+    std::vector<int> colBoundary(cols, -1), rowBoundary(rows, -1);
+    for (int x = 0; x < cols; ++x) {
+        if (x + 1 < cols && colBlock[x + 1] != colBlock[x]) {
+            colBoundary[x] = colBlock[x];
+        } else if (x > 0 && colBlock[x - 1] != colBlock[x]) {
+            colBoundary[x] = colBlock[x - 1];
         }
     }
-    
-    return dithered;
+    for (int y = 0; y < rows; ++y) {
+        if (y + 1 < rows && rowBlock[y + 1] != rowBlock[y]) {
+            rowBoundary[y] = rowBlock[y];
+        } else if (y > 0 && rowBlock[y - 1] != rowBlock[y]) {
+            rowBoundary[y] = rowBlock[y - 1];
+        }
+    }
+
+    frame.create(frame.size(), CV_8UC3);
+    cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; ++y) {
+            const cv::Vec3b* colors = grid.ptr<cv::Vec3b>(rowBlock[y]);
+            const cv::Vec2b* blockEdges = edges.ptr<cv::Vec2b>(rowBlock[y]);
+            const cv::Vec2b* horizontal = rowBoundary[y] >= 0 ? edges.ptr<cv::Vec2b>(rowBoundary[y]) : nullptr;
+            cv::Vec3b* out = frame.ptr<cv::Vec3b>(y);
+
+            for (int x = 0; x < cols; ++x) {
+                int ink = 0;
+                if (colBoundary[x] >= 0) {
+                    ink = blockEdges[colBoundary[x]][0];
+                }
+                if (horizontal) {
+                    ink = std::max<int>(ink, horizontal[colBlock[x]][1]);
+                }
+
+                const cv::Vec3b& color = colors[colBlock[x]];
+                if (ink == 0) {
+                    out[x] = color;
+                } else {
+                    const int keep = 255 - ink;
+                    out[x] = cv::Vec3b(static_cast<uchar>((color[0] * keep + 127) / 255),
+                                       static_cast<uchar>((color[1] * keep + 127) / 255),
+                                       static_cast<uchar>((color[2] * keep + 127) / 255));
+                }
+            }
+        }
+    });
 }
 
-cv::Mat PixelArtProcessor::StabilizeFrame(const cv::Mat& currentFrame)
+void PixelArtProcessor::StabilizeGrid(const cv::Mat& grid, const cv::Mat& edges)
 {
-    if (currentFrame.empty()) {
-        return currentFrame.clone();
-    }
-    
-    // First frame - no stabilization needed
-    if (m_previousFrame.empty() || 
-        m_previousFrame.size() != currentFrame.size() || 
-        m_previousFrame.type() != currentFrame.type()) {
-        m_previousFrame = currentFrame.clone();
-        return currentFrame.clone();
+    // Blend block colors and outline ink with the previous frame; both are
+    // per block, so this is the full-res blend at 1/(block size)^2 the cost
+    if (m_previousFrame.empty() ||
+        m_previousFrame.size() != grid.size() ||
+        m_previousFrame.type() != grid.type() ||
+        m_previousEdges.size() != edges.size()) {
+        m_previousFrame = grid.clone();
+        m_previousEdges = edges.clone();
+        return;
     }
     
-    // Blend current frame with previous frame for temporal stability
-    cv::Mat stabilized;
-    cv::addWeighted(currentFrame, m_temporalBlendWeight, 
-                    m_previousFrame, 1.0 - m_temporalBlendWeight, 
-                    0, stabilized);
-    
-    // Update previous frame for next iteration
-    m_previousFrame = stabilized.clone();
-    
-    return stabilized;
+    cv::addWeighted(grid, m_temporalBlendWeight,
+                    m_previousFrame, 1.0 - m_temporalBlendWeight,
+                    0, m_previousFrame);
+    cv::addWeighted(edges, m_temporalBlendWeight,
+                    m_previousEdges, 1.0 - m_temporalBlendWeight,
+                    0, m_previousEdges);
 }
 
 #endif // HAVE_OPENCV
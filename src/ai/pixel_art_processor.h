@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ai_processor.h"
+#include "color_lut.h"
+#include "ditherer.h"
+#include "palette_mapper.h"
 #include <deque>
 
 #ifdef HAVE_OPENCV
@@ -11,8 +14,10 @@
  * Pixel Art Processor
  * 
  * Creates anime-style pixel art effect similar to Minecraft aesthetics:
- * - Pixelation/downsampling for blocky appearance
- * - Bold color quantization with vibrant anime colors
+ * - Pixelation/downsampling for blocky appearance (all color work, edges and
+ *   temporal blending run on the block grid; one nearest expansion at the end)
+ * - Bold color quantization with vibrant anime colors, or mapping to a fixed
+ *   retro palette (built-in or palette file)
  * - Strong edge outlines for anime style
  * - Optional dithering for retro look
  */
@@ -65,24 +70,33 @@ public:
     void SetDithering(bool enable) { m_enableDithering = enable; }
     bool GetDithering() const { return m_enableDithering; }
 
+    // Dither algorithm (wavefront Floyd-Steinberg by default; Bayer is fastest)
+    void SetDitherMethod(Ditherer::Method method) { m_ditherer.SetMethod(method); }
+    Ditherer::Method GetDitherMethod() const { return m_ditherer.GetMethod(); }
+
 private:
 #ifdef HAVE_OPENCV
-    cv::Mat Pixelate(const cv::Mat& src, int pixelSize);
+    cv::Mat DownsampleToGrid(const cv::Mat& src, int pixelSize);
     cv::Mat QuantizeColors(const cv::Mat& src, int colorLevels);
+    cv::Mat ReduceColors(const cv::Mat& src, int colorLevels);     // Fixed palette if loaded, else QuantizeColors
     cv::Mat ApplyAnimePalette(const cv::Mat& src);
-    cv::Mat DetectEdges(const cv::Mat& src);
-    cv::Mat ApplyEdgeOutlines(cv::Mat& src, const cv::Mat& edges);
-    cv::Mat ApplyDithering(const cv::Mat& src);
+    cv::Mat DetectBlockEdges(const cv::Mat& grid);
+    void ExpandBlocks(const cv::Mat& grid, const cv::Mat& edges, cv::Mat& frame);
+    void RenderBlocks(const cv::Mat& grid, cv::Mat& frame);
     void ApplyMinecraftStyle(cv::Mat& frame);
     void ApplyAnimePixelStyle(cv::Mat& frame);
     void ApplyRetro16BitStyle(cv::Mat& frame);
     
-    // Temporal stabilization
-    cv::Mat StabilizeFrame(const cv::Mat& currentFrame);
+    // Temporal stabilization (on the block grid)
+    void StabilizeGrid(const cv::Mat& grid, const cv::Mat& edges);
     std::deque<cv::Mat> m_frameBuffer;
-    cv::Mat m_previousFrame;
+    cv::Mat m_previousFrame;      // Stabilized block colors, one pixel per block
+    cv::Mat m_previousEdges;      // Stabilized outline ink per block, CV_8UC2 (right, below)
 #endif
 
+    Ditherer m_ditherer;
+    PaletteMapper m_palette;      // Optional fixed palette replacing level quantization
+
     Style m_style;
     int m_pixelSize;
     int m_colorLevels;
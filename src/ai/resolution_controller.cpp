@@ -0,0 +1,151 @@
+#include "resolution_controller.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+const int kDownFrames = 5;          // Consecutive over-budget frames before stepping down
+const int kUpFrames = 60;           // Consecutive comfortable frames before stepping up
+const double kUpHeadroom = 0.85;    // Predicted latency must stay under this share of the budget
+const double kSmoothing = 0.2;      // EMA weight of the newest sample
+}
+
+ResolutionController::ResolutionController()
+    : m_index(0),
+      m_budget(33.3),
+      m_smoothed(0.0),
+      m_enabled(false),
+      m_overCount(0),
+      m_underCount(0),
+      m_frames(0),
+      m_misses(0),
+      m_stepsDown(0),
+      m_stepsUp(0)
+{
+}
+
+void ResolutionController::SetLadder(const std::vector<int>& sizes)
+{
+    int current = GetCurrentSize();
+
+    m_ladder.clear();
+    for (int size : sizes) {
+        if (size > 0) {
+            m_ladder.push_back(size);
+        }
+    }
+    std::sort(m_ladder.begin(), m_ladder.end());
+    m_ladder.erase(std::unique(m_ladder.begin(), m_ladder.end()), m_ladder.end());
+
+    SetCurrentSize(current);
+}
+
+void ResolutionController::SetBudget(double milliseconds)
+{
+    m_budget = std::max(1.0, milliseconds);
+    m_overCount = 0;
+    m_underCount = 0;
+}
+
+void ResolutionController::SetCurrentSize(int size)
+{
+    m_index = 0;
+    for (size_t i = 1; i < m_ladder.size(); ++i) {
+        if (std::abs(m_ladder[i] - size) < std::abs(m_ladder[m_index] - size)) {
+            m_index = i;
+        }
+    }
+    m_smoothed = 0.0;
+    m_overCount = 0;
+    m_underCount = 0;
+}
+
+int ResolutionController::GetCurrentSize() const
+{
+    return m_ladder.empty() ? 0 : m_ladder[m_index];
+}
+
+bool ResolutionController::Update(double latencyMs)
+{
+    m_frames++;
+    if (latencyMs > m_budget) {
+        m_misses++;
+    }
+
+    m_smoothed = m_smoothed > 0.0 ? m_smoothed * (1.0 - kSmoothing) + latencyMs * kSmoothing : latencyMs;
+
+    if (!m_enabled || m_ladder.size() < 2) {
+        return false;
+    }
+
+    if (m_smoothed > m_budget) {
+        m_overCount++;
+        m_underCount = 0;
+    } else {
+        m_overCount = 0;
+        m_underCount++;
+    }
+
+    if (m_overCount >= kDownFrames && m_index > 0) {
+        double ratio = static_cast<double>(m_ladder[m_index - 1]) / m_ladder[m_index];
+        m_index--;
+        m_smoothed *= ratio * ratio;        // Cost scales with pixel count
+        m_overCount = 0;
+        m_underCount = 0;
+        m_stepsDown++;
+        return true;
+    }
+
+    if (m_underCount >= kUpFrames && m_index + 1 < m_ladder.size()) {
+        double ratio = static_cast<double>(m_ladder[m_index + 1]) / m_ladder[m_index];
+        double predicted = m_smoothed * ratio * ratio;
+        m_underCount = 0;
+        if (predicted < m_budget * kUpHeadroom) {
+            m_index++;
+            m_smoothed = predicted;
+            m_overCount = 0;
+            m_stepsUp++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ResolutionController::ResetStats()
+{
+    m_frames = 0;
+    m_misses = 0;
+    m_stepsDown = 0;
+    m_stepsUp = 0;
+}
+
+bool ResolutionController::ParseLadder(const std::string& text, std::vector<int>& sizes)
+{
+    std::vector<int> parsed;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        char* end = nullptr;
+        long value = std::strtol(item.c_str(), &end, 10);
+        if (end == item.c_str() || value <= 0) {
+            return false;
+        }
+        parsed.push_back(static_cast<int>(value));
+    }
+    if (parsed.empty()) {
+        return false;
+    }
+    sizes = parsed;
+    return true;
+}
+
+std::string ResolutionController::GetLadderString() const
+{
+    std::string text;
+    for (size_t i = 0; i < m_ladder.size(); ++i) {
+        text += (i > 0 ? "," : "") + std::to_string(m_ladder[i]);
+    }
+    return text;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Resolution Controller
+ *
+ * Closed-loop choice of a network input size. Measured inference latency is
+ * compared against a per-frame budget and the size steps down or up along a
+ * ladder of sizes the model accepts.
+ *
+ * Hysteresis: stepping down needs the smoothed latency over budget for a few
+ * consecutive frames; stepping up needs a long run well under budget and a
+ * predicted latency (scaled by pixel count) that still fits with headroom.
+ * Counters restart after every step so the new size is measured first.
+ */
+class ResolutionController {
+public:
+    ResolutionController();
+
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    bool IsEnabled() const { return m_enabled; }
+
+    // Sizes the model accepts (e.g. multiples of 32); sorted and de-duplicated
+    void SetLadder(const std::vector<int>& sizes);
+    const std::vector<int>& GetLadder() const { return m_ladder; }
+
+    void SetBudget(double milliseconds);
+    double GetBudget() const { return m_budget; }
+
+    // Snap to the ladder rung closest to `size` (e.g. the configured size)
+    void SetCurrentSize(int size);
+    int GetCurrentSize() const;
+
+    /**
+     * Record one frame's inference latency
+     * @return true if the size changed and the caller should apply it
+     */
+    bool Update(double latencyMs);
+
+    // Metrics
+    uint64_t GetFrames() const { return m_frames; }
+    uint64_t GetMisses() const { return m_misses; }
+    double GetSmoothedLatency() const { return m_smoothed; }
+    int GetStepsDown() const { return m_stepsDown; }
+    int GetStepsUp() const { return m_stepsUp; }
+    void ResetStats();
+
+    static bool ParseLadder(const std::string& text, std::vector<int>& sizes);
+    std::string GetLadderString() const;
+
+private:
+    std::vector<int> m_ladder;
+    size_t m_index;
+    double m_budget;
+    double m_smoothed;
+    bool m_enabled;
+    int m_overCount;
+    int m_underCount;
+    uint64_t m_frames;
+    uint64_t m_misses;
+    int m_stepsDown;
+    int m_stepsUp;
+};
@@ -0,0 +1,209 @@
+#include "sprite_cache.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPRITE_CACHE_SSE2 1
+#endif
+
+namespace {
+const int kDefaultBucketsPerOctave = 8;
+const size_t kDefaultMaxEntries = 64;
+
+// round(value / 255) for value <= 255 * 255, in 16 bits
+inline uint16_t DivideBy255(uint16_t value)
+{
+    uint16_t t = static_cast<uint16_t>(value + 128);
+    return static_cast<uint16_t>((t + (t >> 8)) >> 8);
+}
+}
+
+SpriteCache::SpriteCache()
+    : m_bucketsPerOctave(kDefaultBucketsPerOctave),
+      m_maxEntries(kDefaultMaxEntries),
+      m_clock(0),
+      m_hits(0),
+      m_misses(0)
+{
+}
+
+void SpriteCache::SetBucketsPerOctave(int buckets)
+{
+    m_bucketsPerOctave = std::max(1, std::min(64, buckets));
+}
+
+void SpriteCache::SetMaxEntries(size_t entries)
+{
+    m_maxEntries = std::max<size_t>(1, entries);
+    Evict(m_maxEntries);
+}
+
+int SpriteCache::QuantizeSize(int pixels) const
+{
+    if (pixels <= 1) {
+        return 1;
+    }
+    double bucket = std::round(std::log2(static_cast<double>(pixels)) * m_bucketsPerOctave);
+    return std::max(1, static_cast<int>(std::lround(std::exp2(bucket / m_bucketsPerOctave))));
+}
+
+void SpriteCache::Invalidate(int key)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if ((it->first >> 40) == static_cast<uint64_t>(key & 0xFFFFFF)) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SpriteCache::Clear()
+{
+    m_entries.clear();
+}
+
+void SpriteCache::OverBytes(const uint8_t* __restrict color, const uint8_t* __restrict inverseAlpha,
+                            uint8_t* __restrict frame, int count)
+{
+    int i = 0;
+#ifdef SPRITE_CACHE_SSE2
+    // 16 bytes per step: widen to 16-bit lanes, multiply, divide by 255, narrow
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+    for (; i + 16 <= count; i += 16) {
+        const __m128i target = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i));
+        const __m128i alpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inverseAlpha + i));
+        __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(target, zero), _mm_unpacklo_epi8(alpha, zero)), half);
+        __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(target, zero), _mm_unpackhi_epi8(alpha, zero)), half);
+        low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+        high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+        const __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(color + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + i), _mm_adds_epu8(source, _mm_packus_epi16(low, high)));
+    }
+#endif
+    for (; i < count; ++i) {
+        frame[i] = static_cast<uint8_t>(std::min(255, color[i] + DivideBy255(static_cast<uint16_t>(frame[i] * inverseAlpha[i]))));
+    }
+}
+
+uint64_t SpriteCache::MakeKey(int key, int width, int height)
+{
+    // 24 bits key | 20 bits width | 20 bits height
+    return (static_cast<uint64_t>(key & 0xFFFFFF) << 40) |
+           (static_cast<uint64_t>(width & 0xFFFFF) << 20) |
+           static_cast<uint64_t>(height & 0xFFFFF);
+}
+
+void SpriteCache::Evict(size_t limit)
+{
+    while (m_entries.size() > limit) {
+        auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+            [](const auto& a, const auto& b) { return a.second.lastUse < b.second.lastUse; });
+        m_entries.erase(oldest);
+    }
+}
+
+#ifdef HAVE_OPENCV
+
+const SpriteCache::Sprite& SpriteCache::Get(int key, int width, int height, const Renderer& render)
+{
+    width = std::max(1, width);
+    height = std::max(1, height);
+    const uint64_t id = MakeKey(key, width, height);
+
+    auto it = m_entries.find(id);
+    if (it != m_entries.end()) {
+        m_hits++;
+        it->second.lastUse = ++m_clock;
+        return it->second.sprite;
+    }
+
+    m_misses++;
+    Entry entry;
+    entry.lastUse = ++m_clock;
+    cv::Mat& image = entry.sprite.image;
+    image = cv::Mat::zeros(height, width, CV_8UC4);
+    render(image);
+
+    // BGR planes and the non-transparent span of every row
+    Sprite& sprite = entry.sprite;
+    sprite.color.resize(static_cast<size_t>(width) * height * 3);
+    sprite.inverseAlpha.resize(sprite.color.size());
+    sprite.spanBegin.assign(height, 0);
+    sprite.spanEnd.assign(height, 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = image.ptr<uint8_t>(y);
+        uint8_t* color = &sprite.color[static_cast<size_t>(y) * width * 3];
+        uint8_t* inverseAlpha = &sprite.inverseAlpha[static_cast<size_t>(y) * width * 3];
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 3; ++c) {
+                color[x * 3 + c] = row[x * 4 + c];
+                inverseAlpha[x * 3 + c] = static_cast<uint8_t>(255 - row[x * 4 + 3]);
+            }
+        }
+
+        int begin = 0;
+        while (begin < width && row[begin * 4 + 3] == 0) begin++;
+        int end = width;
+        while (end > begin && row[(end - 1) * 4 + 3] == 0) end--;
+        sprite.spanBegin[y] = begin;
+        sprite.spanEnd[y] = end;
+    }
+
+    Evict(m_maxEntries - 1);
+    return m_entries.emplace(id, std::move(entry)).first->second.sprite;
+}
+
+void SpriteCache::Premultiply(cv::Mat& bgra)
+{
+    CV_Assert(bgra.type() == CV_8UC4);
+    for (int y = 0; y < bgra.rows; ++y) {
+        uint8_t* row = bgra.ptr<uint8_t>(y);
+        for (int x = 0; x < bgra.cols; ++x) {
+            uint8_t* p = row + x * 4;
+            for (int c = 0; c < 3; ++c) {
+                p[c] = static_cast<uint8_t>(DivideBy255(static_cast<uint16_t>(p[c] * p[3])));
+            }
+        }
+    }
+}
+
+void SpriteCache::Composite(cv::Mat& frame, const Sprite& sprite, const cv::Point& position)
+{
+    const cv::Mat& image = sprite.image;
+    if (image.empty() || frame.empty() || frame.depth() != CV_8U ||
+        (frame.channels() != 3 && frame.channels() != 4)) {
+        return;
+    }
+
+    const int channels = frame.channels();
+    const int top = std::max(0, -position.y);
+    const int bottom = std::min(image.rows, frame.rows - position.y);
+    const int clipLeft = std::max(0, -position.x);
+    const int clipRight = std::min(image.cols, frame.cols - position.x);
+
+    for (int y = top; y < bottom; ++y) {
+        const int begin = std::max(sprite.spanBegin[y], clipLeft);
+        const int end = std::min(sprite.spanEnd[y], clipRight);
+        if (begin >= end) continue;
+
+        uint8_t* target = frame.ptr<uint8_t>(position.y + y) + (position.x + begin) * channels;
+        if (channels == 3) {
+            const size_t offset = (static_cast<size_t>(y) * image.cols + begin) * 3;
+            OverBytes(&sprite.color[offset], &sprite.inverseAlpha[offset], target, (end - begin) * 3);
+        } else {
+            const uint8_t* source = image.ptr<uint8_t>(y) + begin * 4;
+            for (int x = 0; x < end - begin; ++x) {
+                const uint16_t inverseAlpha = static_cast<uint16_t>(255 - source[x * 4 + 3]);
+                for (int c = 0; c < 3; ++c) {
+                    target[x * 4 + c] = static_cast<uint8_t>(
+                        source[x * 4 + c] + DivideBy255(static_cast<uint16_t>(target[x * 4 + c] * inverseAlpha)));
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Sprite Cache
+ *
+ * Overlay sprites (face filter accessories, speech bubbles) rendered once
+ * and composited every frame:
+ *
+ * - Sprites are stored premultiplied, one entry per (key, size), both as
+ *   BGRA and in the frame's BGR byte layout with the inverse alpha repeated
+ *   per byte, so compositing onto BGR is a flat byte loop without shuffles.
+ *   Callers quantize face-dependent sizes with QuantizeSize() (geometric
+ *   buckets, default 8 per octave = at most ~4.5% off), so a face moving
+ *   toward the camera re-renders a handful of times instead of every frame.
+ * - Each sprite row keeps the span of non-transparent pixels; compositing
+ *   skips everything outside it.
+ * - Composite() is the premultiplied "over" operator
+ *   (dst = src + dst * (255 - alpha) / 255, exact rounding) clipped to the
+ *   frame; 16 bytes per step with SSE2 on x86/x64, scalar elsewhere.
+ *
+ * Least recently used sprites are evicted beyond the entry limit.
+ */
+class SpriteCache {
+public:
+    struct Sprite {
+#ifdef HAVE_OPENCV
+        cv::Mat image;                  // Premultiplied BGRA
+#endif
+        std::vector<uint8_t> color;         // Premultiplied BGR, width * 3 bytes per row
+        std::vector<uint8_t> inverseAlpha;  // 255 - alpha, repeated for each of the 3 bytes
+        std::vector<int> spanBegin;         // Per row: first and one past last non-transparent column
+        std::vector<int> spanEnd;
+    };
+
+    SpriteCache();
+
+    // Size buckets per doubling (default 8)
+    void SetBucketsPerOctave(int buckets);
+    // Entries kept before the least recently used one is evicted (default 64)
+    void SetMaxEntries(size_t entries);
+
+    // Nearest bucket size for `pixels`
+    int QuantizeSize(int pixels) const;
+
+    // Forget every size of `key` (e.g. the bubble text changed)
+    void Invalidate(int key);
+    void Clear();
+
+    uint64_t GetHits() const { return m_hits; }
+    uint64_t GetMisses() const { return m_misses; }
+    size_t GetEntryCount() const { return m_entries.size(); }
+
+    // Premultiplied "over" of `count` bytes: frame = color + frame * inverseAlpha / 255
+    static void OverBytes(const uint8_t* color, const uint8_t* inverseAlpha, uint8_t* frame, int count);
+
+#ifdef HAVE_OPENCV
+    // Draws the sprite, premultiplied, into a zeroed BGRA image of the requested size.
+    // cv drawing calls on a transparent canvas already produce premultiplied pixels.
+    using Renderer = std::function<void(cv::Mat& bgra)>;
+
+    // Cached sprite `key` at width x height, rendered on a miss
+    const Sprite& Get(int key, int width, int height, const Renderer& render);
+
+    // Premultiply a straight-alpha BGRA image (PNG assets) in place
+    static void Premultiply(cv::Mat& bgra);
+
+    // Composite `sprite` with its top-left corner at `position`, clipped to an
+    // 8-bit BGR or BGRA frame (frame alpha untouched)
+    static void Composite(cv::Mat& frame, const Sprite& sprite, const cv::Point& position);
+#endif
+
+private:
+    struct Entry {
+        Sprite sprite;
+        uint64_t lastUse;
+    };
+
+    static uint64_t MakeKey(int key, int width, int height);
+    void Evict(size_t limit);
+
+    std::unordered_map<uint64_t, Entry> m_entries;
+    int m_bucketsPerOctave;
+    size_t m_maxEntries;
+    uint64_t m_clock;
+    uint64_t m_hits;
+    uint64_t m_misses;
+};
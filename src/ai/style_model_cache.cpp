@@ -0,0 +1,271 @@
+#include "style_model_cache.h"
+#include "logger.h"
+#include <chrono>
+#include <fstream>
+
+namespace {
+// Loaded networks hold weights plus optimized copies/workspaces; the file
+// size alone undercounts their footprint
+const size_t kLoadedModelOverhead = 2;
+}
+
+StyleModelCache::StyleModelCache()
+    : m_running(false),
+      m_warmupWidth(512),
+      m_warmupHeight(512),
+      m_budget(512ull * 1024 * 1024),
+      m_usage(0),
+      m_clock(0)
+{
+}
+
+StyleModelCache::~StyleModelCache()
+{
+    Stop();
+}
+
+void StyleModelCache::Start(const Loader& loader, int warmupWidth, int warmupHeight)
+{
+    Stop();
+
+    SetLoader(loader);
+    m_warmupWidth = warmupWidth;
+    m_warmupHeight = warmupHeight;
+    m_running = true;
+    m_worker = std::thread(&StyleModelCache::WorkerLoop, this);
+}
+
+void StyleModelCache::SetLoader(const Loader& loader)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loader = loader;
+}
+
+void StyleModelCache::Stop()
+{
+    if (m_running) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.clear();
+}
+
+void StyleModelCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_failed.clear();
+    m_usage = 0;
+}
+
+void StyleModelCache::SetMemoryBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = bytes;
+    EvictLocked(std::string());
+}
+
+void StyleModelCache::Preload(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_entries.count(path) > 0) {
+            return;
+        }
+        for (const auto& queued : m_queue) {
+            if (queued == path) {
+                return;
+            }
+        }
+        m_failed.erase(path);
+        m_queue.push_back(path);
+    }
+    m_wake.notify_all();
+}
+
+void StyleModelCache::Insert(const std::string& path, const std::shared_ptr<InferenceBackend>& backend,
+                             const ModelBytes& bytes)
+{
+    if (!backend) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries[path];
+    m_usage -= entry.cost;
+    entry.backend = backend;
+    entry.bytes = bytes;
+    entry.cost = bytes ? bytes->size() * kLoadedModelOverhead * backend->GetInstanceCount() : 0;
+    entry.lastUsed = ++m_clock;
+    m_usage += entry.cost;
+    EvictLocked(path);
+}
+
+std::shared_ptr<InferenceBackend> StyleModelCache::Get(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+    it->second.lastUsed = ++m_clock;
+    return it->second.backend;
+}
+
+StyleModelCache::ModelBytes StyleModelCache::GetBytes(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(path);
+    return it != m_entries.end() ? it->second.bytes : nullptr;
+}
+
+bool StyleModelCache::IsPending(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& queued : m_queue) {
+        if (queued == path) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StyleModelCache::HasFailed(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed.count(path) > 0;
+}
+
+size_t StyleModelCache::GetEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t StyleModelCache::GetMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+StyleModelCache::ModelBytes StyleModelCache::ReadModelFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return nullptr;
+    }
+
+    auto bytes = std::make_shared<std::vector<unsigned char>>(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes->data()), bytes->size())) {
+        return nullptr;
+    }
+    return bytes;
+}
+
+void StyleModelCache::WorkerLoop()
+{
+    while (true) {
+        std::string path;
+        Loader loader;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
+            if (!m_running) {
+                return;
+            }
+            // Stays queued while loading so IsPending() reports it
+            path = m_queue.front();
+            loader = m_loader;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::shared_ptr<InferenceBackend> backend;
+        ModelBytes bytes = ReadModelFile(path);
+
+        if (bytes) {
+            try {
+                backend = loader(path, bytes);
+
+#ifdef HAVE_OPENCV
+                // Warm-up: the first forward pass allocates and picks kernels
+                if (backend) {
+                    cv::Size fixed = backend->GetFixedInputSize();
+                    int blobShape[] = {1, 3, fixed.area() > 0 ? fixed.height : m_warmupHeight,
+                                       fixed.area() > 0 ? fixed.width : m_warmupWidth};
+                    cv::Mat dummy(4, blobShape, CV_32F, cv::Scalar(0));
+                    cv::Mat output;
+                    if (!backend->Run(dummy, output)) {
+                        backend.reset();
+                    }
+                }
+#endif
+            } catch (const std::exception& e) {
+                // cv::Exception and Ort::Exception both derive from std::exception
+                MS_LOG_ERROR("[StyleModelCache] Failed to load " << path << ": " << e.what());
+                backend.reset();
+            }
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_queue.empty() && m_queue.front() == path) {
+            m_queue.pop_front();
+        }
+        if (!m_running) {
+            return;
+        }
+
+        if (!backend) {
+            m_failed[path] = true;
+            MS_LOG_ERROR("[StyleModelCache] Could not preload " << path);
+            continue;
+        }
+
+        Entry& entry = m_entries[path];
+        m_usage -= entry.cost;
+        entry.backend = backend;
+        entry.bytes = bytes;
+        entry.cost = bytes->size() * kLoadedModelOverhead * backend->GetInstanceCount();
+        entry.lastUsed = ++m_clock;
+        m_usage += entry.cost;
+
+        MS_LOG_INFO("[StyleModelCache] Ready: " << path << " (" << InferenceBackend::GetTypeName(backend->GetType())
+                  << ", loaded + warmed up in " << static_cast<int>(ms) << "ms, cache "
+                  << m_usage / (1024 * 1024) << "/" << m_budget / (1024 * 1024) << " MB)");
+
+        EvictLocked(path);
+    }
+}
+
+void StyleModelCache::EvictLocked(const std::string& keep)
+{
+    while (m_usage > m_budget && m_entries.size() > 1) {
+        auto victim = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->first == keep) {
+                continue;
+            }
+            if (victim == m_entries.end() || it->second.lastUsed < victim->second.lastUsed) {
+                victim = it;
+            }
+        }
+        if (victim == m_entries.end()) {
+            return;
+        }
+
+        // The processor may still hold the engine; only the cache reference goes
+        MS_LOG_INFO("[StyleModelCache] Evicting " << victim->first);
+        m_usage -= victim->second.cost;
+        m_entries.erase(victim);
+    }
+}
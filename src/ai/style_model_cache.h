@@ -0,0 +1,101 @@
+#pragma once
+
+#include "inference_backend.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Style Model Cache
+ *
+ * Keeps several style networks loaded so switching styles mid-call does not
+ * block frames on model loading and graph optimization. Models are loaded on
+ * a background thread, warmed up with one dummy forward pass (so first-use
+ * allocations and kernel selection are already done), and evicted least
+ * recently used when the cache exceeds its memory budget.
+ *
+ * The raw model file is read once and kept with the entry; engines that can
+ * load from memory (ONNX) build every instance from those shared bytes.
+ */
+class StyleModelCache {
+public:
+    using ModelBytes = std::shared_ptr<const std::vector<unsigned char>>;
+
+    // Builds an engine for a model; runs on the cache thread
+    using Loader = std::function<std::shared_ptr<InferenceBackend>(const std::string& path, const ModelBytes& bytes)>;
+
+    StyleModelCache();
+    ~StyleModelCache();
+
+    StyleModelCache(const StyleModelCache&) = delete;
+    StyleModelCache& operator=(const StyleModelCache&) = delete;
+
+    // Start the loader thread; warm-up runs at the given network input size
+    void Start(const Loader& loader, int warmupWidth, int warmupHeight);
+    // Loader for models dequeued from now on (e.g. after engine settings changed)
+    void SetLoader(const Loader& loader);
+    void Stop();
+    void Clear();
+
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const { return m_budget; }
+
+    /**
+     * Queue a model for background loading (no-op if cached or queued)
+     */
+    void Preload(const std::string& path);
+
+    /**
+     * Add an already loaded engine (e.g. the one loaded by Initialize)
+     */
+    void Insert(const std::string& path, const std::shared_ptr<InferenceBackend>& backend, const ModelBytes& bytes);
+
+    /**
+     * Ready engine for a model, or nullptr if not loaded (yet)
+     */
+    std::shared_ptr<InferenceBackend> Get(const std::string& path);
+
+    // Cached bytes of a model file, if any
+    ModelBytes GetBytes(const std::string& path);
+
+    bool IsPending(const std::string& path) const;
+    bool HasFailed(const std::string& path) const;
+
+    size_t GetEntryCount() const;
+    size_t GetMemoryUsage() const;
+
+    static ModelBytes ReadModelFile(const std::string& path);
+
+private:
+    struct Entry {
+        std::shared_ptr<InferenceBackend> backend;
+        ModelBytes bytes;
+        size_t cost = 0;            // Bytes charged against the budget
+        uint64_t lastUsed = 0;
+    };
+
+    void WorkerLoop();
+    void EvictLocked(const std::string& keep);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::map<std::string, Entry> m_entries;
+    std::deque<std::string> m_queue;
+    std::map<std::string, bool> m_failed;
+    std::thread m_worker;
+    std::atomic<bool> m_running;
+    Loader m_loader;
+    int m_warmupWidth;
+    int m_warmupHeight;
+    size_t m_budget;
+    size_t m_usage;
+    uint64_t m_clock;
+};
@@ -0,0 +1,247 @@
+#include "tiled_upscaler.h"
+#include <algorithm>
+#include <atomic>
+
+TiledUpscaler::TiledUpscaler()
+    : m_tileSize(256),
+      m_overlap(16),
+      m_scale(4),
+      m_workers(2),
+      m_arenaDirty(true)
+{
+}
+
+void TiledUpscaler::SetTileSize(int tileSize)
+{
+    tileSize = std::max(32, std::min(1024, tileSize));
+    if (tileSize != m_tileSize) {
+        m_tileSize = tileSize;
+        m_overlap = std::min(m_overlap, m_tileSize / 4);
+        m_arenaDirty = true;
+    }
+}
+
+void TiledUpscaler::SetOverlap(int overlap)
+{
+    overlap = std::max(0, std::min(m_tileSize / 4, overlap));
+    if (overlap != m_overlap) {
+        m_overlap = overlap;
+        m_arenaDirty = true;
+    }
+}
+
+void TiledUpscaler::SetScale(int scale)
+{
+    scale = std::max(1, std::min(8, scale));
+    if (scale != m_scale) {
+        m_scale = scale;
+        m_arenaDirty = true;
+    }
+}
+
+void TiledUpscaler::SetWorkerCount(int workers)
+{
+    workers = std::max(1, std::min(16, workers));
+    if (workers != m_workers) {
+        m_workers = workers;
+        m_arenaDirty = true;
+    }
+}
+
+size_t TiledUpscaler::GetArenaBytes() const
+{
+    size_t inputFloats = 3 * static_cast<size_t>(m_tileSize) * m_tileSize;
+    size_t outputFloats = inputFloats * m_scale * m_scale;
+    return m_workers * (inputFloats + outputFloats) * sizeof(float);
+}
+
+#ifdef HAVE_OPENCV
+
+void TiledUpscaler::EnsureArena()
+{
+    if (!m_arenaDirty && static_cast<int>(m_arena.size()) == m_workers) {
+        return;
+    }
+
+    const int outSize = m_tileSize * m_scale;
+    m_arena.resize(m_workers);
+    for (auto& slot : m_arena) {
+        slot.padded.create(m_tileSize, m_tileSize, CV_8UC3);
+        slot.input.assign(3 * m_tileSize * m_tileSize, 0.0f);
+        slot.output.assign(3 * outSize * outSize, 0.0f);
+    }
+
+    // Separable linear ramp across the overlap band; strictly positive so the
+    // normalization below is defined even where only one tile contributes
+    std::vector<float> ramp(outSize, 1.0f);
+    const float band = static_cast<float>(std::max(1, m_overlap * m_scale));
+    for (int i = 0; i < outSize; ++i) {
+        float fromStart = (i + 0.5f) / band;
+        float fromEnd = (outSize - i - 0.5f) / band;
+        ramp[i] = std::min(1.0f, std::min(fromStart, fromEnd));
+    }
+
+    m_feather.create(outSize, outSize, CV_32F);
+    for (int y = 0; y < outSize; ++y) {
+        float* row = m_feather.ptr<float>(y);
+        for (int x = 0; x < outSize; ++x) {
+            row[x] = ramp[y] * ramp[x];
+        }
+    }
+
+    m_arenaDirty = false;
+}
+
+cv::Mat TiledUpscaler::Upscale(const cv::Mat& image, const TileInference& infer)
+{
+    if (image.empty() || image.type() != CV_8UC3 || !infer) {
+        return cv::Mat();
+    }
+
+    EnsureArena();
+
+    // Tile origins: step by (tile - overlap), last tile clamped to the edge
+    auto origins = [this](int length) {
+        std::vector<int> starts;
+        int step = std::max(1, m_tileSize - m_overlap);
+        int last = std::max(0, length - m_tileSize);
+        for (int s = 0; s < last; s += step) {
+            starts.push_back(s);
+        }
+        starts.push_back(last);
+        return starts;
+    };
+
+    std::vector<cv::Rect> tiles;
+    for (int y : origins(image.rows)) {
+        for (int x : origins(image.cols)) {
+            tiles.emplace_back(x, y, std::min(m_tileSize, image.cols - x), std::min(m_tileSize, image.rows - y));
+        }
+    }
+
+    // Accumulators are reused across frames of the same size
+    cv::Size outSize(image.cols * m_scale, image.rows * m_scale);
+    m_accum.create(outSize, CV_32FC3);
+    m_weightSum.create(outSize, CV_32F);
+    m_accum.setTo(cv::Scalar::all(0));
+    m_weightSum.setTo(cv::Scalar::all(0));
+
+    // One stripe per arena slot; each worker walks every m_workers-th tile
+    std::atomic<bool> failed(false);
+    const int workers = std::min(m_workers, static_cast<int>(tiles.size()));
+    cv::parallel_for_(cv::Range(0, workers), [&](const cv::Range& range) {
+        for (int w = range.start; w < range.end; ++w) {
+            for (size_t t = w; t < tiles.size() && !failed; t += workers) {
+                if (!ProcessTile(image, tiles[t], m_arena[w], infer)) {
+                    failed = true;
+                }
+            }
+        }
+    }, workers);
+
+    if (failed) {
+        return cv::Mat();
+    }
+
+    cv::Mat result(outSize, CV_8UC3);
+    for (int y = 0; y < outSize.height; ++y) {
+        const cv::Vec3f* acc = m_accum.ptr<cv::Vec3f>(y);
+        const float* wsum = m_weightSum.ptr<float>(y);
+        cv::Vec3b* out = result.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < outSize.width; ++x) {
+            float inv = wsum[x] > 0.0f ? 255.0f / wsum[x] : 0.0f;
+            out[x] = cv::Vec3b(cv::saturate_cast<uchar>(acc[x][0] * inv),
+                               cv::saturate_cast<uchar>(acc[x][1] * inv),
+                               cv::saturate_cast<uchar>(acc[x][2] * inv));
+        }
+    }
+
+    return result;
+}
+
+cv::Mat TiledUpscaler::UpscaleROI(const cv::Mat& image, const cv::Rect& roi, const TileInference& infer)
+{
+    cv::Rect bounds(0, 0, image.cols, image.rows);
+    cv::Rect region = roi & bounds;
+    if (region.area() <= 0) {
+        return cv::Mat();
+    }
+
+    // Pad by the overlap so the ROI edge sees real context, then crop it away
+    cv::Rect context(region.x - m_overlap, region.y - m_overlap,
+                     region.width + 2 * m_overlap, region.height + 2 * m_overlap);
+    context &= bounds;
+
+    cv::Mat upscaled = Upscale(image(context), infer);
+    if (upscaled.empty()) {
+        return cv::Mat();
+    }
+
+    cv::Rect inner((region.x - context.x) * m_scale, (region.y - context.y) * m_scale,
+                   region.width * m_scale, region.height * m_scale);
+    return upscaled(inner).clone();
+}
+
+bool TiledUpscaler::ProcessTile(const cv::Mat& image, const cv::Rect& tile, TileArena& arena,
+                                const TileInference& infer)
+{
+    const int T = m_tileSize;
+    const int plane = T * T;
+
+    // Fixed-shape input: edge tiles smaller than T are padded by replication
+    if (tile.width == T && tile.height == T) {
+        image(tile).copyTo(arena.padded);
+    } else {
+        cv::copyMakeBorder(image(tile), arena.padded, 0, T - tile.height, 0, T - tile.width,
+                           cv::BORDER_REPLICATE);
+    }
+
+    // BGR interleaved -> RGB planar, normalized
+    float* r = arena.input.data();
+    float* g = r + plane;
+    float* b = g + plane;
+    const float norm = 1.0f / 255.0f;
+    for (int y = 0; y < T; ++y) {
+        const cv::Vec3b* row = arena.padded.ptr<cv::Vec3b>(y);
+        int offset = y * T;
+        for (int x = 0; x < T; ++x) {
+            b[offset + x] = row[x][0] * norm;
+            g[offset + x] = row[x][1] * norm;
+            r[offset + x] = row[x][2] * norm;
+        }
+    }
+
+    if (!infer(arena.input.data(), arena.output.data(), T, m_scale)) {
+        return false;
+    }
+
+    // Accumulate only the valid (unpadded) part of the output tile
+    const int outT = T * m_scale;
+    const int outPlane = outT * outT;
+    const int validW = tile.width * m_scale;
+    const int validH = tile.height * m_scale;
+    const int dstX = tile.x * m_scale;
+    const int dstY = tile.y * m_scale;
+    const float* outR = arena.output.data();
+    const float* outG = outR + outPlane;
+    const float* outB = outG + outPlane;
+
+    std::lock_guard<std::mutex> lock(m_accumMutex);
+    for (int y = 0; y < validH; ++y) {
+        const float* weight = m_feather.ptr<float>(y);
+        cv::Vec3f* acc = m_accum.ptr<cv::Vec3f>(dstY + y) + dstX;
+        float* wsum = m_weightSum.ptr<float>(dstY + y) + dstX;
+        int offset = y * outT;
+        for (int x = 0; x < validW; ++x) {
+            float w = weight[x];
+            acc[x][0] += outB[offset + x] * w;
+            acc[x][1] += outG[offset + x] * w;
+            acc[x][2] += outR[offset + x] * w;
+            wsum[x] += w;
+        }
+    }
+
+    return true;
+}
+
+#endif  // HAVE_OPENCV
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Tiled Upscaler
+ *
+ * Runs a super-resolution model over fixed-size overlapping tiles instead of
+ * the whole frame, so activation memory is bounded by the tile size rather
+ * than the frame size. Tiles are blended with feathered weights across the
+ * overlap band (no visible seams) and executed in parallel, each worker owning
+ * a preallocated slot in a fixed tile arena.
+ *
+ * Every tile has the same shape (edge tiles are padded), so models exported
+ * with a static input size work as well as dynamic ones.
+ */
+class TiledUpscaler {
+public:
+    /**
+     * Runs the model on one tile. Buffers are planar RGB floats in [0, 1]:
+     * input is 1x3xTxT, output is 1x3x(T*scale)x(T*scale).
+     * Called concurrently from several workers with distinct buffers.
+     */
+    using TileInference = std::function<bool(const float* input, float* output, int tileSize, int scale)>;
+
+    TiledUpscaler();
+
+    void SetTileSize(int tileSize);     // Input tile edge (32-1024)
+    void SetOverlap(int overlap);       // Overlap in input pixels (0 to tileSize / 4)
+    void SetScale(int scale);           // Model upscale factor (1-8)
+    void SetWorkerCount(int workers);   // Parallel tiles in flight (1-16)
+
+    int GetTileSize() const { return m_tileSize; }
+    int GetOverlap() const { return m_overlap; }
+    int GetScale() const { return m_scale; }
+    int GetWorkerCount() const { return m_workers; }
+
+    // Bytes held by the tile arena (input + output tensors of every worker)
+    size_t GetArenaBytes() const;
+
+#ifdef HAVE_OPENCV
+    /**
+     * Upscale a whole BGR image
+     * @return Upscaled image, or empty Mat if any tile failed
+     */
+    cv::Mat Upscale(const cv::Mat& image, const TileInference& infer);
+
+    /**
+     * Upscale only a region of the image (e.g. the face). Context pixels
+     * around the ROI are included so the region border is seam-free.
+     * @return Upscaled ROI (roi.size() * scale), or empty Mat on failure
+     */
+    cv::Mat UpscaleROI(const cv::Mat& image, const cv::Rect& roi, const TileInference& infer);
+#endif
+
+private:
+#ifdef HAVE_OPENCV
+    struct TileArena {
+        cv::Mat padded;                 // BGR tile padded to tileSize x tileSize
+        std::vector<float> input;       // 3 x T x T
+        std::vector<float> output;      // 3 x sT x sT
+    };
+
+    void EnsureArena();
+    bool ProcessTile(const cv::Mat& image, const cv::Rect& tile, TileArena& arena, const TileInference& infer);
+
+    std::vector<TileArena> m_arena;
+    cv::Mat m_feather;                  // sT x sT blend weights, CV_32F
+    cv::Mat m_accum;                    // Weighted BGR sum, CV_32FC3
+    cv::Mat m_weightSum;                // CV_32F
+    std::mutex m_accumMutex;
+#endif
+
+    int m_tileSize;
+    int m_overlap;
+    int m_scale;
+    int m_workers;
+    bool m_arenaDirty;
+};
@@ -0,0 +1,143 @@
+#include "video_target_source.h"
+#include "logger.h"
+#include <algorithm>
+
+VideoTargetSource::VideoTargetSource()
+    : m_head(0),
+      m_count(0),
+      m_running(false),
+      m_underruns(0),
+      m_frameCount(0),
+      m_fps(0.0)
+{
+}
+
+VideoTargetSource::~VideoTargetSource()
+{
+    Close();
+}
+
+void VideoTargetSource::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_notFull.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+#ifdef HAVE_OPENCV
+    if (m_capture.isOpened()) {
+        m_capture.release();
+    }
+    m_ring.clear();
+    m_detector = nullptr;
+#endif
+
+    m_head = 0;
+    m_count = 0;
+}
+
+#ifdef HAVE_OPENCV
+
+bool VideoTargetSource::Open(const std::string& path, int capacity, FaceDetector detector)
+{
+    Close();
+
+    if (!m_capture.open(path)) {
+        MS_LOG_ERROR("[VideoTargetSource] Failed to open video: " << path);
+        return false;
+    }
+
+    m_frameCount = static_cast<int>(m_capture.get(cv::CAP_PROP_FRAME_COUNT));
+    m_fps = m_capture.get(cv::CAP_PROP_FPS);
+    m_detector = std::move(detector);
+    m_ring.assign(std::max(2, std::min(64, capacity)), DecodedFrame());
+    m_head = 0;
+    m_count = 0;
+    m_underruns = 0;
+
+    m_running = true;
+    m_thread = std::thread(&VideoTargetSource::DecodeLoop, this);
+
+    MS_LOG_INFO("[VideoTargetSource] Decoding " << path << " (" << m_frameCount << " frames @ "
+              << m_fps << " fps), ring size " << m_ring.size()
+              << (m_detector ? ", detecting faces on decode thread" : ""));
+    return true;
+}
+
+bool VideoTargetSource::TryGetNextFrame(DecodedFrame& frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count == 0) {
+            m_underruns++;
+            return false;
+        }
+
+        // Swap buffers instead of copying: the caller's previous image becomes
+        // the decode target for a future frame
+        DecodedFrame& slot = m_ring[m_head];
+        cv::swap(frame.image, slot.image);
+        frame.faces.swap(slot.faces);
+        frame.frameIndex = slot.frameIndex;
+        frame.facesValid = slot.facesValid;
+
+        m_head = (m_head + 1) % m_ring.size();
+        m_count--;
+    }
+    m_notFull.notify_one();
+    return true;
+}
+
+void VideoTargetSource::DecodeLoop()
+{
+    int frameIndex = 0;
+    cv::Mat decoded;
+    std::vector<cv::Rect> faces;
+
+    while (m_running) {
+        // Decode and detect outside the lock - only the slot handoff is serialized
+        if (!m_capture.read(decoded) || decoded.empty()) {
+            // Loop video
+            m_capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+            frameIndex = 0;
+            if (!m_capture.read(decoded) || decoded.empty()) {
+                MS_LOG_ERROR("[VideoTargetSource] Decoder produced no frames, stopping");
+                m_running = false;
+                break;
+            }
+        }
+
+        bool facesValid = false;
+        faces.clear();
+        if (m_detector) {
+            try {
+                faces = m_detector(decoded);
+                facesValid = true;
+            } catch (const std::exception& e) {
+                MS_LOG_ERROR("[VideoTargetSource] Face detection failed: " << e.what());
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]() { return m_count < m_ring.size() || !m_running; });
+        if (!m_running) {
+            break;
+        }
+
+        DecodedFrame& slot = m_ring[(m_head + m_count) % m_ring.size()];
+        cv::swap(slot.image, decoded);
+        slot.faces.swap(faces);
+        slot.frameIndex = frameIndex;
+        slot.facesValid = facesValid;
+        m_count++;
+
+        frameIndex++;
+    }
+}
+
+#endif  // HAVE_OPENCV
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+/**
+ * Video Target Source
+ *
+ * Decodes a target-person video clip on a background thread into a bounded
+ * ring of frames, so the camera thread never waits on the decoder.
+ * The clip loops at end of stream.
+ *
+ * An optional face detector runs on the decode thread for every frame, so the
+ * consumer receives frames together with their face boxes. When the clip has
+ * a precomputed face index (see FaceIndex), no detector is needed.
+ */
+class VideoTargetSource {
+public:
+#ifdef HAVE_OPENCV
+    using FaceDetector = std::function<std::vector<cv::Rect>(const cv::Mat&)>;
+
+    struct DecodedFrame {
+        cv::Mat image;
+        int frameIndex = -1;
+        std::vector<cv::Rect> faces;
+        bool facesValid = false;    // true if the decode thread ran the detector
+    };
+#endif
+
+    VideoTargetSource();
+    ~VideoTargetSource();
+
+    VideoTargetSource(const VideoTargetSource&) = delete;
+    VideoTargetSource& operator=(const VideoTargetSource&) = delete;
+
+#ifdef HAVE_OPENCV
+    /**
+     * Open the clip and start the decode thread
+     * @param path Video file path
+     * @param capacity Number of decoded frames kept ahead (2-64)
+     * @param detector Optional face detector run on the decode thread
+     */
+    bool Open(const std::string& path, int capacity = 8, FaceDetector detector = nullptr);
+
+    /**
+     * Take the next decoded frame without blocking.
+     * The previous contents of `frame` are recycled as a decode buffer.
+     * @return false if the decoder has not produced a new frame yet
+     */
+    bool TryGetNextFrame(DecodedFrame& frame);
+#endif
+
+    void Close();
+    bool IsOpen() const { return m_running.load(); }
+
+    int GetFrameCount() const { return m_frameCount; }
+    double GetFPS() const { return m_fps; }
+
+    // Number of times the consumer found the ring empty
+    uint64_t GetUnderrunCount() const { return m_underruns.load(); }
+
+private:
+#ifdef HAVE_OPENCV
+    void DecodeLoop();
+
+    cv::VideoCapture m_capture;
+    FaceDetector m_detector;
+    std::vector<DecodedFrame> m_ring;
+#endif
+
+    size_t m_head;      // Next slot to read
+    size_t m_count;     // Decoded frames waiting in the ring
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_underruns;
+
+    int m_frameCount;
+    double m_fps;
+};
@@ -1,6 +1,6 @@
 #include "virtual_background_processor.h"
+#include "logger.h"
 #include <windows.h>
-#include <iostream>
 #include <fstream>
 #include <chrono>
 #include <cmath>
@@ -22,9 +22,15 @@ VirtualBackgroundProcessor::VirtualBackgroundProcessor()
       m_segmentationMethod(METHOD_ONNX_SELFIE),  // Default fallback method
       m_useGPU(true),  // Enable GPU by default
       m_useGuidedFilter(true),
-      m_backend("CPU")
+      m_backend("CPU"),
+      m_letterboxSize(256),
+      m_letterboxDynamic(false),
+      m_adaptiveLetterbox(false)
 {
-    std::cout << "[VirtualBackgroundProcessor] Initializing..." << std::endl;
+    m_letterboxController.SetLadder({160, 192, 224, 256, 320, 384});
+    m_letterboxController.SetCurrentSize(m_letterboxSize);
+    m_letterboxController.SetBudget(15.0);
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Initializing...");
 }
 
 VirtualBackgroundProcessor::~VirtualBackgroundProcessor()
@@ -34,7 +40,7 @@ VirtualBackgroundProcessor::~VirtualBackgroundProcessor()
 
 bool VirtualBackgroundProcessor::Initialize()
 {
-    std::cout << "[VirtualBackgroundProcessor] Initialize called" << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Initialize called");
 
 #ifdef HAVE_OPENCV
     try {
@@ -57,7 +63,7 @@ bool VirtualBackgroundProcessor::Initialize()
         bool modelFound = false;
         for (const auto& [path, name] : modelPaths) {
             if (std::ifstream(path).good()) {
-                std::cout << "[VirtualBackgroundProcessor] Found model: " << name << std::endl;
+                MS_LOG_INFO("[VirtualBackgroundProcessor] Found model: " << name);
                 
                 if (path.find(".onnx") != std::string::npos) {
 #ifdef HAVE_ONNX
@@ -65,18 +71,18 @@ bool VirtualBackgroundProcessor::Initialize()
                         m_segmentationMethod = METHOD_ONNX_SELFIE;
                         m_modelPath = path;
                         modelFound = true;
-                        std::cout << "[VirtualBackgroundProcessor] ✅ Using ONNX model: " << name << std::endl;
+                        MS_LOG_INFO("[VirtualBackgroundProcessor] ✅ Using ONNX model: " << name);
                         break;
                     }
 #else
-                    std::cout << "[VirtualBackgroundProcessor] ⚠️  ONNX model found but ONNX Runtime not available" << std::endl;
+                    MS_LOG_INFO("[VirtualBackgroundProcessor] ⚠️  ONNX model found but ONNX Runtime not available");
 #endif
                 } else if (path.find(".pb") != std::string::npos) {
                     if (LoadSegmentationModelOpenCVDNN(path)) {
                         m_segmentationMethod = METHOD_OPENCV_DNN;
                         m_modelPath = path;
                         modelFound = true;
-                        std::cout << "[VirtualBackgroundProcessor] ✅ Using OpenCV DNN model: " << name << std::endl;
+                        MS_LOG_INFO("[VirtualBackgroundProcessor] ✅ Using OpenCV DNN model: " << name);
                         break;
                     }
                 }
@@ -84,35 +90,35 @@ bool VirtualBackgroundProcessor::Initialize()
         }
         
         if (!modelFound) {
-            std::cout << "[VirtualBackgroundProcessor] ⚠️  No segmentation model found, using motion detection fallback" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor] 💡 For better quality, download MediaPipe Selfie Segmentation:" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor]    Run: .\\scripts\\download_segmentation_model.ps1" << std::endl;
+            MS_LOG_INFO("[VirtualBackgroundProcessor] ⚠️  No segmentation model found, using motion detection fallback");
+            MS_LOG_INFO("[VirtualBackgroundProcessor] 💡 For better quality, download MediaPipe Selfie Segmentation:");
+            MS_LOG_INFO("[VirtualBackgroundProcessor]    Run: .\\scripts\\download_segmentation_model.ps1");
             m_segmentationMethod = METHOD_MOTION;
         }
         
-        std::cout << "[VirtualBackgroundProcessor] Processor initialized successfully" << std::endl;
-        std::cout << "[VirtualBackgroundProcessor] Configuration:" << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   Background Mode: " << (int)m_backgroundMode << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   Segmentation Method: " << (m_segmentationMethod == METHOD_ONNX_SELFIE ? "ONNX" : m_segmentationMethod == METHOD_OPENCV_DNN ? "OpenCV DNN" : "Motion+Face") << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   Segmentation Threshold: " << m_segmentationThreshold << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   Blend Alpha: " << m_blendAlpha << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   GPU Enabled: " << (m_useGPU ? "YES" : "NO") << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   Backend: " << m_backend << std::endl;
+        MS_LOG_INFO("[VirtualBackgroundProcessor] Processor initialized successfully");
+        MS_LOG_INFO("[VirtualBackgroundProcessor] Configuration:");
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Background Mode: " << (int)m_backgroundMode);
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Segmentation Method: " << (m_segmentationMethod == METHOD_ONNX_SELFIE ? "ONNX" : m_segmentationMethod == METHOD_OPENCV_DNN ? "OpenCV DNN" : "Motion+Face"));
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Segmentation Threshold: " << m_segmentationThreshold);
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Blend Alpha: " << m_blendAlpha);
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   GPU Enabled: " << (m_useGPU ? "YES" : "NO"));
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Backend: " << m_backend);
         
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "[VirtualBackgroundProcessor] Exception during initialization: " << e.what() << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] Exception during initialization: " << e.what());
         return false;
     }
 #else
-    std::cerr << "[VirtualBackgroundProcessor] ERROR: OpenCV not available" << std::endl;
+    MS_LOG_ERROR("[VirtualBackgroundProcessor] ERROR: OpenCV not available");
     return false;
 #endif
 }
 
 void VirtualBackgroundProcessor::Cleanup()
 {
-    std::cout << "[VirtualBackgroundProcessor] Cleanup called" << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Cleanup called");
     m_backgroundImage.release();
     m_cachedBackground.release();
     m_modelLoaded = false;
@@ -149,6 +155,16 @@ Frame VirtualBackgroundProcessor::ProcessFrame(const Frame& input)
 
 #ifdef HAVE_OPENCV
 
+cv::Mat VirtualBackgroundProcessor::ComputePersonMask(const cv::Mat& frame)
+{
+    // Same mask ProcessFrame composites with, for processors that only need
+    // to know where the person is
+    if (frame.empty()) {
+        return cv::Mat();
+    }
+    return SegmentPerson(frame);
+}
+
 cv::Mat VirtualBackgroundProcessor::SegmentPerson(const cv::Mat& frame)
 {
     cv::Mat mask;
@@ -179,7 +195,7 @@ cv::Mat VirtualBackgroundProcessor::SegmentPerson(const cv::Mat& frame)
 
 cv::Mat VirtualBackgroundProcessor::DetectPersonUsingMotionAndFace(const cv::Mat& frame)
 {
-    std::cout << "[VirtualBackgroundProcessor] Using motion + face detection for segmentation" << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Using motion + face detection for segmentation");
     
     cv::Mat mask = cv::Mat::zeros(frame.size(), CV_8U);
     cv::Mat personMask = cv::Mat::zeros(frame.size(), CV_8U);
@@ -195,7 +211,7 @@ cv::Mat VirtualBackgroundProcessor::DetectPersonUsingMotionAndFace(const cv::Mat
         
         m_previousFrame = frame.clone();
         m_bgSubtractorInitialized = true;
-        std::cout << "[VirtualBackgroundProcessor] Background subtractor initialized" << std::endl;
+        MS_LOG_INFO("[VirtualBackgroundProcessor] Background subtractor initialized");
         
         // Return center ellipse for first frame
         cv::Point center(frame.cols / 2, frame.rows / 2);
@@ -275,11 +291,11 @@ cv::Mat VirtualBackgroundProcessor::DetectPersonUsingMotionAndFace(const cv::Mat
                 cv::drawContours(personMask, validContours, bestIdx, cv::Scalar(255), -1);
                 personDetected = true;
                 
-                std::cout << "[VirtualBackgroundProcessor] Selected contour " << bestIdx 
-                          << " from " << validContours.size() << " valid contours" << std::endl;
+                MS_LOG_DEBUG("[VirtualBackgroundProcessor] Selected contour " << bestIdx 
+                          << " from " << validContours.size() << " valid contours");
             }
             
-            std::cout << "[VirtualBackgroundProcessor] Detected person contour from motion" << std::endl;
+            MS_LOG_DEBUG("[VirtualBackgroundProcessor] Detected person contour from motion");
         }
     }
     
@@ -319,7 +335,7 @@ cv::Mat VirtualBackgroundProcessor::DetectPersonUsingMotionAndFace(const cv::Mat
             
             // If no motion detected but face found, create body estimate
             if (!personDetected) {
-                std::cout << "[VirtualBackgroundProcessor] No motion contour, using face detection" << std::endl;
+                MS_LOG_DEBUG("[VirtualBackgroundProcessor] No motion contour, using face detection");
                 
                 // More conservative body estimation
                 int bodyWidth = static_cast<int>(largestFace.width * 2.5);
@@ -357,7 +373,7 @@ cv::Mat VirtualBackgroundProcessor::DetectPersonUsingMotionAndFace(const cv::Mat
     
     // Step 6: Last resort fallback to center region (only if really nothing detected)
     if (!personDetected) {
-        std::cout << "[VirtualBackgroundProcessor] No detection, using center fallback" << std::endl;
+        MS_LOG_DEBUG("[VirtualBackgroundProcessor] No detection, using center fallback");
         cv::Point center(frame.cols / 2, frame.rows / 2);
         cv::Size axes(frame.cols / 5, frame.rows / 3);  // Smaller fallback
         cv::ellipse(personMask, center, axes, 0, 0, 360, cv::Scalar(255), -1);
@@ -397,10 +413,10 @@ cv::Mat VirtualBackgroundProcessor::DetectPersonUsingMotionAndFace(const cv::Mat
         // Blend current and previous masks
         cv::addWeighted(refinedMask, alpha, prevMaskFloat, beta, 0.0, refinedMask);
         
-        std::cout << "[VirtualBackgroundProcessor] Temporal smoothing: alpha=" << alpha 
-                  << ", stable_frames=" << m_stableFrameCount << std::endl;
+        MS_LOG_DEBUG("[VirtualBackgroundProcessor] Temporal smoothing: alpha=" << alpha 
+                  << ", stable_frames=" << m_stableFrameCount);
     } else {
-        std::cout << "[VirtualBackgroundProcessor] First mask, no temporal smoothing" << std::endl;
+        MS_LOG_DEBUG("[VirtualBackgroundProcessor] First mask, no temporal smoothing");
     }
     
     // Apply bilateral filter to preserve edges while smoothing
@@ -414,9 +430,9 @@ cv::Mat VirtualBackgroundProcessor::DetectPersonUsingMotionAndFace(const cv::Mat
     // Store current mask for next frame
     m_previousMask = personMask.clone();
     
-    std::cout << "[VirtualBackgroundProcessor] Person mask: " << nonZeroPixels << " / " << totalPixels 
+    MS_LOG_DEBUG("[VirtualBackgroundProcessor] Person mask: " << nonZeroPixels << " / " << totalPixels 
               << " (" << percentage << "%) - Detection: " 
-              << (personDetected ? "Motion/Face" : "Fallback") << std::endl;
+              << (personDetected ? "Motion/Face" : "Fallback"));
     
     return personMask;
 }
@@ -425,7 +441,7 @@ cv::Mat VirtualBackgroundProcessor::GetBackgroundFrame(const cv::Mat& frame)
 {
     cv::Mat background = frame.clone();
     
-    std::cout << "[VirtualBackgroundProcessor::GetBackgroundFrame] Mode=" << (int)m_backgroundMode << std::endl;
+    MS_LOG_DEBUG("[VirtualBackgroundProcessor::GetBackgroundFrame] Mode=" << (int)m_backgroundMode);
     
     switch (m_backgroundMode) {
         case BLUR: {
@@ -435,15 +451,15 @@ cv::Mat VirtualBackgroundProcessor::GetBackgroundFrame(const cv::Mat& frame)
             kernelSize = std::max(3, std::min(kernelSize, 99));
             
             cv::GaussianBlur(frame, background, cv::Size(kernelSize, kernelSize), 0);
-            std::cout << "[VirtualBackgroundProcessor] Applying BLUR mode, kernel=" << kernelSize << std::endl;
+            MS_LOG_DEBUG("[VirtualBackgroundProcessor] Applying BLUR mode, kernel=" << kernelSize);
             break;
         }
         
         case SOLID_COLOR: {
             // Create solid color background
             background = cv::Mat(frame.size(), frame.type(), m_solidColor);
-            std::cout << "[VirtualBackgroundProcessor] Applying SOLID_COLOR mode: (" 
-                      << m_solidColor[0] << "," << m_solidColor[1] << "," << m_solidColor[2] << ")" << std::endl;
+            MS_LOG_DEBUG("[VirtualBackgroundProcessor] Applying SOLID_COLOR mode: (" 
+                      << m_solidColor[0] << "," << m_solidColor[1] << "," << m_solidColor[2] << ")");
             break;
         }
         
@@ -451,9 +467,9 @@ cv::Mat VirtualBackgroundProcessor::GetBackgroundFrame(const cv::Mat& frame)
             // Use custom background image
             if (!m_backgroundImage.empty()) {
                 background = ResizeBackgroundToFrame(frame);
-                std::cout << "[VirtualBackgroundProcessor] Applying CUSTOM_IMAGE mode" << std::endl;
+                MS_LOG_DEBUG("[VirtualBackgroundProcessor] Applying CUSTOM_IMAGE mode");
             } else {
-                std::cout << "[VirtualBackgroundProcessor] CUSTOM_IMAGE: No image loaded, fallback to blur" << std::endl;
+                MS_LOG_DEBUG("[VirtualBackgroundProcessor] CUSTOM_IMAGE: No image loaded, fallback to blur");
                 // Fallback to blur
                 int kernelSize = std::max(3, std::min(m_blurStrength, 99));
                 if (kernelSize % 2 == 0) kernelSize++;
@@ -464,13 +480,13 @@ cv::Mat VirtualBackgroundProcessor::GetBackgroundFrame(const cv::Mat& frame)
         
         case DESKTOP_CAPTURE: {
             // Use desktop screenshot as background
-            std::cout << "[VirtualBackgroundProcessor] DESKTOP_CAPTURE: Capturing desktop..." << std::endl;
+            MS_LOG_DEBUG("[VirtualBackgroundProcessor] DESKTOP_CAPTURE: Capturing desktop...");
             CaptureDesktopBackground();
             if (!m_backgroundImage.empty()) {
                 background = ResizeBackgroundToFrame(frame);
-                std::cout << "[VirtualBackgroundProcessor] Desktop captured and applied" << std::endl;
+                MS_LOG_DEBUG("[VirtualBackgroundProcessor] Desktop captured and applied");
             } else {
-                std::cout << "[VirtualBackgroundProcessor] DESKTOP_CAPTURE: Failed, fallback to solid color" << std::endl;
+                MS_LOG_DEBUG("[VirtualBackgroundProcessor] DESKTOP_CAPTURE: Failed, fallback to solid color");
                 // Fallback to solid color
                 background = cv::Mat(frame.size(), frame.type(), m_solidColor);
             }
@@ -480,7 +496,7 @@ cv::Mat VirtualBackgroundProcessor::GetBackgroundFrame(const cv::Mat& frame)
         case MINECRAFT_PIXEL: {
             // Create Minecraft-style pixelated background
             background = CreateMinecraftPixelBackground(frame);
-            std::cout << "[VirtualBackgroundProcessor] Applying MINECRAFT_PIXEL mode" << std::endl;
+            MS_LOG_DEBUG("[VirtualBackgroundProcessor] Applying MINECRAFT_PIXEL mode");
             break;
         }
         
@@ -600,7 +616,7 @@ void VirtualBackgroundProcessor::CaptureDesktopBackground()
     // Get desktop DC
     HDC desktopDC = GetDC(nullptr);
     if (!desktopDC) {
-        std::cerr << "[VirtualBackgroundProcessor] Failed to get desktop DC" << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] Failed to get desktop DC");
         return;
     }
     
@@ -631,7 +647,7 @@ void VirtualBackgroundProcessor::CaptureDesktopBackground()
     // Convert BGR (GetDIBits returns RGB)
     cv::cvtColor(screenshot, m_backgroundImage, cv::COLOR_RGB2BGR);
     
-    std::cout << "[VirtualBackgroundProcessor] Desktop captured: " << screenWidth << "x" << screenHeight << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Desktop captured: " << screenWidth << "x" << screenHeight);
     
     // Cleanup
     DeleteObject(memBitmap);
@@ -644,12 +660,12 @@ bool VirtualBackgroundProcessor::LoadBackgroundImage(const std::string& imagePat
     m_backgroundImage = cv::imread(imagePath);
     
     if (m_backgroundImage.empty()) {
-        std::cerr << "[VirtualBackgroundProcessor] Failed to load image: " << imagePath << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] Failed to load image: " << imagePath);
         return false;
     }
     
-    std::cout << "[VirtualBackgroundProcessor] Background image loaded: " << imagePath << std::endl;
-    std::cout << "[VirtualBackgroundProcessor] Image size: " << m_backgroundImage.cols << "x" << m_backgroundImage.rows << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Background image loaded: " << imagePath);
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Image size: " << m_backgroundImage.cols << "x" << m_backgroundImage.rows);
     
     // Reset cache to force resize on next frame
     m_cachedWidth = 0;
@@ -677,18 +693,18 @@ bool VirtualBackgroundProcessor::LoadSegmentationModelONNX(const std::string& mo
                 OrtCUDAProviderOptions cuda_options;
                 m_sessionOptions->AppendExecutionProvider_CUDA(cuda_options);
                 m_backend = "CUDA";
-                std::cout << "[VirtualBackgroundProcessor] GPU acceleration enabled (CUDA)" << std::endl;
+                MS_LOG_INFO("[VirtualBackgroundProcessor] GPU acceleration enabled (CUDA)");
                 #elif defined(USE_DIRECTML)
                 m_sessionOptions->AppendExecutionProvider_DML(0);
                 m_backend = "DirectML";
-                std::cout << "[VirtualBackgroundProcessor] GPU acceleration enabled (DirectML)" << std::endl;
+                MS_LOG_INFO("[VirtualBackgroundProcessor] GPU acceleration enabled (DirectML)");
                 #else
                 m_backend = "CPU";
-                std::cout << "[VirtualBackgroundProcessor] GPU requested but no provider available, using CPU" << std::endl;
+                MS_LOG_INFO("[VirtualBackgroundProcessor] GPU requested but no provider available, using CPU");
                 #endif
             } catch (...) {
                 m_backend = "CPU";
-                std::cout << "[VirtualBackgroundProcessor] GPU initialization failed, using CPU" << std::endl;
+                MS_LOG_INFO("[VirtualBackgroundProcessor] GPU initialization failed, using CPU");
             }
         } else {
             m_backend = "CPU";
@@ -710,17 +726,32 @@ bool VirtualBackgroundProcessor::LoadSegmentationModelONNX(const std::string& mo
         Ort::AllocatorWithDefaultOptions allocator;
         m_onnxInputName = m_onnxSession->GetInputNameAllocated(0, allocator).get();
         m_onnxOutputName = m_onnxSession->GetOutputNameAllocated(0, allocator).get();
+
+        // NCHW input: fixed H/W pins the letterbox size (MediaPipe selfie is
+        // 256x256), symbolic dims (-1) let the controller pick it per frame
+        auto inputShape = m_onnxSession->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (inputShape.size() == 4 && inputShape[2] > 0 && inputShape[3] > 0) {
+            m_letterboxSize = static_cast<int>(inputShape[2]);
+            m_letterboxDynamic = false;
+        } else {
+            m_letterboxSize = 256;
+            m_letterboxDynamic = true;
+        }
+        m_letterboxController.SetCurrentSize(m_letterboxSize);
+        m_letterboxController.SetEnabled(m_adaptiveLetterbox && m_letterboxDynamic);
         
         m_modelLoaded = true;
-        std::cout << "[VirtualBackgroundProcessor] ONNX model loaded successfully" << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   Input name: " << m_onnxInputName << std::endl;
-        std::cout << "[VirtualBackgroundProcessor]   Output name: " << m_onnxOutputName << std::endl;
-        std::cout << "[VirtualBackgroundProcessor] Backend: " << m_backend << std::endl;
+        MS_LOG_INFO("[VirtualBackgroundProcessor] ONNX model loaded successfully");
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Input name: " << m_onnxInputName);
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Output name: " << m_onnxOutputName);
+        MS_LOG_INFO("[VirtualBackgroundProcessor]   Input size: " << m_letterboxSize
+                  << (m_letterboxDynamic ? " (dynamic)" : " (fixed)"));
+        MS_LOG_INFO("[VirtualBackgroundProcessor] Backend: " << m_backend);
         
         return true;
         
     } catch (const Ort::Exception& e) {
-        std::cerr << "[VirtualBackgroundProcessor] ONNX error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] ONNX error: " << e.what());
         return false;
     }
 }
@@ -732,11 +763,12 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithONNX(const cv::Mat& frame)
     }
     
     try {
-        // MediaPipe Selfie Segmentation expects 256x256 input
-        const int inputSize = 256;
+        // Square letterbox: the model's fixed size, or the adaptive size for
+        // dynamic-shape models
+        const int inputSize = m_letterboxSize;
         
         // IMPORTANT: Use letterboxing to preserve aspect ratio
-        // Calculate scale to fit frame into 256x256 square with higher precision
+        // Calculate scale to fit frame into the square with higher precision
         double scale = std::min(
             static_cast<double>(inputSize) / frame.cols,
             static_cast<double>(inputSize) / frame.rows
@@ -754,7 +786,7 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithONNX(const cv::Mat& frame)
         cv::Mat scaled;
         cv::resize(frame, scaled, cv::Size(scaledWidth, scaledHeight), 0, 0, cv::INTER_AREA);
         
-        // Create 256x256 canvas and center the scaled image (letterboxing)
+        // Create square canvas and center the scaled image (letterboxing)
         // CRITICAL: Use integer division for offsets (consistent with crop operation)
         // If we use rounding here, we must use the SAME offsets when cropping
         cv::Mat letterboxed = cv::Mat::zeros(inputSize, inputSize, frame.type());
@@ -764,11 +796,11 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithONNX(const cv::Mat& frame)
         // Debug output (first frame only)
         static bool debugPrinted = false;
         if (!debugPrinted) {
-            std::cout << "[VirtualBackgroundProcessor] Letterbox math:" << std::endl;
-            std::cout << "  Original: " << frame.cols << "x" << frame.rows << std::endl;
-            std::cout << "  Scale: " << scale << std::endl;
-            std::cout << "  Scaled: " << scaledWidth << "x" << scaledHeight << std::endl;
-            std::cout << "  Offset: (" << offsetX << ", " << offsetY << ")" << std::endl;
+            MS_LOG_INFO("[VirtualBackgroundProcessor] Letterbox math:");
+            MS_LOG_INFO("  Original: " << frame.cols << "x" << frame.rows);
+            MS_LOG_INFO("  Scale: " << scale);
+            MS_LOG_INFO("  Scaled: " << scaledWidth << "x" << scaledHeight);
+            MS_LOG_INFO("  Offset: (" << offsetX << ", " << offsetY << ")");
             debugPrinted = true;
         }
         
@@ -784,7 +816,7 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithONNX(const cv::Mat& frame)
         cv::cvtColor(letterboxed, rgb, cv::COLOR_BGR2RGB);
         rgb.convertTo(rgb, CV_32F, 1.0 / 255.0);
         
-        // Prepare input tensor [1, 3, 256, 256]
+        // Prepare input tensor [1, 3, inputSize, inputSize]
         std::vector<float> inputTensorValues(1 * 3 * inputSize * inputSize);
         
         // Convert HWC to CHW format
@@ -809,19 +841,41 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithONNX(const cv::Mat& frame)
         const char* inputNames[] = {m_onnxInputName.c_str()};
         const char* outputNames[] = {m_onnxOutputName.c_str()};
         
+        auto inferenceStart = std::chrono::high_resolution_clock::now();
         auto outputTensors = m_onnxSession->Run(
             Ort::RunOptions{nullptr},
             inputNames, &inputTensor, 1,
             outputNames, 1
         );
+        double inferenceMs = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - inferenceStart).count();
         
-        // Get output [1, 1, 256, 256] or [1, 256, 256, 1]
+        // Get output [1, 1, H, W] or [1, H, W, 1]
         float* outputData = outputTensors[0].GetTensorMutableData<float>();
         auto tensorInfo = outputTensors[0].GetTensorTypeAndShapeInfo();
         auto shape = tensorInfo.GetShape();
+
+        int maskHeight = inputSize;
+        int maskWidth = inputSize;
+        if (shape.size() == 4) {
+            bool channelsLast = shape[3] == 1 && shape[1] != 1;
+            maskHeight = static_cast<int>(channelsLast ? shape[1] : shape[2]);
+            maskWidth = static_cast<int>(channelsLast ? shape[2] : shape[3]);
+        }
         
-        // Convert to OpenCV Mat
-        cv::Mat maskSmall(inputSize, inputSize, CV_32F, outputData);
+        // Convert to OpenCV Mat (letterbox coordinates)
+        cv::Mat maskRaw(maskHeight, maskWidth, CV_32F, outputData);
+        cv::Mat maskSmall = maskRaw;
+        if (maskRaw.size() != cv::Size(inputSize, inputSize)) {
+            cv::resize(maskRaw, maskSmall, cv::Size(inputSize, inputSize), 0, 0, cv::INTER_LINEAR);
+        }
+
+        // Next frame's letterbox size; this frame's crop still uses inputSize
+        if (m_letterboxController.Update(inferenceMs)) {
+            m_letterboxSize = m_letterboxController.GetCurrentSize();
+            MS_LOG_INFO("[VirtualBackgroundProcessor] Letterbox size " << inputSize << " -> " << m_letterboxSize
+                      << " (smoothed " << m_letterboxController.GetSmoothedLatency() << "ms)");
+        }
         
         // IMPORTANT: Remove letterboxing padding - crop to scaled region
         // Validate crop rectangle before using it
@@ -852,7 +906,7 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithONNX(const cv::Mat& frame)
             return PostProcessMask(shiftedMask, frame);
         } else {
             // Fallback: use entire mask if crop validation fails
-            std::cerr << "[VirtualBackgroundProcessor] Invalid crop rect, using full mask" << std::endl;
+            MS_LOG_ERROR("[VirtualBackgroundProcessor] Invalid crop rect, using full mask");
             cv::Mat mask;
             cv::resize(maskSmall, mask, frame.size(), 0, 0, cv::INTER_CUBIC);
             mask.convertTo(mask, CV_8U, 255.0);
@@ -860,10 +914,10 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithONNX(const cv::Mat& frame)
         }
         
     } catch (const Ort::Exception& e) {
-        std::cerr << "[VirtualBackgroundProcessor] ONNX inference error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] ONNX inference error: " << e.what());
         return DetectPersonUsingMotionAndFace(frame);
     } catch (const std::exception& e) {
-        std::cerr << "[VirtualBackgroundProcessor] Error in ONNX segmentation: " << e.what() << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] Error in ONNX segmentation: " << e.what());
         return DetectPersonUsingMotionAndFace(frame);
     }
 }
@@ -890,12 +944,12 @@ bool VirtualBackgroundProcessor::LoadSegmentationModelOpenCVDNN(const std::strin
                 m_segmentationNet.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
                 m_segmentationNet.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA_FP16);
                 m_backend = "CUDA FP16";
-                std::cout << "[VirtualBackgroundProcessor] GPU acceleration enabled (OpenCV CUDA)" << std::endl;
+                MS_LOG_INFO("[VirtualBackgroundProcessor] GPU acceleration enabled (OpenCV CUDA)");
             } catch (...) {
                 m_segmentationNet.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
                 m_segmentationNet.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
                 m_backend = "CPU";
-                std::cout << "[VirtualBackgroundProcessor] CUDA not available, using CPU" << std::endl;
+                MS_LOG_INFO("[VirtualBackgroundProcessor] CUDA not available, using CPU");
             }
         } else {
             m_segmentationNet.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
@@ -904,13 +958,13 @@ bool VirtualBackgroundProcessor::LoadSegmentationModelOpenCVDNN(const std::strin
         }
         
         m_modelLoaded = true;
-        std::cout << "[VirtualBackgroundProcessor] OpenCV DNN model loaded successfully" << std::endl;
-        std::cout << "[VirtualBackgroundProcessor] Backend: " << m_backend << std::endl;
+        MS_LOG_INFO("[VirtualBackgroundProcessor] OpenCV DNN model loaded successfully");
+        MS_LOG_INFO("[VirtualBackgroundProcessor] Backend: " << m_backend);
         
         return true;
         
     } catch (const cv::Exception& e) {
-        std::cerr << "[VirtualBackgroundProcessor] OpenCV DNN error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] OpenCV DNN error: " << e.what());
         return false;
     }
 }
@@ -934,12 +988,12 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithOpenCVDNN(const cv::Mat& fr
         // Debug: Print output tensor shape to verify layout
         static bool shapeDebugPrinted = false;
         if (!shapeDebugPrinted) {
-            std::cout << "[VirtualBackgroundProcessor] DeepLab output shape: ";
+            std::string shape;
             for (int i = 0; i < output.dims; i++) {
-                std::cout << output.size[i];
-                if (i < output.dims - 1) std::cout << " x ";
+                shape += std::to_string(output.size[i]);
+                if (i < output.dims - 1) shape += " x ";
             }
-            std::cout << std::endl;
+            MS_LOG_INFO("[VirtualBackgroundProcessor] DeepLab output shape: " << shape);
             shapeDebugPrinted = true;
         }
         
@@ -972,7 +1026,7 @@ cv::Mat VirtualBackgroundProcessor::SegmentPersonWithOpenCVDNN(const cv::Mat& fr
         return PostProcessMask(mask, frame);
         
     } catch (const cv::Exception& e) {
-        std::cerr << "[VirtualBackgroundProcessor] DNN inference error: " << e.what() << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] DNN inference error: " << e.what());
         return DetectPersonUsingMotionAndFace(frame);
     }
 }
@@ -1061,30 +1115,30 @@ void VirtualBackgroundProcessor::SetSegmentationMethod(SegmentationMethod method
     std::string methodName = (method == METHOD_ONNX_SELFIE ? "ONNX (MediaPipe)" : 
                               method == METHOD_OPENCV_DNN ? "OpenCV DNN" : "Motion+Face");
     
-    std::cout << "[VirtualBackgroundProcessor] Segmentation method changed to: " << methodName << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Segmentation method changed to: " << methodName);
     
     // Check if the requested method is available
     if (method == METHOD_OPENCV_DNN) {
         if (!m_modelLoaded || m_segmentationNet.empty()) {
-            std::cout << "[VirtualBackgroundProcessor] ⚠️  OpenCV DNN model not loaded!" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor]    Falling back to Motion+Face detection" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor] 💡 To use OpenCV DNN, download DeepLab model:" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor]    1. Download: deeplabv3_mnv2_pascal_train_aug.pb" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor]    2. Place in: models/ folder" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor]    3. Restart application" << std::endl;
+            MS_LOG_INFO("[VirtualBackgroundProcessor] ⚠️  OpenCV DNN model not loaded!");
+            MS_LOG_INFO("[VirtualBackgroundProcessor]    Falling back to Motion+Face detection");
+            MS_LOG_INFO("[VirtualBackgroundProcessor] 💡 To use OpenCV DNN, download DeepLab model:");
+            MS_LOG_INFO("[VirtualBackgroundProcessor]    1. Download: deeplabv3_mnv2_pascal_train_aug.pb");
+            MS_LOG_INFO("[VirtualBackgroundProcessor]    2. Place in: models/ folder");
+            MS_LOG_INFO("[VirtualBackgroundProcessor]    3. Restart application");
         } else {
-            std::cout << "[VirtualBackgroundProcessor] ✅ OpenCV DNN ready" << std::endl;
+            MS_LOG_INFO("[VirtualBackgroundProcessor] ✅ OpenCV DNN ready");
         }
     }
     
 #ifdef HAVE_ONNX
     if (method == METHOD_ONNX_SELFIE) {
         if (!m_modelLoaded) {
-            std::cout << "[VirtualBackgroundProcessor] ⚠️  ONNX model not loaded!" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor]    Falling back to Motion+Face detection" << std::endl;
-            std::cout << "[VirtualBackgroundProcessor] 💡 To use ONNX, run: .\\scripts\\download_mediapipe_onnx.ps1" << std::endl;
+            MS_LOG_INFO("[VirtualBackgroundProcessor] ⚠️  ONNX model not loaded!");
+            MS_LOG_INFO("[VirtualBackgroundProcessor]    Falling back to Motion+Face detection");
+            MS_LOG_INFO("[VirtualBackgroundProcessor] 💡 To use ONNX, run: .\\scripts\\download_mediapipe_onnx.ps1");
         } else {
-            std::cout << "[VirtualBackgroundProcessor] ✅ ONNX (MediaPipe) ready with " << m_backend << std::endl;
+            MS_LOG_INFO("[VirtualBackgroundProcessor] ✅ ONNX (MediaPipe) ready with " << m_backend);
         }
     }
 #endif
@@ -1095,11 +1149,11 @@ void VirtualBackgroundProcessor::SetSegmentationMethod(SegmentationMethod method
 void VirtualBackgroundProcessor::SetUseGPU(bool useGPU)
 {
     m_useGPU = useGPU;
-    std::cout << "[VirtualBackgroundProcessor] GPU usage " << (useGPU ? "enabled" : "disabled") << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] GPU usage " << (useGPU ? "enabled" : "disabled"));
     
     // If model is already loaded, may need to reinitialize
     if (m_modelLoaded) {
-        std::cout << "[VirtualBackgroundProcessor] ⚠️  GPU setting changed. Reinitialize processor for changes to take effect." << std::endl;
+        MS_LOG_INFO("[VirtualBackgroundProcessor] ⚠️  GPU setting changed. Reinitialize processor for changes to take effect.");
     }
 }
 
@@ -1111,13 +1165,13 @@ bool VirtualBackgroundProcessor::LoadSegmentationModel(const std::string& modelP
 #ifdef HAVE_ONNX
         return LoadSegmentationModelONNX(modelPath);
 #else
-        std::cerr << "[VirtualBackgroundProcessor] ONNX model specified but ONNX Runtime not available" << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] ONNX model specified but ONNX Runtime not available");
         return false;
 #endif
     } else if (modelPath.find(".pb") != std::string::npos) {
         return LoadSegmentationModelOpenCVDNN(modelPath);
     } else {
-        std::cerr << "[VirtualBackgroundProcessor] Unsupported model format: " << modelPath << std::endl;
+        MS_LOG_ERROR("[VirtualBackgroundProcessor] Unsupported model format: " << modelPath);
         return false;
     }
 }
@@ -1179,7 +1233,7 @@ bool VirtualBackgroundProcessor::SupportsRealTime() const
 void VirtualBackgroundProcessor::SetBackgroundMode(BackgroundMode mode)
 {
     m_backgroundMode = mode;
-    std::cout << "[VirtualBackgroundProcessor] Background mode changed to: " << (int)mode << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Background mode changed to: " << (int)mode);
 }
 
 void VirtualBackgroundProcessor::SetBackgroundImage(const std::string& imagePath)
@@ -1194,7 +1248,7 @@ void VirtualBackgroundProcessor::SetBackgroundImage(const std::string& imagePath
 void VirtualBackgroundProcessor::SetBlurStrength(int kernelSize)
 {
     m_blurStrength = std::max(1, std::min(kernelSize, 100));
-    std::cout << "[VirtualBackgroundProcessor] Blur strength set to: " << m_blurStrength << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Blur strength set to: " << m_blurStrength);
 }
 
 #ifdef HAVE_OPENCV
@@ -1202,7 +1256,7 @@ void VirtualBackgroundProcessor::SetSolidColor(cv::Scalar color)
 {
     m_solidColor = color;
     m_backgroundMode = SOLID_COLOR;
-    std::cout << "[VirtualBackgroundProcessor] Solid color set to: (" << color[0] << "," << color[1] << "," << color[2] << ")" << std::endl;
+    MS_LOG_INFO("[VirtualBackgroundProcessor] Solid color set to: (" << color[0] << "," << color[1] << "," << color[2] << ")");
 }
 #endif
 
@@ -1253,6 +1307,42 @@ bool VirtualBackgroundProcessor::SetParameter(const std::string& name, const std
             return false;
         }
     }
+    else if (name == "adaptive_resolution") {
+        SetAdaptiveResolution(value == "true" || value == "1" || value == "yes");
+        m_parameters[name] = value;
+        return true;
+    }
+    else if (name == "segmentation_budget_ms") {
+        try {
+            m_letterboxController.SetBudget(std::stod(value));
+            m_parameters[name] = value;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+    else if (name == "resolution_ladder") {
+        std::vector<int> sizes;
+        if (!ResolutionController::ParseLadder(value, sizes)) {
+            return false;
+        }
+        m_letterboxController.SetLadder(sizes);
+        if (!m_letterboxDynamic) {
+            m_letterboxController.SetCurrentSize(m_letterboxSize);
+        }
+        m_parameters[name] = value;
+        return true;
+    }
+    else if (name == "background_palette") {
+        if (value.empty() || value == "none") {
+            m_backgroundPalette.Clear();
+        } else if (!m_backgroundPalette.Load(value)) {
+            MS_LOG_ERROR("[VirtualBackgroundProcessor] Could not load palette: " << value);
+            return false;
+        }
+        m_parameters[name] = value;
+        return true;
+    }
     else if (name == "blend_alpha") {
         try {
             float alpha = std::stof(value);
@@ -1268,7 +1358,25 @@ bool VirtualBackgroundProcessor::SetParameter(const std::string& name, const std
 
 std::map<std::string, std::string> VirtualBackgroundProcessor::GetParameters() const
 {
-    return m_parameters;
+    auto params = m_parameters;
+    params["letterbox_size"] = std::to_string(m_letterboxSize);
+    params["letterbox_dynamic"] = m_letterboxDynamic ? "true" : "false";
+    params["segmentation_latency_ms"] = std::to_string(m_letterboxController.GetSmoothedLatency());
+    params["deadline_misses"] = std::to_string(m_letterboxController.GetMisses());
+    return params;
+}
+
+void VirtualBackgroundProcessor::SetAdaptiveResolution(bool enabled)
+{
+    m_adaptiveLetterbox = enabled;
+    m_letterboxController.SetCurrentSize(m_letterboxSize);
+    m_letterboxController.SetEnabled(enabled && m_letterboxDynamic);
+    m_letterboxController.ResetStats();
+
+    if (enabled && m_modelLoaded && !m_letterboxDynamic) {
+        MS_LOG_INFO("[VirtualBackgroundProcessor] Model input is fixed at " << m_letterboxSize
+                  << ", adaptive resolution has no effect");
+    }
 }
 
 double VirtualBackgroundProcessor::GetExpectedProcessingTime() const
@@ -1287,13 +1395,8 @@ cv::Mat VirtualBackgroundProcessor::CreateMinecraftPixelBackground(const cv::Mat
     cv::Mat result = frame.clone();
     
     // Step 1: Enhance saturation for vibrant Minecraft-like colors
-    cv::Mat hsv;
-    cv::cvtColor(result, hsv, cv::COLOR_BGR2HSV);
-    std::vector<cv::Mat> channels;
-    cv::split(hsv, channels);
-    channels[1] = channels[1] * 1.4; // Boost saturation
-    cv::merge(channels, hsv);
-    cv::cvtColor(hsv, result, cv::COLOR_HSV2BGR);
+    // (HSV round trip sampled once into a shared LUT)
+    ColorLut3D::ScaleSaturationValue(result, 1.4);
     
     // Step 2: Pixelate - downsample then upsample with nearest neighbor
     int newWidth = std::max(1, result.cols / pixelSize);
@@ -1302,22 +1405,20 @@ cv::Mat VirtualBackgroundProcessor::CreateMinecraftPixelBackground(const cv::Mat
     cv::Mat small;
     cv::resize(result, small, cv::Size(newWidth, newHeight), 0, 0, cv::INTER_LINEAR);
     
+    // Step 3: Reduce colors per block (identical after the nearest-neighbor
+    // expansion): a fixed palette if one is loaded, otherwise quantize to
+    // fewer levels
+    if (m_backgroundPalette.IsLoaded()) {
+        m_backgroundPalette.Apply(small, small);
+    } else {
+        const int step = 256 / colorLevels;
+        ColorLut3D::Posterize(small, small, step, step / 2);
+    }
+    
     // Upsample back with nearest neighbor for sharp, blocky effect
     cv::Mat pixelated;
     cv::resize(small, pixelated, result.size(), 0, 0, cv::INTER_NEAREST);
     
-    // Step 3: Quantize colors to fewer levels for blocky color palette
-    int step = 256 / colorLevels;
-    for (int y = 0; y < pixelated.rows; ++y) {
-        cv::Vec3b* row = pixelated.ptr<cv::Vec3b>(y);
-        for (int x = 0; x < pixelated.cols; ++x) {
-            for (int c = 0; c < 3; ++c) {
-                int val = row[x][c];
-                row[x][c] = (val / step) * step + step / 2;
-            }
-        }
-    }
-    
     // Step 4: Add strong black edge outlines (optional but looks good)
     cv::Mat gray, edges;
     cv::cvtColor(pixelated, gray, cv::COLOR_BGR2GRAY);
@@ -2,6 +2,9 @@
 #define VIRTUAL_BACKGROUND_PROCESSOR_H
 
 #include "ai_processor.h"
+#include "color_lut.h"
+#include "palette_mapper.h"
+#include "resolution_controller.h"
 #include <vector>
 #include <string>
 #include <deque>
@@ -62,7 +65,11 @@ public:
     void SetSegmentationMethod(SegmentationMethod method);
     void SetUseGPU(bool useGPU);  // Enable GPU acceleration
     bool LoadSegmentationModel(const std::string& modelPath);
+    void SetAdaptiveResolution(bool enabled);  // Step letterbox size to hold the segmentation budget
     std::string GetSegmentationInfo() const;  // Get current method and performance info
+#ifdef HAVE_OPENCV
+    cv::Mat ComputePersonMask(const cv::Mat& frame);  // CV_8U person mask (0-255), frame size
+#endif
 
 private:
 #ifdef HAVE_OPENCV
@@ -82,8 +89,15 @@ private:
     std::string m_onnxInputName;
     std::string m_onnxOutputName;
 #endif
+
+    // Letterbox input size; adapted only when the model has dynamic H/W
+    int m_letterboxSize;
+    bool m_letterboxDynamic;
+    bool m_adaptiveLetterbox;
+    ResolutionController m_letterboxController;
     
     // Background data
+    PaletteMapper m_backgroundPalette;    // Minecraft background: fixed palette instead of level quantization
     cv::Mat m_backgroundImage;
     cv::Scalar m_solidColor;
     BackgroundMode m_backgroundMode;
@@ -17,6 +17,7 @@
 #include "ai/person_tracker_processor.h"
 #include "ai/virtual_background_processor.h"
 #include "ai/person_replacement_processor.h"
+#include "ai/logger.h"
 #include "virtual_camera/virtual_camera_filter.h"
 #include "virtual_camera/virtual_camera_manager.h"
 #include "virtual_camera/camera_diagnostics.h"
@@ -1019,7 +1020,7 @@ void OnCameraFrame(const Frame& frame) {
     if (g_processor->GetName() == "Face Filter Processor") {
         static int frameCount = 0;
         if (frameCount % 30 == 0) { // Log every 30 frames
-            std::cout << "[Main] Face filter processing frame " << frameCount << std::endl;
+            MS_LOG_DEBUG("[Main] Face filter processing frame " << frameCount);
         }
         frameCount++;
     }